@@ -0,0 +1,656 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Microbenchmarks of the computational kernels of the LTE module, run
+ * outside of a full simulation with synthetic inputs:
+ *
+ *   - pf: PfFfMacScheduler::DoSchedDlTriggerReq, driven through the
+ *     FfMacSchedSapProvider API, for several numbers of UEs and RBGs;
+ *   - mi: LteMiErrorModel::GetTbDecodificationStats;
+ *   - amc: LteAmc::CreateCqiFeedbacks;
+ *   - interference: one reception by LteInterference, with interferers
+ *     added and subtracted during the reception;
+ *   - chunk: LteChunkProcessorMultiple, over several chunks per signal.
+ *
+ * For each kernel and input size, one tab-separated line reports the
+ * number of iterations, the time per operation in nanoseconds and the
+ * number of heap allocations per operation. The inputs are generated
+ * with a fixed seed, so that successive runs are comparable.
+ *
+ * Example: ./waf --run "lena-kernel-benchmark --kernel=pf --iterations=20000"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/lte-module.h"
+#include <ns3/spectrum-value.h>
+#include <time.h>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LenaKernelBenchmark");
+
+/// number of calls of operator new since the beginning of the run
+static uint64_t g_nAllocations = 0;
+
+void*
+operator new (std::size_t size) throw (std::bad_alloc)
+{
+  ++g_nAllocations;
+  void* p = std::malloc (size == 0 ? 1 : size);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+void
+operator delete (void* p) throw ()
+{
+  std::free (p);
+}
+
+/**
+ * \return a monotonic clock, in nanoseconds
+ */
+static uint64_t
+GetNanoSeconds (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t> (ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * \param bandwidth a number of RBs
+ * \return the size of the RBGs for this bandwidth (3GPP TS 36.213 table 7.1.6.1-1)
+ */
+static uint32_t
+GetRbgSize (uint32_t bandwidth)
+{
+  static const uint32_t maxBandwidth[4] = {10, 26, 63, 110};
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      if (bandwidth < maxBandwidth[i])
+        {
+          return i + 1;
+        }
+    }
+  return 4;
+}
+
+/**
+ * \param bandwidth a number of RBs
+ * \param uniform the random variable of the inputs
+ * \return a SINR of 0 to 20 dB on each RB
+ */
+static SpectrumValue
+CreateSinr (uint32_t bandwidth, Ptr<UniformRandomVariable> uniform)
+{
+  SpectrumValue sinr (LteSpectrumValueHelper::GetSpectrumModel (100, bandwidth));
+  for (uint32_t i = 0; i < bandwidth; ++i)
+    {
+      sinr[i] = std::pow (10.0, uniform->GetValue (0, 20) / 10);
+    }
+  return sinr;
+}
+
+
+/**
+ * A kernel, run repeatedly on the same synthetic inputs
+ */
+class KernelBenchmark
+{
+public:
+  virtual ~KernelBenchmark ()
+  {
+  }
+
+  /**
+   * \return the name of the kernel
+   */
+  virtual std::string GetName (void) const = 0;
+
+  /**
+   * \return the size of the inputs, e.g. "ue=10 rb=25"
+   */
+  virtual std::string GetParameters (void) const = 0;
+
+  /**
+   * Run the kernel once
+   */
+  virtual void RunOnce (void) = 0;
+};
+
+/**
+ * Run a kernel, and print the time and the allocations per operation
+ * \param benchmark the kernel
+ * \param iterations the number of operations measured
+ */
+static void
+Measure (KernelBenchmark& benchmark, uint32_t iterations)
+{
+  // warm up the caches and the internal state of the kernel
+  for (uint32_t i = 0; i < iterations / 10 + 1; ++i)
+    {
+      benchmark.RunOnce ();
+    }
+  uint64_t allocations = g_nAllocations;
+  uint64_t start = GetNanoSeconds ();
+  for (uint32_t i = 0; i < iterations; ++i)
+    {
+      benchmark.RunOnce ();
+    }
+  uint64_t elapsed = GetNanoSeconds () - start;
+  allocations = g_nAllocations - allocations;
+  std::cout << benchmark.GetName () << "\t" << benchmark.GetParameters () << "\t"
+            << iterations << "\t"
+            << static_cast<double> (elapsed) / iterations << "\t"
+            << static_cast<double> (allocations) / iterations << std::endl;
+}
+
+
+/**
+ * Scheduler SAP user discarding the scheduling decisions
+ */
+class BenchmarkSchedSapUser : public FfMacSchedSapUser
+{
+public:
+  BenchmarkSchedSapUser ()
+    : m_nDci (0)
+  {
+  }
+
+  virtual void SchedDlConfigInd (const struct SchedDlConfigIndParameters& params)
+  {
+    m_nDci += params.m_buildDataList.size ();
+  }
+
+  virtual void SchedUlConfigInd (const struct SchedUlConfigIndParameters& params)
+  {
+  }
+
+  uint64_t m_nDci; ///< number of DL DCIs, so that the scheduling is not optimized out
+};
+
+/**
+ * Scheduler CSCHED SAP user ignoring the confirmations
+ */
+class BenchmarkCschedSapUser : public FfMacCschedSapUser
+{
+public:
+  virtual void CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params)
+  {
+  }
+  virtual void CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params)
+  {
+  }
+};
+
+/**
+ * PfFfMacScheduler::DoSchedDlTriggerReq with nUe fully backlogged UEs
+ * reporting subband CQIs
+ */
+class PfDlTriggerBenchmark : public KernelBenchmark
+{
+public:
+  PfDlTriggerBenchmark (uint32_t nUe, uint32_t bandwidth, Ptr<UniformRandomVariable> uniform)
+    : m_nUe (nUe),
+      m_bandwidth (bandwidth),
+      m_frameNo (1),
+      m_subframeNo (1)
+  {
+    m_scheduler = CreateObject<PfFfMacScheduler> ();
+    // no HARQ feedback is simulated, and the CQIs never expire
+    m_scheduler->SetAttribute ("HarqEnabled", BooleanValue (false));
+    m_scheduler->SetAttribute ("CqiTimerThreshold", UintegerValue (0xffffffff));
+    m_ffr = CreateObject<LteFrNoOpAlgorithm> ();
+    m_ffr->SetDlBandwidth (bandwidth);
+    m_ffr->SetUlBandwidth (bandwidth);
+    m_scheduler->SetFfMacSchedSapUser (&m_schedSapUser);
+    m_scheduler->SetFfMacCschedSapUser (&m_cschedSapUser);
+    m_scheduler->SetLteFfrSapProvider (m_ffr->GetLteFfrSapProvider ());
+    m_ffr->SetLteFfrSapUser (m_scheduler->GetLteFfrSapUser ());
+    FfMacSchedSapProvider* sched = m_scheduler->GetFfMacSchedSapProvider ();
+    FfMacCschedSapProvider* csched = m_scheduler->GetFfMacCschedSapProvider ();
+
+    FfMacCschedSapProvider::CschedCellConfigReqParameters cellParams;
+    cellParams.m_ulBandwidth = bandwidth;
+    cellParams.m_dlBandwidth = bandwidth;
+    csched->CschedCellConfigReq (cellParams);
+
+    uint32_t nRbg = (bandwidth + GetRbgSize (bandwidth) - 1) / GetRbgSize (bandwidth);
+    FfMacSchedSapProvider::SchedDlCqiInfoReqParameters cqiParams;
+    cqiParams.m_sfnSf = 0;
+    for (uint16_t rnti = 1; rnti <= nUe; ++rnti)
+      {
+        FfMacCschedSapProvider::CschedUeConfigReqParameters ueParams;
+        ueParams.m_rnti = rnti;
+        ueParams.m_transmissionMode = 0;
+        csched->CschedUeConfigReq (ueParams);
+
+        FfMacCschedSapProvider::CschedLcConfigReqParameters lcParams;
+        lcParams.m_rnti = rnti;
+        lcParams.m_reconfigureFlag = false;
+        LogicalChannelConfigListElement_s lccle;
+        lccle.m_logicalChannelIdentity = 3;
+        lccle.m_logicalChannelGroup = 1;
+        lccle.m_direction = LogicalChannelConfigListElement_s::DIR_BOTH;
+        lccle.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+        lccle.m_qci = EpsBearer::NGBR_VIDEO_TCP_DEFAULT;
+        lccle.m_eRabMaximulBitrateUl = 0;
+        lccle.m_eRabMaximulBitrateDl = 0;
+        lccle.m_eRabGuaranteedBitrateUl = 0;
+        lccle.m_eRabGuaranteedBitrateDl = 0;
+        lcParams.m_logicalChannelConfigList.push_back (lccle);
+        csched->CschedLcConfigReq (lcParams);
+
+        FfMacSchedSapProvider::SchedDlRlcBufferReqParameters rlcParams;
+        rlcParams.m_rnti = rnti;
+        rlcParams.m_logicalChannelIdentity = 3;
+        rlcParams.m_rlcTransmissionQueueSize = 2000000000;
+        rlcParams.m_rlcTransmissionQueueHolDelay = 0;
+        rlcParams.m_rlcRetransmissionQueueSize = 0;
+        rlcParams.m_rlcRetransmissionHolDelay = 0;
+        rlcParams.m_rlcStatusPduSize = 0;
+        sched->SchedDlRlcBufferReq (rlcParams);
+
+        CqiListElement_s cqi;
+        cqi.m_rnti = rnti;
+        cqi.m_ri = 1;
+        cqi.m_cqiType = CqiListElement_s::A30;
+        cqi.m_wbCqi.push_back (uniform->GetInteger (1, 15));
+        cqi.m_wbPmi = 0;
+        for (uint32_t rbg = 0; rbg < nRbg; ++rbg)
+          {
+            HigherLayerSelected_s subband;
+            subband.m_sbPmi = 0;
+            subband.m_sbCqi.push_back (uniform->GetInteger (1, 15));
+            cqi.m_sbMeasResult.m_higherLayerSelected.push_back (subband);
+          }
+        cqiParams.m_cqiList.push_back (cqi);
+      }
+    sched->SchedDlCqiInfoReq (cqiParams);
+  }
+
+  virtual ~PfDlTriggerBenchmark ()
+  {
+    m_scheduler->Dispose ();
+    m_ffr->Dispose ();
+  }
+
+  virtual std::string GetName (void) const
+  {
+    return "PfFfMacScheduler::DoSchedDlTriggerReq";
+  }
+
+  virtual std::string GetParameters (void) const
+  {
+    std::ostringstream oss;
+    oss << "ue=" << m_nUe << " rbg=" << (m_bandwidth + GetRbgSize (m_bandwidth) - 1) / GetRbgSize (m_bandwidth);
+    return oss.str ();
+  }
+
+  virtual void RunOnce (void)
+  {
+    if (++m_subframeNo > 10)
+      {
+        m_subframeNo = 1;
+        m_frameNo = (m_frameNo % 1024) + 1;
+      }
+    FfMacSchedSapProvider::SchedDlTriggerReqParameters params;
+    params.m_sfnSf = ((0x3FF & m_frameNo) << 4) | (0xF & m_subframeNo);
+    m_scheduler->GetFfMacSchedSapProvider ()->SchedDlTriggerReq (params);
+  }
+
+private:
+  uint32_t m_nUe; ///< number of UEs
+  uint32_t m_bandwidth; ///< DL bandwidth, in RBs
+  uint32_t m_frameNo; ///< frame number of the next trigger
+  uint32_t m_subframeNo; ///< subframe number of the next trigger
+  Ptr<PfFfMacScheduler> m_scheduler; ///< the scheduler
+  Ptr<LteFrNoOpAlgorithm> m_ffr; ///< the FFR algorithm required by the scheduler
+  BenchmarkSchedSapUser m_schedSapUser; ///< the MAC side of the SCHED SAP
+  BenchmarkCschedSapUser m_cschedSapUser; ///< the MAC side of the CSCHED SAP
+};
+
+/**
+ * LteMiErrorModel::GetTbDecodificationStats of a TB over the whole
+ * bandwidth, without HARQ history
+ */
+class MiErrorModelBenchmark : public KernelBenchmark
+{
+public:
+  MiErrorModelBenchmark (uint32_t bandwidth, uint8_t mcs, Ptr<UniformRandomVariable> uniform)
+    : m_bandwidth (bandwidth),
+      m_mcs (mcs),
+      m_sinr (CreateSinr (bandwidth, uniform)),
+      m_tbler (0)
+  {
+    for (uint32_t i = 0; i < bandwidth; ++i)
+      {
+        m_map.push_back (i);
+      }
+    Ptr<LteAmc> amc = CreateObject<LteAmc> ();
+    m_size = amc->GetTbSizeFromMcs (mcs, bandwidth) / 8;
+  }
+
+  virtual std::string GetName (void) const
+  {
+    return "LteMiErrorModel::GetTbDecodificationStats";
+  }
+
+  virtual std::string GetParameters (void) const
+  {
+    std::ostringstream oss;
+    oss << "rb=" << m_bandwidth << " mcs=" << (uint32_t) m_mcs;
+    return oss.str ();
+  }
+
+  virtual void RunOnce (void)
+  {
+    m_tbler += LteMiErrorModel::GetTbDecodificationStats (m_sinr, m_map, m_size, m_mcs, m_history).tbler;
+  }
+
+private:
+  uint32_t m_bandwidth; ///< number of RBs of the TB
+  uint8_t m_mcs; ///< MCS of the TB
+  uint16_t m_size; ///< size of the TB, in bytes
+  SpectrumValue m_sinr; ///< SINR per RB
+  std::vector<int> m_map; ///< the RBs of the TB
+  HarqProcessInfoList_t m_history; ///< empty HARQ history
+  double m_tbler; ///< sum of the results, so that they are not optimized out
+};
+
+/**
+ * LteAmc::CreateCqiFeedbacks of subband CQIs
+ */
+class AmcCqiBenchmark : public KernelBenchmark
+{
+public:
+  AmcCqiBenchmark (uint32_t bandwidth, Ptr<UniformRandomVariable> uniform)
+    : m_bandwidth (bandwidth),
+      m_sinr (CreateSinr (bandwidth, uniform)),
+      m_sum (0)
+  {
+    m_amc = CreateObject<LteAmc> ();
+  }
+
+  virtual std::string GetName (void) const
+  {
+    return "LteAmc::CreateCqiFeedbacks";
+  }
+
+  virtual std::string GetParameters (void) const
+  {
+    std::ostringstream oss;
+    oss << "rb=" << m_bandwidth << " rbgSize=" << GetRbgSize (m_bandwidth);
+    return oss.str ();
+  }
+
+  virtual void RunOnce (void)
+  {
+    m_sum += m_amc->CreateCqiFeedbacks (m_sinr, GetRbgSize (m_bandwidth)).front ();
+  }
+
+private:
+  uint32_t m_bandwidth; ///< number of RBs
+  SpectrumValue m_sinr; ///< SINR per RB
+  Ptr<LteAmc> m_amc; ///< the AMC
+  uint64_t m_sum; ///< sum of the results, so that they are not optimized out
+};
+
+/**
+ * One reception by LteInterference, during which nInterferers signals
+ * start at regular intervals. The signals are subtracted by the events
+ * of the simulator, which is run until the end of the last signal.
+ */
+class InterferenceBenchmark : public KernelBenchmark
+{
+public:
+  InterferenceBenchmark (uint32_t bandwidth, uint32_t nInterferers, Ptr<UniformRandomVariable> uniform)
+    : m_bandwidth (bandwidth),
+      m_nInterferers (nInterferers)
+  {
+    std::vector<int> activeRbs;
+    for (uint32_t i = 0; i < bandwidth; ++i)
+      {
+        activeRbs.push_back (i);
+      }
+    m_rxPsd = LteSpectrumValueHelper::CreateTxPowerSpectralDensity (100, bandwidth, 30, activeRbs);
+    (*m_rxPsd) *= 1e-10;
+    for (uint32_t i = 0; i < nInterferers; ++i)
+      {
+        Ptr<SpectrumValue> psd = LteSpectrumValueHelper::CreateTxPowerSpectralDensity (100, bandwidth, 30, activeRbs);
+        (*psd) *= std::pow (10.0, -uniform->GetValue (110, 130) / 10);
+        m_interfererPsds.push_back (psd);
+      }
+    m_interference = CreateObject<LteInterference> ();
+    m_interference->SetNoisePowerSpectralDensity (LteSpectrumValueHelper::CreateNoisePowerSpectralDensity (100, bandwidth, 9));
+    Ptr<LteChunkProcessor> processor = Create<LteChunkProcessor> ();
+    processor->AddCallback (MakeCallback (&LteSpectrumValueCatcher::ReportValue, &m_catcher));
+    m_interference->AddSinrChunkProcessor (processor);
+  }
+
+  virtual ~InterferenceBenchmark ()
+  {
+    m_interference->Dispose ();
+    Simulator::Destroy ();
+  }
+
+  virtual std::string GetName (void) const
+  {
+    return "LteInterference";
+  }
+
+  virtual std::string GetParameters (void) const
+  {
+    std::ostringstream oss;
+    oss << "rb=" << m_bandwidth << " interferers=" << m_nInterferers;
+    return oss.str ();
+  }
+
+  virtual void RunOnce (void)
+  {
+    Time duration = MilliSeconds (1);
+    m_interference->StartRx (m_rxPsd);
+    m_interference->AddSignal (m_rxPsd, duration);
+    for (uint32_t i = 0; i < m_nInterferers; ++i)
+      {
+        Simulator::Schedule (MicroSeconds (1000 * i / m_nInterferers), &LteInterference::AddSignal,
+                             m_interference, m_interfererPsds[i], duration);
+      }
+    Simulator::Schedule (duration, &BenchmarkEndRx, m_interference);
+    Simulator::Run ();
+  }
+
+private:
+  /**
+   * \param interference the interference model at the end of the reception
+   */
+  static void BenchmarkEndRx (Ptr<LteInterference> interference)
+  {
+    interference->EndRx ();
+  }
+
+  uint32_t m_bandwidth; ///< number of RBs
+  uint32_t m_nInterferers; ///< number of interferers per reception
+  Ptr<SpectrumValue> m_rxPsd; ///< the received signal
+  std::vector<Ptr<SpectrumValue> > m_interfererPsds; ///< the interferers
+  Ptr<LteInterference> m_interference; ///< the interference model
+  LteSpectrumValueCatcher m_catcher; ///< the sink of the SINR
+};
+
+/**
+ * LteChunkProcessorMultiple over nChunks chunks of one signal
+ */
+class ChunkProcessorMultipleBenchmark : public KernelBenchmark
+{
+public:
+  ChunkProcessorMultipleBenchmark (uint32_t bandwidth, uint32_t nChunks, Ptr<UniformRandomVariable> uniform)
+    : m_bandwidth (bandwidth),
+      m_nChunks (nChunks),
+      m_signalId (0)
+  {
+    for (uint32_t i = 0; i < nChunks; ++i)
+      {
+        m_sinrs.push_back (CreateSinr (bandwidth, uniform));
+      }
+    m_processor = Create<LteChunkProcessorMultiple> ();
+    m_processor->AddCallback (MakeCallback (&ChunkProcessorMultipleBenchmark::ReportValue));
+  }
+
+  virtual std::string GetName (void) const
+  {
+    return "LteChunkProcessorMultiple";
+  }
+
+  virtual std::string GetParameters (void) const
+  {
+    std::ostringstream oss;
+    oss << "rb=" << m_bandwidth << " chunks=" << m_nChunks;
+    return oss.str ();
+  }
+
+  virtual void RunOnce (void)
+  {
+    ++m_signalId;
+    m_processor->Start (m_signalId);
+    for (uint32_t i = 0; i < m_nChunks; ++i)
+      {
+        m_processor->EvaluateChunk (m_sinrs[i], MicroSeconds (1000 / m_nChunks), m_signalId);
+      }
+    m_processor->End (m_signalId);
+  }
+
+private:
+  /**
+   * Sink of the average SINR
+   * \param value the average SINR
+   * \param signalId the signal
+   */
+  static void ReportValue (const SpectrumValue& value, uint32_t signalId)
+  {
+  }
+
+  uint32_t m_bandwidth; ///< number of RBs
+  uint32_t m_nChunks; ///< number of chunks per signal
+  uint32_t m_signalId; ///< the current signal
+  std::vector<SpectrumValue> m_sinrs; ///< SINR of the chunks
+  Ptr<LteChunkProcessorMultiple> m_processor; ///< the chunk processor
+};
+
+
+int
+main (int argc, char *argv[])
+{
+  std::string kernel = "all";
+  uint32_t iterations = 10000;
+
+  CommandLine cmd;
+  cmd.AddValue ("kernel", "Kernel to be measured: all, pf, mi, amc, interference or chunk", kernel);
+  cmd.AddValue ("iterations", "Number of operations measured per input size", iterations);
+  cmd.Parse (argc, argv);
+
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+
+  const uint32_t bandwidths[] = {25, 50, 100};
+  std::cout << "% kernel\tparameters\titerations\tnsPerOp\tallocationsPerOp" << std::endl;
+
+  if (kernel == "all" || kernel == "pf")
+    {
+      const uint32_t nUes[] = {10, 50, 100, 200};
+      for (uint32_t b = 0; b < 3; ++b)
+        {
+          for (uint32_t u = 0; u < 4; ++u)
+            {
+              PfDlTriggerBenchmark benchmark (nUes[u], bandwidths[b], uniform);
+              Measure (benchmark, iterations);
+            }
+        }
+    }
+  if (kernel == "all" || kernel == "mi")
+    {
+      const uint8_t mcss[] = {5, 15, 28};
+      for (uint32_t b = 0; b < 3; ++b)
+        {
+          for (uint32_t m = 0; m < 3; ++m)
+            {
+              MiErrorModelBenchmark benchmark (bandwidths[b], mcss[m], uniform);
+              Measure (benchmark, iterations);
+            }
+        }
+    }
+  if (kernel == "all" || kernel == "amc")
+    {
+      for (uint32_t b = 0; b < 3; ++b)
+        {
+          AmcCqiBenchmark benchmark (bandwidths[b], uniform);
+          Measure (benchmark, iterations);
+        }
+    }
+  if (kernel == "all" || kernel == "interference")
+    {
+      const uint32_t nInterferers[] = {1, 6, 18};
+      for (uint32_t b = 0; b < 3; ++b)
+        {
+          for (uint32_t i = 0; i < 3; ++i)
+            {
+              InterferenceBenchmark benchmark (bandwidths[b], nInterferers[i], uniform);
+              Measure (benchmark, iterations);
+            }
+        }
+    }
+  if (kernel == "all" || kernel == "chunk")
+    {
+      const uint32_t nChunks[] = {1, 4, 14};
+      for (uint32_t b = 0; b < 3; ++b)
+        {
+          for (uint32_t c = 0; c < 3; ++c)
+            {
+              ChunkProcessorMultipleBenchmark benchmark (bandwidths[b], nChunks[c], uniform);
+              Measure (benchmark, iterations);
+            }
+        }
+    }
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -200,6 +200,10 @@ main (int argc, char *argv[])
 
   Simulator::Run ();
 
+  // only filled when configured with --enable-lte-profiling
+  LteProfiler::Dump ("LteProfiler.txt");
+  LteEventProfiler::Dump ("LteEventProfiler.txt");
+
   /*GtkConfigStore config;
   config.ConfigureAttributes ();*/
 
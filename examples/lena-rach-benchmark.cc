@@ -0,0 +1,292 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Scaling benchmark of the random access model.
+ *
+ * nUe UEs are dropped uniformly in discs around nEnb eNBs and attach to
+ * their eNB at uniformly distributed times in [0, accessWindow], each
+ * attachment starting a contention-based random access. One run is one
+ * point of the benchmark: the wall time of the setup and of the
+ * simulation, the number of events scheduled, the peak resident set
+ * size and the random access KPIs of all the cells are appended as one
+ * tab-separated line to outputFile (the header line is written when the
+ * file is created). Since the peak RSS is the one of the process, each
+ * point must be run in a new process; test/lte-test-rach-benchmark.py
+ * sweeps the number of UEs, the PRACH configuration and the ideal or
+ * real RRC and PRACH models.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/lte-module.h"
+#include <ns3/default-simulator-impl.h>
+#include <ns3/system-wall-clock-ms.h>
+#include <sys/resource.h>
+#include <cmath>
+#include <fstream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LenaRachBenchmark");
+
+namespace ns3 {
+
+/**
+ * The default simulator, counting the scheduled events
+ */
+class RachBenchmarkSimulatorImpl : public DefaultSimulatorImpl
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::RachBenchmarkSimulatorImpl")
+      .SetParent<DefaultSimulatorImpl> ()
+      .AddConstructor<RachBenchmarkSimulatorImpl> ()
+    ;
+    return tid;
+  }
+
+  virtual EventId Schedule (Time const &delay, EventImpl *event)
+  {
+    ++s_nEvents;
+    return DefaultSimulatorImpl::Schedule (delay, event);
+  }
+
+  virtual void ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+  {
+    ++s_nEvents;
+    DefaultSimulatorImpl::ScheduleWithContext (context, delay, event);
+  }
+
+  virtual EventId ScheduleNow (EventImpl *event)
+  {
+    ++s_nEvents;
+    return DefaultSimulatorImpl::ScheduleNow (event);
+  }
+
+  static uint64_t s_nEvents; ///< number of events scheduled so far
+};
+
+uint64_t RachBenchmarkSimulatorImpl::s_nEvents = 0;
+
+NS_OBJECT_ENSURE_REGISTERED (RachBenchmarkSimulatorImpl);
+
+} // namespace ns3
+
+/**
+ * \param bins the merged access delay histogram of the cells
+ * \param binWidth the width of the bins
+ * \param maxDelay the largest access delay, for the last bin
+ * \param p the percentile, in (0, 1)
+ * \return the upper edge of the bin of the percentile
+ */
+static double
+GetHistogramPercentile (const std::vector<uint64_t>& bins, double binWidth, double maxDelay, double p)
+{
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < bins.size (); ++i)
+    {
+      total += bins[i];
+    }
+  if (total == 0)
+    {
+      return 0;
+    }
+  uint64_t rank = static_cast<uint64_t> (std::ceil (p * total));
+  uint64_t cumulated = 0;
+  for (uint32_t i = 0; i + 1 < bins.size (); ++i)
+    {
+      cumulated += bins[i];
+      if (cumulated >= rank)
+        {
+          return std::min ((i + 1) * binWidth, maxDelay);
+        }
+    }
+  return maxDelay;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nUe = 1000;
+  uint32_t nEnb = 1;
+  double interSiteDistance = 500;
+  double cellRadius = 200;
+  uint32_t prachConfigurationIndex = 3;
+  uint32_t nPreambles = 54;
+  bool useIdealRrc = false;
+  bool useIdealPrach = false;
+  double accessWindow = 1.0;
+  double simTime = 2.0;
+  uint32_t runNumber = 1;
+  std::string outputFile = "RachBenchmark.txt";
+
+  CommandLine cmd;
+  cmd.AddValue ("nUe", "Number of UEs", nUe);
+  cmd.AddValue ("nEnb", "Number of eNBs, on a square grid", nEnb);
+  cmd.AddValue ("interSiteDistance", "Distance between the eNBs (m)", interSiteDistance);
+  cmd.AddValue ("cellRadius", "Radius of the disc of the UEs of an eNB (m)", cellRadius);
+  cmd.AddValue ("prachConfigurationIndex", "PRACH configuration index (3GPP TS 36.211)", prachConfigurationIndex);
+  cmd.AddValue ("nPreambles", "Number of contention-based preambles", nPreambles);
+  cmd.AddValue ("useIdealRrc", "Use the ideal RRC protocol", useIdealRrc);
+  cmd.AddValue ("useIdealPrach", "Use the ideal PRACH model", useIdealPrach);
+  cmd.AddValue ("accessWindow", "The UEs attach uniformly in [0, accessWindow] (s)", accessWindow);
+  cmd.AddValue ("simTime", "Total duration of the simulation (s)", simTime);
+  cmd.AddValue ("runNumber", "Run number of the random number generators", runNumber);
+  cmd.AddValue ("outputFile", "File where the results of the run are appended", outputFile);
+  cmd.Parse (argc, argv);
+
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::RachBenchmarkSimulatorImpl"));
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (runNumber);
+
+  Config::SetDefault ("ns3::LteHelper::UseIdealRrc", BooleanValue (useIdealRrc));
+  Config::SetDefault ("ns3::LteHelper::UseIdealPrach", BooleanValue (useIdealPrach));
+  Config::SetDefault ("ns3::LteEnbMac::PRachConfigurationIndex", UintegerValue (prachConfigurationIndex));
+  Config::SetDefault ("ns3::LteEnbMac::NumberOfRaPreambles", UintegerValue (nPreambles));
+  // a single epoch, so that the KPIs cover the whole run
+  Config::SetDefault ("ns3::RaCompleteStatsCalculator::EpochDuration", TimeValue (Seconds (simTime + 1)));
+  Config::SetDefault ("ns3::RaCompleteStatsCalculator::LogEvents", BooleanValue (false));
+  Config::SetDefault ("ns3::RaPreambleStatsCalculator::EpochDuration", TimeValue (Seconds (simTime + 1)));
+  Config::SetDefault ("ns3::RaPreambleStatsCalculator::LogEvents", BooleanValue (false));
+
+  SystemWallClockMs setupClock;
+  setupClock.Start ();
+
+  NodeContainer enbNodes;
+  enbNodes.Create (nEnb);
+  NodeContainer ueNodes;
+  ueNodes.Create (nUe);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+
+  uint32_t gridWidth = static_cast<uint32_t> (std::ceil (std::sqrt (static_cast<double> (nEnb))));
+  for (uint32_t i = 0; i < nEnb; ++i)
+    {
+      Vector position ((i % gridWidth) * interSiteDistance, (i / gridWidth) * interSiteDistance, 30.0);
+      enbNodes.Get (i)->GetObject<MobilityModel> ()->SetPosition (position);
+    }
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  for (uint32_t u = 0; u < nUe; ++u)
+    {
+      Vector center = enbNodes.Get (u % nEnb)->GetObject<MobilityModel> ()->GetPosition ();
+      double rho = cellRadius * std::sqrt (uniform->GetValue (0, 1));
+      double theta = uniform->GetValue (0, 2 * M_PI);
+      Vector position (center.x + rho * std::cos (theta), center.y + rho * std::sin (theta), 1.5);
+      ueNodes.Get (u)->GetObject<MobilityModel> ()->SetPosition (position);
+    }
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+
+  void (LteHelper::*attach) (Ptr<NetDevice>, Ptr<NetDevice>) = &LteHelper::Attach;
+  for (uint32_t u = 0; u < nUe; ++u)
+    {
+      Simulator::Schedule (Seconds (uniform->GetValue (0, accessWindow)), attach, lteHelper,
+                           ueDevs.Get (u), enbDevs.Get (u % nEnb));
+    }
+
+  lteHelper->EnableRaDelayTraces ();
+  if (!useIdealPrach)
+    {
+      lteHelper->EnableRaPreambleTraces ();
+    }
+
+  Simulator::Stop (Seconds (simTime));
+  int64_t setupMs = setupClock.End ();
+
+  uint64_t setupEvents = RachBenchmarkSimulatorImpl::s_nEvents;
+  SystemWallClockMs runClock;
+  runClock.Start ();
+  Simulator::Run ();
+  int64_t runMs = runClock.End ();
+  uint64_t runEvents = RachBenchmarkSimulatorImpl::s_nEvents - setupEvents;
+
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+
+  // sum the KPIs of the cells
+  uint64_t preambleTx = 0;
+  uint64_t rarRx = 0;
+  uint64_t msg4Rx = 0;
+  double delaySum = 0;
+  double maxDelay = 0;
+  double binWidth = 0;
+  std::vector<uint64_t> delayBins;
+  uint64_t preambleRx = 0;
+  uint64_t decodeFailures = 0;
+  uint64_t collisions = 0;
+  for (uint32_t i = 0; i < nEnb; ++i)
+    {
+      uint16_t cellId = enbDevs.Get (i)->GetObject<LteEnbNetDevice> ()->GetCellId ();
+      const RaCompleteKpi_t& kpi = lteHelper->GetRaDelayStats ()->GetKpi (cellId);
+      preambleTx += kpi.m_preambleTx;
+      rarRx += kpi.m_rarRx;
+      msg4Rx += kpi.m_msg4Rx;
+      delaySum += kpi.m_accessDelay.GetMean () * kpi.m_accessDelay.GetCount ();
+      maxDelay = std::max (maxDelay, kpi.m_accessDelay.GetMax ());
+      binWidth = kpi.m_accessDelay.GetBinWidth ();
+      delayBins.resize (kpi.m_accessDelay.GetNBins (), 0);
+      for (uint32_t bin = 0; bin < delayBins.size (); ++bin)
+        {
+          delayBins[bin] += kpi.m_accessDelay.GetBinCount (bin);
+        }
+      if (!useIdealPrach)
+        {
+          const RaPreambleKpi_t& preambleKpi = lteHelper->GetRaPreambleStats ()->GetKpi (cellId);
+          preambleRx += preambleKpi.m_preambleRx;
+          decodeFailures += preambleKpi.m_decodeFailures;
+          collisions += preambleKpi.m_collisions;
+        }
+    }
+
+  bool newFile = !std::ifstream (outputFile.c_str ()).good ();
+  std::ofstream out (outputFile.c_str (), std::ios_base::app);
+  if (!out.is_open ())
+    {
+      NS_FATAL_ERROR ("Can't open file " << outputFile);
+    }
+  if (newFile)
+    {
+      out << "% nUe\tnEnb\tprachConfigurationIndex\tnPreambles\tidealRrc\tidealPrach\t"
+          << "accessWindow\tsimTime\trunNumber\tsetupWallTime\trunWallTime\tevents\teventsPerSecond\t"
+          << "peakRssKb\tpreambleTx\trarRx\tmsg4Rx\tmeanAccessDelay\tp95AccessDelay\tp99AccessDelay\t"
+          << "preambleRx\tdecodeFailures\tcollisions" << std::endl;
+    }
+  out << nUe << "\t" << nEnb << "\t" << prachConfigurationIndex << "\t" << nPreambles << "\t"
+      << useIdealRrc << "\t" << useIdealPrach << "\t"
+      << accessWindow << "\t" << simTime << "\t" << runNumber << "\t"
+      << setupMs / 1000.0 << "\t" << runMs / 1000.0 << "\t" << runEvents << "\t"
+      << (runMs > 0 ? runEvents * 1000.0 / runMs : 0) << "\t"
+      << usage.ru_maxrss << "\t"
+      << preambleTx << "\t" << rarRx << "\t" << msg4Rx << "\t"
+      << (msg4Rx > 0 ? delaySum / msg4Rx : 0) << "\t"
+      << GetHistogramPercentile (delayBins, binWidth, maxDelay, 0.95) << "\t"
+      << GetHistogramPercentile (delayBins, binWidth, maxDelay, 0.99) << "\t"
+      << preambleRx << "\t" << decodeFailures << "\t" << collisions << std::endl;
+  out.close ();
+
+  lteHelper = 0;
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,74 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Converts the statistics files written by the LTE stats calculators with
+ *
+ *   --ns3::LteStatsWriter::Format=Binary
+ *
+ * to CSV. Usage:
+ *
+ *   ./waf --run "lte-stats-to-csv --input=DlMacStats.txt --output=DlMacStats.csv"
+ *
+ * The CSV is written to the standard output if no output file is given.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/lte-module.h"
+#include <fstream>
+#include <iostream>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+
+  CommandLine cmd;
+  cmd.AddValue ("input", "BINARY stats file to be converted", input);
+  cmd.AddValue ("output", "CSV file to be written (standard output if empty)", output);
+  cmd.Parse (argc, argv);
+
+  if (input.empty ())
+    {
+      std::cerr << "missing --input" << std::endl;
+      return 1;
+    }
+
+  bool ok;
+  if (output.empty ())
+    {
+      ok = LteStatsReader::ConvertToCsv (input, std::cout);
+    }
+  else
+    {
+      std::ofstream outFile (output.c_str ());
+      if (!outFile.is_open ())
+        {
+          std::cerr << "Can't open file " << output << std::endl;
+          return 1;
+        }
+      ok = LteStatsReader::ConvertToCsv (input, outFile);
+    }
+
+  if (!ok)
+    {
+      std::cerr << input << " is not a BINARY LTE stats file" << std::endl;
+      return 1;
+    }
+  return 0;
+}
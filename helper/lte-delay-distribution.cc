@@ -0,0 +1,259 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-delay-distribution.h"
+#include <ns3/assert.h>
+#include <algorithm>
+
+namespace ns3 {
+
+LteP2Quantile::LteP2Quantile (double p)
+  : m_p (p)
+{
+  NS_ASSERT (p > 0 && p < 1);
+  Reset ();
+}
+
+void
+LteP2Quantile::Reset (void)
+{
+  m_count = 0;
+  for (int i = 0; i < 5; ++i)
+    {
+      m_height[i] = 0;
+      m_position[i] = i + 1;
+    }
+  m_desired[0] = 1;
+  m_desired[1] = 1 + 2 * m_p;
+  m_desired[2] = 1 + 4 * m_p;
+  m_desired[3] = 3 + 2 * m_p;
+  m_desired[4] = 5;
+  m_increment[0] = 0;
+  m_increment[1] = m_p / 2;
+  m_increment[2] = m_p;
+  m_increment[3] = (1 + m_p) / 2;
+  m_increment[4] = 1;
+}
+
+void
+LteP2Quantile::Add (double x)
+{
+  if (m_count < 5)
+    {
+      // the first samples are the initial heights of the markers
+      m_height[m_count++] = x;
+      if (m_count == 5)
+        {
+          std::sort (m_height, m_height + 5);
+        }
+      return;
+    }
+  ++m_count;
+
+  // find the cell of the sample, extending the extreme markers if needed
+  int k;
+  if (x < m_height[0])
+    {
+      m_height[0] = x;
+      k = 0;
+    }
+  else if (x >= m_height[4])
+    {
+      m_height[4] = x;
+      k = 3;
+    }
+  else
+    {
+      k = 0;
+      while (x >= m_height[k + 1])
+        {
+          ++k;
+        }
+    }
+  for (int i = k + 1; i < 5; ++i)
+    {
+      m_position[i] += 1;
+    }
+  for (int i = 0; i < 5; ++i)
+    {
+      m_desired[i] += m_increment[i];
+    }
+
+  // move the middle markers towards their desired positions
+  for (int i = 1; i < 4; ++i)
+    {
+      double delta = m_desired[i] - m_position[i];
+      if ((delta >= 1 && m_position[i + 1] - m_position[i] > 1)
+          || (delta <= -1 && m_position[i - 1] - m_position[i] < -1))
+        {
+          int d = delta > 0 ? 1 : -1;
+          double height = Parabolic (i, d);
+          if (m_height[i - 1] < height && height < m_height[i + 1])
+            {
+              m_height[i] = height;
+            }
+          else
+            {
+              m_height[i] = Linear (i, d);
+            }
+          m_position[i] += d;
+        }
+    }
+}
+
+double
+LteP2Quantile::Parabolic (int i, double d) const
+{
+  return m_height[i] + d / (m_position[i + 1] - m_position[i - 1])
+         * ((m_position[i] - m_position[i - 1] + d) * (m_height[i + 1] - m_height[i]) / (m_position[i + 1] - m_position[i])
+            + (m_position[i + 1] - m_position[i] - d) * (m_height[i] - m_height[i - 1]) / (m_position[i] - m_position[i - 1]));
+}
+
+double
+LteP2Quantile::Linear (int i, int d) const
+{
+  return m_height[i] + d * (m_height[i + d] - m_height[i]) / (m_position[i + d] - m_position[i]);
+}
+
+double
+LteP2Quantile::Get (void) const
+{
+  if (m_count >= 5)
+    {
+      return m_height[2];
+    }
+  if (m_count == 0)
+    {
+      return 0;
+    }
+  // too few samples for the markers: nearest rank among the samples
+  double samples[5];
+  std::copy (m_height, m_height + m_count, samples);
+  std::sort (samples, samples + m_count);
+  return samples[static_cast<uint32_t> (m_p * (m_count - 1) + 0.5)];
+}
+
+
+LteDelayDistribution::LteDelayDistribution (double binWidth, uint32_t nBins)
+  : m_binWidth (binWidth),
+    m_bins (nBins, 0),
+    m_p50 (0.5),
+    m_p95 (0.95),
+    m_p99 (0.99)
+{
+  NS_ASSERT (binWidth > 0 && nBins > 0);
+  Reset ();
+}
+
+void
+LteDelayDistribution::Add (double delay)
+{
+  uint32_t bin = m_bins.size () - 1;
+  if (delay < m_binWidth * bin)
+    {
+      bin = delay > 0 ? static_cast<uint32_t> (delay / m_binWidth) : 0;
+    }
+  ++m_bins[bin];
+  if (m_count == 0 || delay < m_min)
+    {
+      m_min = delay;
+    }
+  if (m_count == 0 || delay > m_max)
+    {
+      m_max = delay;
+    }
+  ++m_count;
+  m_sum += delay;
+  m_p50.Add (delay);
+  m_p95.Add (delay);
+  m_p99.Add (delay);
+}
+
+void
+LteDelayDistribution::Reset (void)
+{
+  std::fill (m_bins.begin (), m_bins.end (), 0);
+  m_count = 0;
+  m_sum = 0;
+  m_min = 0;
+  m_max = 0;
+  m_p50.Reset ();
+  m_p95.Reset ();
+  m_p99.Reset ();
+}
+
+uint64_t
+LteDelayDistribution::GetCount (void) const
+{
+  return m_count;
+}
+
+double
+LteDelayDistribution::GetMean (void) const
+{
+  return m_count > 0 ? m_sum / m_count : 0;
+}
+
+double
+LteDelayDistribution::GetMin (void) const
+{
+  return m_min;
+}
+
+double
+LteDelayDistribution::GetMax (void) const
+{
+  return m_max;
+}
+
+double
+LteDelayDistribution::GetP50 (void) const
+{
+  return m_p50.Get ();
+}
+
+double
+LteDelayDistribution::GetP95 (void) const
+{
+  return m_p95.Get ();
+}
+
+double
+LteDelayDistribution::GetP99 (void) const
+{
+  return m_p99.Get ();
+}
+
+uint32_t
+LteDelayDistribution::GetNBins (void) const
+{
+  return m_bins.size ();
+}
+
+double
+LteDelayDistribution::GetBinWidth (void) const
+{
+  return m_binWidth;
+}
+
+uint64_t
+LteDelayDistribution::GetBinCount (uint32_t i) const
+{
+  NS_ASSERT (i < m_bins.size ());
+  return m_bins[i];
+}
+
+} // namespace ns3
@@ -0,0 +1,166 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_DELAY_DISTRIBUTION_H_
+#define LTE_DELAY_DISTRIBUTION_H_
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * Streaming estimator of a single quantile with the P-square algorithm
+ * (R. Jain and I. Chlamtac, "The P2 algorithm for dynamic calculation of
+ * quantiles and histograms without storing observations", Communications
+ * of the ACM, 1985). Five markers are kept whatever the number of
+ * samples.
+ */
+class LteP2Quantile
+{
+public:
+  /**
+   * \param p the quantile to be estimated, in (0, 1)
+   */
+  LteP2Quantile (double p);
+
+  /**
+   * \param x the new sample
+   */
+  void Add (double x);
+
+  /**
+   * \return the current estimate of the quantile, 0 if there is no sample
+   */
+  double Get (void) const;
+
+  /**
+   * Forget all the samples
+   */
+  void Reset (void);
+
+private:
+  /**
+   * \param i the index of a middle marker
+   * \param d -1 or 1, the direction of the move of the marker
+   * \return the piecewise-parabolic prediction of the height of the marker
+   */
+  double Parabolic (int i, double d) const;
+
+  /**
+   * \param i the index of a middle marker
+   * \param d -1 or 1, the direction of the move of the marker
+   * \return the linear prediction of the height of the marker
+   */
+  double Linear (int i, int d) const;
+
+  double m_p; ///< the quantile to be estimated
+  uint64_t m_count; ///< the number of samples
+  double m_height[5]; ///< the heights of the markers, or the first samples
+  double m_position[5]; ///< the actual positions of the markers
+  double m_desired[5]; ///< the desired positions of the markers
+  double m_increment[5]; ///< the increments of the desired positions per sample
+};
+
+
+/**
+ * \ingroup lte
+ *
+ * Distribution of delays summarized in constant memory: count, mean,
+ * minimum and maximum, a histogram with bins of equal width (the last
+ * bin also counting all the larger delays) and estimates of the 50th,
+ * 95th and 99th percentiles.
+ */
+class LteDelayDistribution
+{
+public:
+  /**
+   * \param binWidth the width of the bins of the histogram, in seconds
+   * \param nBins the number of bins of the histogram
+   */
+  LteDelayDistribution (double binWidth, uint32_t nBins);
+
+  /**
+   * \param delay the new sample, in seconds
+   */
+  void Add (double delay);
+
+  /**
+   * Forget all the samples
+   */
+  void Reset (void);
+
+  /**
+   * \return the number of samples
+   */
+  uint64_t GetCount (void) const;
+
+  /**
+   * \return the mean of the samples, 0 if there is no sample
+   */
+  double GetMean (void) const;
+
+  /**
+   * \return the smallest sample, 0 if there is no sample
+   */
+  double GetMin (void) const;
+
+  /**
+   * \return the largest sample, 0 if there is no sample
+   */
+  double GetMax (void) const;
+
+  /// \return the estimate of the median
+  double GetP50 (void) const;
+  /// \return the estimate of the 95th percentile
+  double GetP95 (void) const;
+  /// \return the estimate of the 99th percentile
+  double GetP99 (void) const;
+
+  /**
+   * \return the number of bins of the histogram
+   */
+  uint32_t GetNBins (void) const;
+
+  /**
+   * \return the width of the bins of the histogram, in seconds
+   */
+  double GetBinWidth (void) const;
+
+  /**
+   * \param i the index of a bin
+   * \return the number of samples in [i * binWidth, (i + 1) * binWidth),
+   *         or larger than i * binWidth for the last bin
+   */
+  uint64_t GetBinCount (uint32_t i) const;
+
+private:
+  double m_binWidth; ///< the width of the bins
+  std::vector<uint64_t> m_bins; ///< the histogram
+  uint64_t m_count; ///< the number of samples
+  double m_sum; ///< the sum of the samples
+  double m_min; ///< the smallest sample
+  double m_max; ///< the largest sample
+  LteP2Quantile m_p50; ///< estimator of the median
+  LteP2Quantile m_p95; ///< estimator of the 95th percentile
+  LteP2Quantile m_p99; ///< estimator of the 99th percentile
+};
+
+} // namespace ns3
+
+#endif /* LTE_DELAY_DISTRIBUTION_H_ */
@@ -64,6 +64,22 @@
 #include <ns3/epc-x2.h>
 #include "ns3/ra-preamble-stats-calculator.h"
 #include "ns3/ra-complete-stats-calculator.h"
+#include <ns3/lte-pdcp.h>
+#include <ns3/lte-traffic-generator.h>
+#include <ns3/lte-radio-bearer-info.h>
+#include <ns3/uinteger.h>
+#include <ns3/node-list.h>
+#include <ns3/core-config.h>
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#endif
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <set>
+#include <sstream>
+#include <unistd.h>
 
 namespace ns3 {
 
@@ -82,6 +98,8 @@ LteHelper::LteHelper (void)
   m_ueNetDeviceFactory.SetTypeId (LteUeNetDevice::GetTypeId ());
   m_ueAntennaModelFactory.SetTypeId (IsotropicAntennaModel::GetTypeId ());
   m_channelFactory.SetTypeId (MultiModelSpectrumChannel::GetTypeId ());
+  m_dlTrafficGeneratorFactory.SetTypeId (LteTrafficGenerator::GetTypeId ());
+  m_ulTrafficGeneratorFactory.SetTypeId (LteTrafficGenerator::GetTypeId ());
 }
 
 void 
@@ -198,6 +216,18 @@ TypeId LteHelper::GetTypeId (void)
                    BooleanValue (true), 
                    MakeBooleanAccessor (&LteHelper::m_useIdealPrach),
                    MakeBooleanChecker ())    
+    .AddAttribute ("UseDlTrafficGenerator",
+                   "If true, an LteTrafficGenerator feeds each data radio bearer "
+                   "of the eNodeB devices installed afterwards, without EPC.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteHelper::m_useDlTrafficGenerator),
+                   MakeBooleanChecker ())
+    .AddAttribute ("UseUlTrafficGenerator",
+                   "If true, an LteTrafficGenerator feeds each data radio bearer "
+                   "of the UE devices installed afterwards, without EPC.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteHelper::m_useUlTrafficGenerator),
+                   MakeBooleanChecker ())
     .AddAttribute ("AnrEnabled",
                    "Activate or deactivate Automatic Neighbour Relation function",
                    BooleanValue (true),
@@ -209,6 +239,18 @@ TypeId LteHelper::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&LteHelper::m_usePdschForCqiGeneration),
                    MakeBooleanChecker ())
+    .AddAttribute ("BulkAttachThreads",
+                   "Number of threads used by BulkAttach to look up the closest eNBs "
+                   "of the UEs. If zero, one thread per online processor is used.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&LteHelper::m_bulkAttachThreads),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("BulkAttachCandidates",
+                   "Number of closest eNBs whose received power is evaluated by "
+                   "BulkAttach when selecting the strongest eNB of a UE.",
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&LteHelper::m_bulkAttachCandidates),
+                   MakeUintegerChecker<uint32_t> (1))
   ;
   return tid;
 }
@@ -219,6 +261,39 @@ LteHelper::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_downlinkChannel = 0;
   m_uplinkChannel = 0;
+  // write the pending statistics and close their files
+  if (m_phyStats != 0)
+    {
+      m_phyStats->Dispose ();
+    }
+  if (m_phyTxStats != 0)
+    {
+      m_phyTxStats->Dispose ();
+    }
+  if (m_phyRxStats != 0)
+    {
+      m_phyRxStats->Dispose ();
+    }
+  if (m_macStats != 0)
+    {
+      m_macStats->Dispose ();
+    }
+  if (m_rlcStats != 0)
+    {
+      m_rlcStats->Dispose ();
+    }
+  if (m_pdcpStats != 0)
+    {
+      m_pdcpStats->Dispose ();
+    }
+  if (m_raPreambleStats != 0)
+    {
+      m_raPreambleStats->Dispose ();
+    }
+  if (m_raDelayStats != 0)
+    {
+      m_raDelayStats->Dispose ();
+    }
   Object::DoDispose ();
 }
 
@@ -272,6 +347,20 @@ LteHelper::SetFfrAlgorithmAttribute (std::string n, const AttributeValue &v)
   m_ffrAlgorithmFactory.Set (n, v);
 }
 
+void
+LteHelper::SetDlTrafficGeneratorAttribute (std::string n, const AttributeValue &v)
+{
+  NS_LOG_FUNCTION (this << n);
+  m_dlTrafficGeneratorFactory.Set (n, v);
+}
+
+void
+LteHelper::SetUlTrafficGeneratorAttribute (std::string n, const AttributeValue &v)
+{
+  NS_LOG_FUNCTION (this << n);
+  m_ulTrafficGeneratorFactory.Set (n, v);
+}
+
 std::string
 LteHelper::GetHandoverAlgorithmType () const
 {
@@ -373,6 +462,13 @@ LteHelper::SetFadingModelAttribute (std::string n, const AttributeValue &v)
   m_fadingModelFactory.Set (n, v);
 }
 
+void
+LteHelper::SetTraceSampler (const LteTraceSampler& sampler)
+{
+  NS_LOG_FUNCTION (this);
+  m_traceSampler = sampler;
+}
+
 void 
 LteHelper::SetSpectrumChannelType (std::string type) 
 {
@@ -492,16 +588,21 @@ LteHelper::InstallSingleEnbDevice (Ptr<Node> n)
       mac->SetPrachMode(!m_useIdealPrach);
     }
 
-  if (m_epcHelper != 0)
+  if (m_epcHelper != 0 || m_useDlTrafficGenerator || m_useUlTrafficGenerator)
     {
       EnumValue epsBearerToRlcMapping;
       rrc->GetAttribute ("EpsBearerToRlcMapping", epsBearerToRlcMapping);
-      // it does not make sense to use RLC/SM when also using the EPC
+      // it does not make sense to use RLC/SM when also using the EPC or the
+      // traffic generators, which need the PDCP
       if (epsBearerToRlcMapping.Get () == LteEnbRrc::RLC_SM_ALWAYS)
         {
           rrc->SetAttribute ("EpsBearerToRlcMapping", EnumValue (LteEnbRrc::RLC_UM_ALWAYS));
         }
     }
+  if (m_useDlTrafficGenerator)
+    {
+      rrc->SetTrafficGeneratorFactory (m_dlTrafficGeneratorFactory);
+    }
 
   rrc->SetLteEnbCmacSapProvider (mac->GetLteEnbCmacSapProvider ());
   mac->SetLteEnbCmacSapUser (rrc->GetLteEnbCmacSapUser ());
@@ -552,8 +653,12 @@ LteHelper::InstallSingleEnbDevice (Ptr<Node> n)
   dlPhy->SetDevice (dev);
   ulPhy->SetDevice (dev);
 
+  phy->SetTraceSampler (m_traceSampler);
+  ulPhy->SetTraceSampler (m_traceSampler);
+  mac->SetTraceSampler (m_traceSampler, cellId);
+
   n->AddDevice (dev);
-  ulPhy->SetLtePhyRxDataEndOkCallback (MakeCallback (&LteEnbPhy::PhyPduReceived, phy));
+  ulPhy->SetLtePhyRxDataEndOkListCallback (MakeCallback (&LteEnbPhy::PhyPdusReceived, phy));
   ulPhy->SetLtePhyRxCtrlEndOkCallback (MakeCallback (&LteEnbPhy::ReceiveLteControlMessageList, phy));
   ulPhy->SetLtePhyUlHarqFeedbackCallback (MakeCallback (&LteEnbPhy::ReceiveLteUlHarqFeedback, phy));
   ulPhy->SetLtePhyRxPrachEndOkCallback (MakeCallback (&LteEnbPhy::ReceiveLteControlMessageList, phy));
@@ -681,10 +786,14 @@ LteHelper::InstallSingleUeDevice (Ptr<Node> n)
       phy->SetPrachMode(!m_useIdealPrach);
     }
 
-  if (m_epcHelper != 0)
+  if (m_epcHelper != 0 || m_useDlTrafficGenerator || m_useUlTrafficGenerator)
     {
       rrc->SetUseRlcSm (false);
     }
+  if (m_useUlTrafficGenerator)
+    {
+      rrc->SetTrafficGeneratorFactory (m_ulTrafficGeneratorFactory);
+    }
   Ptr<EpcUeNas> nas = CreateObject<EpcUeNas> ();
  
   nas->SetAsSapProvider (rrc->GetAsSapProvider ());
@@ -716,6 +825,9 @@ LteHelper::InstallSingleUeDevice (Ptr<Node> n)
   ulPhy->SetDevice (dev);
   nas->SetDevice (dev);
 
+  phy->SetTraceSampler (m_traceSampler);
+  dlPhy->SetTraceSampler (m_traceSampler);
+
   n->AddDevice (dev);
   dlPhy->SetLtePhyRxDataEndOkCallback (MakeCallback (&LteUePhy::PhyPduReceived, phy));
   dlPhy->SetLtePhyRxCtrlEndOkCallback (MakeCallback (&LteUePhy::ReceiveLteControlMessageList, phy));
@@ -850,10 +962,7 @@ void
 LteHelper::AttachToClosestEnb (NetDeviceContainer ueDevices, NetDeviceContainer enbDevices)
 {
   NS_LOG_FUNCTION (this);
-  for (NetDeviceContainer::Iterator i = ueDevices.Begin (); i != ueDevices.End (); ++i)
-    {
-      AttachToClosestEnb (*i, enbDevices);
-    }
+  BulkAttach (ueDevices, enbDevices, CLOSEST_ENB);
 }
 
 void
@@ -878,6 +987,629 @@ LteHelper::AttachToClosestEnb (Ptr<NetDevice> ueDevice, NetDeviceContainer enbDe
   Attach (ueDevice, closestEnbDevice);
 }
 
+/**
+ * Uniform grid over the horizontal position of a set of eNBs, used to
+ * find the closest eNBs of a point by visiting the grid cells in rings
+ * of increasing size around it. Once built it is only read, hence it
+ * can be shared by several threads.
+ */
+class EnbGridIndex
+{
+public:
+  /**
+   * \param positions the eNB positions, indexed as in the eNB container
+   */
+  EnbGridIndex (const std::vector<Vector>& positions);
+
+  /**
+   * Find the k closest eNBs of a position, in increasing distance and
+   * increasing index for equal distance, i.e., the first one is the
+   * eNB a linear scan with a strict comparison would select.
+   *
+   * \param pos the position
+   * \param k the number of eNBs to look for
+   * \param result filled with the indices of the eNBs found (at most k)
+   */
+  void FindClosest (const Vector& pos, uint32_t k, std::vector<uint32_t>& result) const;
+
+private:
+  /// \return the cell index of a coordinate along an axis, clamped to the grid
+  int32_t GetCell (double v, double min, int32_t n) const;
+
+  const std::vector<Vector>& m_positions; ///< eNB positions
+  double m_minX;     ///< lower bound of the grid along x
+  double m_minY;     ///< lower bound of the grid along y
+  double m_cellSize; ///< side of a grid cell
+  int32_t m_nx;      ///< number of cells along x
+  int32_t m_ny;      ///< number of cells along y
+  std::vector<std::vector<uint32_t> > m_cells; ///< eNB indices of each cell, row-major
+};
+
+EnbGridIndex::EnbGridIndex (const std::vector<Vector>& positions)
+  : m_positions (positions),
+    m_minX (0),
+    m_minY (0),
+    m_cellSize (1),
+    m_nx (1),
+    m_ny (1)
+{
+  NS_ASSERT (!positions.empty ());
+  double maxX = positions[0].x;
+  double maxY = positions[0].y;
+  m_minX = positions[0].x;
+  m_minY = positions[0].y;
+  for (uint32_t i = 1; i < positions.size (); ++i)
+    {
+      m_minX = std::min (m_minX, positions[i].x);
+      m_minY = std::min (m_minY, positions[i].y);
+      maxX = std::max (maxX, positions[i].x);
+      maxY = std::max (maxY, positions[i].y);
+    }
+  double width = maxX - m_minX;
+  double height = maxY - m_minY;
+
+  // about two eNBs per cell; the cells are never smaller than for eNBs
+  // along a line, which bounds their number by about n when the eNBs
+  // are nearly aligned (e.g. a height of 1e-12 from rounding errors)
+  double n = positions.size ();
+  if (width > 0 || height > 0)
+    {
+      m_cellSize = std::max (std::sqrt (2 * width * height / n),
+                             2 * std::max (width, height) / n);
+    }
+  m_nx = (int32_t) std::floor (width / m_cellSize) + 1;
+  m_ny = (int32_t) std::floor (height / m_cellSize) + 1;
+
+  m_cells.resize (m_nx * m_ny);
+  for (uint32_t i = 0; i < positions.size (); ++i)
+    {
+      int32_t cx = GetCell (positions[i].x, m_minX, m_nx);
+      int32_t cy = GetCell (positions[i].y, m_minY, m_ny);
+      m_cells[cy * m_nx + cx].push_back (i);
+    }
+}
+
+int32_t
+EnbGridIndex::GetCell (double v, double min, int32_t n) const
+{
+  double c = std::floor ((v - min) / m_cellSize);
+  if (c < 0)
+    {
+      return 0;
+    }
+  if (c >= n)
+    {
+      return n - 1;
+    }
+  return (int32_t) c;
+}
+
+void
+EnbGridIndex::FindClosest (const Vector& pos, uint32_t k, std::vector<uint32_t>& result) const
+{
+  // (distance, index) of the best eNBs found so far, in increasing order
+  std::vector<std::pair<double, uint32_t> > best;
+  int32_t cx = GetCell (pos.x, m_minX, m_nx);
+  int32_t cy = GetCell (pos.y, m_minY, m_ny);
+  int32_t maxRing = std::max (m_nx, m_ny);
+  for (int32_t r = 0; r <= maxRing; ++r)
+    {
+      // the eNBs in ring r are at least (r - 1) cells away; the margin
+      // covers rounding in the cell computation
+      if (best.size () == k && (r - 1) * m_cellSize - 1e-6 > best.back ().first)
+        {
+          break;
+        }
+      for (int32_t y = std::max (cy - r, 0); y <= std::min (cy + r, m_ny - 1); ++y)
+        {
+          bool edgeRow = (y == cy - r) || (y == cy + r);
+          int32_t step = edgeRow ? 1 : 2 * r;
+          for (int32_t x = cx - r; x <= cx + r; x += step)
+            {
+              if (x < 0 || x >= m_nx)
+                {
+                  continue;
+                }
+              const std::vector<uint32_t>& cell = m_cells[y * m_nx + x];
+              for (std::vector<uint32_t>::const_iterator it = cell.begin (); it != cell.end (); ++it)
+                {
+                  std::pair<double, uint32_t> candidate (CalculateDistance (pos, m_positions[*it]), *it);
+                  if (best.size () < k || candidate < best.back ())
+                    {
+                      best.insert (std::upper_bound (best.begin (), best.end (), candidate), candidate);
+                      if (best.size () > k)
+                        {
+                          best.pop_back ();
+                        }
+                    }
+                }
+            }
+        }
+    }
+  result.clear ();
+  for (uint32_t i = 0; i < best.size (); ++i)
+    {
+      result.push_back (best[i].second);
+    }
+}
+
+/**
+ * Look up of the closest eNBs of a contiguous range of UEs, run by one
+ * thread of LteHelper::BulkAttach.
+ */
+struct BulkAttachWorker
+{
+  const EnbGridIndex* index;                ///< the eNB index
+  const std::vector<Vector>* uePositions;   ///< positions of all the UEs
+  uint32_t k;                               ///< number of eNBs per UE
+  uint32_t begin;                           ///< first UE of the range
+  uint32_t end;                             ///< one past the last UE of the range
+  std::vector<std::vector<uint32_t> >* closest; ///< closest eNBs of each UE
+
+  /// look up the UEs of the range
+  void Run ()
+  {
+    for (uint32_t i = begin; i < end; ++i)
+      {
+        index->FindClosest ((*uePositions)[i], k, (*closest)[i]);
+      }
+  }
+};
+
+void
+LteHelper::BulkAttach (NetDeviceContainer ueDevices, NetDeviceContainer enbDevices,
+                       EnbSelectionCriterion criterion)
+{
+  NS_LOG_FUNCTION (this << ueDevices.GetN () << enbDevices.GetN () << criterion);
+  NS_ASSERT_MSG (enbDevices.GetN () > 0, "empty enb device container");
+
+  Ptr<PropagationLossModel> pathlossModel;
+  if (criterion == STRONGEST_ENB)
+    {
+      NS_ASSERT_MSG (m_downlinkPathlossModel != 0, "the LteHelper has not been initialized yet");
+      pathlossModel = m_downlinkPathlossModel->GetObject<PropagationLossModel> ();
+      if (pathlossModel == 0)
+        {
+          NS_LOG_WARN ("the downlink pathloss model is not a PropagationLossModel, attaching to the closest eNB");
+          criterion = CLOSEST_ENB;
+        }
+    }
+
+  // mobility models are not thread safe, read all the positions first
+  uint32_t nUes = ueDevices.GetN ();
+  std::vector<Vector> uePositions (nUes);
+  for (uint32_t i = 0; i < nUes; ++i)
+    {
+      uePositions[i] = ueDevices.Get (i)->GetNode ()->GetObject<MobilityModel> ()->GetPosition ();
+    }
+  std::vector<Ptr<MobilityModel> > enbMobility (enbDevices.GetN ());
+  std::vector<Vector> enbPositions (enbDevices.GetN ());
+  for (uint32_t j = 0; j < enbDevices.GetN (); ++j)
+    {
+      enbMobility[j] = enbDevices.Get (j)->GetNode ()->GetObject<MobilityModel> ();
+      enbPositions[j] = enbMobility[j]->GetPosition ();
+    }
+
+  EnbGridIndex index (enbPositions);
+  uint32_t k = (criterion == STRONGEST_ENB) ? m_bulkAttachCandidates : 1;
+  std::vector<std::vector<uint32_t> > closest (nUes);
+
+  // split the UEs in ranges of at least a thousand UEs each
+  uint32_t nThreads = m_bulkAttachThreads;
+  if (nThreads == 0)
+    {
+      long nProcessors = sysconf (_SC_NPROCESSORS_ONLN);
+      nThreads = (nProcessors > 0) ? nProcessors : 1;
+    }
+  nThreads = std::max (1u, std::min (nThreads, (nUes + 999) / 1000));
+  std::vector<BulkAttachWorker> workers (nThreads);
+  for (uint32_t t = 0; t < nThreads; ++t)
+    {
+      workers[t].index = &index;
+      workers[t].uePositions = &uePositions;
+      workers[t].k = k;
+      workers[t].begin = (uint64_t) nUes * t / nThreads;
+      workers[t].end = (uint64_t) nUes * (t + 1) / nThreads;
+      workers[t].closest = &closest;
+    }
+#ifdef HAVE_PTHREAD_H
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t t = 1; t < nThreads; ++t)
+    {
+      threads.push_back (Create<SystemThread> (MakeCallback (&BulkAttachWorker::Run, &workers[t])));
+      threads.back ()->Start ();
+    }
+  workers[0].Run ();
+  for (uint32_t t = 0; t < threads.size (); ++t)
+    {
+      threads[t]->Join ();
+    }
+#else
+  for (uint32_t t = 0; t < nThreads; ++t)
+    {
+      workers[t].Run ();
+    }
+#endif
+
+  // attach serially, in the order of the UE container
+  for (uint32_t i = 0; i < nUes; ++i)
+    {
+      NS_ASSERT (!closest[i].empty ());
+      uint32_t selected = closest[i][0];
+      if (criterion == STRONGEST_ENB)
+        {
+          Ptr<MobilityModel> ueMobility = ueDevices.Get (i)->GetNode ()->GetObject<MobilityModel> ();
+          double maxRxPower = -std::numeric_limits<double>::infinity ();
+          for (std::vector<uint32_t>::const_iterator it = closest[i].begin (); it != closest[i].end (); ++it)
+            {
+              double txPower = enbDevices.Get (*it)->GetObject<LteEnbNetDevice> ()->GetPhy ()->GetTxPower ();
+              double rxPower = pathlossModel->CalcRxPower (txPower, enbMobility[*it], ueMobility);
+              if (rxPower > maxRxPower)
+                {
+                  maxRxPower = rxPower;
+                  selected = *it;
+                }
+            }
+        }
+      Attach (ueDevices.Get (i), enbDevices.Get (selected));
+    }
+}
+
+/**
+ * Order UEs by the first TEID of their bearers, i.e., by the order in
+ * which the SGW created their sessions during the original attach.
+ */
+static bool
+CompareUeSnapshotByTeid (const std::pair<uint32_t, std::string>& a,
+                         const std::pair<uint32_t, std::string>& b)
+{
+  return a.first < b.first;
+}
+
+void
+LteHelper::SaveConnectedState (std::string fileName, NetDeviceContainer ueDevices, NetDeviceContainer enbDevices)
+{
+  NS_LOG_FUNCTION (this << fileName);
+
+  std::map<uint16_t, Ptr<LteEnbNetDevice> > enbByCellId;
+  for (NetDeviceContainer::Iterator i = enbDevices.Begin (); i != enbDevices.End (); ++i)
+    {
+      Ptr<LteEnbNetDevice> enbLteDevice = (*i)->GetObject<LteEnbNetDevice> ();
+      NS_ASSERT_MSG (enbLteDevice != 0, "The passed NetDevice must be an LteEnbNetDevice");
+      enbByCellId[enbLteDevice->GetCellId ()] = enbLteDevice;
+    }
+
+  std::vector<std::pair<uint32_t, std::string> > entries;
+  for (NetDeviceContainer::Iterator i = ueDevices.Begin (); i != ueDevices.End (); ++i)
+    {
+      Ptr<LteUeNetDevice> ueLteDevice = (*i)->GetObject<LteUeNetDevice> ();
+      NS_ASSERT_MSG (ueLteDevice != 0, "The passed NetDevice must be an LteUeNetDevice");
+      Ptr<LteUeRrc> ueRrc = ueLteDevice->GetRrc ();
+      uint64_t imsi = ueLteDevice->GetImsi ();
+      if (ueRrc->GetState () != LteUeRrc::CONNECTED_NORMALLY)
+        {
+          NS_LOG_WARN ("IMSI " << imsi << " not in CONNECTED_NORMALLY, not saved");
+          continue;
+        }
+      uint16_t cellId = ueRrc->GetCellId ();
+      uint16_t rnti = ueRrc->GetRnti ();
+      std::map<uint16_t, Ptr<LteEnbNetDevice> >::iterator enbIt = enbByCellId.find (cellId);
+      NS_ABORT_MSG_IF (enbIt == enbByCellId.end (), "serving cell " << cellId << " of IMSI " << imsi << " not in the eNB container");
+      Ptr<LteEnbRrc> enbRrc = enbIt->second->GetRrc ();
+      if (!enbRrc->HasUeManager (rnti)
+          || enbRrc->GetUeManager (rnti)->GetState () != UeManager::CONNECTED_NORMALLY)
+        {
+          NS_LOG_WARN ("IMSI " << imsi << " not in CONNECTED_NORMALLY at the eNB, not saved");
+          continue;
+        }
+
+      Ptr<UeManager> ueManager = enbRrc->GetUeManager (rnti);
+      std::map<uint8_t, Ptr<LteDataRadioBearerInfo> > enbDrbs = ueManager->GetRadioBearers ();
+      std::map<uint8_t, Ptr<LteDataRadioBearerInfo> > ueDrbs = ueRrc->GetDataRadioBearers ();
+
+      // the bearers are activated again in the order of their
+      // identities, which the MME allocates from 1
+      std::set<uint8_t> epsBearerIds;
+      for (std::map<uint8_t, Ptr<LteDataRadioBearerInfo> >::iterator it = enbDrbs.begin ();
+           it != enbDrbs.end ();
+           ++it)
+        {
+          epsBearerIds.insert (it->second->m_epsBearerIdentity);
+        }
+      NS_ABORT_MSG_IF (!epsBearerIds.empty ()
+                       && (*epsBearerIds.begin () != 1 || (uint32_t) *epsBearerIds.rbegin () != epsBearerIds.size ()),
+                       "the EPS bearer identities of IMSI " << imsi << " are not 1 to " << epsBearerIds.size ()
+                       << ", was a bearer deactivated? Such a state cannot be restored");
+
+      Ptr<EpcUeNas> ueNas = ueLteDevice->GetNas ();
+      std::ostringstream oss;
+      oss << "ue " << imsi << " " << cellId << " " << rnti << " " << ueManager->GetSrsConfigurationIndex ()
+          << " " << enbDrbs.size () << "\n";
+      uint32_t firstTeid = 0xFFFFFFFF;
+      for (std::map<uint8_t, Ptr<LteDataRadioBearerInfo> >::iterator it = enbDrbs.begin ();
+           it != enbDrbs.end ();
+           ++it)
+        {
+          LtePdcp::Status enbStatus = {0, 0};
+          LtePdcp::Status ueStatus = {0, 0};
+          if (it->second->m_pdcp != 0)
+            {
+              enbStatus = it->second->m_pdcp->GetStatus ();
+            }
+          std::map<uint8_t, Ptr<LteDataRadioBearerInfo> >::iterator ueIt = ueDrbs.find (it->first);
+          if (ueIt != ueDrbs.end () && ueIt->second->m_pdcp != 0)
+            {
+              ueStatus = ueIt->second->m_pdcp->GetStatus ();
+            }
+          firstTeid = std::min (firstTeid, it->second->m_gtpTeid);
+          const EpsBearer& bearer = it->second->m_epsBearer;
+          oss << "drb " << (uint32_t) it->first << " " << it->second->m_gtpTeid
+              << " " << enbStatus.txSn << " " << enbStatus.rxSn
+              << " " << ueStatus.txSn << " " << ueStatus.rxSn
+              << " " << (uint32_t) it->second->m_epsBearerIdentity << " " << (uint32_t) bearer.qci
+              << " " << bearer.gbrQosInfo.gbrDl << " " << bearer.gbrQosInfo.gbrUl
+              << " " << bearer.gbrQosInfo.mbrDl << " " << bearer.gbrQosInfo.mbrUl << "\n";
+
+          Ptr<EpcTft> tft = ueNas->GetTft (it->second->m_epsBearerIdentity);
+          NS_ABORT_MSG_IF (tft == 0, "no TFT for EPS bearer " << (uint32_t) it->second->m_epsBearerIdentity
+                           << " of IMSI " << imsi);
+          std::list<EpcTft::PacketFilter> filters = tft->GetPacketFilters ();
+          for (std::list<EpcTft::PacketFilter>::iterator fIt = filters.begin (); fIt != filters.end (); ++fIt)
+            {
+              oss << "filter " << (uint32_t) fIt->direction << " " << (uint32_t) fIt->precedence
+                  << " " << fIt->remoteAddress << " " << fIt->remoteMask
+                  << " " << fIt->localAddress << " " << fIt->localMask
+                  << " " << fIt->remotePortStart << " " << fIt->remotePortEnd
+                  << " " << fIt->localPortStart << " " << fIt->localPortEnd
+                  << " " << (uint32_t) fIt->typeOfService << " " << (uint32_t) fIt->typeOfServiceMask << "\n";
+            }
+        }
+      entries.push_back (std::make_pair (firstTeid, oss.str ()));
+    }
+
+  // restoring the UEs in the same order reproduces the TEID allocation
+  std::stable_sort (entries.begin (), entries.end (), CompareUeSnapshotByTeid);
+
+  std::ofstream outFile (fileName.c_str ());
+  if (!outFile.is_open ())
+    {
+      NS_LOG_ERROR ("Can't open file " << fileName.c_str ());
+      return;
+    }
+  outFile << "% LTE connected state at " << Simulator::Now ().GetSeconds () << " s\n";
+  outFile << "% cell cellId lastAllocatedRnti\n";
+  outFile << "% ue IMSI cellId RNTI srsConfigIndex nDrbs\n";
+  outFile << "% drb DRBID TEID enbPdcpTxSn enbPdcpRxSn uePdcpTxSn uePdcpRxSn EPSBID QCI gbrDl gbrUl mbrDl mbrUl\n";
+  outFile << "% filter direction precedence remoteAddress remoteMask localAddress localMask"
+          << " remotePortStart remotePortEnd localPortStart localPortEnd tos tosMask\n";
+  for (std::map<uint16_t, Ptr<LteEnbNetDevice> >::iterator it = enbByCellId.begin ();
+       it != enbByCellId.end ();
+       ++it)
+    {
+      outFile << "cell " << it->first << " " << it->second->GetRrc ()->GetLastAllocatedRnti () << "\n";
+    }
+  for (std::vector<std::pair<uint32_t, std::string> >::iterator it = entries.begin ();
+       it != entries.end ();
+       ++it)
+    {
+      outFile << it->second;
+    }
+  outFile.close ();
+}
+
+void
+LteHelper::RestoreConnectedState (std::string fileName, NetDeviceContainer ueDevices, NetDeviceContainer enbDevices)
+{
+  NS_LOG_FUNCTION (this << fileName);
+
+  if (m_epcHelper == 0)
+    {
+      NS_FATAL_ERROR ("This function is not valid without properly configured EPC");
+    }
+
+  std::map<uint16_t, Ptr<NetDevice> > enbByCellId;
+  for (NetDeviceContainer::Iterator i = enbDevices.Begin (); i != enbDevices.End (); ++i)
+    {
+      Ptr<LteEnbNetDevice> enbLteDevice = (*i)->GetObject<LteEnbNetDevice> ();
+      NS_ASSERT_MSG (enbLteDevice != 0, "The passed NetDevice must be an LteEnbNetDevice");
+      enbByCellId[enbLteDevice->GetCellId ()] = *i;
+    }
+  std::map<uint64_t, Ptr<NetDevice> > ueByImsi;
+  for (NetDeviceContainer::Iterator i = ueDevices.Begin (); i != ueDevices.End (); ++i)
+    {
+      Ptr<LteUeNetDevice> ueLteDevice = (*i)->GetObject<LteUeNetDevice> ();
+      NS_ASSERT_MSG (ueLteDevice != 0, "The passed NetDevice must be an LteUeNetDevice");
+      ueByImsi[ueLteDevice->GetImsi ()] = *i;
+    }
+
+  std::ifstream inFile (fileName.c_str ());
+  NS_ABORT_MSG_IF (!inFile.is_open (), "Can't open file " << fileName);
+
+  std::vector<UeSnapshot> ues;
+  std::map<uint16_t, uint16_t> lastRntiByCellId;
+  std::string line;
+  while (std::getline (inFile, line))
+    {
+      std::istringstream iss (line);
+      std::string kind;
+      if (!(iss >> kind) || kind[0] == '%')
+        {
+          continue;
+        }
+      if (kind == "cell")
+        {
+          uint16_t cellId;
+          uint16_t lastRnti;
+          iss >> cellId >> lastRnti;
+          NS_ABORT_MSG_IF (iss.fail (), "malformed line in " << fileName << ": " << line);
+          lastRntiByCellId[cellId] = lastRnti;
+        }
+      else if (kind == "ue")
+        {
+          UeSnapshot ue;
+          uint32_t nDrbs;
+          iss >> ue.imsi >> ue.cellId >> ue.rnti >> ue.srsConfigIndex >> nDrbs;
+          NS_ABORT_MSG_IF (iss.fail (), "malformed line in " << fileName << ": " << line);
+          ues.push_back (ue);
+        }
+      else if (kind == "drb")
+        {
+          NS_ABORT_MSG_IF (ues.empty (), "drb line before any ue line in " << fileName);
+          DrbSnapshot drb;
+          uint32_t drbid;
+          uint32_t epsBearerId;
+          uint32_t qci;
+          iss >> drbid >> drb.teid >> drb.enbTxSn >> drb.enbRxSn >> drb.ueTxSn >> drb.ueRxSn
+              >> epsBearerId >> qci
+              >> drb.bearer.gbrQosInfo.gbrDl >> drb.bearer.gbrQosInfo.gbrUl
+              >> drb.bearer.gbrQosInfo.mbrDl >> drb.bearer.gbrQosInfo.mbrUl;
+          NS_ABORT_MSG_IF (iss.fail (), "malformed line in " << fileName << ": " << line);
+          drb.drbid = drbid;
+          drb.epsBearerId = epsBearerId;
+          drb.bearer.qci = (EpsBearer::Qci) qci;
+          ues.back ().drbs.push_back (drb);
+        }
+      else if (kind == "filter")
+        {
+          NS_ABORT_MSG_IF (ues.empty () || ues.back ().drbs.empty (), "filter line before any drb line in " << fileName);
+          EpcTft::PacketFilter f;
+          uint32_t direction;
+          uint32_t precedence;
+          std::string remoteAddress;
+          std::string remoteMask;
+          std::string localAddress;
+          std::string localMask;
+          uint32_t tos;
+          uint32_t tosMask;
+          iss >> direction >> precedence >> remoteAddress >> remoteMask >> localAddress >> localMask
+              >> f.remotePortStart >> f.remotePortEnd >> f.localPortStart >> f.localPortEnd
+              >> tos >> tosMask;
+          NS_ABORT_MSG_IF (iss.fail (), "malformed line in " << fileName << ": " << line);
+          f.direction = (EpcTft::Direction) direction;
+          f.precedence = precedence;
+          f.remoteAddress = Ipv4Address (remoteAddress.c_str ());
+          f.remoteMask = Ipv4Mask (remoteMask.c_str ());
+          f.localAddress = Ipv4Address (localAddress.c_str ());
+          f.localMask = Ipv4Mask (localMask.c_str ());
+          f.typeOfService = tos;
+          f.typeOfServiceMask = tosMask;
+          ues.back ().drbs.back ().filters.push_back (f);
+        }
+      else
+        {
+          NS_FATAL_ERROR ("unknown record \"" << kind << "\" in " << fileName);
+        }
+    }
+
+  for (std::vector<UeSnapshot>::iterator it = ues.begin (); it != ues.end (); ++it)
+    {
+      std::map<uint64_t, Ptr<NetDevice> >::iterator ueIt = ueByImsi.find (it->imsi);
+      NS_ABORT_MSG_IF (ueIt == ueByImsi.end (), "IMSI " << it->imsi << " of the snapshot not in the UE container");
+      std::map<uint16_t, Ptr<NetDevice> >::iterator enbIt = enbByCellId.find (it->cellId);
+      NS_ABORT_MSG_IF (enbIt == enbByCellId.end (), "cell " << it->cellId << " of the snapshot not in the eNB container");
+
+      // activate the default and dedicated EPS bearers in the order in
+      // which the MME allocated their identities
+      Ptr<NetDevice> ueDevice = ueIt->second;
+      std::stable_sort (it->drbs.begin (), it->drbs.end ());
+      for (uint32_t b = 0; b < it->drbs.size (); ++b)
+        {
+          const DrbSnapshot& drb = it->drbs[b];
+          NS_ABORT_MSG_IF (drb.epsBearerId != b + 1,
+                           "EPS bearer " << (uint32_t) drb.epsBearerId << " of IMSI " << it->imsi
+                           << " cannot be restored: the bearer identities are not allocated from 1 without gaps");
+          NS_ABORT_MSG_IF (drb.filters.empty (), "EPS bearer " << (uint32_t) drb.epsBearerId
+                           << " of IMSI " << it->imsi << " without packet filters in " << fileName);
+          Ptr<EpcTft> tft = Create<EpcTft> ();
+          for (std::vector<EpcTft::PacketFilter>::const_iterator fIt = drb.filters.begin ();
+               fIt != drb.filters.end ();
+               ++fIt)
+            {
+              tft->Add (*fIt);
+            }
+          uint8_t bearerId = m_epcHelper->ActivateEpsBearer (ueDevice, it->imsi, tft, drb.bearer);
+          NS_ABORT_MSG_IF (bearerId != drb.epsBearerId,
+                           "EPS bearer " << (uint32_t) drb.epsBearerId << " of IMSI " << it->imsi
+                           << " restored with identity " << (uint32_t) bearerId
+                           << ", were bearers activated before RestoreConnectedState?");
+        }
+
+      // the devices are initialized at the beginning of the simulation,
+      // the UEs are restored right after in the order of the snapshot
+      Simulator::ScheduleNow (&LteHelper::DoRestoreConnectedUe, this, ueDevice, enbIt->second, *it);
+    }
+
+  // the RNTI allocation resumes where it was, once the UEs are restored
+  for (std::map<uint16_t, uint16_t>::iterator it = lastRntiByCellId.begin (); it != lastRntiByCellId.end (); ++it)
+    {
+      std::map<uint16_t, Ptr<NetDevice> >::iterator enbIt = enbByCellId.find (it->first);
+      NS_ABORT_MSG_IF (enbIt == enbByCellId.end (), "cell " << it->first << " of the snapshot not in the eNB container");
+      Ptr<LteEnbRrc> enbRrc = enbIt->second->GetObject<LteEnbNetDevice> ()->GetRrc ();
+      Simulator::ScheduleNow (&LteEnbRrc::RestoreLastAllocatedRnti, enbRrc, it->second);
+    }
+}
+
+void
+LteHelper::DoRestoreConnectedUe (Ptr<NetDevice> ueDevice, Ptr<NetDevice> enbDevice, UeSnapshot ue)
+{
+  NS_LOG_FUNCTION (this << ue.imsi << ue.cellId << ue.rnti);
+
+  Ptr<LteUeNetDevice> ueLteDevice = ueDevice->GetObject<LteUeNetDevice> ();
+  Ptr<LteEnbNetDevice> enbLteDevice = enbDevice->GetObject<LteEnbNetDevice> ();
+  Ptr<LteEnbRrc> enbRrc = enbLteDevice->GetRrc ();
+  Ptr<LteUeRrc> ueRrc = ueLteDevice->GetRrc ();
+
+  LteRrcSap::RrcConnectionReconfiguration msg = enbRrc->RestoreUe (ue.rnti, ue.imsi, ue.srsConfigIndex);
+  ueRrc->RestoreConnection (enbLteDevice->GetCellId (), enbLteDevice->GetDlEarfcn (), ue.rnti,
+                            enbRrc->GetMasterInformationBlock (),
+                            enbRrc->GetSystemInformationBlockType1 (),
+                            enbRrc->BuildSystemInformation (),
+                            msg);
+
+  Ptr<LteUeRrcProtocolIdeal> idealProtocol = ueRrc->GetObject<LteUeRrcProtocolIdeal> ();
+  if (idealProtocol != 0)
+    {
+      idealProtocol->NotifyConnectionRestored ();
+    }
+  Ptr<LteUeRrcProtocolReal> realProtocol = ueRrc->GetObject<LteUeRrcProtocolReal> ();
+  if (realProtocol != 0)
+    {
+      realProtocol->NotifyConnectionRestored ();
+    }
+
+  std::map<uint8_t, Ptr<LteDataRadioBearerInfo> > enbDrbs = enbRrc->GetUeManager (ue.rnti)->GetRadioBearers ();
+  std::map<uint8_t, Ptr<LteDataRadioBearerInfo> > ueDrbs = ueRrc->GetDataRadioBearers ();
+  for (std::vector<DrbSnapshot>::iterator it = ue.drbs.begin (); it != ue.drbs.end (); ++it)
+    {
+      std::map<uint8_t, Ptr<LteDataRadioBearerInfo> >::iterator enbIt = enbDrbs.find (it->drbid);
+      if (enbIt == enbDrbs.end ())
+        {
+          NS_LOG_WARN ("IMSI " << ue.imsi << " DRB " << (uint32_t) it->drbid << " of the snapshot was not set up");
+          continue;
+        }
+      if (enbIt->second->m_gtpTeid != it->teid)
+        {
+          NS_LOG_WARN ("IMSI " << ue.imsi << " DRB " << (uint32_t) it->drbid << " restored with TEID "
+                       << enbIt->second->m_gtpTeid << " instead of " << it->teid);
+        }
+      if (enbIt->second->m_pdcp != 0)
+        {
+          LtePdcp::Status s;
+          s.txSn = it->enbTxSn;
+          s.rxSn = it->enbRxSn;
+          enbIt->second->m_pdcp->SetStatus (s);
+        }
+      std::map<uint8_t, Ptr<LteDataRadioBearerInfo> >::iterator ueIt = ueDrbs.find (it->drbid);
+      if (ueIt != ueDrbs.end () && ueIt->second->m_pdcp != 0)
+        {
+          LtePdcp::Status s;
+          s.txSn = it->ueTxSn;
+          s.rxSn = it->ueRxSn;
+          ueIt->second->m_pdcp->SetStatus (s);
+        }
+    }
+}
+
 uint8_t
 LteHelper::ActivateDedicatedEpsBearer (NetDeviceContainer ueDevices, EpsBearer bearer, Ptr<EpcTft> tft)
 {
@@ -1194,6 +1926,10 @@ LteHelper::AssignStreams (NetDeviceContainer c, int64_t stream)
           Ptr<LteSpectrumPhy> ulPhy = lteEnb->GetPhy ()->GetUplinkSpectrumPhy ();
           currentStream += dlPhy->AssignStreams (currentStream);
           currentStream += ulPhy->AssignStreams (currentStream);
+          if (m_useDlTrafficGenerator)
+            {
+              currentStream += lteEnb->GetRrc ()->AssignStreams (currentStream);
+            }
         }
       Ptr<LteUeNetDevice> lteUe = DynamicCast<LteUeNetDevice> (netDevice);
       if (lteUe)
@@ -1204,6 +1940,10 @@ LteHelper::AssignStreams (NetDeviceContainer c, int64_t stream)
           currentStream += dlPhy->AssignStreams (currentStream);
           currentStream += ulPhy->AssignStreams (currentStream);
           currentStream += ueMac->AssignStreams (currentStream);
+          if (m_useUlTrafficGenerator)
+            {
+              currentStream += lteUe->GetRrc ()->AssignStreams (currentStream);
+            }
         }
     }
   return (currentStream - stream);
@@ -1221,32 +1961,102 @@ LteHelper::EnablePhyTraces (void)
   EnableUlRxPhyTraces ();
 }
 
+/**
+ * Collect the LTE devices of all the nodes currently in the simulation,
+ * i.e., the devices that a "/NodeList/*/DeviceList/*" path would match
+ */
+static void
+CollectLteDevices (std::vector<Ptr<LteEnbNetDevice> >& enbDevs,
+                   std::vector<Ptr<LteUeNetDevice> >& ueDevs)
+{
+  for (NodeList::Iterator it = NodeList::Begin (); it != NodeList::End (); ++it)
+    {
+      Ptr<Node> node = *it;
+      for (uint32_t i = 0; i < node->GetNDevices (); ++i)
+        {
+          Ptr<NetDevice> dev = node->GetDevice (i);
+          Ptr<LteEnbNetDevice> enbDev = DynamicCast<LteEnbNetDevice> (dev);
+          if (enbDev != 0)
+            {
+              enbDevs.push_back (enbDev);
+              continue;
+            }
+          Ptr<LteUeNetDevice> ueDev = DynamicCast<LteUeNetDevice> (dev);
+          if (ueDev != 0)
+            {
+              ueDevs.push_back (ueDev);
+            }
+        }
+    }
+}
+
+/**
+ * Connect a trace sink to a trace source without context, logging the
+ * trace sources that are not provided by this build of the model
+ */
+static void
+ConnectStatsTrace (Ptr<Object> obj, std::string name, const CallbackBase& cb)
+{
+  if (!obj->TraceConnectWithoutContext (name, cb))
+    {
+      NS_LOG_WARN ("trace source " << name << " not available in " << obj->GetInstanceTypeId ().GetName ());
+    }
+}
+
 void
 LteHelper::EnableDlTxPhyTraces (void)
 {
-  Config::Connect ("/NodeList/*/DeviceList/*/LteEnbPhy/DlPhyTransmission",
-                   MakeBoundCallback (&PhyTxStatsCalculator::DlPhyTransmissionCallback, m_phyTxStats));
+  std::vector<Ptr<LteEnbNetDevice> > enbDevs;
+  std::vector<Ptr<LteUeNetDevice> > ueDevs;
+  CollectLteDevices (enbDevs, ueDevs);
+  for (uint32_t i = 0; i < enbDevs.size (); ++i)
+    {
+      m_phyTxStats->RegisterEnb (enbDevs[i]->GetCellId (), enbDevs[i]->GetRrc ());
+      ConnectStatsTrace (enbDevs[i]->GetPhy (), "DlPhyTransmission",
+                         MakeBoundCallback (&PhyTxStatsCalculator::DlPhyTransmissionCallback, m_phyTxStats));
+    }
 }
 
 void
 LteHelper::EnableUlTxPhyTraces (void)
 {
-  Config::Connect ("/NodeList/*/DeviceList/*/LteUePhy/UlPhyTransmission",
-                   MakeBoundCallback (&PhyTxStatsCalculator::UlPhyTransmissionCallback, m_phyTxStats));
+  std::vector<Ptr<LteEnbNetDevice> > enbDevs;
+  std::vector<Ptr<LteUeNetDevice> > ueDevs;
+  CollectLteDevices (enbDevs, ueDevs);
+  for (uint32_t i = 0; i < ueDevs.size (); ++i)
+    {
+      ConnectStatsTrace (ueDevs[i]->GetPhy (), "UlPhyTransmission",
+                         MakeBoundCallback (&PhyTxStatsCalculator::UlPhyTransmissionCallback, m_phyTxStats,
+                                            ueDevs[i]->GetImsi ()));
+    }
 }
 
 void
 LteHelper::EnableDlRxPhyTraces (void)
 {
-  Config::Connect ("/NodeList/*/DeviceList/*/LteUePhy/DlSpectrumPhy/DlPhyReception",
-                   MakeBoundCallback (&PhyRxStatsCalculator::DlPhyReceptionCallback, m_phyRxStats));
+  std::vector<Ptr<LteEnbNetDevice> > enbDevs;
+  std::vector<Ptr<LteUeNetDevice> > ueDevs;
+  CollectLteDevices (enbDevs, ueDevs);
+  for (uint32_t i = 0; i < ueDevs.size (); ++i)
+    {
+      ConnectStatsTrace (ueDevs[i]->GetPhy ()->GetDlSpectrumPhy (), "DlPhyReception",
+                         MakeBoundCallback (&PhyRxStatsCalculator::DlPhyReceptionCallback, m_phyRxStats,
+                                            ueDevs[i]->GetImsi ()));
+    }
 }
 
 void
 LteHelper::EnableUlRxPhyTraces (void)
 {
-  Config::Connect ("/NodeList/*/DeviceList/*/LteEnbPhy/UlSpectrumPhy/UlPhyReception",
-                   MakeBoundCallback (&PhyRxStatsCalculator::UlPhyReceptionCallback, m_phyRxStats));
+  std::vector<Ptr<LteEnbNetDevice> > enbDevs;
+  std::vector<Ptr<LteUeNetDevice> > ueDevs;
+  CollectLteDevices (enbDevs, ueDevs);
+  for (uint32_t i = 0; i < enbDevs.size (); ++i)
+    {
+      m_phyRxStats->RegisterEnb (enbDevs[i]->GetCellId (), enbDevs[i]->GetRrc ());
+      ConnectStatsTrace (enbDevs[i]->GetPhy ()->GetUlSpectrumPhy (), "UlPhyReception",
+                         MakeBoundCallback (&PhyRxStatsCalculator::UlPhyReceptionCallback, m_phyRxStats));
+    }
 }
 
 
@@ -1262,35 +2072,64 @@ void
 LteHelper::EnableDlMacTraces (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  Config::Connect ("/NodeList/*/DeviceList/*/LteEnbMac/DlScheduling",
-                   MakeBoundCallback (&MacStatsCalculator::DlSchedulingCallback, m_macStats));
+  std::vector<Ptr<LteEnbNetDevice> > enbDevs;
+  std::vector<Ptr<LteUeNetDevice> > ueDevs;
+  CollectLteDevices (enbDevs, ueDevs);
+  for (uint32_t i = 0; i < enbDevs.size (); ++i)
+    {
+      uint16_t cellId = enbDevs[i]->GetCellId ();
+      m_macStats->RegisterEnb (cellId, enbDevs[i]->GetRrc ());
+      ConnectStatsTrace (enbDevs[i]->GetMac (), "DlScheduling",
+                         MakeBoundCallback (&MacStatsCalculator::DlSchedulingCallback, m_macStats, cellId));
+    }
 }
 
 void
 LteHelper::EnableUlMacTraces (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  Config::Connect ("/NodeList/*/DeviceList/*/LteEnbMac/UlScheduling",
-                   MakeBoundCallback (&MacStatsCalculator::UlSchedulingCallback, m_macStats));
+  std::vector<Ptr<LteEnbNetDevice> > enbDevs;
+  std::vector<Ptr<LteUeNetDevice> > ueDevs;
+  CollectLteDevices (enbDevs, ueDevs);
+  for (uint32_t i = 0; i < enbDevs.size (); ++i)
+    {
+      uint16_t cellId = enbDevs[i]->GetCellId ();
+      m_macStats->RegisterEnb (cellId, enbDevs[i]->GetRrc ());
+      ConnectStatsTrace (enbDevs[i]->GetMac (), "UlScheduling",
+                         MakeBoundCallback (&MacStatsCalculator::UlSchedulingCallback, m_macStats, cellId));
+    }
 }
 
 void
 LteHelper::EnableDlPhyTraces (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  Config::Connect ("/NodeList/*/DeviceList/*/LteUePhy/ReportCurrentCellRsrpSinr",
-                   MakeBoundCallback (&PhyStatsCalculator::ReportCurrentCellRsrpSinrCallback, m_phyStats));
+  std::vector<Ptr<LteEnbNetDevice> > enbDevs;
+  std::vector<Ptr<LteUeNetDevice> > ueDevs;
+  CollectLteDevices (enbDevs, ueDevs);
+  for (uint32_t i = 0; i < ueDevs.size (); ++i)
+    {
+      ConnectStatsTrace (ueDevs[i]->GetPhy (), "ReportCurrentCellRsrpSinr",
+                         MakeBoundCallback (&PhyStatsCalculator::ReportCurrentCellRsrpSinrCallback, m_phyStats,
+                                            ueDevs[i]->GetImsi ()));
+    }
 }
 
 void
 LteHelper::EnableUlPhyTraces (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  Config::Connect ("/NodeList/*/DeviceList/*/LteEnbPhy/ReportUeSinr",
-                   MakeBoundCallback (&PhyStatsCalculator::ReportUeSinr, m_phyStats));
-  Config::Connect ("/NodeList/*/DeviceList/*/LteEnbPhy/ReportInterference",
-                   MakeBoundCallback (&PhyStatsCalculator::ReportInterference, m_phyStats));
-
+  std::vector<Ptr<LteEnbNetDevice> > enbDevs;
+  std::vector<Ptr<LteUeNetDevice> > ueDevs;
+  CollectLteDevices (enbDevs, ueDevs);
+  for (uint32_t i = 0; i < enbDevs.size (); ++i)
+    {
+      m_phyStats->RegisterEnb (enbDevs[i]->GetCellId (), enbDevs[i]->GetRrc ());
+      ConnectStatsTrace (enbDevs[i]->GetPhy (), "ReportUeSinr",
+                         MakeBoundCallback (&PhyStatsCalculator::ReportUeSinr, m_phyStats));
+      ConnectStatsTrace (enbDevs[i]->GetPhy (), "ReportInterference",
+                         MakeBoundCallback (&PhyStatsCalculator::ReportInterference, m_phyStats));
+    }
 }
 
 Ptr<RadioBearerStatsCalculator>
@@ -1313,8 +2152,16 @@ LteHelper::EnableRaPreambleTraces (void)
   NS_LOG_FUNCTION("Enabling ra traces");
   NS_ASSERT_MSG (m_raPreambleStats == 0, "please make sure that LteHelper::EnableRaPrambleTraces is called at most once");
   m_raPreambleStats = CreateObject<RaPreambleStatsCalculator> ();
-  Config::Connect ("/NodeList/*/DeviceList/*/LteEnbMac/RaPreambleReceived",
-                   MakeBoundCallback (&RaPreambleStatsCalculator::StorePreambleRx, m_raPreambleStats));
+  // the MAC trace does not tell the cell, which the collision counters need
+  std::vector<Ptr<LteEnbNetDevice> > enbDevs;
+  std::vector<Ptr<LteUeNetDevice> > ueDevs;
+  CollectLteDevices (enbDevs, ueDevs);
+  for (uint32_t i = 0; i < enbDevs.size (); ++i)
+    {
+      ConnectStatsTrace (enbDevs[i]->GetMac (), "RaPreambleReceived",
+                         MakeBoundCallback (&RaPreambleStatsCalculator::StorePreambleRx, m_raPreambleStats,
+                                            enbDevs[i]->GetCellId ()));
+    }
   Config::Connect ("/NodeList/*/DeviceList/*/LteEnbPhy/UlSpectrumPhy/PrachPhyReception",
                    MakeBoundCallback (&RaPreambleStatsCalculator::StorePreamblePhyRx, m_raPreambleStats));
 }
@@ -1333,6 +2180,8 @@ LteHelper::EnableRaDelayTraces (void)
   m_raDelayStats = CreateObject<RaCompleteStatsCalculator> ();
   Config::Connect ("/NodeList/*/DeviceList/*/LteUePhy/PrachTxStart",
                    MakeBoundCallback (&RaCompleteStatsCalculator::StorePreambleTx, m_raDelayStats));
+  Config::Connect ("/NodeList/*/DeviceList/*/LteUeMac/TxMsg3Start",
+                   MakeBoundCallback (&RaCompleteStatsCalculator::StoreMsg3Tx, m_raDelayStats));
   Config::Connect ("/NodeList/*/DeviceList/*/LteUeRrc/ConnectionEstablished",
                    MakeBoundCallback (&RaCompleteStatsCalculator::StoreMsg4Rx, m_raDelayStats));
 }
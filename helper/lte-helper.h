@@ -40,6 +40,8 @@
 #include "ns3/ra-preamble-phy-stats-calculator.h"
 #include "ns3/ra-preamble-stats-calculator.h"
 #include "ns3/ra-complete-stats-calculator.h"
+#include <ns3/lte-trace-sampler.h>
+#include <vector>
 
 
 namespace ns3 {
@@ -217,6 +219,26 @@ public:
    */
   void SetHandoverAlgorithmAttribute (std::string n, const AttributeValue &v);
 
+  /**
+   * Set an attribute for the DL traffic generators (LteTrafficGenerator)
+   * attached to the data radio bearers of the eNodeB devices, when the
+   * `UseDlTrafficGenerator` attribute is set.
+   *
+   * \param n the name of the attribute
+   * \param v the value of the attribute
+   */
+  void SetDlTrafficGeneratorAttribute (std::string n, const AttributeValue &v);
+
+  /**
+   * Set an attribute for the UL traffic generators (LteTrafficGenerator)
+   * attached to the data radio bearers of the UE devices, when the
+   * `UseUlTrafficGenerator` attribute is set.
+   *
+   * \param n the name of the attribute
+   * \param v the value of the attribute
+   */
+  void SetUlTrafficGeneratorAttribute (std::string n, const AttributeValue &v);
+
   /**
    * Set an attribute for the eNodeB devices (LteEnbNetDevice) to be created.
    * 
@@ -426,6 +448,83 @@ public:
    */
   void AttachToClosestEnb (Ptr<NetDevice> ueDevice, NetDeviceContainer enbDevices);
 
+  /// Criterion used by BulkAttach to select the serving eNodeB of a UE.
+  enum EnbSelectionCriterion
+  {
+    CLOSEST_ENB,  ///< minimum distance, as in AttachToClosestEnb
+    STRONGEST_ENB ///< maximum received power with the downlink pathloss model
+  };
+
+  /**
+   * \brief Manual attachment of a set of UE devices to the network via
+   *        the best eNodeB of a set according to a given criterion.
+   * \param ueDevices the set of UE devices to be attached
+   * \param enbDevices the set of eNodeB devices to be considered
+   * \param criterion how the serving eNodeB is selected
+   *
+   * The eNodeB positions are indexed once in a uniform grid, so that the
+   * closest eNodeBs of each UE are found without scanning the whole set.
+   * The lookups run in parallel on `BulkAttachThreads` threads; the
+   * attachments are then performed in the order of the UE container,
+   * hence the result does not depend on the number of threads and, for
+   * CLOSEST_ENB, is the same as AttachToClosestEnb.
+   *
+   * With STRONGEST_ENB, the `BulkAttachCandidates` closest eNodeBs of
+   * each UE are ranked by transmission power minus the loss of the
+   * downlink pathloss model, antenna gains and fading are not
+   * considered. If the pathloss model is a SpectrumPropagationLossModel
+   * the closest eNodeB is used.
+   */
+  void BulkAttach (NetDeviceContainer ueDevices, NetDeviceContainer enbDevices,
+                   EnbSelectionCriterion criterion = CLOSEST_ENB);
+
+  /**
+   * \brief Write the connected state of a set of UEs to a snapshot file.
+   * \param fileName the name of the snapshot file
+   * \param ueDevices the UE devices whose state is saved
+   * \param enbDevices the eNodeB devices the UEs may be connected to
+   *
+   * For every UE in CONNECTED_NORMALLY state the snapshot records IMSI,
+   * serving cell, C-RNTI, SRS configuration index and, for every data
+   * radio bearer, the S1-U TEID, the PDCP sequence numbers on both sides
+   * and the EPS bearer, i.e., its identity, its QoS and the packet
+   * filters of its TFT. UEs which are not connected are skipped. For
+   * every eNodeB, it records the last C-RNTI allocated. The state is
+   * taken when the method is called, hence it is typically scheduled at
+   * the end of a warm-up period.
+   *
+   * Aborts if the EPS bearer identities of a UE are not 1 to n, e.g.,
+   * after the deactivation of a dedicated bearer, since
+   * RestoreConnectedState could not reproduce them.
+   *
+   * \sa LteHelper::RestoreConnectedState
+   */
+  void SaveConnectedState (std::string fileName, NetDeviceContainer ueDevices, NetDeviceContainer enbDevices);
+
+  /**
+   * \brief Bring UEs to the connected state stored in a snapshot file.
+   * \param fileName the name of a file written by SaveConnectedState
+   * \param ueDevices the UE devices to be restored, matched by IMSI
+   * \param enbDevices the eNodeB devices, matched by cell ID
+   *
+   * To be used in place of Attach before the simulation starts, in a
+   * scenario with the same nodes, devices and IP addresses as the one
+   * which produced the snapshot. The EPS bearers of the snapshot, the
+   * default and the dedicated ones, are activated with their QoS and TFT
+   * in the order of their identities, so that the MME assigns the same
+   * identities. Cell search, random access and RRC connection
+   * establishment are skipped and the UEs are connected at the start of
+   * the simulation with the same RNTIs, SRS configuration indices and
+   * TEIDs as in the original run. The eNodeBs then allocate the RNTIs of
+   * the UEs connecting afterwards as in the original run.
+   *
+   * RLC entities start empty and the MAC scheduler learns the channel
+   * state again, as after an RRC connection re-establishment.
+   *
+   * \warning Requires the use of EPC mode. See SetEpcHelper() method.
+   */
+  void RestoreConnectedState (std::string fileName, NetDeviceContainer ueDevices, NetDeviceContainer enbDevices);
+
   /**
    * Activate a dedicated EPS bearer on a given set of UE devices.
    *
@@ -523,6 +622,18 @@ public:
    */
   void SetFadingModelAttribute (std::string n, const AttributeValue &v);
 
+  /**
+   * Set the sampling policy of the per-TTI trace sources (DlScheduling,
+   * UlScheduling, DlPhyTransmission, UlPhyTransmission, DlPhyReception,
+   * UlPhyReception, ReportUeSinr and ReportCurrentCellRsrpSinr) of the
+   * devices installed afterwards. The samples left out are dropped by
+   * the trace sources, before the trace sinks of the stats calculators
+   * are called.
+   *
+   * \param sampler the sampling policy
+   */
+  void SetTraceSampler (const LteTraceSampler& sampler);
+
   /**
    * Enables full-blown logging for major components of the LENA architecture.
    */
@@ -641,6 +752,10 @@ public:
    * If TraceFadingLossModel has been set as the fading model type, this method
    * will also assign a stream number to it, if none has been assigned before.
    *
+   * If the DL (UL) traffic generators are used, this method also reserves
+   * the streams of the generators that the RRC of each eNB (UE) attaches
+   * to the data radio bearers.
+   *
    * \param c NetDeviceContainer of the set of net devices for which the
    *          LteNetDevice should be modified to use a fixed stream
    * \param stream first stream index to use
@@ -695,6 +810,47 @@ private:
    */
   void DoDeActivateDedicatedEpsBearer (Ptr<NetDevice> ueDevice, Ptr<NetDevice> enbDevice, uint8_t bearerId);
 
+  /// State of a data radio bearer stored in a connected state snapshot.
+  struct DrbSnapshot
+  {
+    uint8_t drbid;    ///< data radio bearer identity
+    uint32_t teid;    ///< S1-U tunnel endpoint identifier
+    uint16_t enbTxSn; ///< eNB PDCP TX sequence number
+    uint16_t enbRxSn; ///< eNB PDCP RX sequence number
+    uint16_t ueTxSn;  ///< UE PDCP TX sequence number
+    uint16_t ueRxSn;  ///< UE PDCP RX sequence number
+    uint8_t epsBearerId; ///< EPS bearer identity
+    EpsBearer bearer; ///< QoS of the EPS bearer
+    std::vector<EpcTft::PacketFilter> filters; ///< packet filters of the TFT
+
+    /// order by EPS bearer identity, i.e., as allocated by the MME
+    bool operator< (const DrbSnapshot& other) const
+    {
+      return epsBearerId < other.epsBearerId;
+    }
+  };
+
+  /// State of a UE stored in a connected state snapshot.
+  struct UeSnapshot
+  {
+    uint64_t imsi;   ///< IMSI of the UE
+    uint16_t cellId; ///< serving cell
+    uint16_t rnti;   ///< C-RNTI in the serving cell
+    uint16_t srsConfigIndex; ///< SRS configuration index in the serving cell
+    std::vector<DrbSnapshot> drbs; ///< data radio bearers
+  };
+
+  /**
+   * \brief Restore a single UE in both the eNodeB and the UE.
+   * \param ueDevice the UE, must be of the type LteUeNetDevice
+   * \param enbDevice the serving eNB, must be of the type LteEnbNetDevice
+   * \param ue the state stored in the snapshot
+   *
+   * Scheduled by RestoreConnectedState() so that it runs after the
+   * initialization of the devices.
+   */
+  void DoRestoreConnectedUe (Ptr<NetDevice> ueDevice, Ptr<NetDevice> enbDevice, UeSnapshot ue);
+
 
   /// The downlink LTE channel used in the simulation.
   Ptr<SpectrumChannel> m_downlinkChannel;
@@ -711,6 +867,10 @@ private:
   ObjectFactory m_ffrAlgorithmFactory;
   /// Factory of handover algorithm object.
   ObjectFactory m_handoverAlgorithmFactory;
+  /// Factory of the DL traffic generators of the data radio bearers.
+  ObjectFactory m_dlTrafficGeneratorFactory;
+  /// Factory of the UL traffic generators of the data radio bearers.
+  ObjectFactory m_ulTrafficGeneratorFactory;
   /// Factory of LteEnbNetDevice objects.
   ObjectFactory m_enbNetDeviceFactory;
   /// Factory of antenna object for eNodeB.
@@ -788,6 +948,20 @@ private:
    */
   bool m_useIdealPrach;
 
+  /**
+   * The `UseDlTrafficGenerator` attribute. If true, the data radio bearers
+   * of the eNodeB devices are fed by a traffic generator.
+   */
+  bool m_useDlTrafficGenerator;
+
+  /**
+   * The `UseUlTrafficGenerator` attribute. If true, the data radio bearers
+   * of the UE devices are fed by a traffic generator.
+   */
+  bool m_useUlTrafficGenerator;
+
+  /// Sampling policy of the per-TTI traces of the devices installed.
+  LteTraceSampler m_traceSampler;
 
   /**
    * The `AnrEnabled` attribute. Activate or deactivate Automatic Neighbour
@@ -800,6 +974,17 @@ private:
    * DL-CQI will be calculated from PDCCH as signal and PDCCH as interference.
    */
   bool m_usePdschForCqiGeneration;
+  /**
+   * The `BulkAttachThreads` attribute. Number of threads used by
+   * BulkAttach to look up the closest eNodeBs, 0 for one per processor;
+   * 1 by default, so that no thread is spawned unless asked for.
+   */
+  uint32_t m_bulkAttachThreads;
+  /**
+   * The `BulkAttachCandidates` attribute. Number of closest eNodeBs
+   * evaluated by BulkAttach with the STRONGEST_ENB criterion.
+   */
+  uint32_t m_bulkAttachCandidates;
 
 }; // end of `class LteHelper`
 
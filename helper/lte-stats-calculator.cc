@@ -137,6 +137,70 @@ LteStatsCalculator::GetCellIdPath (std::string path)
 }
 
 
+void
+LteStatsCalculator::RegisterEnb (uint16_t cellId, Ptr<LteEnbRrc> rrc)
+{
+  NS_LOG_FUNCTION (this << cellId << rrc);
+  if (cellId >= m_enbRrcByCellId.size ())
+    {
+      m_enbRrcByCellId.resize (cellId + 1);
+    }
+  if (m_enbRrcByCellId[cellId] == rrc)
+    {
+      return;
+    }
+  m_enbRrcByCellId[cellId] = rrc;
+  rrc->TraceConnectWithoutContext ("NewUeContext",
+                                   MakeCallback (&LteStatsCalculator::NotifyNewUeContext, this));
+}
+
+uint64_t
+LteStatsCalculator::GetImsi (uint16_t cellId, uint16_t rnti)
+{
+  if (cellId < m_imsiByCellIdRnti.size () && rnti < m_imsiByCellIdRnti[cellId].size ())
+    {
+      uint64_t imsi = m_imsiByCellIdRnti[cellId][rnti];
+      if (imsi != 0)
+        {
+          return imsi;
+        }
+    }
+
+  // the IMSI is known by the eNB only once the RRC connection request
+  // has been received, hence the UEs still in random access are not cached
+  NS_ASSERT_MSG (cellId < m_enbRrcByCellId.size () && m_enbRrcByCellId[cellId] != 0,
+                 "cell " << cellId << " not registered");
+  Ptr<LteEnbRrc> rrc = m_enbRrcByCellId[cellId];
+  if (!rrc->HasUeManager (rnti))
+    {
+      return 0;
+    }
+  uint64_t imsi = rrc->GetUeManager (rnti)->GetImsi ();
+  if (imsi != 0)
+    {
+      if (cellId >= m_imsiByCellIdRnti.size ())
+        {
+          m_imsiByCellIdRnti.resize (cellId + 1);
+        }
+      if (rnti >= m_imsiByCellIdRnti[cellId].size ())
+        {
+          m_imsiByCellIdRnti[cellId].resize (rnti + 1, 0);
+        }
+      m_imsiByCellIdRnti[cellId][rnti] = imsi;
+    }
+  return imsi;
+}
+
+void
+LteStatsCalculator::NotifyNewUeContext (uint16_t cellId, uint16_t rnti)
+{
+  NS_LOG_FUNCTION (this << cellId << rnti);
+  if (cellId < m_imsiByCellIdRnti.size () && rnti < m_imsiByCellIdRnti[cellId].size ())
+    {
+      m_imsiByCellIdRnti[cellId][rnti] = 0;
+    }
+}
+
 uint64_t
 LteStatsCalculator::FindImsiFromEnbRlcPath (std::string path)
 {
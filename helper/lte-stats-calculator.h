@@ -24,9 +24,12 @@
 #include "ns3/object.h"
 #include "ns3/string.h"
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
+class LteEnbRrc;
+
 /**
  * \ingroup lte
  *
@@ -122,6 +125,26 @@ public:
    */
   uint16_t GetCellIdPath (std::string path);
 
+  /**
+   * Register an eNB whose UEs may be reported by the traces connected
+   * to this calculator, so that their IMSI can be resolved from the
+   * (cellId, RNTI) pair carried by the traces. Registering the same eNB
+   * more than once has no effect.
+   * @param cellId the cell ID of the eNB
+   * @param rrc the RRC of the eNB
+   */
+  void RegisterEnb (uint16_t cellId, Ptr<LteEnbRrc> rrc);
+
+  /**
+   * Retrieves the IMSI of a UE from its serving cell and RNTI. The
+   * result is cached in a table indexed by cell ID and RNTI, the entry
+   * being dropped when the RNTI is allocated again by the eNB.
+   * @param cellId the cell ID of a registered eNB
+   * @param rnti the C-RNTI of the UE in that cell
+   * @return the IMSI of the UE, or 0 if not known yet by the eNB
+   */
+  uint64_t GetImsi (uint16_t cellId, uint16_t rnti);
+
 protected:
 
   /**
@@ -195,6 +218,23 @@ private:
    */
   std::map<std::string, uint16_t> m_pathCellIdMap;
 
+  /**
+   * Trace sink of the NewUeContext trace of the registered eNBs
+   * @param cellId the cell ID of the eNB
+   * @param rnti the newly allocated RNTI
+   */
+  void NotifyNewUeContext (uint16_t cellId, uint16_t rnti);
+
+  /**
+   * RRC of the registered eNBs, indexed by cell ID
+   */
+  std::vector<Ptr<LteEnbRrc> > m_enbRrcByCellId;
+
+  /**
+   * IMSI of the known UEs, indexed by cell ID and RNTI, 0 if unknown
+   */
+  std::vector<std::vector<uint64_t> > m_imsiByCellIdRnti;
+
   /**
    * Name of the file where the downlink results will be saved
    */
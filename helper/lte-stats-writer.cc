@@ -0,0 +1,898 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-stats-writer.h"
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/enum.h>
+#include <ns3/boolean.h>
+#include <ns3/uinteger.h>
+#include <ns3/unused.h>
+#include <ns3/simple-ref-count.h>
+#include <ns3/core-config.h>
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#include <ns3/system-condition.h>
+#endif
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteStatsWriter");
+
+NS_OBJECT_ENSURE_REGISTERED (LteStatsWriter);
+
+const char LteStatsWriter::MAGIC[8] = { 'L', 'T', 'E', 'S', 'T', 'A', 'T', 'S' };
+
+/// Written after the magic number to detect a host byte order mismatch
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/**
+ * Each buffered record starts with a 32 bit tag. If its most significant
+ * bit is set, the record is free-form text whose length is given by the
+ * other bits. Otherwise the tag is the bitmap of the missing values of a
+ * row, whose fields follow.
+ */
+static const uint32_t TEXT_RECORD = 0x80000000;
+
+/**
+ * Maximum number of full buffers handed to the background thread and
+ * not yet written, which bounds the memory used by the pending output.
+ */
+static const uint32_t MAX_PENDING_BLOCKS = 32;
+
+/**
+ * \param type the type of a column
+ * \return the width in bytes of the column in BINARY records
+ */
+static uint32_t
+GetColumnWidth (LteStatsWriter::ColumnType type)
+{
+  switch (type)
+    {
+    case LteStatsWriter::UINT8:
+      return 1;
+    case LteStatsWriter::UINT16:
+      return 2;
+    case LteStatsWriter::UINT32:
+      return 4;
+    case LteStatsWriter::UINT64:
+    case LteStatsWriter::DOUBLE:
+      return 8;
+    default:
+      return 0;
+    }
+}
+
+
+/**
+ * \ingroup lte
+ *
+ * Background thread writing the full buffers of all the LteStatsWriter
+ * instances. The simulator thread is the only producer and the
+ * background thread the only consumer of a fixed-size ring of pending
+ * buffers, so that neither side needs a lock to access the ring; the
+ * conditions are only used to sleep while the ring is empty or full.
+ */
+class LteStatsOutputThread : public SimpleRefCount<LteStatsOutputThread>
+{
+public:
+  /**
+   * \return the thread, started upon the first call and stopped when
+   *         no writer references it anymore
+   */
+  static Ptr<LteStatsOutputThread> Get (void);
+
+  ~LteStatsOutputThread ();
+
+  /**
+   * Hand a buffer over to the background thread, waiting if too many
+   * buffers are already pending
+   * \param writer the writer of the buffer
+   * \param block the buffer, deleted once written
+   */
+  void Push (LteStatsWriter* writer, std::vector<char>* block);
+
+  /**
+   * Wait until all the buffers handed over have been written
+   */
+  void Drain (void);
+
+private:
+  LteStatsOutputThread ();
+
+  /// Main loop of the background thread
+  void Run (void);
+
+  /// A buffer waiting to be written
+  struct Job
+  {
+    LteStatsWriter* writer; ///< the writer of the buffer
+    std::vector<char>* block; ///< the buffer
+  };
+
+  Job m_ring[MAX_PENDING_BLOCKS]; ///< the pending buffers
+  volatile uint32_t m_pushed; ///< number of buffers handed over, written by the producer only
+  volatile uint32_t m_written; ///< number of buffers written, written by the consumer only
+  volatile bool m_stop; ///< set by the producer to stop the background thread
+#ifdef HAVE_PTHREAD_H
+  SystemCondition m_notEmpty; ///< signaled when a buffer is handed over
+  SystemCondition m_notFull; ///< signaled when a buffer has been written
+  Ptr<SystemThread> m_thread; ///< the background thread
+#endif
+
+  static LteStatsOutputThread* s_instance; ///< the running thread, if any
+};
+
+LteStatsOutputThread* LteStatsOutputThread::s_instance = 0;
+
+Ptr<LteStatsOutputThread>
+LteStatsOutputThread::Get (void)
+{
+  if (s_instance == 0)
+    {
+      s_instance = new LteStatsOutputThread ();
+      // the reference of the Ptr returned is the only one
+      Ptr<LteStatsOutputThread> thread (s_instance, false);
+      return thread;
+    }
+  return Ptr<LteStatsOutputThread> (s_instance);
+}
+
+LteStatsOutputThread::LteStatsOutputThread ()
+  : m_pushed (0),
+    m_written (0),
+    m_stop (false)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  m_thread = Create<SystemThread> (MakeCallback (&LteStatsOutputThread::Run, this));
+  m_thread->Start ();
+#endif
+}
+
+LteStatsOutputThread::~LteStatsOutputThread ()
+{
+  NS_LOG_FUNCTION (this);
+  Drain ();
+#ifdef HAVE_PTHREAD_H
+  m_stop = true;
+  __sync_synchronize ();
+  m_notEmpty.SetCondition (true);
+  m_notEmpty.Signal ();
+  m_thread->Join ();
+#endif
+  s_instance = 0;
+}
+
+void
+LteStatsOutputThread::Push (LteStatsWriter* writer, std::vector<char>* block)
+{
+#ifdef HAVE_PTHREAD_H
+  // back-pressure: wait for a free slot
+  while (m_pushed - m_written == MAX_PENDING_BLOCKS)
+    {
+      m_notFull.SetCondition (false);
+      if (m_pushed - m_written == MAX_PENDING_BLOCKS)
+        {
+          m_notFull.TimedWait (1000000);
+        }
+    }
+  __sync_synchronize ();
+  Job& job = m_ring[m_pushed % MAX_PENDING_BLOCKS];
+  job.writer = writer;
+  job.block = block;
+  // make the job visible before publishing it
+  __sync_synchronize ();
+  m_pushed = m_pushed + 1;
+  m_notEmpty.SetCondition (true);
+  m_notEmpty.Signal ();
+#else
+  writer->WriteBlock (*block);
+  delete block;
+#endif
+}
+
+void
+LteStatsOutputThread::Drain (void)
+{
+#ifdef HAVE_PTHREAD_H
+  while (m_written != m_pushed)
+    {
+      m_notFull.SetCondition (false);
+      if (m_written != m_pushed)
+        {
+          m_notFull.TimedWait (1000000);
+        }
+    }
+  __sync_synchronize ();
+#endif
+}
+
+void
+LteStatsOutputThread::Run (void)
+{
+#ifdef HAVE_PTHREAD_H
+  while (true)
+    {
+      m_notEmpty.SetCondition (false);
+      if (m_written == m_pushed)
+        {
+          if (m_stop)
+            {
+              return;
+            }
+          m_notEmpty.TimedWait (1000000);
+          continue;
+        }
+      // read the job only after having seen it published
+      __sync_synchronize ();
+      Job job = m_ring[m_written % MAX_PENDING_BLOCKS];
+      job.writer->WriteBlock (*job.block);
+      delete job.block;
+      // complete the write before releasing the slot
+      __sync_synchronize ();
+      m_written = m_written + 1;
+      m_notFull.SetCondition (true);
+      m_notFull.Signal ();
+    }
+#endif
+}
+
+
+LteStatsWriter::LteStatsWriter ()
+  : m_format (TEXT),
+    m_bufferSize (1 << 20),
+    m_async (true),
+    m_textTrailingSeparator (false),
+    m_rowWidth (0),
+    m_currentColumn (0),
+    m_rowStart (0),
+    m_batch (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LteStatsWriter::~LteStatsWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+TypeId
+LteStatsWriter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LteStatsWriter")
+    .SetParent<Object> ()
+    .SetGroupName("Lte")
+    .AddConstructor<LteStatsWriter> ()
+    .AddAttribute ("Format",
+                   "Format of the statistics files. BINARY files can be "
+                   "converted to CSV with the lte-stats-to-csv program.",
+                   EnumValue (LteStatsWriter::TEXT),
+                   MakeEnumAccessor (&LteStatsWriter::SetFormat,
+                                     &LteStatsWriter::GetFormat),
+                   MakeEnumChecker (LteStatsWriter::TEXT, "Text",
+                                    LteStatsWriter::BINARY, "Binary"))
+    .AddAttribute ("BufferSize",
+                   "Number of bytes accumulated in memory before being written to the file.",
+                   UintegerValue (1 << 20),
+                   MakeUintegerAccessor (&LteStatsWriter::m_bufferSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("AsyncOutput",
+                   "If true, the buffers are formatted and written to the file "
+                   "by a background thread. Ignored if threads are not available.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&LteStatsWriter::m_async),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+void
+LteStatsWriter::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+  Object::DoDispose ();
+}
+
+void
+LteStatsWriter::SetFormat (Format format)
+{
+  NS_ASSERT_MSG (!IsOpen (), "the format cannot be changed once the file is open");
+  m_format = format;
+}
+
+LteStatsWriter::Format
+LteStatsWriter::GetFormat (void) const
+{
+  return m_format;
+}
+
+void
+LteStatsWriter::SetTextTrailingSeparator (bool trailing)
+{
+  m_textTrailingSeparator = trailing;
+}
+
+void
+LteStatsWriter::AddColumn (std::string name, ColumnType type, int textPrecision)
+{
+  NS_ASSERT_MSG (!IsOpen (), "columns must be declared before opening " << m_filename);
+  NS_ASSERT (name.size () < 256);
+  NS_ASSERT_MSG (m_columns.size () < 31, "too many columns");
+  Column c;
+  c.name = name;
+  c.type = type;
+  c.precision = textPrecision;
+  m_columns.push_back (c);
+  m_rowWidth += GetColumnWidth (type);
+}
+
+bool
+LteStatsWriter::Open (std::string filename, std::string textHeader)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+  m_filename = filename;
+  m_outFile.open (filename.c_str (), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+  if (!m_outFile.is_open ())
+    {
+      NS_LOG_ERROR ("Can't open file " << filename);
+      return false;
+    }
+  m_buffer.reserve (m_bufferSize + m_rowWidth + 4);
+  m_currentColumn = 0;
+
+  // the header is written right away, before any buffer is handed over
+  if (m_format == TEXT)
+    {
+      if (textHeader.empty ())
+        {
+          textHeader = "%";
+          for (uint32_t i = 0; i < m_columns.size (); ++i)
+            {
+              textHeader += (i == 0 ? " " : "\t") + m_columns[i].name;
+            }
+        }
+      textHeader += "\n";
+      m_outFile.write (textHeader.data (), textHeader.size ());
+    }
+  else
+    {
+      m_outFile.write (MAGIC, sizeof (MAGIC));
+      m_outFile.write (reinterpret_cast<const char*> (&BYTE_ORDER_MARK), sizeof (BYTE_ORDER_MARK));
+      uint32_t nColumns = m_columns.size ();
+      m_outFile.write (reinterpret_cast<const char*> (&nColumns), sizeof (nColumns));
+      for (uint32_t i = 0; i < m_columns.size (); ++i)
+        {
+          char type = m_columns[i].type;
+          char length = m_columns[i].name.size ();
+          m_outFile.put (type);
+          m_outFile.put (length);
+          m_outFile.write (m_columns[i].name.data (), m_columns[i].name.size ());
+        }
+    }
+
+  if (m_async)
+    {
+      m_thread = LteStatsOutputThread::Get ();
+    }
+  // the helper holding the calculators is often never disposed
+  m_closeEvent = Simulator::ScheduleDestroy (&LteStatsWriter::Close, this);
+  return true;
+}
+
+bool
+LteStatsWriter::IsOpen (void) const
+{
+  return m_outFile.is_open ();
+}
+
+const LteStatsWriter::Column&
+LteStatsWriter::NextColumn (void)
+{
+  NS_ASSERT_MSG (m_currentColumn < m_columns.size (), "too many values in a row of " << m_filename);
+  if (m_currentColumn == 0)
+    {
+      // tag of the record, with no missing value so far
+      m_rowStart = m_buffer.size ();
+      uint32_t tag = 0;
+      Append (&tag, sizeof (tag));
+    }
+  return m_columns[m_currentColumn++];
+}
+
+void
+LteStatsWriter::WriteUint (uint64_t value)
+{
+  if (!IsOpen ())
+    {
+      return;
+    }
+  switch (NextColumn ().type)
+    {
+    case UINT8:
+      {
+        uint8_t v = value;
+        Append (&v, sizeof (v));
+      }
+      break;
+    case UINT16:
+      {
+        uint16_t v = value;
+        Append (&v, sizeof (v));
+      }
+      break;
+    case UINT32:
+      {
+        uint32_t v = value;
+        Append (&v, sizeof (v));
+      }
+      break;
+    case UINT64:
+      Append (&value, sizeof (value));
+      break;
+    case DOUBLE:
+      {
+        double v = value;
+        Append (&v, sizeof (v));
+      }
+      break;
+    }
+}
+
+void
+LteStatsWriter::WriteDouble (double value)
+{
+  if (!IsOpen ())
+    {
+      return;
+    }
+  ColumnType type = NextColumn ().type;
+  NS_ASSERT_MSG (type == DOUBLE, "floating point value in an integer column of " << m_filename);
+  NS_UNUSED (type);
+  Append (&value, sizeof (value));
+}
+
+void
+LteStatsWriter::WriteMissing (void)
+{
+  if (!IsOpen ())
+    {
+      return;
+    }
+  if (m_columns[m_currentColumn].type == DOUBLE)
+    {
+      WriteDouble (std::numeric_limits<double>::quiet_NaN ());
+    }
+  else
+    {
+      WriteUint (std::numeric_limits<uint64_t>::max ());
+    }
+  uint32_t tag;
+  std::memcpy (&tag, &m_buffer[m_rowStart], sizeof (tag));
+  tag |= 1u << (m_currentColumn - 1);
+  std::memcpy (&m_buffer[m_rowStart], &tag, sizeof (tag));
+}
+
+void
+LteStatsWriter::EndRow (void)
+{
+  if (!IsOpen ())
+    {
+      return;
+    }
+  NS_ASSERT_MSG (m_currentColumn == m_columns.size (), "incomplete row in " << m_filename);
+  m_currentColumn = 0;
+  FlushIfFull ();
+}
+
+void
+LteStatsWriter::WriteText (const std::string& text)
+{
+  NS_ASSERT_MSG (m_format == TEXT, "free-form text in the BINARY file " << m_filename);
+  NS_ASSERT_MSG (m_currentColumn == 0, "free-form text inside a row of " << m_filename);
+  NS_ASSERT (text.size () < TEXT_RECORD);
+  if (IsOpen ())
+    {
+      uint32_t tag = TEXT_RECORD | text.size ();
+      Append (&tag, sizeof (tag));
+      Append (text.data (), text.size ());
+      FlushIfFull ();
+    }
+}
+
+void
+LteStatsWriter::Append (const void* data, uint32_t size)
+{
+  const char* bytes = static_cast<const char*> (data);
+  m_buffer.insert (m_buffer.end (), bytes, bytes + size);
+}
+
+void
+LteStatsWriter::FlushIfFull (void)
+{
+  if (m_buffer.size () >= m_bufferSize)
+    {
+      Flush ();
+    }
+}
+
+void
+LteStatsWriter::Flush (void)
+{
+  NS_ASSERT_MSG (m_currentColumn == 0, "flushing an incomplete row of " << m_filename);
+  if (m_buffer.empty () || !IsOpen ())
+    {
+      return;
+    }
+  NS_LOG_LOGIC (this << " handing over " << m_buffer.size () << " bytes of records for " << m_filename);
+  if (m_thread != 0)
+    {
+      // the next batch is likely to be as large as this one
+      std::vector<char>* block = new std::vector<char> ();
+      block->reserve (m_buffer.size () + m_rowWidth + 4);
+      block->swap (m_buffer);
+      m_thread->Push (this, block);
+    }
+  else
+    {
+      WriteBlock (m_buffer);
+      m_buffer.clear ();
+    }
+}
+
+void
+LteStatsWriter::StartBatch (int64_t batch)
+{
+  if (batch != m_batch)
+    {
+      Flush ();
+      m_batch = batch;
+    }
+}
+
+void
+LteStatsWriter::WriteBlock (const std::vector<char>& block)
+{
+  // no logging here, this runs on the background thread in asynchronous mode
+  std::string out;
+  out.reserve (m_format == TEXT ? 2 * block.size () : block.size ());
+  char text[64];
+  uint32_t pos = 0;
+  while (pos < block.size ())
+    {
+      uint32_t tag;
+      std::memcpy (&tag, &block[pos], sizeof (tag));
+      pos += sizeof (tag);
+      if (tag & TEXT_RECORD)
+        {
+          uint32_t length = tag & ~TEXT_RECORD;
+          out.append (&block[pos], length);
+          pos += length;
+          continue;
+        }
+      if (m_format == BINARY)
+        {
+          out.append (&block[pos], m_rowWidth);
+          pos += m_rowWidth;
+          continue;
+        }
+      for (uint32_t i = 0; i < m_columns.size (); ++i)
+        {
+          if (i > 0)
+            {
+              out += '\t';
+            }
+          const Column& column = m_columns[i];
+          const char* field = &block[pos];
+          pos += GetColumnWidth (column.type);
+          if (tag & (1u << i))
+            {
+              out += '-';
+              continue;
+            }
+          int n = 0;
+          switch (column.type)
+            {
+            case UINT8:
+              n = std::snprintf (text, sizeof (text), "%u", (unsigned) (uint8_t) field[0]);
+              break;
+            case UINT16:
+              {
+                uint16_t v;
+                std::memcpy (&v, field, sizeof (v));
+                n = std::snprintf (text, sizeof (text), "%u", (unsigned) v);
+              }
+              break;
+            case UINT32:
+              {
+                uint32_t v;
+                std::memcpy (&v, field, sizeof (v));
+                n = std::snprintf (text, sizeof (text), "%lu", (unsigned long) v);
+              }
+              break;
+            case UINT64:
+              {
+                uint64_t v;
+                std::memcpy (&v, field, sizeof (v));
+                n = std::snprintf (text, sizeof (text), "%llu", (unsigned long long) v);
+              }
+              break;
+            case DOUBLE:
+              {
+                double v;
+                std::memcpy (&v, field, sizeof (v));
+                if (column.precision < 0)
+                  {
+                    // same representation as the default formatting of std::ostream
+                    n = std::snprintf (text, sizeof (text), "%g", v);
+                  }
+                else
+                  {
+                    n = std::snprintf (text, sizeof (text), "%.*f", column.precision, v);
+                  }
+              }
+              break;
+            }
+          out.append (text, std::min<int> (n, sizeof (text) - 1));
+        }
+      if (m_textTrailingSeparator)
+        {
+          out += '\t';
+        }
+      out += '\n';
+    }
+  m_outFile.write (out.data (), out.size ());
+  m_outFile.flush ();
+}
+
+void
+LteStatsWriter::Close (void)
+{
+  if (IsOpen ())
+    {
+      NS_LOG_FUNCTION (this << m_filename);
+      Flush ();
+      if (m_thread != 0)
+        {
+          m_thread->Drain ();
+          m_thread = 0;
+        }
+      m_outFile.close ();
+    }
+  Simulator::Cancel (m_closeEvent);
+}
+
+
+LteStatsReader::LteStatsReader ()
+{
+}
+
+bool
+LteStatsReader::Open (std::string filename)
+{
+  m_names.clear ();
+  m_types.clear ();
+  m_offsets.clear ();
+  if (m_inFile.is_open ())
+    {
+      m_inFile.close ();
+    }
+  m_inFile.clear ();
+  m_inFile.open (filename.c_str (), std::ios_base::in | std::ios_base::binary);
+  if (!m_inFile.is_open ())
+    {
+      return false;
+    }
+
+  char magic[sizeof (LteStatsWriter::MAGIC)];
+  uint32_t byteOrderMark = 0;
+  uint32_t nColumns = 0;
+  m_inFile.read (magic, sizeof (magic));
+  m_inFile.read (reinterpret_cast<char*> (&byteOrderMark), sizeof (byteOrderMark));
+  m_inFile.read (reinterpret_cast<char*> (&nColumns), sizeof (nColumns));
+  if (!m_inFile
+      || std::memcmp (magic, LteStatsWriter::MAGIC, sizeof (magic)) != 0
+      || byteOrderMark != BYTE_ORDER_MARK)
+    {
+      return false;
+    }
+
+  uint32_t offset = 0;
+  for (uint32_t i = 0; i < nColumns; ++i)
+    {
+      uint8_t type = 0;
+      uint8_t length = 0;
+      m_inFile.read (reinterpret_cast<char*> (&type), 1);
+      m_inFile.read (reinterpret_cast<char*> (&length), 1);
+      std::string name (length, ' ');
+      if (length > 0)
+        {
+          m_inFile.read (&name[0], length);
+        }
+      uint32_t width = GetColumnWidth (static_cast<LteStatsWriter::ColumnType> (type));
+      if (!m_inFile || width == 0)
+        {
+          return false;
+        }
+      m_names.push_back (name);
+      m_types.push_back (static_cast<LteStatsWriter::ColumnType> (type));
+      m_offsets.push_back (offset);
+      offset += width;
+    }
+  m_record.resize (offset);
+  return true;
+}
+
+uint32_t
+LteStatsReader::GetNColumns (void) const
+{
+  return m_names.size ();
+}
+
+std::string
+LteStatsReader::GetColumnName (uint32_t i) const
+{
+  return m_names.at (i);
+}
+
+LteStatsWriter::ColumnType
+LteStatsReader::GetColumnType (uint32_t i) const
+{
+  return m_types.at (i);
+}
+
+bool
+LteStatsReader::ReadRow (void)
+{
+  if (m_record.empty ())
+    {
+      return false;
+    }
+  m_inFile.read (&m_record[0], m_record.size ());
+  return m_inFile.gcount () == static_cast<std::streamsize> (m_record.size ());
+}
+
+uint64_t
+LteStatsReader::GetUint (uint32_t i) const
+{
+  const char* p = &m_record[m_offsets.at (i)];
+  switch (m_types[i])
+    {
+    case LteStatsWriter::UINT8:
+      {
+        uint8_t v;
+        std::memcpy (&v, p, sizeof (v));
+        return v;
+      }
+    case LteStatsWriter::UINT16:
+      {
+        uint16_t v;
+        std::memcpy (&v, p, sizeof (v));
+        return v;
+      }
+    case LteStatsWriter::UINT32:
+      {
+        uint32_t v;
+        std::memcpy (&v, p, sizeof (v));
+        return v;
+      }
+    case LteStatsWriter::UINT64:
+      {
+        uint64_t v;
+        std::memcpy (&v, p, sizeof (v));
+        return v;
+      }
+    case LteStatsWriter::DOUBLE:
+      return static_cast<uint64_t> (GetDouble (i));
+    }
+  return 0;
+}
+
+double
+LteStatsReader::GetDouble (uint32_t i) const
+{
+  if (m_types.at (i) != LteStatsWriter::DOUBLE)
+    {
+      return static_cast<double> (GetUint (i));
+    }
+  double v;
+  std::memcpy (&v, &m_record[m_offsets[i]], sizeof (v));
+  return v;
+}
+
+bool
+LteStatsReader::IsMissing (uint32_t i) const
+{
+  switch (m_types.at (i))
+    {
+    case LteStatsWriter::UINT8:
+      return GetUint (i) == std::numeric_limits<uint8_t>::max ();
+    case LteStatsWriter::UINT16:
+      return GetUint (i) == std::numeric_limits<uint16_t>::max ();
+    case LteStatsWriter::UINT32:
+      return GetUint (i) == std::numeric_limits<uint32_t>::max ();
+    case LteStatsWriter::UINT64:
+      return GetUint (i) == std::numeric_limits<uint64_t>::max ();
+    case LteStatsWriter::DOUBLE:
+      {
+        double v = GetDouble (i);
+        return v != v;
+      }
+    }
+  return false;
+}
+
+void
+LteStatsReader::WriteCsvHeader (std::ostream& os) const
+{
+  for (uint32_t i = 0; i < m_names.size (); ++i)
+    {
+      os << (i == 0 ? "" : ",") << m_names[i];
+    }
+  os << "\n";
+}
+
+void
+LteStatsReader::WriteCsvRow (std::ostream& os) const
+{
+  for (uint32_t i = 0; i < m_names.size (); ++i)
+    {
+      if (i > 0)
+        {
+          os << ",";
+        }
+      if (IsMissing (i))
+        {
+          continue;
+        }
+      if (m_types[i] == LteStatsWriter::DOUBLE)
+        {
+          char text[32];
+          std::snprintf (text, sizeof (text), "%.17g", GetDouble (i));
+          os << text;
+        }
+      else
+        {
+          os << GetUint (i);
+        }
+    }
+  os << "\n";
+}
+
+bool
+LteStatsReader::ConvertToCsv (std::string filename, std::ostream& os)
+{
+  LteStatsReader reader;
+  if (!reader.Open (filename))
+    {
+      return false;
+    }
+  reader.WriteCsvHeader (os);
+  while (reader.ReadRow ())
+    {
+      reader.WriteCsvRow (os);
+    }
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,342 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_STATS_WRITER_H_
+#define LTE_STATS_WRITER_H_
+
+#include "ns3/object.h"
+#include "ns3/event-id.h"
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+class LteStatsOutputThread;
+
+/**
+ * \ingroup lte
+ *
+ * Output backend shared by the LTE stats calculators. The file is kept
+ * open for the whole simulation and rows are accumulated in a memory
+ * buffer which is written to disk in large blocks.
+ *
+ * Two formats are supported:
+ *   - TEXT: one line per row, tab-separated, preceded by a header line,
+ *     as written by the stats calculators so far;
+ *   - BINARY: a schema header (column names and types) followed by one
+ *     fixed-width record per row, in the byte order of the host. Such
+ *     files can be converted to CSV with LteStatsReader or with the
+ *     lte-stats-to-csv example program.
+ *
+ * The columns are declared with AddColumn before calling Open. Each row
+ * is then written as one WriteUint or WriteDouble call per column, in
+ * declaration order, followed by EndRow.
+ *
+ * The rows are buffered as raw records, and formatting them (for the
+ * TEXT format) and writing them to disk is done a full buffer at a
+ * time. When the AsyncOutput attribute is set and threads are
+ * available, the full buffers are handed to a background thread shared
+ * by all the writers, so that the simulation keeps running while they
+ * are formatted and written. At most a fixed number of buffers can be
+ * pending: beyond that, the simulation waits for the background thread
+ * to catch up.
+ *
+ * The rows are also handed over by Flush, which the calculators call at
+ * the end of each epoch, and by StartBatch, which the per-TTI
+ * calculators call with the current time before each row. The file is
+ * closed by Close, when the writer is disposed, or at the latest when
+ * the simulator is destroyed.
+ */
+class LteStatsWriter : public Object
+{
+public:
+  /// Output format
+  enum Format
+  {
+    TEXT,
+    BINARY
+  };
+
+  /// Type of a column, which also determines its width in BINARY records
+  enum ColumnType
+  {
+    UINT8 = 1,
+    UINT16 = 2,
+    UINT32 = 3,
+    UINT64 = 4,
+    DOUBLE = 5
+  };
+
+  LteStatsWriter ();
+  virtual ~LteStatsWriter ();
+
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \param format the output format, to be set before Open
+   */
+  void SetFormat (Format format);
+
+  /**
+   * \return the output format
+   */
+  Format GetFormat (void) const;
+
+  /**
+   * \param trailing whether the TEXT rows end with a separator after the
+   *        last column, as some of the statistics files always had
+   */
+  void SetTextTrailingSeparator (bool trailing);
+
+  /**
+   * Declare the next column of the rows
+   *
+   * \param name the name of the column
+   * \param type the type of the column
+   * \param textPrecision for DOUBLE columns, the number of decimals in
+   *        TEXT format, or -1 for the default formatting of std::ostream
+   */
+  void AddColumn (std::string name, ColumnType type, int textPrecision = -1);
+
+  /**
+   * Create (or truncate) the output file and write its header. In TEXT
+   * format the header is textHeader if not empty, or else the column
+   * names preceded by "% ".
+   *
+   * \param filename the name of the output file
+   * \param textHeader the header line of the TEXT format, without the
+   *        end of line
+   * \return false if the file could not be created
+   */
+  bool Open (std::string filename, std::string textHeader = "");
+
+  /**
+   * \return true if the file has been opened successfully
+   */
+  bool IsOpen (void) const;
+
+  /**
+   * Write the value of the next column of the current row
+   *
+   * \param value the value, converted to the type of the column
+   */
+  void WriteUint (uint64_t value);
+
+  /**
+   * Write the value of the next column of the current row
+   *
+   * \param value the value, which must belong to a DOUBLE column
+   */
+  void WriteDouble (double value);
+
+  /**
+   * Mark the next column of the current row as not applicable. It is
+   * written as "-" in TEXT format, and as the largest value of the
+   * column type (NaN for DOUBLE columns) in BINARY format.
+   */
+  void WriteMissing (void);
+
+  /**
+   * Complete the current row
+   */
+  void EndRow (void);
+
+  /**
+   * Append free-form text to the file. Only allowed in TEXT format, for
+   * the statistics which do not fit in fixed-width records.
+   *
+   * \param text the text to be written
+   */
+  void WriteText (const std::string& text);
+
+  /**
+   * Hand the buffered rows over to be written to the file. In
+   * asynchronous mode, they may still be pending when this returns.
+   */
+  void Flush (void);
+
+  /**
+   * Start a row of the given batch, flushing the buffered rows first if
+   * they belong to another batch. With the current time as the batch,
+   * the rows of a TTI are handed over once the next TTI starts.
+   *
+   * \param batch the batch of the next row
+   */
+  void StartBatch (int64_t batch);
+
+  /**
+   * Flush the buffered rows, wait until they have been written and
+   * close the file. Scheduled with Simulator::ScheduleDestroy by Open.
+   */
+  void Close (void);
+
+  /// Magic number at the beginning of the BINARY files
+  static const char MAGIC[8];
+
+protected:
+  // inherited from Object
+  virtual void DoDispose (void);
+
+private:
+  friend class LteStatsOutputThread;
+
+  /// Declaration of a column
+  struct Column
+  {
+    std::string name; ///< the name of the column
+    ColumnType type; ///< the type of the column
+    int precision; ///< the number of decimals in TEXT format, -1 for default
+  };
+
+  /**
+   * Append raw bytes to the buffer
+   * \param data the bytes
+   * \param size the number of bytes
+   */
+  void Append (const void* data, uint32_t size);
+
+  /**
+   * Start the next column of the current row
+   * \return the column
+   */
+  const Column& NextColumn (void);
+
+  /**
+   * Hand the buffer over if it is full
+   */
+  void FlushIfFull (void);
+
+  /**
+   * Format a block of buffered records and write it to the file. Called
+   * by the background thread in asynchronous mode.
+   * \param block the records
+   */
+  void WriteBlock (const std::vector<char>& block);
+
+  Format m_format; ///< output format
+  uint32_t m_bufferSize; ///< number of bytes buffered before writing to the file
+  bool m_async; ///< whether the buffers are written by the background thread
+  bool m_textTrailingSeparator; ///< whether the TEXT rows end with a separator
+  std::vector<Column> m_columns; ///< the columns of the rows
+  uint32_t m_rowWidth; ///< the size of the fields of a record
+  uint32_t m_currentColumn; ///< the next column to be written in the current row
+  uint32_t m_rowStart; ///< the offset of the current row in the buffer
+  std::ofstream m_outFile; ///< the output file
+  std::string m_filename; ///< the name of the output file
+  std::vector<char> m_buffer; ///< rows not yet handed over
+  int64_t m_batch; ///< the batch of the buffered rows
+  EventId m_closeEvent; ///< closes the file when the simulator is destroyed
+  Ptr<LteStatsOutputThread> m_thread; ///< the background thread, in asynchronous mode
+};
+
+
+/**
+ * \ingroup lte
+ *
+ * Reader of the BINARY files of LteStatsWriter
+ */
+class LteStatsReader
+{
+public:
+  LteStatsReader ();
+
+  /**
+   * Open a BINARY stats file and read its schema
+   * \param filename the name of the file
+   * \return false if the file cannot be read or is not a BINARY stats file
+   */
+  bool Open (std::string filename);
+
+  /**
+   * \return the number of columns
+   */
+  uint32_t GetNColumns (void) const;
+
+  /**
+   * \param i the index of the column
+   * \return the name of the column
+   */
+  std::string GetColumnName (uint32_t i) const;
+
+  /**
+   * \param i the index of the column
+   * \return the type of the column
+   */
+  LteStatsWriter::ColumnType GetColumnType (uint32_t i) const;
+
+  /**
+   * Read the next record
+   * \return false at the end of the file
+   */
+  bool ReadRow (void);
+
+  /**
+   * \param i the index of an integer column
+   * \return its value in the last record read
+   */
+  uint64_t GetUint (uint32_t i) const;
+
+  /**
+   * \param i the index of a column
+   * \return its value in the last record read
+   */
+  double GetDouble (uint32_t i) const;
+
+  /**
+   * \param i the index of a column
+   * \return true if the column was written with LteStatsWriter::WriteMissing
+   *         in the last record read
+   */
+  bool IsMissing (uint32_t i) const;
+
+  /**
+   * Write the column names as a CSV line
+   * \param os the output stream
+   */
+  void WriteCsvHeader (std::ostream& os) const;
+
+  /**
+   * Write the last record read as a CSV line, the missing values being
+   * left empty
+   * \param os the output stream
+   */
+  void WriteCsvRow (std::ostream& os) const;
+
+  /**
+   * Convert a BINARY stats file to CSV
+   * \param filename the name of the BINARY stats file
+   * \param os the output stream
+   * \return false if the file cannot be read
+   */
+  static bool ConvertToCsv (std::string filename, std::ostream& os);
+
+private:
+  std::ifstream m_inFile; ///< the input file
+  std::vector<std::string> m_names; ///< the names of the columns
+  std::vector<LteStatsWriter::ColumnType> m_types; ///< the types of the columns
+  std::vector<uint32_t> m_offsets; ///< the offset of each column in the records
+  std::vector<char> m_record; ///< the last record read
+};
+
+} // namespace ns3
+
+#endif /* LTE_STATS_WRITER_H_ */
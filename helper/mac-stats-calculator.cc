@@ -30,8 +30,6 @@ NS_LOG_COMPONENT_DEFINE ("MacStatsCalculator");
 NS_OBJECT_ENSURE_REGISTERED (MacStatsCalculator);
 
 MacStatsCalculator::MacStatsCalculator ()
-  : m_dlFirstWrite (true),
-    m_ulFirstWrite (true)
 {
   NS_LOG_FUNCTION (this);
 
@@ -42,6 +40,21 @@ MacStatsCalculator::~MacStatsCalculator ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+MacStatsCalculator::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_dlWriter != 0)
+    {
+      m_dlWriter->Close ();
+    }
+  if (m_ulWriter != 0)
+    {
+      m_ulWriter->Close ();
+    }
+  LteStatsCalculator::DoDispose ();
+}
+
 TypeId
 MacStatsCalculator::GetTypeId (void)
 {
@@ -94,40 +107,34 @@ MacStatsCalculator::DlScheduling (uint16_t cellId, uint64_t imsi, uint32_t frame
   NS_LOG_FUNCTION (this << cellId << imsi << frameNo << subframeNo << rnti << (uint32_t) mcsTb1 << sizeTb1 << (uint32_t) mcsTb2 << sizeTb2);
   NS_LOG_INFO ("Write DL Mac Stats in " << GetDlOutputFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_dlFirstWrite == true )
+  if (m_dlWriter == 0)
     {
-      outFile.open (GetDlOutputFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetDlOutputFilename ().c_str ());
-          return;
-        }
-      m_dlFirstWrite = false;
-      outFile << "% time\tcellId\tIMSI\tframe\tsframe\tRNTI\tmcsTb1\tsizeTb1\tmcsTb2\tsizeTb2";
-      outFile << std::endl;
-    }
-  else
-    {
-      outFile.open (GetDlOutputFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetDlOutputFilename ().c_str ());
-          return;
-        }
+      m_dlWriter = CreateObject<LteStatsWriter> ();
+      m_dlWriter->AddColumn ("time", LteStatsWriter::DOUBLE);
+      m_dlWriter->AddColumn ("cellId", LteStatsWriter::UINT16);
+      m_dlWriter->AddColumn ("IMSI", LteStatsWriter::UINT64);
+      m_dlWriter->AddColumn ("frame", LteStatsWriter::UINT32);
+      m_dlWriter->AddColumn ("sframe", LteStatsWriter::UINT32);
+      m_dlWriter->AddColumn ("RNTI", LteStatsWriter::UINT16);
+      m_dlWriter->AddColumn ("mcsTb1", LteStatsWriter::UINT8);
+      m_dlWriter->AddColumn ("sizeTb1", LteStatsWriter::UINT16);
+      m_dlWriter->AddColumn ("mcsTb2", LteStatsWriter::UINT8);
+      m_dlWriter->AddColumn ("sizeTb2", LteStatsWriter::UINT16);
+      m_dlWriter->Open (GetDlOutputFilename ());
     }
 
-  outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
-  outFile << (uint32_t) cellId << "\t";
-  outFile << imsi << "\t";
-  outFile << frameNo << "\t";
-  outFile << subframeNo << "\t";
-  outFile << rnti << "\t";
-  outFile << (uint32_t) mcsTb1 << "\t";
-  outFile << sizeTb1 << "\t";
-  outFile << (uint32_t) mcsTb2 << "\t";
-  outFile << sizeTb2 << std::endl;
-  outFile.close ();
+  m_dlWriter->StartBatch (Simulator::Now ().GetTimeStep ());
+  m_dlWriter->WriteDouble (Simulator::Now ().GetNanoSeconds () / (double) 1e9);
+  m_dlWriter->WriteUint (cellId);
+  m_dlWriter->WriteUint (imsi);
+  m_dlWriter->WriteUint (frameNo);
+  m_dlWriter->WriteUint (subframeNo);
+  m_dlWriter->WriteUint (rnti);
+  m_dlWriter->WriteUint (mcsTb1);
+  m_dlWriter->WriteUint (sizeTb1);
+  m_dlWriter->WriteUint (mcsTb2);
+  m_dlWriter->WriteUint (sizeTb2);
+  m_dlWriter->EndRow ();
 }
 
 void
@@ -137,105 +144,50 @@ MacStatsCalculator::UlScheduling (uint16_t cellId, uint64_t imsi, uint32_t frame
   NS_LOG_FUNCTION (this << cellId << imsi << frameNo << subframeNo << rnti << (uint32_t) mcsTb << size);
   NS_LOG_INFO ("Write UL Mac Stats in " << GetUlOutputFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_ulFirstWrite == true )
-    {
-      outFile.open (GetUlOutputFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetUlOutputFilename ().c_str ());
-          return;
-        }
-      m_ulFirstWrite = false;
-      outFile << "% time\tcellId\tIMSI\tframe\tsframe\tRNTI\tmcs\tsize";
-      outFile << std::endl;
-    }
-  else
+  if (m_ulWriter == 0)
     {
-      outFile.open (GetUlOutputFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetUlOutputFilename ().c_str ());
-          return;
-        }
+      m_ulWriter = CreateObject<LteStatsWriter> ();
+      m_ulWriter->AddColumn ("time", LteStatsWriter::DOUBLE);
+      m_ulWriter->AddColumn ("cellId", LteStatsWriter::UINT16);
+      m_ulWriter->AddColumn ("IMSI", LteStatsWriter::UINT64);
+      m_ulWriter->AddColumn ("frame", LteStatsWriter::UINT32);
+      m_ulWriter->AddColumn ("sframe", LteStatsWriter::UINT32);
+      m_ulWriter->AddColumn ("RNTI", LteStatsWriter::UINT16);
+      m_ulWriter->AddColumn ("mcs", LteStatsWriter::UINT8);
+      m_ulWriter->AddColumn ("size", LteStatsWriter::UINT16);
+      m_ulWriter->Open (GetUlOutputFilename ());
     }
 
-  outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
-  outFile << (uint32_t) cellId << "\t";
-  outFile << imsi << "\t";
-  outFile << frameNo << "\t";
-  outFile << subframeNo << "\t";
-  outFile << rnti << "\t";
-  outFile << (uint32_t) mcsTb << "\t";
-  outFile << size << std::endl;
-  outFile.close ();
+  m_ulWriter->StartBatch (Simulator::Now ().GetTimeStep ());
+  m_ulWriter->WriteDouble (Simulator::Now ().GetNanoSeconds () / (double) 1e9);
+  m_ulWriter->WriteUint (cellId);
+  m_ulWriter->WriteUint (imsi);
+  m_ulWriter->WriteUint (frameNo);
+  m_ulWriter->WriteUint (subframeNo);
+  m_ulWriter->WriteUint (rnti);
+  m_ulWriter->WriteUint (mcsTb);
+  m_ulWriter->WriteUint (size);
+  m_ulWriter->EndRow ();
 }
 
 void
 MacStatsCalculator::DlSchedulingCallback (Ptr<MacStatsCalculator> macStats,
-                      std::string path, uint32_t frameNo, uint32_t subframeNo,
+                      uint16_t cellId, uint32_t frameNo, uint32_t subframeNo,
                       uint16_t rnti, uint8_t mcsTb1, uint16_t sizeTb1,
                       uint8_t mcsTb2, uint16_t sizeTb2)
 {
-  NS_LOG_FUNCTION (macStats << path);
-  uint64_t imsi = 0;
-  std::ostringstream pathAndRnti;
-  pathAndRnti << path << "/" << rnti;
-  if (macStats->ExistsImsiPath (pathAndRnti.str ()) == true)
-    {
-      imsi = macStats->GetImsiPath (pathAndRnti.str ());
-    }
-  else
-    {
-      imsi = FindImsiFromEnbMac (path, rnti);
-      macStats->SetImsiPath (pathAndRnti.str (), imsi);
-    }
-
-  uint16_t cellId = 0;
-  if (macStats->ExistsCellIdPath (pathAndRnti.str ()) == true)
-    {
-      cellId = macStats->GetCellIdPath (pathAndRnti.str ());
-    }
-  else
-    {
-      cellId = FindCellIdFromEnbMac (path, rnti);
-      macStats->SetCellIdPath (pathAndRnti.str (), cellId);
-    }
-
+  NS_LOG_FUNCTION (macStats << cellId << rnti);
+  uint64_t imsi = macStats->GetImsi (cellId, rnti);
   macStats->DlScheduling (cellId, imsi, frameNo, subframeNo, rnti, mcsTb1, sizeTb1, mcsTb2, sizeTb2);
 }
 
 void
-MacStatsCalculator::UlSchedulingCallback (Ptr<MacStatsCalculator> macStats, std::string path,
+MacStatsCalculator::UlSchedulingCallback (Ptr<MacStatsCalculator> macStats, uint16_t cellId,
                       uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
                       uint8_t mcs, uint16_t size)
 {
-  NS_LOG_FUNCTION (macStats << path);
-
-  uint64_t imsi = 0;
-  std::ostringstream pathAndRnti;
-  pathAndRnti << path << "/" << rnti;
-  if (macStats->ExistsImsiPath (pathAndRnti.str ()) == true)
-    {
-      imsi = macStats->GetImsiPath (pathAndRnti.str ());
-    }
-  else
-    {
-      NS_LOG_INFO("UlSchedulingCallback for rnti " << rnti << " on frameNo " << frameNo << " path " << path);
-      imsi = FindImsiFromEnbMac (path, rnti);
-      macStats->SetImsiPath (pathAndRnti.str (), imsi);
-    }
-  uint16_t cellId = 0;
-  if (macStats->ExistsCellIdPath (pathAndRnti.str ()) == true)
-    {
-      cellId = macStats->GetCellIdPath (pathAndRnti.str ());
-    }
-  else
-    {
-      cellId = FindCellIdFromEnbMac (path, rnti);
-      macStats->SetCellIdPath (pathAndRnti.str (), cellId);
-    }
-
+  NS_LOG_FUNCTION (macStats << cellId << rnti);
+  uint64_t imsi = macStats->GetImsi (cellId, rnti);
   macStats->UlScheduling (cellId, imsi, frameNo, subframeNo, rnti, mcs, size);
 }
 
@@ -22,6 +22,7 @@
 #define MAC_STATS_CALCULATOR_H_
 
 #include "ns3/lte-stats-calculator.h"
+#include "ns3/lte-stats-writer.h"
 #include "ns3/nstime.h"
 #include "ns3/uinteger.h"
 #include <string>
@@ -61,6 +62,7 @@ public:
    *  \return The object TypeId.
    */
   static TypeId GetTypeId (void);
+  void DoDispose ();
 
   /**
    * Set the name of the file where the uplink statistics will be stored.
@@ -121,7 +123,7 @@ public:
    * Trace sink for the ns3::LteEnbMac::DlScheduling trace source
    * 
    * \param macStats 
-   * \param path 
+   * \param cellId the cell ID of the eNB
    * \param frameNo 
    * \param subframeNo 
    * \param rnti 
@@ -131,7 +133,7 @@ public:
    * \param sizeTb2 
    */
   static void DlSchedulingCallback (Ptr<MacStatsCalculator> macStats,
-                             std::string path, uint32_t frameNo, uint32_t subframeNo,
+                             uint16_t cellId, uint32_t frameNo, uint32_t subframeNo,
                              uint16_t rnti, uint8_t mcsTb1, uint16_t sizeTb1,
                              uint8_t mcsTb2, uint16_t sizeTb2);
 
@@ -139,34 +141,30 @@ public:
    * Trace sink for the ns3::LteEnbMac::UlScheduling trace source
    * 
    * \param macStats 
-   * \param path 
+   * \param cellId the cell ID of the eNB
    * \param frameNo 
    * \param subframeNo 
    * \param rnti 
    * \param mcs 
    * \param size 
    */
-  static void UlSchedulingCallback (Ptr<MacStatsCalculator> macStats, std::string path,
+  static void UlSchedulingCallback (Ptr<MacStatsCalculator> macStats, uint16_t cellId,
                              uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
                              uint8_t mcs, uint16_t size);
 
 
 private:
   /**
-   * When writing DL MAC statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Writer of the DL MAC statistics, which opens the output file
+   * upon the first write
    */
-  bool m_dlFirstWrite;
+  Ptr<LteStatsWriter> m_dlWriter;
 
   /**
-   * When writing UL MAC statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Writer of the UL MAC statistics, which opens the output file
+   * upon the first write
    */
-  bool m_ulFirstWrite;
+  Ptr<LteStatsWriter> m_ulWriter;
 
 };
 
@@ -32,8 +32,6 @@ NS_LOG_COMPONENT_DEFINE ("PhyRxStatsCalculator");
 NS_OBJECT_ENSURE_REGISTERED (PhyRxStatsCalculator);
 
 PhyRxStatsCalculator::PhyRxStatsCalculator ()
-  : m_dlRxFirstWrite (true),
-    m_ulRxFirstWrite (true)
 {
   NS_LOG_FUNCTION (this);
 
@@ -44,6 +42,21 @@ PhyRxStatsCalculator::~PhyRxStatsCalculator ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+PhyRxStatsCalculator::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_dlRxWriter != 0)
+    {
+      m_dlRxWriter->Close ();
+    }
+  if (m_ulRxWriter != 0)
+    {
+      m_ulRxWriter->Close ();
+    }
+  LteStatsCalculator::DoDispose ();
+}
+
 TypeId
 PhyRxStatsCalculator::GetTypeId (void)
 {
@@ -95,42 +108,36 @@ PhyRxStatsCalculator::DlPhyReception (PhyReceptionStatParameters params)
   NS_LOG_FUNCTION (this << params.m_cellId << params.m_imsi << params.m_timestamp << params.m_rnti << params.m_layer << params.m_mcs << params.m_size << params.m_rv << params.m_ndi << params.m_correctness);
   NS_LOG_INFO ("Write DL Rx Phy Stats in " << GetDlRxOutputFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_dlRxFirstWrite == true )
+  if (m_dlRxWriter == 0)
     {
-      outFile.open (GetDlRxOutputFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetDlRxOutputFilename ().c_str ());
-          return;
-        }
-      m_dlRxFirstWrite = false;
-      outFile << "% time\tcellId\tIMSI\tRNTI\ttxMode\tlayer\tmcs\tsize\trv\tndi\tcorrect";
-      outFile << std::endl;
-    }
-  else
-    {
-      outFile.open (GetDlRxOutputFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetDlRxOutputFilename ().c_str ());
-          return;
-        }
+      m_dlRxWriter = CreateObject<LteStatsWriter> ();
+      m_dlRxWriter->AddColumn ("time", LteStatsWriter::UINT64);
+      m_dlRxWriter->AddColumn ("cellId", LteStatsWriter::UINT16);
+      m_dlRxWriter->AddColumn ("IMSI", LteStatsWriter::UINT64);
+      m_dlRxWriter->AddColumn ("RNTI", LteStatsWriter::UINT16);
+      m_dlRxWriter->AddColumn ("txMode", LteStatsWriter::UINT8);
+      m_dlRxWriter->AddColumn ("layer", LteStatsWriter::UINT8);
+      m_dlRxWriter->AddColumn ("mcs", LteStatsWriter::UINT8);
+      m_dlRxWriter->AddColumn ("size", LteStatsWriter::UINT16);
+      m_dlRxWriter->AddColumn ("rv", LteStatsWriter::UINT8);
+      m_dlRxWriter->AddColumn ("ndi", LteStatsWriter::UINT8);
+      m_dlRxWriter->AddColumn ("correct", LteStatsWriter::UINT8);
+      m_dlRxWriter->Open (GetDlRxOutputFilename ());
     }
 
-//   outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
-  outFile << params.m_timestamp << "\t";
-  outFile << (uint32_t) params.m_cellId << "\t";
-  outFile << params.m_imsi << "\t";
-  outFile << params.m_rnti << "\t";
-  outFile << (uint32_t) params.m_txMode << "\t";
-  outFile << (uint32_t) params.m_layer << "\t";
-  outFile << (uint32_t) params.m_mcs << "\t";
-  outFile << params.m_size << "\t";
-  outFile << (uint32_t) params.m_rv << "\t";
-  outFile << (uint32_t) params.m_ndi << "\t";
-  outFile << (uint32_t) params.m_correctness << std::endl;
-  outFile.close ();
+  m_dlRxWriter->StartBatch (Simulator::Now ().GetTimeStep ());
+  m_dlRxWriter->WriteUint (params.m_timestamp);
+  m_dlRxWriter->WriteUint (params.m_cellId);
+  m_dlRxWriter->WriteUint (params.m_imsi);
+  m_dlRxWriter->WriteUint (params.m_rnti);
+  m_dlRxWriter->WriteUint (params.m_txMode);
+  m_dlRxWriter->WriteUint (params.m_layer);
+  m_dlRxWriter->WriteUint (params.m_mcs);
+  m_dlRxWriter->WriteUint (params.m_size);
+  m_dlRxWriter->WriteUint (params.m_rv);
+  m_dlRxWriter->WriteUint (params.m_ndi);
+  m_dlRxWriter->WriteUint (params.m_correctness);
+  m_dlRxWriter->EndRow ();
 }
 
 void
@@ -139,84 +146,51 @@ PhyRxStatsCalculator::UlPhyReception (PhyReceptionStatParameters params)
   NS_LOG_FUNCTION (this << params.m_cellId << params.m_imsi << params.m_timestamp << params.m_rnti << params.m_layer << params.m_mcs << params.m_size << params.m_rv << params.m_ndi << params.m_correctness);
   NS_LOG_INFO ("Write UL Rx Phy Stats in " << GetUlRxOutputFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_ulRxFirstWrite == true )
-    {
-      outFile.open (GetUlRxOutputFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetUlRxOutputFilename ().c_str ());
-          return;
-        }
-      m_ulRxFirstWrite = false;
-      outFile << "% time\tcellId\tIMSI\tRNTI\tlayer\tmcs\tsize\trv\tndi\tcorrect";
-      outFile << std::endl;
-    }
-  else
+  if (m_ulRxWriter == 0)
     {
-      outFile.open (GetUlRxOutputFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetUlRxOutputFilename ().c_str ());
-          return;
-        }
+      m_ulRxWriter = CreateObject<LteStatsWriter> ();
+      m_ulRxWriter->AddColumn ("time", LteStatsWriter::UINT64);
+      m_ulRxWriter->AddColumn ("cellId", LteStatsWriter::UINT16);
+      m_ulRxWriter->AddColumn ("IMSI", LteStatsWriter::UINT64);
+      m_ulRxWriter->AddColumn ("RNTI", LteStatsWriter::UINT16);
+      m_ulRxWriter->AddColumn ("layer", LteStatsWriter::UINT8);
+      m_ulRxWriter->AddColumn ("mcs", LteStatsWriter::UINT8);
+      m_ulRxWriter->AddColumn ("size", LteStatsWriter::UINT16);
+      m_ulRxWriter->AddColumn ("rv", LteStatsWriter::UINT8);
+      m_ulRxWriter->AddColumn ("ndi", LteStatsWriter::UINT8);
+      m_ulRxWriter->AddColumn ("correct", LteStatsWriter::UINT8);
+      m_ulRxWriter->Open (GetUlRxOutputFilename ());
     }
 
-//   outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
-  outFile << params.m_timestamp << "\t";
-  outFile << (uint32_t) params.m_cellId << "\t";
-  outFile << params.m_imsi << "\t";
-  outFile << params.m_rnti << "\t";
-  outFile << (uint32_t) params.m_layer << "\t";
-  outFile << (uint32_t) params.m_mcs << "\t";
-  outFile << params.m_size << "\t";
-  outFile << (uint32_t) params.m_rv << "\t";
-  outFile << (uint32_t) params.m_ndi << "\t";
-  outFile << (uint32_t) params.m_correctness << std::endl;
-  outFile.close ();
+  m_ulRxWriter->StartBatch (Simulator::Now ().GetTimeStep ());
+  m_ulRxWriter->WriteUint (params.m_timestamp);
+  m_ulRxWriter->WriteUint (params.m_cellId);
+  m_ulRxWriter->WriteUint (params.m_imsi);
+  m_ulRxWriter->WriteUint (params.m_rnti);
+  m_ulRxWriter->WriteUint (params.m_layer);
+  m_ulRxWriter->WriteUint (params.m_mcs);
+  m_ulRxWriter->WriteUint (params.m_size);
+  m_ulRxWriter->WriteUint (params.m_rv);
+  m_ulRxWriter->WriteUint (params.m_ndi);
+  m_ulRxWriter->WriteUint (params.m_correctness);
+  m_ulRxWriter->EndRow ();
 }
 
 void
 PhyRxStatsCalculator::DlPhyReceptionCallback (Ptr<PhyRxStatsCalculator> phyRxStats,
-                      std::string path, PhyReceptionStatParameters params)
+                      uint64_t imsi, PhyReceptionStatParameters params)
 {
-  NS_LOG_FUNCTION (phyRxStats << path);
-  uint64_t imsi = 0;
-  std::ostringstream pathAndRnti;
-  pathAndRnti << path << "/" << params.m_rnti;
-  if (phyRxStats->ExistsImsiPath (pathAndRnti.str ()) == true)
-    {
-      imsi = phyRxStats->GetImsiPath (pathAndRnti.str ());
-    }
-  else
-    {
-      imsi = FindImsiForUe (path, params.m_rnti);
-      phyRxStats->SetImsiPath (pathAndRnti.str (), imsi);
-    }
-
+  NS_LOG_FUNCTION (phyRxStats << imsi << params.m_rnti);
   params.m_imsi = imsi;
   phyRxStats->DlPhyReception (params);
 }
 
 void
 PhyRxStatsCalculator::UlPhyReceptionCallback (Ptr<PhyRxStatsCalculator> phyRxStats,
-                      std::string path, PhyReceptionStatParameters params)
+                      PhyReceptionStatParameters params)
 {
-  NS_LOG_FUNCTION (phyRxStats << path);
-  uint64_t imsi = 0;
-  std::ostringstream pathAndRnti;
-  pathAndRnti << path << "/" << params.m_rnti;
-  if (phyRxStats->ExistsImsiPath (pathAndRnti.str ()) == true)
-    {
-      imsi = phyRxStats->GetImsiPath (pathAndRnti.str ());
-    }
-  else
-    {
-      imsi = FindImsiForEnb (path, params.m_rnti);
-      phyRxStats->SetImsiPath (pathAndRnti.str (), imsi);
-    }
-
-  params.m_imsi = imsi;
+  NS_LOG_FUNCTION (phyRxStats << params.m_cellId << params.m_rnti);
+  params.m_imsi = phyRxStats->GetImsi (params.m_cellId, params.m_rnti);
   phyRxStats->UlPhyReception (params);
 }
 
@@ -24,6 +24,7 @@
 #define PHY_RX_STATS_CALCULATOR_H_
 
 #include "ns3/lte-stats-calculator.h"
+#include "ns3/lte-stats-writer.h"
 #include "ns3/nstime.h"
 #include "ns3/uinteger.h"
 #include <string>
@@ -66,6 +67,7 @@ public:
    *  \return The object TypeId.
    */
   static TypeId GetTypeId (void);
+  void DoDispose ();
 
   /**
    * Set the name of the file where the UL Rx PHY statistics will be stored.
@@ -109,38 +111,33 @@ public:
    * trace sink
    * 
    * \param phyRxStats 
-   * \param path 
+   * \param imsi the IMSI of the receiving UE
    * \param params 
    */
   static void DlPhyReceptionCallback (Ptr<PhyRxStatsCalculator> phyRxStats,
-                               std::string path, PhyReceptionStatParameters params);
+                               uint64_t imsi, PhyReceptionStatParameters params);
 
   /** 
    * trace sink
    * 
    * \param phyRxStats 
-   * \param path 
    * \param params 
    */
   static void UlPhyReceptionCallback (Ptr<PhyRxStatsCalculator> phyRxStats,
-                               std::string path, PhyReceptionStatParameters params);
+                               PhyReceptionStatParameters params);
 private:
 
   /**
-   * When writing DL RX PHY statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Writer of the DL RX PHY statistics, which opens the output file
+   * upon the first write
    */
-  bool m_dlRxFirstWrite;
+  Ptr<LteStatsWriter> m_dlRxWriter;
 
   /**
-   * When writing UL RX PHY statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Writer of the UL RX PHY statistics, which opens the output file
+   * upon the first write
    */
-  bool m_ulRxFirstWrite;
+  Ptr<LteStatsWriter> m_ulRxWriter;
 
 };
 
@@ -22,6 +22,7 @@
 #include "ns3/string.h"
 #include <ns3/simulator.h>
 #include <ns3/log.h>
+#include <sstream>
 
 namespace ns3 {
 
@@ -30,9 +31,6 @@ NS_LOG_COMPONENT_DEFINE ("PhyStatsCalculator");
 NS_OBJECT_ENSURE_REGISTERED (PhyStatsCalculator);
 
 PhyStatsCalculator::PhyStatsCalculator ()
-  :  m_RsrpSinrFirstWrite (true),
-    m_UeSinrFirstWrite (true),
-    m_InterferenceFirstWrite (true)
 {
   NS_LOG_FUNCTION (this);
 
@@ -43,6 +41,25 @@ PhyStatsCalculator::~PhyStatsCalculator ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+PhyStatsCalculator::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_rsrpSinrWriter != 0)
+    {
+      m_rsrpSinrWriter->Close ();
+    }
+  if (m_ueSinrWriter != 0)
+    {
+      m_ueSinrWriter->Close ();
+    }
+  if (m_interferenceWriter != 0)
+    {
+      m_interferenceWriter->Close ();
+    }
+  LteStatsCalculator::DoDispose ();
+}
+
 TypeId
 PhyStatsCalculator::GetTypeId (void)
 {
@@ -114,36 +131,26 @@ PhyStatsCalculator::ReportCurrentCellRsrpSinr (uint16_t cellId, uint64_t imsi, u
   NS_LOG_FUNCTION (this << cellId <<  imsi << rnti  << rsrp << sinr);
   NS_LOG_INFO ("Write RSRP/SINR Phy Stats in " << GetCurrentCellRsrpSinrFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_RsrpSinrFirstWrite == true )
+  if (m_rsrpSinrWriter == 0)
     {
-      outFile.open (GetCurrentCellRsrpSinrFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetCurrentCellRsrpSinrFilename ().c_str ());
-          return;
-        }
-      m_RsrpSinrFirstWrite = false;
-      outFile << "% time\tcellId\tIMSI\tRNTI\trsrp\tsinr";
-      outFile << std::endl;
-    }
-  else
-    {
-      outFile.open (GetCurrentCellRsrpSinrFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetCurrentCellRsrpSinrFilename ().c_str ());
-          return;
-        }
+      m_rsrpSinrWriter = CreateObject<LteStatsWriter> ();
+      m_rsrpSinrWriter->AddColumn ("time", LteStatsWriter::DOUBLE);
+      m_rsrpSinrWriter->AddColumn ("cellId", LteStatsWriter::UINT16);
+      m_rsrpSinrWriter->AddColumn ("IMSI", LteStatsWriter::UINT64);
+      m_rsrpSinrWriter->AddColumn ("RNTI", LteStatsWriter::UINT16);
+      m_rsrpSinrWriter->AddColumn ("rsrp", LteStatsWriter::DOUBLE);
+      m_rsrpSinrWriter->AddColumn ("sinr", LteStatsWriter::DOUBLE);
+      m_rsrpSinrWriter->Open (GetCurrentCellRsrpSinrFilename ());
     }
 
-  outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
-  outFile << cellId << "\t";
-  outFile << imsi << "\t";
-  outFile << rnti << "\t";
-  outFile << rsrp << "\t";
-  outFile << sinr << std::endl;
-  outFile.close ();
+  m_rsrpSinrWriter->StartBatch (Simulator::Now ().GetTimeStep ());
+  m_rsrpSinrWriter->WriteDouble (Simulator::Now ().GetNanoSeconds () / (double) 1e9);
+  m_rsrpSinrWriter->WriteUint (cellId);
+  m_rsrpSinrWriter->WriteUint (imsi);
+  m_rsrpSinrWriter->WriteUint (rnti);
+  m_rsrpSinrWriter->WriteDouble (rsrp);
+  m_rsrpSinrWriter->WriteDouble (sinr);
+  m_rsrpSinrWriter->EndRow ();
 }
 
 void
@@ -152,35 +159,24 @@ PhyStatsCalculator::ReportUeSinr (uint16_t cellId, uint64_t imsi, uint16_t rnti,
   NS_LOG_FUNCTION (this << cellId <<  imsi << rnti  << sinrLinear);
   NS_LOG_INFO ("Write SINR Linear Phy Stats in " << GetUeSinrFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_UeSinrFirstWrite == true )
+  if (m_ueSinrWriter == 0)
     {
-      outFile.open (GetUeSinrFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetUeSinrFilename ().c_str ());
-          return;
-        }
-      m_UeSinrFirstWrite = false;
-      outFile << "% time\tcellId\tIMSI\tRNTI\tsinrLinear";
-      outFile << std::endl;
-    }
-  else
-    {
-      outFile.open (GetUeSinrFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetUeSinrFilename ().c_str ());
-          return;
-        }
+      m_ueSinrWriter = CreateObject<LteStatsWriter> ();
+      m_ueSinrWriter->AddColumn ("time", LteStatsWriter::DOUBLE);
+      m_ueSinrWriter->AddColumn ("cellId", LteStatsWriter::UINT16);
+      m_ueSinrWriter->AddColumn ("IMSI", LteStatsWriter::UINT64);
+      m_ueSinrWriter->AddColumn ("RNTI", LteStatsWriter::UINT16);
+      m_ueSinrWriter->AddColumn ("sinrLinear", LteStatsWriter::DOUBLE);
+      m_ueSinrWriter->Open (GetUeSinrFilename ());
     }
 
-  outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
-  outFile << cellId << "\t";
-  outFile << imsi << "\t";
-  outFile << rnti << "\t";
-  outFile << sinrLinear << std::endl;
-  outFile.close ();
+  m_ueSinrWriter->StartBatch (Simulator::Now ().GetTimeStep ());
+  m_ueSinrWriter->WriteDouble (Simulator::Now ().GetNanoSeconds () / (double) 1e9);
+  m_ueSinrWriter->WriteUint (cellId);
+  m_ueSinrWriter->WriteUint (imsi);
+  m_ueSinrWriter->WriteUint (rnti);
+  m_ueSinrWriter->WriteDouble (sinrLinear);
+  m_ueSinrWriter->EndRow ();
 }
 
 void
@@ -189,86 +185,45 @@ PhyStatsCalculator::ReportInterference (uint16_t cellId, Ptr<SpectrumValue> inte
   NS_LOG_FUNCTION (this << cellId <<  interference);
   NS_LOG_INFO ("Write Interference Phy Stats in " << GetInterferenceFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_InterferenceFirstWrite == true )
-    {
-      outFile.open (GetInterferenceFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetInterferenceFilename ().c_str ());
-          return;
-        }
-      m_InterferenceFirstWrite = false;
-      outFile << "% time\tcellId\tInterference";
-      outFile << std::endl;
-    }
-  else
+  if (m_interferenceWriter == 0)
     {
-      outFile.open (GetInterferenceFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetInterferenceFilename ().c_str ());
-          return;
-        }
+      m_interferenceWriter = CreateObject<LteStatsWriter> ();
+      m_interferenceWriter->SetFormat (LteStatsWriter::TEXT);
+      m_interferenceWriter->Open (GetInterferenceFilename (), "% time\tcellId\tInterference");
     }
 
-  outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
-  outFile << cellId << "\t";
-  outFile << *interference;
-  outFile.close ();
+  std::ostringstream row;
+  row << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
+  row << cellId << "\t";
+  row << *interference;
+  m_interferenceWriter->StartBatch (Simulator::Now ().GetTimeStep ());
+  m_interferenceWriter->WriteText (row.str ());
 }
 
 
 void
 PhyStatsCalculator::ReportCurrentCellRsrpSinrCallback (Ptr<PhyStatsCalculator> phyStats,
-                      std::string path, uint16_t cellId, uint16_t rnti,
+                      uint64_t imsi, uint16_t cellId, uint16_t rnti,
                       double rsrp, double sinr)
 {
-  NS_LOG_FUNCTION (phyStats << path);
-  uint64_t imsi = 0;
-  std::string pathUePhy  = path.substr (0, path.find ("/ReportCurrentCellRsrpSinr"));
-  if (phyStats->ExistsImsiPath (pathUePhy) == true)
-    {
-      imsi = phyStats->GetImsiPath (pathUePhy);
-    }
-  else
-    {
-      imsi = FindImsiFromUePhy (pathUePhy);
-      phyStats->SetImsiPath (pathUePhy, imsi);
-    }
-
+  NS_LOG_FUNCTION (phyStats << imsi << cellId << rnti);
   phyStats->ReportCurrentCellRsrpSinr (cellId, imsi, rnti, rsrp,sinr);
 }
 
 void
-PhyStatsCalculator::ReportUeSinr (Ptr<PhyStatsCalculator> phyStats, std::string path,
+PhyStatsCalculator::ReportUeSinr (Ptr<PhyStatsCalculator> phyStats,
               uint16_t cellId, uint16_t rnti, double sinrLinear)
 {
-  NS_LOG_FUNCTION (phyStats << path);
-
-  uint64_t imsi = 0;
-  std::ostringstream pathAndRnti;
-  pathAndRnti << path << "/" << rnti;
-  std::string pathEnbMac  = path.substr (0, path.find ("LteEnbPhy/ReportUeSinr"));
-  pathEnbMac += "LteEnbMac/DlScheduling";
-  if (phyStats->ExistsImsiPath (pathAndRnti.str ()) == true)
-    {
-      imsi = phyStats->GetImsiPath (pathAndRnti.str ());
-    }
-  else
-    {
-      imsi = FindImsiFromEnbMac (pathEnbMac, rnti);
-      phyStats->SetImsiPath (pathAndRnti.str (), imsi);
-    }
-
+  NS_LOG_FUNCTION (phyStats << cellId << rnti);
+  uint64_t imsi = phyStats->GetImsi (cellId, rnti);
   phyStats->ReportUeSinr (cellId, imsi, rnti, sinrLinear);
 }
 
 void
-PhyStatsCalculator::ReportInterference (Ptr<PhyStatsCalculator> phyStats, std::string path,
+PhyStatsCalculator::ReportInterference (Ptr<PhyStatsCalculator> phyStats,
                     uint16_t cellId, Ptr<SpectrumValue> interference)
 {
-  NS_LOG_FUNCTION (phyStats << path);
+  NS_LOG_FUNCTION (phyStats << cellId);
   phyStats->ReportInterference (cellId, interference);
 }
 
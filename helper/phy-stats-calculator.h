@@ -22,6 +22,7 @@
 #define PHY_STATS_CALCULATOR_H_
 
 #include "ns3/lte-stats-calculator.h"
+#include "ns3/lte-stats-writer.h"
 #include "ns3/nstime.h"
 #include "ns3/uinteger.h"
 #include "ns3/spectrum-value.h"
@@ -71,6 +72,7 @@ public:
    *  @return The object TypeId.
    */
   static TypeId GetTypeId (void);
+  void DoDispose ();
 
   /**
    * Set the name of the file where the RSRP/SINR statistics will be stored.
@@ -141,64 +143,58 @@ public:
    * trace sink
    * 
    * \param phyStats 
-   * \param path 
+   * \param imsi the IMSI of the UE
    * \param cellId 
    * \param rnti 
    * \param rsrp 
    * \param sinr 
    */
   static void ReportCurrentCellRsrpSinrCallback (Ptr<PhyStatsCalculator> phyStats,
-                                          std::string path, uint16_t cellId, uint16_t rnti,
+                                          uint64_t imsi, uint16_t cellId, uint16_t rnti,
                                           double rsrp, double sinr);
   
   /** 
    * trace sink
    * 
    * \param phyStats 
-   * \param path 
    * \param cellId 
    * \param rnti 
    * \param sinrLinear 
    */
-  static void ReportUeSinr (Ptr<PhyStatsCalculator> phyStats, std::string path,
+  static void ReportUeSinr (Ptr<PhyStatsCalculator> phyStats,
                      uint16_t cellId, uint16_t rnti, double sinrLinear);
 
   /** 
    * trace sink
    * 
    * \param phyStats 
-   * \param path 
    * \param cellId 
    * \param interference 
    */
-  static void ReportInterference (Ptr<PhyStatsCalculator> phyStats, std::string path,
+  static void ReportInterference (Ptr<PhyStatsCalculator> phyStats,
                            uint16_t cellId, Ptr<SpectrumValue> interference);
 
 
 private:
   /**
-   * When writing RSRP SINR statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Writer of the RSRP/SINR statistics, which opens the output file
+   * upon the first write
    */
-  bool m_RsrpSinrFirstWrite;
+  Ptr<LteStatsWriter> m_rsrpSinrWriter;
 
   /**
-   * When writing UE SINR statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Writer of the UE SINR statistics, which opens the output file
+   * upon the first write
    */
-  bool m_UeSinrFirstWrite;
+  Ptr<LteStatsWriter> m_ueSinrWriter;
 
   /**
-   * When writing interference statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Writer of the interference statistics, which opens the output file
+   * upon the first write. The interference is written as text whatever
+   * the format of the other statistics, since the number of RBs is not
+   * known beforehand.
    */
-  bool m_InterferenceFirstWrite;
+  Ptr<LteStatsWriter> m_interferenceWriter;
 
   /**
    * Name of the file where the RSRP/SINR statistics will be saved
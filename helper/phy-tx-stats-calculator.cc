@@ -32,8 +32,6 @@ NS_LOG_COMPONENT_DEFINE ("PhyTxStatsCalculator");
 NS_OBJECT_ENSURE_REGISTERED (PhyTxStatsCalculator);
 
 PhyTxStatsCalculator::PhyTxStatsCalculator ()
-  : m_dlTxFirstWrite (true),
-    m_ulTxFirstWrite (true)
 {
   NS_LOG_FUNCTION (this);
 
@@ -44,6 +42,21 @@ PhyTxStatsCalculator::~PhyTxStatsCalculator ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+PhyTxStatsCalculator::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_dlTxWriter != 0)
+    {
+      m_dlTxWriter->Close ();
+    }
+  if (m_ulTxWriter != 0)
+    {
+      m_ulTxWriter->Close ();
+    }
+  LteStatsCalculator::DoDispose ();
+}
+
 TypeId
 PhyTxStatsCalculator::GetTypeId (void)
 {
@@ -95,42 +108,32 @@ PhyTxStatsCalculator::DlPhyTransmission (PhyTransmissionStatParameters params)
   NS_LOG_FUNCTION (this << params.m_cellId << params.m_imsi << params.m_timestamp << params.m_rnti << params.m_layer << params.m_mcs << params.m_size << params.m_rv << params.m_ndi);
   NS_LOG_INFO ("Write DL Tx Phy Stats in " << GetDlTxOutputFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_dlTxFirstWrite == true )
+  if (m_dlTxWriter == 0)
     {
-      outFile.open (GetDlOutputFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetDlTxOutputFilename ().c_str ());
-          return;
-        }
-      m_dlTxFirstWrite = false;
-      //outFile << "% time\tcellId\tIMSI\tRNTI\tlayer\tmcs\tsize\trv\tndi"; // txMode is not available at dl tx side
-      outFile << "% time\tcellId\tIMSI\tRNTI\tlayer\tmcs\tsize\trv\tndi";
-      outFile << std::endl;
-    }
-  else
-    {
-      outFile.open (GetDlTxOutputFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetDlTxOutputFilename ().c_str ());
-          return;
-        }
+      m_dlTxWriter = CreateObject<LteStatsWriter> ();
+      m_dlTxWriter->AddColumn ("time", LteStatsWriter::UINT64);
+      m_dlTxWriter->AddColumn ("cellId", LteStatsWriter::UINT16);
+      m_dlTxWriter->AddColumn ("IMSI", LteStatsWriter::UINT64);
+      m_dlTxWriter->AddColumn ("RNTI", LteStatsWriter::UINT16);
+      m_dlTxWriter->AddColumn ("layer", LteStatsWriter::UINT8);
+      m_dlTxWriter->AddColumn ("mcs", LteStatsWriter::UINT8);
+      m_dlTxWriter->AddColumn ("size", LteStatsWriter::UINT16);
+      m_dlTxWriter->AddColumn ("rv", LteStatsWriter::UINT8);
+      m_dlTxWriter->AddColumn ("ndi", LteStatsWriter::UINT8);
+      m_dlTxWriter->Open (GetDlTxOutputFilename ());
     }
 
-//   outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
-  outFile << params.m_timestamp << "\t";
-  outFile << (uint32_t) params.m_cellId << "\t";
-  outFile << params.m_imsi << "\t";
-  outFile << params.m_rnti << "\t";
-  //outFile << (uint32_t) params.m_txMode << "\t"; // txMode is not available at dl tx side
-  outFile << (uint32_t) params.m_layer << "\t";
-  outFile << (uint32_t) params.m_mcs << "\t";
-  outFile << params.m_size << "\t";
-  outFile << (uint32_t) params.m_rv << "\t";
-  outFile << (uint32_t) params.m_ndi << std::endl;
-  outFile.close ();
+  m_dlTxWriter->StartBatch (Simulator::Now ().GetTimeStep ());
+  m_dlTxWriter->WriteUint (params.m_timestamp);
+  m_dlTxWriter->WriteUint (params.m_cellId);
+  m_dlTxWriter->WriteUint (params.m_imsi);
+  m_dlTxWriter->WriteUint (params.m_rnti);
+  m_dlTxWriter->WriteUint (params.m_layer);
+  m_dlTxWriter->WriteUint (params.m_mcs);
+  m_dlTxWriter->WriteUint (params.m_size);
+  m_dlTxWriter->WriteUint (params.m_rv);
+  m_dlTxWriter->WriteUint (params.m_ndi);
+  m_dlTxWriter->EndRow ();
 }
 
 void
@@ -139,84 +142,48 @@ PhyTxStatsCalculator::UlPhyTransmission (PhyTransmissionStatParameters params)
   NS_LOG_FUNCTION (this << params.m_cellId << params.m_imsi << params.m_timestamp << params.m_rnti << params.m_layer << params.m_mcs << params.m_size << params.m_rv << params.m_ndi);
   NS_LOG_INFO ("Write UL Tx Phy Stats in " << GetUlTxOutputFilename ().c_str ());
 
-  std::ofstream outFile;
-  if ( m_ulTxFirstWrite == true )
-    {
-      outFile.open (GetUlTxOutputFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetUlTxOutputFilename ().c_str ());
-          return;
-        }
-      m_ulTxFirstWrite = false;
-//       outFile << "% time\tcellId\tIMSI\tRNTI\ttxMode\tlayer\tmcs\tsize\trv\tndi";
-      outFile << "% time\tcellId\tIMSI\tRNTI\tlayer\tmcs\tsize\trv\tndi";
-      outFile << std::endl;
-    }
-  else
+  if (m_ulTxWriter == 0)
     {
-      outFile.open (GetUlTxOutputFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetUlTxOutputFilename ().c_str ());
-          return;
-        }
+      m_ulTxWriter = CreateObject<LteStatsWriter> ();
+      m_ulTxWriter->AddColumn ("time", LteStatsWriter::UINT64);
+      m_ulTxWriter->AddColumn ("cellId", LteStatsWriter::UINT16);
+      m_ulTxWriter->AddColumn ("IMSI", LteStatsWriter::UINT64);
+      m_ulTxWriter->AddColumn ("RNTI", LteStatsWriter::UINT16);
+      m_ulTxWriter->AddColumn ("layer", LteStatsWriter::UINT8);
+      m_ulTxWriter->AddColumn ("mcs", LteStatsWriter::UINT8);
+      m_ulTxWriter->AddColumn ("size", LteStatsWriter::UINT16);
+      m_ulTxWriter->AddColumn ("rv", LteStatsWriter::UINT8);
+      m_ulTxWriter->AddColumn ("ndi", LteStatsWriter::UINT8);
+      m_ulTxWriter->Open (GetUlTxOutputFilename ());
     }
 
-//   outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
-  outFile << params.m_timestamp << "\t";
-  outFile << (uint32_t) params.m_cellId << "\t";
-  outFile << params.m_imsi << "\t";
-  outFile << params.m_rnti << "\t";
-  //outFile << (uint32_t) params.m_txMode << "\t";
-  outFile << (uint32_t) params.m_layer << "\t";
-  outFile << (uint32_t) params.m_mcs << "\t";
-  outFile << params.m_size << "\t";
-  outFile << (uint32_t) params.m_rv << "\t";
-  outFile << (uint32_t) params.m_ndi << std::endl;
-  outFile.close ();
+  m_ulTxWriter->StartBatch (Simulator::Now ().GetTimeStep ());
+  m_ulTxWriter->WriteUint (params.m_timestamp);
+  m_ulTxWriter->WriteUint (params.m_cellId);
+  m_ulTxWriter->WriteUint (params.m_imsi);
+  m_ulTxWriter->WriteUint (params.m_rnti);
+  m_ulTxWriter->WriteUint (params.m_layer);
+  m_ulTxWriter->WriteUint (params.m_mcs);
+  m_ulTxWriter->WriteUint (params.m_size);
+  m_ulTxWriter->WriteUint (params.m_rv);
+  m_ulTxWriter->WriteUint (params.m_ndi);
+  m_ulTxWriter->EndRow ();
 }
 
 void
 PhyTxStatsCalculator::DlPhyTransmissionCallback (Ptr<PhyTxStatsCalculator> phyTxStats,
-                      std::string path, PhyTransmissionStatParameters params)
+                      PhyTransmissionStatParameters params)
 {
-  NS_LOG_FUNCTION (phyTxStats << path);
-  uint64_t imsi = 0;
-  std::ostringstream pathAndRnti;
-  pathAndRnti << path << "/" << params.m_rnti;
-  if (phyTxStats->ExistsImsiPath (pathAndRnti.str ()) == true)
-    {
-      imsi = phyTxStats->GetImsiPath (pathAndRnti.str ());
-    }
-  else
-    {
-      imsi = FindImsiForEnb (path, params.m_rnti);
-      phyTxStats->SetImsiPath (pathAndRnti.str (), imsi);
-    }
-
-  params.m_imsi = imsi;
+  NS_LOG_FUNCTION (phyTxStats << params.m_cellId << params.m_rnti);
+  params.m_imsi = phyTxStats->GetImsi (params.m_cellId, params.m_rnti);
   phyTxStats->DlPhyTransmission (params);
 }
 
 void
 PhyTxStatsCalculator::UlPhyTransmissionCallback (Ptr<PhyTxStatsCalculator> phyTxStats,
-                      std::string path, PhyTransmissionStatParameters params)
+                      uint64_t imsi, PhyTransmissionStatParameters params)
 {
-  NS_LOG_FUNCTION (phyTxStats << path);
-  uint64_t imsi = 0;
-  std::ostringstream pathAndRnti;
-  pathAndRnti << path << "/" << params.m_rnti;
-  if (phyTxStats->ExistsImsiPath (pathAndRnti.str ()) == true)
-    {
-      imsi = phyTxStats->GetImsiPath (pathAndRnti.str ());
-    }
-  else
-    {
-      imsi = FindImsiForUe (path, params.m_rnti);
-      phyTxStats->SetImsiPath (pathAndRnti.str (), imsi);
-    }
-
+  NS_LOG_FUNCTION (phyTxStats << imsi << params.m_rnti);
   params.m_imsi = imsi;
   phyTxStats->UlPhyTransmission (params);
 }
@@ -24,6 +24,7 @@
 #define PHY_TX_STATS_CALCULATOR_H_
 
 #include "ns3/lte-stats-calculator.h"
+#include "ns3/lte-stats-writer.h"
 #include "ns3/nstime.h"
 #include "ns3/uinteger.h"
 #include <string>
@@ -66,6 +67,7 @@ public:
    *  \return The object TypeId.
    */
   static TypeId GetTypeId (void);
+  void DoDispose ();
 
   /**
    * Set the name of the file where the UL Tx PHY statistics will be stored.
@@ -110,38 +112,33 @@ public:
    * trace sink
    * 
    * \param phyTxStats 
-   * \param path 
    * \param params 
    */
   static void DlPhyTransmissionCallback (Ptr<PhyTxStatsCalculator> phyTxStats,
-                                  std::string path, PhyTransmissionStatParameters params);
+                                  PhyTransmissionStatParameters params);
 
   /** 
    * trace sink
    * 
    * \param phyTxStats 
-   * \param path 
+   * \param imsi the IMSI of the transmitting UE
    * \param params 
    */
   static void UlPhyTransmissionCallback (Ptr<PhyTxStatsCalculator> phyTxStats,
-                                  std::string path, PhyTransmissionStatParameters params);
+                                  uint64_t imsi, PhyTransmissionStatParameters params);
 
 private:
   /**
-   * When writing DL TX PHY statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Writer of the DL TX PHY statistics, which opens the output file
+   * upon the first write
    */
-  bool m_dlTxFirstWrite;
+  Ptr<LteStatsWriter> m_dlTxWriter;
 
   /**
-   * When writing UL TX PHY statistics first time to file,
-   * columns description is added. Then next lines are
-   * appended to file. This value is true if output
-   * files have not been opened yet
+   * Writer of the UL TX PHY statistics, which opens the output file
+   * upon the first write
    */
-  bool m_ulTxFirstWrite;
+  Ptr<LteStatsWriter> m_ulTxWriter;
 
 };
 
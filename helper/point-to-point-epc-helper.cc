@@ -231,6 +231,7 @@ PointToPointEpcHelper::AddEnb (Ptr<Node> enb, Ptr<NetDevice> lteEnbNetDevice, ui
   NS_LOG_INFO ("connect S1-AP interface");
   m_mme->AddEnb (cellId, enbAddress, enbApp->GetS1apSapEnb ());
   m_sgwPgwApp->AddEnb (cellId, enbAddress, sgwAddress);
+  m_sgwPgwApp->SetS1uDevice (enbAddress, sgwAddress, sgwDev);
   enbApp->SetS1apSapMme (m_mme->GetS1apSapMme ());
 }
 
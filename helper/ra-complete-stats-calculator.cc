@@ -4,6 +4,7 @@
 #include "ns3/string.h"
 #include "ns3/nstime.h"
 #include "ns3/simulator.h"
+#include "ns3/boolean.h"
 #include <ns3/log.h>
 #include <map>
 #include <fstream>
@@ -16,8 +17,10 @@ NS_LOG_COMPONENT_DEFINE ("RaCompleteStatsCalculator");
 NS_OBJECT_ENSURE_REGISTERED ( RaCompleteStatsCalculator);
 
 RaCompleteStatsCalculator::RaCompleteStatsCalculator ()
-  : m_firstWriteImsiTime (true),
-    m_pendingOutput (false) 
+  : m_logEvents (false),
+    m_delayBinWidth (MilliSeconds (1)),
+    m_delayBins (100),
+    m_pendingOutput (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -50,6 +53,33 @@ RaCompleteStatsCalculator::GetTypeId (void)
                    StringValue ("RaCompleted.txt"),
                    MakeStringAccessor (&RaCompleteStatsCalculator::SetRachDelayFilename),
                    MakeStringChecker ())
+    .AddAttribute ("LogEvents",
+                   "If true, the access delay of every UE is logged in RachDelayFilename, "
+                   "otherwise only the KPIs per cell are written.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RaCompleteStatsCalculator::m_logEvents),
+                   MakeBooleanChecker ())
+    .AddAttribute ("KpiFilename",
+                   "Name of the file where the KPIs of the random access of each cell will be logged.",
+                   StringValue ("RaCompleteKpi.txt"),
+                   MakeStringAccessor (&RaCompleteStatsCalculator::m_kpiFilename),
+                   MakeStringChecker ())
+    .AddAttribute ("DelayHistogramFilename",
+                   "Name of the file where the histograms of the access delay of each cell will be logged.",
+                   StringValue ("RaDelayHistogram.txt"),
+                   MakeStringAccessor (&RaCompleteStatsCalculator::m_delayHistogramFilename),
+                   MakeStringChecker ())
+    .AddAttribute ("DelayBinWidth",
+                   "Width of the bins of the access delay histograms.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&RaCompleteStatsCalculator::m_delayBinWidth),
+                   MakeTimeChecker ())
+    .AddAttribute ("DelayBins",
+                   "Number of bins of the access delay histograms, the last one "
+                   "counting all the larger delays.",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&RaCompleteStatsCalculator::m_delayBins),
+                   MakeUintegerChecker<uint32_t> (1))
   ;
   return tid;
 }
@@ -62,6 +92,15 @@ RaCompleteStatsCalculator::DoDispose ()
     {
       ShowResults ();
     }
+  if (m_writer != 0)
+    {
+      m_writer->Close ();
+    }
+  if (m_kpiWriter != 0)
+    {
+      m_kpiWriter->Close ();
+      m_histogramWriter->Close ();
+    }
 }
 
 
@@ -103,28 +142,61 @@ RaCompleteStatsCalculator::GetEpoch () const
   return m_epochDuration;  
 }
 
+RaCompleteKpi_t::RaCompleteKpi_t (double binWidth, uint32_t nBins)
+  : m_active (false),
+    m_preambleTx (0),
+    m_rarRx (0),
+    m_msg4Rx (0),
+    m_accessDelay (binWidth, nBins)
+{
+}
+
+RaCompleteKpi_t&
+RaCompleteStatsCalculator::GetOrCreateKpi (uint16_t cellId)
+{
+	if (cellId >= m_kpiByCellId.size ())
+	{
+		m_kpiByCellId.resize (cellId + 1, RaCompleteKpi_t (m_delayBinWidth.GetSeconds (), m_delayBins));
+	}
+	RaCompleteKpi_t& kpi = m_kpiByCellId[cellId];
+	kpi.m_active = true;
+	return kpi;
+}
+
+const RaCompleteKpi_t&
+RaCompleteStatsCalculator::GetKpi (uint16_t cellId) const
+{
+	if (cellId >= m_kpiByCellId.size ())
+	{
+		// a cell not seen yet: no random access, without growing the table
+		static const RaCompleteKpi_t emptyKpi (0.001, 1);
+		return emptyKpi;
+	}
+	return m_kpiByCellId[cellId];
+}
+
 void
 RaCompleteStatsCalculator::StorePreambleTx(uint64_t imsi, uint16_t cellId, uint16_t rnti)
 {
-	//NS_LOG_ERROR("StorePreambleTx");
-	// this method will store every tx attempt on prach for each imsi
-	ImsiRntiCidTimeInfo_t info;
-	info.m_time = Simulator::Now();
-	info.m_imsi = imsi;
-	info.m_cellId = cellId;
-	info.m_rnti = rnti; // probably useless
-	ImsiInfoMap_t::iterator it = m_preambleTxEvents.find(imsi);
-	if (it == m_preambleTxEvents.end())
+	NS_LOG_FUNCTION (this << imsi << cellId << rnti);
+	++GetOrCreateKpi (cellId).m_preambleTx;
+
+	// the access delay starts with the first preamble sent to the cell;
+	// a preamble sent to another cell starts a new random access
+	PendingAccessMap_t::iterator it = m_pendingAccesses.find (imsi);
+	if (it == m_pendingAccesses.end ())
 	{
-		ImsiRntiCidTimeInfoList_t list;
-		list.push_back(info);
-		m_preambleTxEvents[imsi] = list;
+		PendingAccessInfo_t info;
+		info.m_cellId = cellId;
+		info.m_firstPreambleTx = Simulator::Now ();
+		m_pendingAccesses.insert (std::pair<uint64_t, PendingAccessInfo_t> (imsi, info));
 	}
-	else
+	else if (it->second.m_cellId != cellId)
 	{
-		it->second.push_back(info);
+		it->second.m_cellId = cellId;
+		it->second.m_firstPreambleTx = Simulator::Now ();
 	}
-	//NS_LOG_ERROR("StorePreambleTx for imsi " << imsi << " at time " << Simulator::Now().GetSeconds());
+	m_pendingOutput = true;
 }
 
 void
@@ -136,94 +208,55 @@ RaCompleteStatsCalculator::StorePreambleTx (Ptr<RaCompleteStatsCalculator> raSta
 }
 
 void
-RaCompleteStatsCalculator::StoreMsg3Tx(uint64_t imsi, uint16_t cellId, uint16_t rnti)
+RaCompleteStatsCalculator::StoreMsg3Tx(uint64_t imsi)
 {
-	// this method will store every tx attempt of msg3 for each imsi
-	ImsiRntiCidTimeInfo_t info;
-	info.m_time = Simulator::Now();
-	info.m_imsi = imsi;
-	info.m_cellId = cellId;
-	info.m_rnti = rnti; // probably useless
-	ImsiInfoMap_t::iterator it = m_msg3TxEvents.find(imsi);
-	if (it == m_msg3TxEvents.end())
+	NS_LOG_FUNCTION (this << imsi);
+	// the MAC trace does not tell the cell, which is the one of the
+	// random access in progress
+	PendingAccessMap_t::iterator it = m_pendingAccesses.find (imsi);
+	if (it == m_pendingAccesses.end ())
 	{
-		ImsiRntiCidTimeInfoList_t list;
-		list.push_back(info);
-		m_msg3TxEvents[imsi] = list;
-	}
-	else
-	{
-		it->second.push_back(info);
+		NS_LOG_WARN ("msg3 of IMSI " << imsi << " without preamble");
+		return;
 	}
+	++GetOrCreateKpi (it->second.m_cellId).m_rarRx;
+	m_pendingOutput = true;
 }
 
 void
 RaCompleteStatsCalculator::StoreMsg3Tx (Ptr<RaCompleteStatsCalculator> raStats, std::string path,
-                           uint64_t imsi, uint16_t cellId, uint16_t rnti)
+                           uint64_t imsi)
 {
 	NS_LOG_FUNCTION (raStats << path);
-  	raStats->StoreMsg3Tx (imsi, cellId, rnti);
+  	raStats->StoreMsg3Tx (imsi);
 }
 
 void
 RaCompleteStatsCalculator::StoreMsg4Rx(uint64_t imsi, uint16_t cellId, uint16_t rnti)
 {
-	//NS_LOG_ERROR("StoreMsg4Rx for imsi " << imsi << " at time " << Simulator::Now().GetSeconds());
-	// this method will store every tx attempt on prach for each imsi
-	ImsiRntiCidTimeInfo_t info;
-	info.m_time = Simulator::Now();
-	info.m_imsi = imsi;
-	info.m_cellId = cellId;
-	info.m_rnti = rnti;
-	ImsiInfoMap_t::iterator it = m_msg4RxEvents.find(imsi);
-	if (it == m_msg4RxEvents.end())
+	NS_LOG_FUNCTION (this << imsi << cellId << rnti);
+	PendingAccessMap_t::iterator it = m_pendingAccesses.find (imsi);
+	if (it == m_pendingAccesses.end () || it->second.m_cellId != cellId)
 	{
-		ImsiRntiCidTimeInfoList_t list;
-		list.push_back(info);
-		m_msg4RxEvents[imsi] = list;
+		NS_LOG_WARN ("msg4 of IMSI " << imsi << " in cell " << cellId << " without preamble");
+		return;
 	}
-	else
+	Time delay = Simulator::Now () - it->second.m_firstPreambleTx;
+	m_pendingAccesses.erase (it);
+
+	RaCompleteKpi_t& kpi = GetOrCreateKpi (cellId);
+	++kpi.m_msg4Rx;
+	kpi.m_accessDelay.Add (delay.GetNanoSeconds () / 1.0e9);
+
+	if (m_logEvents)
 	{
-		it->second.push_back(info);
+		ImsiRntiCidTimeInfo_t imsiDlInfo;
+		imsiDlInfo.m_imsi = imsi;
+		imsiDlInfo.m_time = delay;
+		imsiDlInfo.m_cellId = cellId;
+		imsiDlInfo.m_rnti = rnti;
+		m_imsiDelayMap.insert(std::pair<uint64_t, ImsiRntiCidTimeInfo_t> (imsi, imsiDlInfo));
 	}
-
-	// compute total delay
-	ImsiInfoMap_t::iterator preambleTxIterator = m_preambleTxEvents.find(imsi);
-	NS_ASSERT_MSG(preambleTxIterator != m_preambleTxEvents.end(), "Imsi never inserted");
-	preambleTxIterator->second.sort();
-	//NS_LOG_ERROR("Sorted, get list iterator");
-	//NS_LOG_ERROR("Size of preambleTxIterator associated list " << preambleTxIterator->second.size());
-
-	ImsiRntiCidTimeInfoList_t::iterator listIterator = preambleTxIterator->second.begin();
-	while(listIterator->m_cellId != cellId) // get the first preamble tx for this cellId
-		{
-			listIterator++;	
-			//NS_LOG_ERROR("listIterator " << listIterator->m_time.GetSeconds());
-		}
-	Time delay = Simulator::Now() - listIterator->m_time;
-	NS_ASSERT_MSG(listIterator != preambleTxIterator->second.end(), "CellId for this imsi not found");
-	//NS_LOG_ERROR("Delay computed " << delay.GetSeconds());
-	// delete all other entries related to this (imsi, cellId) pair
-	listIterator = preambleTxIterator->second.begin(); 
-	while(listIterator != preambleTxIterator->second.end())
-		{
-			//NS_LOG_ERROR("Cid " << listIterator->m_cellId << " imsi " << listIterator->m_imsi << " time " << listIterator->m_time.GetSeconds());
-			if (listIterator->m_cellId == cellId)
-				{
-					listIterator = preambleTxIterator->second.erase(listIterator);
-				}
-			else
-				{
-					++listIterator;
-				}	
-		}
-
-	ImsiRntiCidTimeInfo_t imsiDlInfo;
-	imsiDlInfo.m_imsi = imsi;
-	imsiDlInfo.m_time = delay;
-	imsiDlInfo.m_cellId = cellId;
-	imsiDlInfo.m_rnti = rnti;
-	m_imsiDelayMap.insert(std::pair<uint64_t, ImsiRntiCidTimeInfo_t> (imsi, imsiDlInfo));
 	m_pendingOutput = true;
 }
 
@@ -239,51 +272,108 @@ void
 RaCompleteStatsCalculator::ShowResults (void)
 {
 	//NS_LOG_ERROR (this << GetRachDelayFilename ().c_str ());
-	std::ofstream outFile;
-
-	if (m_firstWriteImsiTime == true)
+	if (m_logEvents && m_writer == 0)
 	{
-	  outFile.open (GetRachDelayFilename ().c_str ());
-	  if (!outFile.is_open ())
-	    {
-	      NS_LOG_ERROR ("Can't open file " << GetRachDelayFilename ().c_str ());
-	      return;
-	    }
-
-	  m_firstWriteImsiTime = false;
-	  outFile << "wt\tIMSI\tcellId\tdelay";
-	  outFile << std::endl;
+	  m_writer = CreateObject<LteStatsWriter> ();
+	  m_writer->AddColumn ("wt", LteStatsWriter::DOUBLE);
+	  m_writer->AddColumn ("IMSI", LteStatsWriter::UINT64);
+	  m_writer->AddColumn ("cellId", LteStatsWriter::UINT16);
+	  m_writer->AddColumn ("delay", LteStatsWriter::DOUBLE);
+	  m_writer->Open (GetRachDelayFilename (), "wt\tIMSI\tcellId\tdelay");
 	}
-	else
+	if (m_kpiWriter == 0)
 	{
-	  outFile.open (GetRachDelayFilename ().c_str (),  std::ios_base::app);
-	  if (!outFile.is_open ())
-	    {
-	      NS_LOG_ERROR ("Can't open file " << GetRachDelayFilename ().c_str ());
-	      return;
-	    }
+	  m_kpiWriter = CreateObject<LteStatsWriter> ();
+	  m_kpiWriter->AddColumn ("time", LteStatsWriter::DOUBLE, 3);
+	  m_kpiWriter->AddColumn ("cellId", LteStatsWriter::UINT16);
+	  m_kpiWriter->AddColumn ("preambleTx", LteStatsWriter::UINT64);
+	  m_kpiWriter->AddColumn ("rarRx", LteStatsWriter::UINT64);
+	  m_kpiWriter->AddColumn ("msg4Rx", LteStatsWriter::UINT64);
+	  m_kpiWriter->AddColumn ("mean", LteStatsWriter::DOUBLE, 6);
+	  m_kpiWriter->AddColumn ("p50", LteStatsWriter::DOUBLE, 6);
+	  m_kpiWriter->AddColumn ("p95", LteStatsWriter::DOUBLE, 6);
+	  m_kpiWriter->AddColumn ("p99", LteStatsWriter::DOUBLE, 6);
+	  m_kpiWriter->AddColumn ("max", LteStatsWriter::DOUBLE, 6);
+	  m_kpiWriter->Open (m_kpiFilename);
+
+	  m_histogramWriter = CreateObject<LteStatsWriter> ();
+	  m_histogramWriter->AddColumn ("time", LteStatsWriter::DOUBLE, 3);
+	  m_histogramWriter->AddColumn ("cellId", LteStatsWriter::UINT16);
+	  m_histogramWriter->AddColumn ("delay", LteStatsWriter::DOUBLE, 6);
+	  m_histogramWriter->AddColumn ("count", LteStatsWriter::UINT64);
+	  m_histogramWriter->Open (m_delayHistogramFilename);
 	}
 
-	WriteResults (outFile);
+	if (m_logEvents)
+	{
+	  WriteResults ();
+	}
+	WriteKpis ();
 	m_pendingOutput = false;
 }
 
 
 void
-RaCompleteStatsCalculator::WriteResults (std::ofstream& outFile)
+RaCompleteStatsCalculator::WriteResults (void)
 {
 	double wt = Simulator::Now().GetSeconds();
 	//NS_LOG_ERROR (this << "Write results");
 	for (ImsiDelayMap_t::iterator it = m_imsiDelayMap.begin (); it != m_imsiDelayMap.end (); ++it)
 	{
-	  outFile << wt << "\t";
-	  outFile << it->first << "\t";
-	  outFile << it->second.m_cellId << "\t";
-	  outFile << it->second.m_time.GetNanoSeconds() / 1.0e9;
-	  outFile << std::endl;
+	  m_writer->WriteDouble (wt);
+	  m_writer->WriteUint (it->first);
+	  m_writer->WriteUint (it->second.m_cellId);
+	  m_writer->WriteDouble (it->second.m_time.GetNanoSeconds() / 1.0e9);
+	  m_writer->EndRow ();
 	}
+}
 
-	outFile.close ();
+void
+RaCompleteStatsCalculator::WriteKpis (void)
+{
+	double time = Simulator::Now ().GetSeconds ();
+	for (uint16_t cellId = 0; cellId < m_kpiByCellId.size (); ++cellId)
+	{
+	  const RaCompleteKpi_t& kpi = m_kpiByCellId[cellId];
+	  if (!kpi.m_active)
+	    {
+	      continue;
+	    }
+	  const LteDelayDistribution& delay = kpi.m_accessDelay;
+	  m_kpiWriter->WriteDouble (time);
+	  m_kpiWriter->WriteUint (cellId);
+	  m_kpiWriter->WriteUint (kpi.m_preambleTx);
+	  m_kpiWriter->WriteUint (kpi.m_rarRx);
+	  m_kpiWriter->WriteUint (kpi.m_msg4Rx);
+	  if (delay.GetCount () > 0)
+	    {
+	      m_kpiWriter->WriteDouble (delay.GetMean ());
+	      m_kpiWriter->WriteDouble (delay.GetP50 ());
+	      m_kpiWriter->WriteDouble (delay.GetP95 ());
+	      m_kpiWriter->WriteDouble (delay.GetP99 ());
+	      m_kpiWriter->WriteDouble (delay.GetMax ());
+	    }
+	  else
+	    {
+	      for (int i = 0; i < 5; ++i)
+	        {
+	          m_kpiWriter->WriteMissing ();
+	        }
+	    }
+	  m_kpiWriter->EndRow ();
+
+	  for (uint32_t bin = 0; bin < delay.GetNBins (); ++bin)
+	    {
+	      if (delay.GetBinCount (bin) > 0)
+	        {
+	          m_histogramWriter->WriteDouble (time);
+	          m_histogramWriter->WriteUint (cellId);
+	          m_histogramWriter->WriteDouble (bin * delay.GetBinWidth ());
+	          m_histogramWriter->WriteUint (delay.GetBinCount (bin));
+	          m_histogramWriter->EndRow ();
+	        }
+	    }
+	}
 }
 
 void
@@ -291,6 +381,14 @@ RaCompleteStatsCalculator::ResetResults (void)
 {
   NS_LOG_FUNCTION (this);
   m_imsiDelayMap.erase (m_imsiDelayMap.begin (), m_imsiDelayMap.end ());
+  for (uint16_t cellId = 0; cellId < m_kpiByCellId.size (); ++cellId)
+    {
+      RaCompleteKpi_t& kpi = m_kpiByCellId[cellId];
+      kpi.m_preambleTx = 0;
+      kpi.m_rarRx = 0;
+      kpi.m_msg4Rx = 0;
+      kpi.m_accessDelay.Reset ();
+    }
 }
 
 void
@@ -307,6 +405,18 @@ RaCompleteStatsCalculator::EndEpoch (void)
 {
   NS_LOG_FUNCTION (this);
   ShowResults ();
+  if (m_writer != 0)
+    {
+      m_writer->Flush ();
+    }
+  if (m_kpiWriter != 0)
+    {
+      m_kpiWriter->Flush ();
+    }
+  if (m_histogramWriter != 0)
+    {
+      m_histogramWriter->Flush ();
+    }
   ResetResults ();
   m_startTime += m_epochDuration;
   m_endEpochEvent = Simulator::Schedule (m_epochDuration, &RaCompleteStatsCalculator::EndEpoch, this);
@@ -8,8 +8,11 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
+#include "ns3/lte-stats-writer.h"
+#include "ns3/lte-delay-distribution.h"
 #include <string>
 #include <map>
+#include <vector>
 #include <fstream>
 
 namespace ns3 {
@@ -31,11 +34,42 @@ struct ImsiRntiCidTimeInfo_t
 
 };
 
-typedef std::list<ImsiRntiCidTimeInfo_t> ImsiRntiCidTimeInfoList_t;
 typedef std::multimap < uint64_t, ImsiRntiCidTimeInfo_t > ImsiDelayMap_t;
-typedef std::map < uint64_t, ImsiRntiCidTimeInfoList_t > ImsiInfoMap_t;
 
+// Random access of a UE not completed yet
+struct PendingAccessInfo_t
+{
+	uint16_t m_cellId; // the cell of the preambles
+	Time m_firstPreambleTx; // the first preamble sent to this cell
+};
+
+typedef std::map < uint64_t, PendingAccessInfo_t > PendingAccessMap_t;
+
+// KPIs of the random access in a cell during the current epoch
+struct RaCompleteKpi_t
+{
+	RaCompleteKpi_t (double binWidth, uint32_t nBins);
+
+	bool m_active; // true once the cell has been seen
+	uint64_t m_preambleTx; // preambles sent by the UEs
+	uint64_t m_rarRx; // RARs received, i.e. msg3 queued
+	uint64_t m_msg4Rx; // random accesses completed
+	LteDelayDistribution m_accessDelay; // delays of the completed random accesses
+};
 
+/**
+ * Computes the KPIs of the random access procedure seen from the UEs.
+ *
+ * For each cell and each epoch, the number of preambles sent, of RARs
+ * received and of random accesses completed are counted, and the
+ * distribution of the access delay (from the first preamble sent to the
+ * cell to the reception of msg4) is summarized by its mean, maximum,
+ * percentiles and histogram. Only a constant amount of memory is used
+ * per cell, plus the first preamble time of the UEs whose random access
+ * is in progress.
+ *
+ * The access delay of every UE can also be logged, if LogEvents is true.
+ */
 class RaCompleteStatsCalculator : public Object
 {
 public:
@@ -100,7 +134,8 @@ public:
 
 
 	/**
-	* Stores in the event list the tx of a preamble, along with imsi.  
+	* Counts the tx of a preamble and remembers the time of the first
+	* preamble of the random access of the UE.
 	* @param imsi
 	* @param cellId
 	* @param rnti
@@ -120,12 +155,11 @@ public:
                            uint64_t imsi, uint16_t cellId, uint16_t rnti);
 
   	/**
-	* Stores in the event list when a msg3 is queued, along with imsi.  
+	* Counts a msg3 queued, i.e. a RAR received, in the cell of the
+	* random access in progress of the UE.
 	* @param imsi
-	* @param cellId
-	* @param rnti
 	*/
-	void StoreMsg3Tx(uint64_t imsi, uint16_t cellId, uint16_t rnti);
+	void StoreMsg3Tx(uint64_t imsi);
 
 
 	/** 
@@ -134,15 +168,13 @@ public:
 	* \param raStatsCalculator 
 	* \param path
 	* @param imsi
-	* @param cellId
-	* @param rnti
 	*/
   	static void StoreMsg3Tx (Ptr<RaCompleteStatsCalculator> raStats, std::string path,
-                           uint64_t imsi, uint16_t cellId, uint16_t rnti);
+                           uint64_t imsi);
 
 
   	/**
-	* Stores in the event list when a msg4 is received, along with imsi, cellId and rnti.  
+	* Counts the reception of msg4 and accounts for the access delay of the UE.
 	* @param imsi
 	* @param cellId
 	* @param rnti
@@ -165,24 +197,42 @@ public:
 
 
 
+	/**
+	* @param cellId
+	* @return the KPIs of the cell in the current epoch, all zero if the
+	*         cell has not been seen
+	*/
+	const RaCompleteKpi_t& GetKpi (uint16_t cellId) const;
+
 private:
 
+	/**
+	* @param cellId
+	* @return the KPIs of the cell, created if needed
+	*/
+	RaCompleteKpi_t& GetOrCreateKpi (uint16_t cellId);
+
+	/**
+	* Writes the KPIs of the cells to the output files.
+	*/
+	void
+	WriteKpis (void);
+
 	/**
 	* Called after each epoch to write collected
 	* statistics to output files. During first call
 	* it opens output files and write columns descriptions.
-	* During next calls it opens output files in append mode.
+	* The event, KPI and histogram files stay open for the rest of the
+	* simulation, each epoch being flushed by EndEpoch.
 	*/
 	void
 	ShowResults (void);
 
 	/**
-	* Writes collected statistics to output file and
-	* closes output file.
-	* @param outFile ofstream for statistics
+	* Writes collected statistics to output file.
 	*/
 	void
-	WriteResults (std::ofstream& outFile);
+	WriteResults (void);
 
 
 	/**
@@ -206,16 +256,22 @@ private:
 
 
    	std::string m_raCompletedFilename;
+	std::string m_kpiFilename;
+	std::string m_delayHistogramFilename;
+	bool m_logEvents; //!< Whether the delay of every random access is logged
+	Time m_delayBinWidth; //!< Width of the bins of the access delay histograms
+	uint32_t m_delayBins; //!< Number of bins of the access delay histograms
 
 	Time m_startTime;
 	Time m_epochDuration;
 
-	bool m_firstWriteImsiTime;
+	Ptr<LteStatsWriter> m_writer; //!< Writer of the statistics, created upon the first write
+	Ptr<LteStatsWriter> m_kpiWriter; //!< Writer of the KPIs, created upon the first write
+	Ptr<LteStatsWriter> m_histogramWriter; //!< Writer of the delay histograms, created upon the first write
 	bool m_pendingOutput;
 
-	ImsiInfoMap_t m_preambleTxEvents;
-	ImsiInfoMap_t m_msg3TxEvents;
-	ImsiInfoMap_t m_msg4RxEvents;
+	PendingAccessMap_t m_pendingAccesses;
+	std::vector<RaCompleteKpi_t> m_kpiByCellId; //!< KPIs of the cells, indexed by cell ID
 	ImsiDelayMap_t m_imsiDelayMap;
 
   	EventId m_endEpochEvent; //!< Event id for next end epoch event
@@ -16,8 +16,7 @@ NS_LOG_COMPONENT_DEFINE ("RaPreamblePhyStatsCalculator");
 NS_OBJECT_ENSURE_REGISTERED ( RaPreamblePhyStatsCalculator);
 
 RaPreamblePhyStatsCalculator::RaPreamblePhyStatsCalculator ()
-  : m_firstWriteImsiTime (true),
-    m_pendingOutput (false) 
+  : m_pendingOutput (false) 
 {
   NS_LOG_FUNCTION (this);
 }
@@ -62,6 +61,10 @@ RaPreamblePhyStatsCalculator::DoDispose ()
     {
       ShowResults ();
     }
+  if (m_writer != 0)
+    {
+      m_writer->Close ();
+    }
 }
 
 std::string
@@ -132,6 +135,10 @@ RaPreamblePhyStatsCalculator::EndEpoch (void)
 {
   NS_LOG_FUNCTION (this);
   ShowResults ();
+  if (m_writer != 0)
+    {
+      m_writer->Flush ();
+    }
   ResetResults ();
   m_startTime += m_epochDuration;
   m_endEpochEvent = Simulator::Schedule (m_epochDuration, &RaPreamblePhyStatsCalculator::EndEpoch, this);
@@ -150,51 +157,35 @@ RaPreamblePhyStatsCalculator::ShowResults (void)
 	NS_LOG_INFO (this << GetPreambleRxFilename ().c_str ());
 	NS_LOG_DEBUG ("Write Rach Preamble Stats in " << GetPreambleRxFilename ().c_str ());
 
-	std::ofstream outFile;
-
-	if (m_firstWriteImsiTime == true)
-	{
-	  outFile.open (GetPreambleRxFilename ().c_str ());
-	  if (!outFile.is_open ())
-	    {
-	      NS_LOG_ERROR ("Can't open file " << GetPreambleRxFilename ().c_str ());
-	      return;
-	    }
-
-	  m_firstWriteImsiTime = false;
-	  outFile << "% time\tcellId\tIMSI\tcorrect\tdelay";
-	  outFile << std::endl;
-	}
-	else
+	if (m_writer == 0)
 	{
-	  outFile.open (GetPreambleRxFilename ().c_str (),  std::ios_base::app);
-	  if (!outFile.is_open ())
-	    {
-	      NS_LOG_ERROR ("Can't open file " << GetPreambleRxFilename ().c_str ());
-	      return;
-	    }
+	  m_writer = CreateObject<LteStatsWriter> ();
+	  m_writer->AddColumn ("time", LteStatsWriter::DOUBLE);
+	  m_writer->AddColumn ("cellId", LteStatsWriter::UINT16);
+	  m_writer->AddColumn ("IMSI", LteStatsWriter::UINT64);
+	  m_writer->AddColumn ("correct", LteStatsWriter::UINT8);
+	  m_writer->AddColumn ("delay", LteStatsWriter::DOUBLE);
+	  m_writer->Open (GetPreambleRxFilename ());
 	}
 
-	WriteResults (outFile);
+	WriteResults ();
 	m_pendingOutput = false;
 }
 
 
 void
-RaPreamblePhyStatsCalculator::WriteResults (std::ofstream& outFile)
+RaPreamblePhyStatsCalculator::WriteResults (void)
 {
 	NS_LOG_FUNCTION (this << "Write results");
 	for (std::multimap<Time, RxPhyPreambleInfo_t>::iterator it = m_preambleRxEvents.begin (); it != m_preambleRxEvents.end (); ++it)
 	{
-	  outFile << it->first.GetNanoSeconds() / 1.0e9 << "\t";
-	  outFile << it->second.m_cellId << "\t";
-	  outFile << it->second.m_imsi << "\t";
-	  outFile << (uint32_t)it->second.m_correct << "\t";
-    outFile << it->second.m_delay.GetNanoSeconds() / 1.0e9;
-	  outFile << std::endl;
+	  m_writer->WriteDouble (it->first.GetNanoSeconds() / 1.0e9);
+	  m_writer->WriteUint (it->second.m_cellId);
+	  m_writer->WriteUint (it->second.m_imsi);
+	  m_writer->WriteUint (it->second.m_correct);
+	  m_writer->WriteDouble (it->second.m_delay.GetNanoSeconds() / 1.0e9);
+	  m_writer->EndRow ();
 	}
-
-	outFile.close ();
 }
 
 void
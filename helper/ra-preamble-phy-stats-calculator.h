@@ -8,6 +8,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
+#include "ns3/lte-stats-writer.h"
 #include <string>
 #include <map>
 #include <fstream>
@@ -117,18 +118,17 @@ private:
 	* Called after each epoch to write collected
 	* statistics to output files. During first call
 	* it opens output files and write columns descriptions.
-	* During next calls it opens output files in append mode.
+	* The rows of each epoch are flushed by EndEpoch, and the file stays
+	* open until this object is disposed or the simulator is destroyed.
 	*/
 	void
 	ShowResults (void);
 
 	/**
-	* Writes collected statistics to output file and
-	* closes output file.
-	* @param outFile ofstream for statistics
+	* Writes collected statistics to output file.
 	*/
 	void
-	WriteResults (std::ofstream& outFile);
+	WriteResults (void);
 
 
 	/**
@@ -161,7 +161,7 @@ private:
 	Time m_startTime;
 	Time m_epochDuration;
 
-	bool m_firstWriteImsiTime;
+	Ptr<LteStatsWriter> m_writer; //!< Writer of the statistics, created upon the first write
 	bool m_pendingOutput;
 
 	EventListPhy_t m_preambleRxEvents;
@@ -4,9 +4,11 @@
 #include "ns3/string.h"
 #include "ns3/nstime.h"
 #include "ns3/simulator.h"
+#include "ns3/boolean.h"
 #include <ns3/log.h>
 #include <map>
 #include <fstream>
+#include <cstring>
 
 
 namespace ns3 {
@@ -15,9 +17,19 @@ NS_LOG_COMPONENT_DEFINE ("RaPreambleStatsCalculator");
 
 NS_OBJECT_ENSURE_REGISTERED ( RaPreambleStatsCalculator);
 
+RaPreambleKpi_t::RaPreambleKpi_t ()
+  : m_active (false),
+    m_preambleRx (0),
+    m_decodeFailures (0),
+    m_collisions (0),
+    m_lastMacRx (Seconds (-1))
+{
+  std::memset (m_rapIdCount, 0, sizeof (m_rapIdCount));
+}
+
 RaPreambleStatsCalculator::RaPreambleStatsCalculator ()
-  : m_firstWriteImsiTime (true),
-    m_pendingOutput (false) 
+  : m_logEvents (false),
+    m_pendingOutput (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -50,6 +62,17 @@ RaPreambleStatsCalculator::GetTypeId (void)
                    StringValue ("PreambleRxCollisions.txt"),
                    MakeStringAccessor (&RaPreambleStatsCalculator::SetPreambleRxFilename),
                    MakeStringChecker ())
+    .AddAttribute ("LogEvents",
+                   "If true, every preamble received is logged in PreambleRxOutputFilename, "
+                   "otherwise only the KPIs per cell are written.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RaPreambleStatsCalculator::m_logEvents),
+                   MakeBooleanChecker ())
+    .AddAttribute ("KpiFilename",
+                   "Name of the file where the KPIs of the PRACH of each cell will be logged.",
+                   StringValue ("RaPreambleKpi.txt"),
+                   MakeStringAccessor (&RaPreambleStatsCalculator::m_kpiFilename),
+                   MakeStringChecker ())
   ;
   return tid;
 }
@@ -62,6 +85,14 @@ RaPreambleStatsCalculator::DoDispose ()
     {
       ShowResults ();
     }
+  if (m_writer != 0)
+    {
+      m_writer->Close ();
+    }
+  if (m_kpiWriter != 0)
+    {
+      m_kpiWriter->Close ();
+    }
 }
 
 std::string
@@ -102,11 +133,47 @@ RaPreambleStatsCalculator::GetEpoch () const
   return m_epochDuration;  
 }
 
+RaPreambleKpi_t&
+RaPreambleStatsCalculator::GetOrCreateKpi (uint16_t cellId)
+{
+  if (cellId >= m_kpiByCellId.size ())
+    {
+      m_kpiByCellId.resize (cellId + 1);
+    }
+  RaPreambleKpi_t& kpi = m_kpiByCellId[cellId];
+  kpi.m_active = true;
+  return kpi;
+}
+
+const RaPreambleKpi_t&
+RaPreambleStatsCalculator::GetKpi (uint16_t cellId) const
+{
+  if (cellId >= m_kpiByCellId.size ())
+    {
+      // a cell not seen yet: no preamble, without growing the table
+      static const RaPreambleKpi_t emptyKpi;
+      return emptyKpi;
+    }
+  return m_kpiByCellId[cellId];
+}
+
 
 void
 RaPreambleStatsCalculator::StorePreamblePhyRx(PhyReceptionStatParameters params)
 {
   NS_LOG_FUNCTION(this << "StorePreambleRx");
+  RaPreambleKpi_t& kpi = GetOrCreateKpi (params.m_cellId);
+  ++kpi.m_preambleRx;
+  if (params.m_correctness == 0)
+    {
+      ++kpi.m_decodeFailures;
+    }
+  m_pendingOutput = true;
+  if (!m_logEvents)
+    {
+      return;
+    }
+
   Time now = Simulator::Now();
   Time startTime = NanoSeconds(params.m_timestamp);
   uint64_t imsi = params.m_imsi;
@@ -125,10 +192,36 @@ RaPreambleStatsCalculator::StorePreamblePhyRx(PhyReceptionStatParameters params)
 
 
 void
-RaPreambleStatsCalculator::StorePreambleRx(Ptr<RachPreambleLteControlMessage> msg)
+RaPreambleStatsCalculator::StorePreambleRx(uint16_t cellId, Ptr<RachPreambleLteControlMessage> msg)
 {
 	NS_LOG_FUNCTION(this << "StorePreambleRx");
   Time now = Simulator::Now();
+  // all the preambles of a subframe are delivered to the MAC at the
+  // same time: count them per RAPID until the next subframe
+  RaPreambleKpi_t& kpi = GetOrCreateKpi (cellId);
+  if (kpi.m_lastMacRx != now)
+    {
+      std::memset (kpi.m_rapIdCount, 0, sizeof (kpi.m_rapIdCount));
+      kpi.m_lastMacRx = now;
+    }
+  uint32_t rapId = msg->GetRapId ();
+  NS_ASSERT (rapId < 64);
+  uint8_t count = ++kpi.m_rapIdCount[rapId];
+  if (count == 2)
+    {
+      // the first preamble with this RAPID collides as well
+      kpi.m_collisions += 2;
+    }
+  else if (count > 2)
+    {
+      ++kpi.m_collisions;
+    }
+  m_pendingOutput = true;
+  if (!m_logEvents)
+    {
+      return;
+    }
+
 	Time startTime = msg->GetStartTime();
   double delay = (now-startTime).GetNanoSeconds() / 1.0e9;
   RxPreambleInfo_t rxPreambleInfo_t;
@@ -154,6 +247,14 @@ RaPreambleStatsCalculator::EndEpoch (void)
 {
   NS_LOG_FUNCTION (this);
   ShowResults ();
+  if (m_writer != 0)
+    {
+      m_writer->Flush ();
+    }
+  if (m_kpiWriter != 0)
+    {
+      m_kpiWriter->Flush ();
+    }
   ResetResults ();
   m_startTime += m_epochDuration;
   m_endEpochEvent = Simulator::Schedule (m_epochDuration, &RaPreambleStatsCalculator::EndEpoch, this);
@@ -165,44 +266,75 @@ RaPreambleStatsCalculator::ResetResults (void)
   NS_LOG_FUNCTION (this);
   m_preambleRxEvents.erase (m_preambleRxEvents.begin (), m_preambleRxEvents.end ());
   m_preamblePhyRxEvents.erase (m_preamblePhyRxEvents.begin(), m_preamblePhyRxEvents.end());
+  for (uint16_t cellId = 0; cellId < m_kpiByCellId.size (); ++cellId)
+    {
+      RaPreambleKpi_t& kpi = m_kpiByCellId[cellId];
+      kpi.m_preambleRx = 0;
+      kpi.m_decodeFailures = 0;
+      kpi.m_collisions = 0;
+    }
 }
 
 void
 RaPreambleStatsCalculator::ShowResults (void)
 {	//info and dbug
 	NS_LOG_INFO (this << GetPreambleRxFilename ().c_str ());
-	std::ofstream outFile;
-
-	if (m_firstWriteImsiTime == true)
+	if (m_kpiWriter == 0)
+	{
+	  m_kpiWriter = CreateObject<LteStatsWriter> ();
+	  m_kpiWriter->AddColumn ("time", LteStatsWriter::DOUBLE, 3);
+	  m_kpiWriter->AddColumn ("cellId", LteStatsWriter::UINT16);
+	  m_kpiWriter->AddColumn ("preambleRx", LteStatsWriter::UINT64);
+	  m_kpiWriter->AddColumn ("decodeFailures", LteStatsWriter::UINT64);
+	  m_kpiWriter->AddColumn ("collisions", LteStatsWriter::UINT64);
+	  m_kpiWriter->Open (m_kpiFilename);
+	}
+	WriteKpis ();
+	if (!m_logEvents)
 	{
-	  outFile.open (GetPreambleRxFilename ().c_str ());
-	  if (!outFile.is_open ())
-	    {
-	      NS_LOG_ERROR ("Can't open file " << GetPreambleRxFilename ().c_str ());
-	      return;
-	    }
-
-	  m_firstWriteImsiTime = false;
-	  outFile << "% time\tcellId\tIMSI\trxok\trapId\tcoll\tdelay";
-	  outFile << std::endl;
+	  m_pendingOutput = false;
+	  return;
 	}
-	else
+
+	if (m_writer == 0)
 	{
-	  outFile.open (GetPreambleRxFilename ().c_str (),  std::ios_base::app);
-	  if (!outFile.is_open ())
-	    {
-	      NS_LOG_ERROR ("Can't open file " << GetPreambleRxFilename ().c_str ());
-	      return;
-	    }
+	  m_writer = CreateObject<LteStatsWriter> ();
+	  m_writer->AddColumn ("time", LteStatsWriter::DOUBLE, 3);
+	  m_writer->AddColumn ("cellId", LteStatsWriter::UINT16);
+	  m_writer->AddColumn ("IMSI", LteStatsWriter::UINT64);
+	  m_writer->AddColumn ("rxok", LteStatsWriter::UINT8);
+	  m_writer->AddColumn ("rapId", LteStatsWriter::UINT8);
+	  m_writer->AddColumn ("coll", LteStatsWriter::UINT8);
+	  m_writer->AddColumn ("delay", LteStatsWriter::DOUBLE, 6);
+	  m_writer->Open (GetPreambleRxFilename ());
 	}
 
-	WriteResults (outFile);
+	WriteResults ();
 	m_pendingOutput = false;
 }
 
 
 void
-RaPreambleStatsCalculator::WriteResults (std::ofstream& outFile)
+RaPreambleStatsCalculator::WriteKpis (void)
+{
+  double time = Simulator::Now ().GetSeconds ();
+  for (uint16_t cellId = 0; cellId < m_kpiByCellId.size (); ++cellId)
+    {
+      const RaPreambleKpi_t& kpi = m_kpiByCellId[cellId];
+      if (kpi.m_active)
+        {
+          m_kpiWriter->WriteDouble (time);
+          m_kpiWriter->WriteUint (cellId);
+          m_kpiWriter->WriteUint (kpi.m_preambleRx);
+          m_kpiWriter->WriteUint (kpi.m_decodeFailures);
+          m_kpiWriter->WriteUint (kpi.m_collisions);
+          m_kpiWriter->EndRow ();
+        }
+    }
+}
+
+void
+RaPreambleStatsCalculator::WriteResults (void)
 {
   NS_LOG_FUNCTION (this << "Write results");
   // this cycle will find all the preambles received but collided
@@ -238,38 +370,32 @@ RaPreambleStatsCalculator::WriteResults (std::ofstream& outFile)
   for(EventPhyList_t::iterator timeImsiPairIterator = m_preamblePhyRxEvents.begin(); timeImsiPairIterator != m_preamblePhyRxEvents.end();
       ++timeImsiPairIterator)
     {
-      outFile.setf ( std::ios::fixed );
-      outFile.precision(3);         
-      outFile << timeImsiPairIterator->first.first.GetSeconds() << "\t";
-      outFile << timeImsiPairIterator->second.m_cellId << "\t";
-      outFile << timeImsiPairIterator->second.m_imsi << "\t";
-      
-      outFile << (uint32_t)timeImsiPairIterator->second.m_correct << "\t";
+      m_writer->WriteDouble (timeImsiPairIterator->first.first.GetSeconds());
+      m_writer->WriteUint (timeImsiPairIterator->second.m_cellId);
+      m_writer->WriteUint (timeImsiPairIterator->second.m_imsi);
+      m_writer->WriteUint (timeImsiPairIterator->second.m_correct);
 
       if (timeImsiPairIterator->second.m_correct > 0)
         {
-          outFile << timeImsiPairIterator->second.m_rapId << "\t";
-          outFile << (uint32_t)timeImsiPairIterator->second.m_collision << "\t";
+          m_writer->WriteUint (timeImsiPairIterator->second.m_rapId);
+          m_writer->WriteUint (timeImsiPairIterator->second.m_collision);
         } 
       else
         {
-          outFile << "-\t-\t";
+          m_writer->WriteMissing ();
+          m_writer->WriteMissing ();
         }
-      outFile.precision(6);
-      outFile << timeImsiPairIterator->second.m_delay.GetNanoSeconds() / 1.0e9;
-      outFile << std::endl;  
+      m_writer->WriteDouble (timeImsiPairIterator->second.m_delay.GetNanoSeconds() / 1.0e9);
+      m_writer->EndRow ();
     }
-	
-
-	outFile.close ();
 }
 
 void
-RaPreambleStatsCalculator::StorePreambleRx (Ptr<RaPreambleStatsCalculator> raStats, std::string path,
+RaPreambleStatsCalculator::StorePreambleRx (Ptr<RaPreambleStatsCalculator> raStats, uint16_t cellId,
                            Ptr<RachPreambleLteControlMessage> msg)
 {
-	NS_LOG_FUNCTION (raStats << path);
-  	raStats->StorePreambleRx (msg);
+	NS_LOG_FUNCTION (raStats << cellId);
+  	raStats->StorePreambleRx (cellId, msg);
 }
 
 void
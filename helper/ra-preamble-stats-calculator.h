@@ -8,8 +8,10 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
+#include "ns3/lte-stats-writer.h"
 #include <string>
 #include <map>
+#include <vector>
 #include <fstream>
 #include "ns3/lte-control-messages.h"
 #include "ra-preamble-phy-stats-calculator.h"
@@ -29,6 +31,29 @@ typedef std::multimap< Time, RxPreambleInfo_t > EventList_t;
 typedef std::pair< Time, uint64_t > TimeImsiPair_t;
 typedef std::multimap < TimeImsiPair_t, RxPhyPreambleInfo_t > EventPhyList_t;
 
+// KPIs of the preambles received by a cell during the current epoch
+struct RaPreambleKpi_t
+{
+	RaPreambleKpi_t ();
+
+	bool m_active; // true once the cell has been seen
+	uint64_t m_preambleRx; // preambles received by the PHY
+	uint64_t m_decodeFailures; // preambles not decoded by the PHY
+	uint64_t m_collisions; // preambles decoded with the RAPID of another UE
+	Time m_lastMacRx; // time of the last preambles delivered to the MAC
+	uint8_t m_rapIdCount[64]; // number of preambles per RAPID at m_lastMacRx
+};
+
+/**
+ * Computes the KPIs of the PRACH of each cell.
+ *
+ * For each cell and each epoch, the number of preambles received, of
+ * preambles that could not be decoded and of preambles which collided
+ * (i.e. decoded in the same subframe as a preamble of another UE with
+ * the same RAPID) are counted, in constant memory per cell.
+ *
+ * Every preamble can also be logged, if LogEvents is true.
+ */
 class RaPreambleStatsCalculator : public Object
 {
 public:
@@ -94,19 +119,22 @@ public:
 
 
 	/**
-	* Stores in the event list the tx of a preamble, along with time and imsi.  
+	* Counts the preambles with the same RAPID decoded by the cell in
+	* the same subframe and stores in the event list the rx of a
+	* preamble, along with time and imsi.
+	* @param cellId the cell receiving the preamble
 	* @param rach preamble msg
 	*/
-	void StorePreambleRx(Ptr<RachPreambleLteControlMessage> msg);
+	void StorePreambleRx(uint16_t cellId, Ptr<RachPreambleLteControlMessage> msg);
 
 	/** 
-	* trace sink
+	* trace sink, to be connected to the MAC of each eNB
 	* 
 	* \param raStatsCalculator 
-	* \param path
+	* \param cellId
 	* \param rach preamble msg
 	*/
-  	static void StorePreambleRx (Ptr<RaPreambleStatsCalculator> raStats, std::string path,
+  	static void StorePreambleRx (Ptr<RaPreambleStatsCalculator> raStats, uint16_t cellId,
                            Ptr<RachPreambleLteControlMessage> msg);
 
   	/**
@@ -127,27 +155,43 @@ public:
   	static void StorePreamblePhyRx (Ptr<RaPreambleStatsCalculator> raStats, std::string path,
                            PhyReceptionStatParameters params);
 
-
+	/**
+	* @param cellId
+	* @return the KPIs of the cell in the current epoch, all zero if the
+	*         cell has not been seen
+	*/
+	const RaPreambleKpi_t& GetKpi (uint16_t cellId) const;
 
 
 private:
 
+	/**
+	* @param cellId
+	* @return the KPIs of the cell, created if needed
+	*/
+	RaPreambleKpi_t& GetOrCreateKpi (uint16_t cellId);
+
+	/**
+	* Writes the KPIs of the cells to the output file.
+	*/
+	void
+	WriteKpis (void);
+
 	/**
 	* Called after each epoch to write collected
 	* statistics to output files. During first call
 	* it opens output files and write columns descriptions.
-	* During next calls it opens output files in append mode.
+	* EndEpoch then flushes the rows of the epoch; the files are closed
+	* when this object is disposed or the simulator is destroyed.
 	*/
 	void
 	ShowResults (void);
 
 	/**
-	* Writes collected statistics to output file and
-	* closes output file.
-	* @param outFile ofstream for statistics
+	* Writes collected statistics to output file.
 	*/
 	void
-	WriteResults (std::ofstream& outFile);
+	WriteResults (void);
 
 
 	/**
@@ -171,13 +215,18 @@ private:
 
 
    	std::string m_preambleRxFilename;
+	std::string m_kpiFilename;
+	bool m_logEvents; //!< Whether every preamble is logged
 
 	Time m_startTime;
 	Time m_epochDuration;
 
-	bool m_firstWriteImsiTime;
+	Ptr<LteStatsWriter> m_writer; //!< Writer of the statistics, created upon the first write
+	Ptr<LteStatsWriter> m_kpiWriter; //!< Writer of the KPIs, created upon the first write
 	bool m_pendingOutput;
 
+	std::vector<RaPreambleKpi_t> m_kpiByCellId; //!< KPIs of the cells, indexed by cell ID
+
 	EventList_t m_preambleRxEvents;
 	EventPhyList_t m_preamblePhyRxEvents;
 
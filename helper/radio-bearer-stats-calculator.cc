@@ -25,6 +25,7 @@
 #include <ns3/log.h>
 #include <vector>
 #include <algorithm>
+#include <cmath>
 
 namespace ns3 {
 
@@ -33,16 +34,14 @@ NS_LOG_COMPONENT_DEFINE ("RadioBearerStatsCalculator");
 NS_OBJECT_ENSURE_REGISTERED ( RadioBearerStatsCalculator);
 
 RadioBearerStatsCalculator::RadioBearerStatsCalculator ()
-  : m_firstWrite (true),
-    m_pendingOutput (false), 
+  : m_pendingOutput (false), 
     m_protocolType ("RLC")
 {
   NS_LOG_FUNCTION (this);
 }
 
 RadioBearerStatsCalculator::RadioBearerStatsCalculator (std::string protocolType)
-  : m_firstWrite (true),
-    m_pendingOutput (false)
+  : m_pendingOutput (false)
 {
   NS_LOG_FUNCTION (this);
   m_protocolType = protocolType;
@@ -102,6 +101,14 @@ RadioBearerStatsCalculator::DoDispose ()
     {
       ShowResults ();
     }
+  if (m_ulWriter != 0)
+    {
+      m_ulWriter->Close ();
+    }
+  if (m_dlWriter != 0)
+    {
+      m_dlWriter->Close ();
+    }
 }
 
 void 
@@ -131,85 +138,182 @@ RadioBearerStatsCalculator::GetEpoch () const
 }
 
 void
-RadioBearerStatsCalculator::UlTxPdu (uint16_t cellId, uint64_t imsi, uint16_t rnti, uint8_t lcid, uint32_t packetSize)
+RadioBearerSampleStats_t::Reset (void)
 {
-  NS_LOG_FUNCTION (this << "UlTxPDU" << cellId << imsi << rnti << (uint32_t) lcid << packetSize);
-  ImsiLcidPair_t p (imsi, lcid);
-  if (Simulator::Now () >= m_startTime)
+  m_count = 0;
+  m_min = 0;
+  m_max = 0;
+  m_mean = 0;
+  m_s = 0;
+}
+
+void
+RadioBearerSampleStats_t::Update (double x)
+{
+  ++m_count;
+  if (m_count == 1)
     {
-      m_ulCellId[p] = cellId;
-      m_flowId[p] = LteFlowId_t (rnti, lcid);
-      m_ulTxPackets[p]++;
-      m_ulTxData[p] += packetSize;
+      m_min = x;
+      m_max = x;
+      m_mean = x;
+      m_s = 0;
+      return;
     }
-  m_pendingOutput = true;
+  m_min = std::min (m_min, x);
+  m_max = std::max (m_max, x);
+  // see equations (15) and (16) on page 216 of "The Art of Computer
+  // Programming, Volume 2", Second Edition, as in MinMaxAvgTotalCalculator
+  double prevMean = m_mean;
+  m_mean = prevMean + (x - prevMean) / m_count;
+  m_s += (x - prevMean) * (x - m_mean);
+}
+
+std::vector<double>
+RadioBearerSampleStats_t::Get (void) const
+{
+  std::vector<double> stats (4, 0.0);
+  if (m_count > 0)
+    {
+      stats[0] = m_mean;
+      stats[1] = m_count > 1 ? std::sqrt (m_s / (m_count - 1)) : 0.0;
+      stats[2] = m_min;
+      stats[3] = m_max;
+    }
+  return stats;
 }
 
 void
-RadioBearerStatsCalculator::DlTxPdu (uint16_t cellId, uint64_t imsi, uint16_t rnti, uint8_t lcid, uint32_t packetSize)
+RadioBearerDirectionStats_t::Reset (void)
+{
+  m_txPackets = 0;
+  m_rxPackets = 0;
+  m_txData = 0;
+  m_rxData = 0;
+  m_delay.Reset ();
+  m_pduSize.Reset ();
+}
+
+uint32_t
+RadioBearerStatsCalculator::GetBearerIndex (uint64_t imsi, uint8_t lcid)
 {
-  NS_LOG_FUNCTION (this << "DlTxPDU" << cellId << imsi << rnti << (uint32_t) lcid << packetSize);
   ImsiLcidPair_t p (imsi, lcid);
-  if (Simulator::Now () >= m_startTime)
+  std::map<ImsiLcidPair_t, uint32_t>::iterator it = m_bearerIndex.find (p);
+  if (it != m_bearerIndex.end ())
     {
-      m_dlCellId[p] = cellId;
-      m_flowId[p] = LteFlowId_t (rnti, lcid);
-      m_dlTxPackets[p]++;
-      m_dlTxData[p] += packetSize;
+      return it->second;
     }
-  m_pendingOutput = true;
+  NS_LOG_DEBUG (this << " Creating stats record for IMSI " << imsi << " and LCID " << (uint32_t) lcid);
+  RadioBearerStatsRecord_t record;
+  record.m_imsi = imsi;
+  record.m_flowId = LteFlowId_t (0, lcid);
+  record.m_ulCellId = 0;
+  record.m_dlCellId = 0;
+  record.m_ul.Reset ();
+  record.m_dl.Reset ();
+  uint32_t index = m_bearers.size ();
+  m_bearers.push_back (record);
+  m_bearerIndex.insert (std::make_pair (p, index));
+  return index;
+}
+
+const RadioBearerStatsRecord_t*
+RadioBearerStatsCalculator::FindBearer (uint64_t imsi, uint8_t lcid) const
+{
+  std::map<ImsiLcidPair_t, uint32_t>::const_iterator it = m_bearerIndex.find (ImsiLcidPair_t (imsi, lcid));
+  if (it == m_bearerIndex.end ())
+    {
+      return 0;
+    }
+  return &m_bearers[it->second];
+}
+
+void
+RadioBearerStatsCalculator::UlTxPdu (uint16_t cellId, uint64_t imsi, uint16_t rnti, uint8_t lcid, uint32_t packetSize)
+{
+  UlTxPdu (GetBearerIndex (imsi, lcid), cellId, rnti, packetSize);
+}
+
+void
+RadioBearerStatsCalculator::DlTxPdu (uint16_t cellId, uint64_t imsi, uint16_t rnti, uint8_t lcid, uint32_t packetSize)
+{
+  DlTxPdu (GetBearerIndex (imsi, lcid), cellId, rnti, packetSize);
 }
 
 void
 RadioBearerStatsCalculator::UlRxPdu (uint16_t cellId, uint64_t imsi, uint16_t rnti, uint8_t lcid, uint32_t packetSize,
                                      uint64_t delay)
 {
-  NS_LOG_FUNCTION (this << " UlRxPDU cellId "  << cellId 
-                     << " imsi "    << imsi 
-                     << " rnti "     << rnti
-                     << " lcid "    << (uint32_t) lcid 
-                     << " packetSize " << packetSize 
-                     << " delay " << delay
-                     );
-  ImsiLcidPair_t p (imsi, lcid);
+  UlRxPdu (GetBearerIndex (imsi, lcid), cellId, packetSize, delay);
+}
+
+void
+RadioBearerStatsCalculator::DlRxPdu (uint16_t cellId, uint64_t imsi, uint16_t rnti, uint8_t lcid, uint32_t packetSize, uint64_t delay)
+{
+  DlRxPdu (GetBearerIndex (imsi, lcid), cellId, packetSize, delay);
+}
+
+void
+RadioBearerStatsCalculator::UlTxPdu (uint32_t bearerIndex, uint16_t cellId, uint16_t rnti, uint32_t packetSize)
+{
+  NS_LOG_FUNCTION (this << "UlTxPDU" << bearerIndex << cellId << rnti << packetSize);
+  NS_ASSERT (bearerIndex < m_bearers.size ());
   if (Simulator::Now () >= m_startTime)
     {
-      m_ulCellId[p] = cellId;
-      m_ulRxPackets[p]++;
-      m_ulRxData[p] += packetSize;
+      RadioBearerStatsRecord_t& record = m_bearers[bearerIndex];
+      record.m_ulCellId = cellId;
+      record.m_flowId.m_rnti = rnti;
+      record.m_ul.m_txPackets++;
+      record.m_ul.m_txData += packetSize;
+    }
+  m_pendingOutput = true;
+}
 
-      Uint64StatsMap::iterator it = m_ulDelay.find (p);
-      if (it == m_ulDelay.end ())
-        {
-          m_ulDelay[p] = CreateObject<MinMaxAvgTotalCalculator<uint64_t> > ();
-          m_ulPduSize[p] = CreateObject<MinMaxAvgTotalCalculator<uint32_t> > ();
-        }
-      m_ulDelay[p]->Update (delay);
-      m_ulPduSize[p]->Update (packetSize);
+void
+RadioBearerStatsCalculator::DlTxPdu (uint32_t bearerIndex, uint16_t cellId, uint16_t rnti, uint32_t packetSize)
+{
+  NS_LOG_FUNCTION (this << "DlTxPDU" << bearerIndex << cellId << rnti << packetSize);
+  NS_ASSERT (bearerIndex < m_bearers.size ());
+  if (Simulator::Now () >= m_startTime)
+    {
+      RadioBearerStatsRecord_t& record = m_bearers[bearerIndex];
+      record.m_dlCellId = cellId;
+      record.m_flowId.m_rnti = rnti;
+      record.m_dl.m_txPackets++;
+      record.m_dl.m_txData += packetSize;
     }
   m_pendingOutput = true;
 }
 
 void
-RadioBearerStatsCalculator::DlRxPdu (uint16_t cellId, uint64_t imsi, uint16_t rnti, uint8_t lcid, uint32_t packetSize, uint64_t delay)
+RadioBearerStatsCalculator::UlRxPdu (uint32_t bearerIndex, uint16_t cellId, uint32_t packetSize, uint64_t delay)
 {
-  NS_LOG_FUNCTION (this << "DlRxPDU" << cellId << imsi << rnti << (uint32_t) lcid << packetSize << delay);
-  ImsiLcidPair_t p (imsi, lcid);
+  NS_LOG_FUNCTION (this << "UlRxPDU" << bearerIndex << cellId << packetSize << delay);
+  NS_ASSERT (bearerIndex < m_bearers.size ());
   if (Simulator::Now () >= m_startTime)
     {
-      m_dlCellId[p] = cellId;
-      m_dlRxPackets[p]++;
-      m_dlRxData[p] += packetSize;
+      RadioBearerStatsRecord_t& record = m_bearers[bearerIndex];
+      record.m_ulCellId = cellId;
+      record.m_ul.m_rxPackets++;
+      record.m_ul.m_rxData += packetSize;
+      record.m_ul.m_delay.Update (delay);
+      record.m_ul.m_pduSize.Update (packetSize);
+    }
+  m_pendingOutput = true;
+}
 
-      Uint64StatsMap::iterator it = m_dlDelay.find (p);
-      if (it == m_dlDelay.end ())
-        {
-          NS_LOG_DEBUG (this << " Creating DL stats calculators for IMSI " << p.m_imsi << " and LCID " << (uint32_t) p.m_lcId);
-          m_dlDelay[p] = CreateObject<MinMaxAvgTotalCalculator<uint64_t> > ();
-          m_dlPduSize[p] = CreateObject<MinMaxAvgTotalCalculator<uint32_t> > ();
-        }
-      m_dlDelay[p]->Update (delay);
-      m_dlPduSize[p]->Update (packetSize);
+void
+RadioBearerStatsCalculator::DlRxPdu (uint32_t bearerIndex, uint16_t cellId, uint32_t packetSize, uint64_t delay)
+{
+  NS_LOG_FUNCTION (this << "DlRxPDU" << bearerIndex << cellId << packetSize << delay);
+  NS_ASSERT (bearerIndex < m_bearers.size ());
+  if (Simulator::Now () >= m_startTime)
+    {
+      RadioBearerStatsRecord_t& record = m_bearers[bearerIndex];
+      record.m_dlCellId = cellId;
+      record.m_dl.m_rxPackets++;
+      record.m_dl.m_rxData += packetSize;
+      record.m_dl.m_delay.Update (delay);
+      record.m_dl.m_pduSize.Update (packetSize);
     }
   m_pendingOutput = true;
 }
@@ -221,146 +325,124 @@ RadioBearerStatsCalculator::ShowResults (void)
   NS_LOG_INFO (this << GetUlOutputFilename ().c_str () << GetDlOutputFilename ().c_str ());
   NS_LOG_DEBUG ("Write Rlc Stats in " << GetUlOutputFilename ().c_str () << " and in " << GetDlOutputFilename ().c_str ());
 
-  std::ofstream ulOutFile;
-  std::ofstream dlOutFile;
-
-  if (m_firstWrite == true)
+  if (m_ulWriter == 0)
     {
-      ulOutFile.open (GetUlOutputFilename ().c_str ());
-      if (!ulOutFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetUlOutputFilename ().c_str ());
-          return;
-        }
-
-      dlOutFile.open (GetDlOutputFilename ().c_str ());
-      if (!dlOutFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetDlOutputFilename ().c_str ());
-          return;
-        }
-      m_firstWrite = false;
-      ulOutFile << "% start\tend\tCellId\tIMSI\tRNTI\tLCID\tnTxPDUs\tTxBytes\tnRxPDUs\tRxBytes\t";
-      ulOutFile << "delay\tstdDev\tmin\tmax\t";
-      ulOutFile << "PduSize\tstdDev\tmin\tmax";
-      ulOutFile << std::endl;
-      dlOutFile << "% start\tend\tCellId\tIMSI\tRNTI\tLCID\tnTxPDUs\tTxBytes\tnRxPDUs\tRxBytes\t";
-      dlOutFile << "delay\tstdDev\tmin\tmax\t";
-      dlOutFile << "PduSize\tstdDev\tmin\tmax";
-      dlOutFile << std::endl;
+      m_ulWriter = CreateWriter (GetUlOutputFilename ());
+      m_dlWriter = CreateWriter (GetDlOutputFilename ());
     }
-  else
-    {
-      ulOutFile.open (GetUlOutputFilename ().c_str (), std::ios_base::app);
-      if (!ulOutFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetUlOutputFilename ().c_str ());
-          return;
-        }
 
-      dlOutFile.open (GetDlOutputFilename ().c_str (), std::ios_base::app);
-      if (!dlOutFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetDlOutputFilename ().c_str ());
-          return;
-        }
-    }
-
-  WriteUlResults (ulOutFile);
-  WriteDlResults (dlOutFile);
+  WriteUlResults (m_ulWriter);
+  WriteDlResults (m_dlWriter);
   m_pendingOutput = false;
 
 }
 
+Ptr<LteStatsWriter>
+RadioBearerStatsCalculator::CreateWriter (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Ptr<LteStatsWriter> writer = CreateObject<LteStatsWriter> ();
+  writer->AddColumn ("start", LteStatsWriter::DOUBLE);
+  writer->AddColumn ("end", LteStatsWriter::DOUBLE);
+  writer->AddColumn ("CellId", LteStatsWriter::UINT16);
+  writer->AddColumn ("IMSI", LteStatsWriter::UINT64);
+  writer->AddColumn ("RNTI", LteStatsWriter::UINT16);
+  writer->AddColumn ("LCID", LteStatsWriter::UINT8);
+  writer->AddColumn ("nTxPDUs", LteStatsWriter::UINT32);
+  writer->AddColumn ("TxBytes", LteStatsWriter::UINT64);
+  writer->AddColumn ("nRxPDUs", LteStatsWriter::UINT32);
+  writer->AddColumn ("RxBytes", LteStatsWriter::UINT64);
+  writer->AddColumn ("delay", LteStatsWriter::DOUBLE);
+  writer->AddColumn ("delayStdDev", LteStatsWriter::DOUBLE);
+  writer->AddColumn ("delayMin", LteStatsWriter::DOUBLE);
+  writer->AddColumn ("delayMax", LteStatsWriter::DOUBLE);
+  writer->AddColumn ("PduSize", LteStatsWriter::DOUBLE);
+  writer->AddColumn ("PduSizeStdDev", LteStatsWriter::DOUBLE);
+  writer->AddColumn ("PduSizeMin", LteStatsWriter::DOUBLE);
+  writer->AddColumn ("PduSizeMax", LteStatsWriter::DOUBLE);
+  // the rows of the RLC/PDCP statistics always ended with a separator
+  writer->SetTextTrailingSeparator (true);
+  writer->Open (filename,
+                "% start\tend\tCellId\tIMSI\tRNTI\tLCID\tnTxPDUs\tTxBytes\tnRxPDUs\tRxBytes\t"
+                "delay\tstdDev\tmin\tmax\t"
+                "PduSize\tstdDev\tmin\tmax");
+  return writer;
+}
+
 void
-RadioBearerStatsCalculator::WriteUlResults (std::ofstream& outFile)
+RadioBearerStatsCalculator::WriteUlResults (Ptr<LteStatsWriter> writer)
 {
   NS_LOG_FUNCTION (this);
 
-  // Get the unique IMSI / LCID list
-
-  std::vector < ImsiLcidPair_t > pairVector;
-  for (Uint32Map::iterator it = m_ulTxPackets.begin (); it != m_ulTxPackets.end (); ++it)
+  // one row per bearer which transmitted in this epoch, by (IMSI, LCID)
+  Time endTime = m_startTime + m_epochDuration;
+  for (std::map<ImsiLcidPair_t, uint32_t>::iterator it = m_bearerIndex.begin (); it != m_bearerIndex.end (); ++it)
     {
-      if (find (pairVector.begin (), pairVector.end (), (*it).first) == pairVector.end ())
+      const RadioBearerStatsRecord_t& record = m_bearers[it->second];
+      if (record.m_ul.m_txPackets == 0)
         {
-          pairVector.push_back ((*it).first);
+          continue;
         }
-    }
-
-  Time endTime = m_startTime + m_epochDuration;
-  for (std::vector<ImsiLcidPair_t>::iterator it = pairVector.begin (); it != pairVector.end (); ++it)
-    {
-      ImsiLcidPair_t p = *it;
-      outFile << m_startTime.GetNanoSeconds () / 1.0e9 << "\t";
-      outFile << endTime.GetNanoSeconds () / 1.0e9 << "\t";
-      outFile << GetUlCellId (p.m_imsi, p.m_lcId) << "\t";
-      outFile << p.m_imsi << "\t";
-      outFile << m_flowId[p].m_rnti << "\t";
-      outFile << (uint32_t) m_flowId[p].m_lcId << "\t";
-      outFile << GetUlTxPackets (p.m_imsi, p.m_lcId) << "\t";
-      outFile << GetUlTxData (p.m_imsi, p.m_lcId) << "\t";
-      outFile << GetUlRxPackets (p.m_imsi, p.m_lcId) << "\t";
-      outFile << GetUlRxData (p.m_imsi, p.m_lcId) << "\t";
-      std::vector<double> stats = GetUlDelayStats (p.m_imsi, p.m_lcId);
+      writer->WriteDouble (m_startTime.GetNanoSeconds () / 1.0e9);
+      writer->WriteDouble (endTime.GetNanoSeconds () / 1.0e9);
+      writer->WriteUint (record.m_ulCellId);
+      writer->WriteUint (record.m_imsi);
+      writer->WriteUint (record.m_flowId.m_rnti);
+      writer->WriteUint (record.m_flowId.m_lcId);
+      writer->WriteUint (record.m_ul.m_txPackets);
+      writer->WriteUint (record.m_ul.m_txData);
+      writer->WriteUint (record.m_ul.m_rxPackets);
+      writer->WriteUint (record.m_ul.m_rxData);
+      std::vector<double> stats = record.m_ul.m_delay.Get ();
       for (std::vector<double>::iterator it = stats.begin (); it != stats.end (); ++it)
         {
-          outFile << (*it) * 1e-9 << "\t";
+          writer->WriteDouble ((*it) * 1e-9);
         }
-      stats = GetUlPduSizeStats (p.m_imsi, p.m_lcId);
+      stats = record.m_ul.m_pduSize.Get ();
       for (std::vector<double>::iterator it = stats.begin (); it != stats.end (); ++it)
         {
-          outFile << (*it) << "\t";
+          writer->WriteDouble (*it);
         }
-      outFile << std::endl;
+      writer->EndRow ();
     }
-
-  outFile.close ();
 }
 
 void
-RadioBearerStatsCalculator::WriteDlResults (std::ofstream& outFile)
+RadioBearerStatsCalculator::WriteDlResults (Ptr<LteStatsWriter> writer)
 {
   NS_LOG_FUNCTION (this);
 
-  // Get the unique IMSI list
-  std::vector < ImsiLcidPair_t > pairVector;
-  for (Uint32Map::iterator it = m_dlTxPackets.begin (); it != m_dlTxPackets.end (); ++it)
+  // one row per bearer which transmitted in this epoch, by (IMSI, LCID)
+  Time endTime = m_startTime + m_epochDuration;
+  for (std::map<ImsiLcidPair_t, uint32_t>::iterator it = m_bearerIndex.begin (); it != m_bearerIndex.end (); ++it)
     {
-      if (find (pairVector.begin (), pairVector.end (), (*it).first) == pairVector.end ())
+      const RadioBearerStatsRecord_t& record = m_bearers[it->second];
+      if (record.m_dl.m_txPackets == 0)
         {
-          pairVector.push_back ((*it).first);
+          continue;
         }
-    }
-
-  Time endTime = m_startTime + m_epochDuration;
-  for (std::vector<ImsiLcidPair_t>::iterator pair = pairVector.begin (); pair != pairVector.end (); ++pair)
-    {
-      ImsiLcidPair_t p = *pair;
-      outFile << m_startTime.GetNanoSeconds () / 1.0e9 << "\t";
-      outFile << endTime.GetNanoSeconds () / 1.0e9 << "\t";
-      outFile << GetDlCellId (p.m_imsi, p.m_lcId) << "\t";
-      outFile << p.m_imsi << "\t";
-      outFile << m_flowId[p].m_rnti << "\t";
-      outFile << (uint32_t) m_flowId[p].m_lcId << "\t";
-      outFile << GetDlTxPackets (p.m_imsi, p.m_lcId) << "\t";
-      outFile << GetDlTxData (p.m_imsi, p.m_lcId) << "\t";
-      outFile << GetDlRxPackets (p.m_imsi, p.m_lcId) << "\t";
-      outFile << GetDlRxData (p.m_imsi, p.m_lcId) << "\t";
-      std::vector<double> stats = GetDlDelayStats (p.m_imsi, p.m_lcId);
+      writer->WriteDouble (m_startTime.GetNanoSeconds () / 1.0e9);
+      writer->WriteDouble (endTime.GetNanoSeconds () / 1.0e9);
+      writer->WriteUint (record.m_dlCellId);
+      writer->WriteUint (record.m_imsi);
+      writer->WriteUint (record.m_flowId.m_rnti);
+      writer->WriteUint (record.m_flowId.m_lcId);
+      writer->WriteUint (record.m_dl.m_txPackets);
+      writer->WriteUint (record.m_dl.m_txData);
+      writer->WriteUint (record.m_dl.m_rxPackets);
+      writer->WriteUint (record.m_dl.m_rxData);
+      std::vector<double> stats = record.m_dl.m_delay.Get ();
       for (std::vector<double>::iterator it = stats.begin (); it != stats.end (); ++it)
         {
-          outFile << (*it) * 1e-9 << "\t";
+          writer->WriteDouble ((*it) * 1e-9);
         }
-      stats = GetDlPduSizeStats (p.m_imsi, p.m_lcId);
+      stats = record.m_dl.m_pduSize.Get ();
       for (std::vector<double>::iterator it = stats.begin (); it != stats.end (); ++it)
         {
-          outFile << (*it) << "\t";
+          writer->WriteDouble (*it);
         }
-      outFile << std::endl;
+      writer->EndRow ();
     }
-
-  outFile.close ();
 }
 
 void
@@ -368,19 +450,11 @@ RadioBearerStatsCalculator::ResetResults (void)
 {
   NS_LOG_FUNCTION (this);
 
-  m_ulTxPackets.erase (m_ulTxPackets.begin (), m_ulTxPackets.end ());
-  m_ulRxPackets.erase (m_ulRxPackets.begin (), m_ulRxPackets.end ());
-  m_ulRxData.erase (m_ulRxData.begin (), m_ulRxData.end ());
-  m_ulTxData.erase (m_ulTxData.begin (), m_ulTxData.end ());
-  m_ulDelay.erase (m_ulDelay.begin (), m_ulDelay.end ());
-  m_ulPduSize.erase (m_ulPduSize.begin (), m_ulPduSize.end ());
-
-  m_dlTxPackets.erase (m_dlTxPackets.begin (), m_dlTxPackets.end ());
-  m_dlRxPackets.erase (m_dlRxPackets.begin (), m_dlRxPackets.end ());
-  m_dlRxData.erase (m_dlRxData.begin (), m_dlRxData.end ());
-  m_dlTxData.erase (m_dlTxData.begin (), m_dlTxData.end ());
-  m_dlDelay.erase (m_dlDelay.begin (), m_dlDelay.end ());
-  m_dlPduSize.erase (m_dlPduSize.begin (), m_dlPduSize.end ());
+  for (std::vector<RadioBearerStatsRecord_t>::iterator it = m_bearers.begin (); it != m_bearers.end (); ++it)
+    {
+      it->m_ul.Reset ();
+      it->m_dl.Reset ();
+    }
 }
 
 void
@@ -397,6 +471,14 @@ RadioBearerStatsCalculator::EndEpoch (void)
 {
   NS_LOG_FUNCTION (this);
   ShowResults ();
+  if (m_ulWriter != 0)
+    {
+      m_ulWriter->Flush ();
+    }
+  if (m_dlWriter != 0)
+    {
+      m_dlWriter->Flush ();
+    }
   ResetResults ();
   m_startTime += m_epochDuration;
   m_endEpochEvent = Simulator::Schedule (m_epochDuration, &RadioBearerStatsCalculator::EndEpoch, this);
@@ -406,198 +488,192 @@ uint32_t
 RadioBearerStatsCalculator::GetUlTxPackets (uint64_t imsi, uint8_t lcid)
 {
   NS_LOG_FUNCTION (this << imsi << (uint16_t) lcid);
-  ImsiLcidPair_t p (imsi, lcid);
-  return m_ulTxPackets[p];
+  const RadioBearerStatsRecord_t* record = FindBearer (imsi, lcid);
+  if (record == 0)
+    {
+      return 0;
+    }
+  return record->m_ul.m_txPackets;
 }
 
 uint32_t
 RadioBearerStatsCalculator::GetUlRxPackets (uint64_t imsi, uint8_t lcid)
 {
   NS_LOG_FUNCTION (this << imsi << (uint16_t) lcid);
-  ImsiLcidPair_t p (imsi, lcid);
-  return m_ulRxPackets[p];
+  const RadioBearerStatsRecord_t* record = FindBearer (imsi, lcid);
+  if (record == 0)
+    {
+      return 0;
+    }
+  return record->m_ul.m_rxPackets;
 }
 
 uint64_t
 RadioBearerStatsCalculator::GetUlTxData (uint64_t imsi, uint8_t lcid)
 {
   NS_LOG_FUNCTION (this << imsi << (uint16_t) lcid);
-  ImsiLcidPair_t p (imsi, lcid);
-  return m_ulTxData[p];
+  const RadioBearerStatsRecord_t* record = FindBearer (imsi, lcid);
+  if (record == 0)
+    {
+      return 0;
+    }
+  return record->m_ul.m_txData;
 }
 
 uint64_t
 RadioBearerStatsCalculator::GetUlRxData (uint64_t imsi, uint8_t lcid)
 {
   NS_LOG_FUNCTION (this << imsi << (uint16_t) lcid);
-  ImsiLcidPair_t p (imsi, lcid);
-  return m_ulRxData[p];
+  const RadioBearerStatsRecord_t* record = FindBearer (imsi, lcid);
+  if (record == 0)
+    {
+      return 0;
+    }
+  return record->m_ul.m_rxData;
 }
 
 double
 RadioBearerStatsCalculator::GetUlDelay (uint64_t imsi, uint8_t lcid)
 {
   NS_LOG_FUNCTION (this << imsi << (uint16_t) lcid);
-  ImsiLcidPair_t p (imsi, lcid);
-  Uint64StatsMap::iterator it = m_ulDelay.find (p);
-  if (it == m_ulDelay.end ())
+  const RadioBearerStatsRecord_t* record = FindBearer (imsi, lcid);
+  if (record == 0)
     {
       return 0;
     }
-  return m_ulDelay[p]->getMean ();
+  return record->m_ul.m_delay.m_mean;
 }
 
 std::vector<double>
 RadioBearerStatsCalculator::GetUlDelayStats (uint64_t imsi, uint8_t lcid)
 {
   NS_LOG_FUNCTION (this << imsi << (uint16_t) lcid);
-  ImsiLcidPair_t p (imsi, lcid);
-  std::vector<double> stats;
-  Uint64StatsMap::iterator it = m_ulDelay.find (p);
-  if (it == m_ulDelay.end ())
+  const RadioBearerStatsRecord_t* record = FindBearer (imsi, lcid);
+  if (record == 0)
     {
-      stats.push_back (0.0);
-      stats.push_back (0.0);
-      stats.push_back (0.0);
-      stats.push_back (0.0);
-      return stats;
-
+      return std::vector<double> (4, 0.0);
     }
-  stats.push_back (m_ulDelay[p]->getMean ());
-  stats.push_back (m_ulDelay[p]->getStddev ());
-  stats.push_back (m_ulDelay[p]->getMin ());
-  stats.push_back (m_ulDelay[p]->getMax ());
-  return stats;
+  return record->m_ul.m_delay.Get ();
 }
 
 std::vector<double>
 RadioBearerStatsCalculator::GetUlPduSizeStats (uint64_t imsi, uint8_t lcid)
 {
   NS_LOG_FUNCTION (this << imsi << (uint16_t) lcid);
-  ImsiLcidPair_t p (imsi, lcid);
-  std::vector<double> stats;
-  Uint32StatsMap::iterator it = m_ulPduSize.find (p);
-  if (it == m_ulPduSize.end ())
+  const RadioBearerStatsRecord_t* record = FindBearer (imsi, lcid);
+  if (record == 0)
     {
-      stats.push_back (0.0);
-      stats.push_back (0.0);
-      stats.push_back (0.0);
-      stats.push_back (0.0);
-      return stats;
-
+      return std::vector<double> (4, 0.0);
     }
-  stats.push_back (m_ulPduSize[p]->getMean ());
-  stats.push_back (m_ulPduSize[p]->getStddev ());
-  stats.push_back (m_ulPduSize[p]->getMin ());
-  stats.push_back (m_ulPduSize[p]->getMax ());
-  return stats;
+  return record->m_ul.m_pduSize.Get ();
 }
 
 uint32_t
 RadioBearerStatsCalculator::GetDlTxPackets (uint64_t imsi, uint8_t lcid)
 {
   NS_LOG_FUNCTION (this << imsi << (uint16_t) lcid);
-  ImsiLcidPair_t p (imsi, lcid);
-  return m_dlTxPackets[p];
+  const RadioBearerStatsRecord_t* record = FindBearer (imsi, lcid);
+  if (record == 0)
+    {
+      return 0;
+    }
+  return record->m_dl.m_txPackets;
 }
 
 uint32_t
 RadioBearerStatsCalculator::GetDlRxPackets (uint64_t imsi, uint8_t lcid)
 {
   NS_LOG_FUNCTION (this << imsi << (uint16_t) lcid);
-  ImsiLcidPair_t p (imsi, lcid);
-  return m_dlRxPackets[p];
+  const RadioBearerStatsRecord_t* record = FindBearer (imsi, lcid);
+  if (record == 0)
+    {
+      return 0;
+    }
+  return record->m_dl.m_rxPackets;
 }
 
 uint64_t
 RadioBearerStatsCalculator::GetDlTxData (uint64_t imsi, uint8_t lcid)
 {
   NS_LOG_FUNCTION (this << imsi << (uint16_t) lcid);
-  ImsiLcidPair_t p (imsi, lcid);
-  return m_dlTxData[p];
+  const RadioBearerStatsRecord_t* record = FindBearer (imsi, lcid);
+  if (record == 0)
+    {
+      return 0;
+    }
+  return record->m_dl.m_txData;
 }
 
 uint64_t
 RadioBearerStatsCalculator::GetDlRxData (uint64_t imsi, uint8_t lcid)
 {
   NS_LOG_FUNCTION (this << imsi << (uint16_t) lcid);
-  ImsiLcidPair_t p (imsi, lcid);
-  return m_dlRxData[p];
+  const RadioBearerStatsRecord_t* record = FindBearer (imsi, lcid);
+  if (record == 0)
+    {
+      return 0;
+    }
+  return record->m_dl.m_rxData;
 }
 
 uint32_t
 RadioBearerStatsCalculator::GetUlCellId (uint64_t imsi, uint8_t lcid)
 {
   NS_LOG_FUNCTION (this << imsi << (uint16_t) lcid);
-  ImsiLcidPair_t p (imsi, lcid);
-  return m_ulCellId[p];
+  const RadioBearerStatsRecord_t* record = FindBearer (imsi, lcid);
+  if (record == 0)
+    {
+      return 0;
+    }
+  return record->m_ulCellId;
 }
 
 uint32_t
 RadioBearerStatsCalculator::GetDlCellId (uint64_t imsi, uint8_t lcid)
 {
   NS_LOG_FUNCTION (this << imsi << (uint16_t) lcid);
-  ImsiLcidPair_t p (imsi, lcid);
-  return m_dlCellId[p];
+  const RadioBearerStatsRecord_t* record = FindBearer (imsi, lcid);
+  if (record == 0)
+    {
+      return 0;
+    }
+  return record->m_dlCellId;
 }
 
 double
 RadioBearerStatsCalculator::GetDlDelay (uint64_t imsi, uint8_t lcid)
 {
   NS_LOG_FUNCTION (this << imsi << (uint16_t) lcid);
-  ImsiLcidPair_t p (imsi, lcid);
-  Uint64StatsMap::iterator it = m_dlDelay.find (p);
-  if (it == m_dlDelay.end ())
+  const RadioBearerStatsRecord_t* record = FindBearer (imsi, lcid);
+  if (record == 0)
     {
       return 0;
     }
-  return m_dlDelay[p]->getMean ();
+  return record->m_dl.m_delay.m_mean;
 }
 
 std::vector<double>
 RadioBearerStatsCalculator::GetDlDelayStats (uint64_t imsi, uint8_t lcid)
 {
   NS_LOG_FUNCTION (this << imsi << (uint16_t) lcid);
-  ImsiLcidPair_t p (imsi, lcid);
-  std::vector<double> stats;
-  Uint64StatsMap::iterator it = m_dlDelay.find (p);
-  if (it == m_dlDelay.end ())
+  const RadioBearerStatsRecord_t* record = FindBearer (imsi, lcid);
+  if (record == 0)
     {
-      stats.push_back (0.0);
-      stats.push_back (0.0);
-      stats.push_back (0.0);
-      stats.push_back (0.0);
-      return stats;
-
+      return std::vector<double> (4, 0.0);
     }
-  stats.push_back (m_dlDelay[p]->getMean ());
-  stats.push_back (m_dlDelay[p]->getStddev ());
-  stats.push_back (m_dlDelay[p]->getMin ());
-  stats.push_back (m_dlDelay[p]->getMax ());
-  return stats;
+  return record->m_dl.m_delay.Get ();
 }
 
 std::vector<double>
 RadioBearerStatsCalculator::GetDlPduSizeStats (uint64_t imsi, uint8_t lcid)
 {
   NS_LOG_FUNCTION (this << imsi << (uint16_t) lcid);
-  ImsiLcidPair_t p (imsi, lcid);
-  std::vector<double> stats;
-  Uint32StatsMap::iterator it = m_dlPduSize.find (p);
-  if (it == m_dlPduSize.end ())
+  const RadioBearerStatsRecord_t* record = FindBearer (imsi, lcid);
+  if (record == 0)
     {
-      stats.push_back (0.0);
-      stats.push_back (0.0);
-      stats.push_back (0.0);
-      stats.push_back (0.0);
-      return stats;
-
+      return std::vector<double> (4, 0.0);
     }
-  stats.push_back (m_dlPduSize[p]->getMean ());
-  stats.push_back (m_dlPduSize[p]->getStddev ());
-  stats.push_back (m_dlPduSize[p]->getMin ());
-  stats.push_back (m_dlPduSize[p]->getMax ());
-  return stats;
+  return record->m_dl.m_pduSize.Get ();
 }
 
 std::string
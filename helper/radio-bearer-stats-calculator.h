@@ -23,29 +23,70 @@
 #define RADIO_BEARER_STATS_CALCULATOR_H_
 
 #include "ns3/lte-stats-calculator.h"
+#include "ns3/lte-stats-writer.h"
 #include "ns3/lte-common.h"
 #include "ns3/uinteger.h"
 #include "ns3/object.h"
-#include "ns3/basic-data-calculators.h"
 #include "ns3/lte-common.h"
 #include <string>
 #include <map>
+#include <vector>
 #include <fstream>
 
 namespace ns3
 {
-/// Container: (IMSI, LCID) pair, uint32_t
-typedef std::map<ImsiLcidPair_t, uint32_t> Uint32Map;
-/// Container: (IMSI, LCID) pair, uint64_t
-typedef std::map<ImsiLcidPair_t, uint64_t> Uint64Map;
-/// Container: (IMSI, LCID) pair, uint32_t calculator
-typedef std::map<ImsiLcidPair_t, Ptr<MinMaxAvgTotalCalculator<uint32_t> > > Uint32StatsMap;
-/// Container: (IMSI, LCID) pair, uint64_t calculator
-typedef std::map<ImsiLcidPair_t, Ptr<MinMaxAvgTotalCalculator<uint64_t> > > Uint64StatsMap;
-/// Container: (IMSI, LCID) pair, double
-typedef std::map<ImsiLcidPair_t, double> DoubleMap;
-/// Container: (IMSI, LCID) pair, LteFlowId_t
-typedef std::map<ImsiLcidPair_t, LteFlowId_t> FlowIdMap;
+
+/**
+ * Minimum, maximum, mean and variance of a sample, updated as by
+ * MinMaxAvgTotalCalculator but stored inline
+ */
+struct RadioBearerSampleStats_t
+{
+  uint32_t m_count; ///< number of values
+  double m_min; ///< smallest value
+  double m_max; ///< largest value
+  double m_mean; ///< mean of the values
+  double m_s; ///< sum of the squared deviations from the mean
+
+  /// Forget all the values
+  void Reset (void);
+
+  /**
+   * \param x the new value
+   */
+  void Update (double x);
+
+  /**
+   * \return the average, standard deviation, minimum and maximum of the
+   *         values, or zeros if there is no value
+   */
+  std::vector<double> Get (void) const;
+};
+
+/// Counters of a radio bearer in one direction during the current epoch
+struct RadioBearerDirectionStats_t
+{
+  uint32_t m_txPackets; ///< number of PDUs transmitted
+  uint32_t m_rxPackets; ///< number of PDUs received
+  uint64_t m_txData; ///< number of bytes transmitted
+  uint64_t m_rxData; ///< number of bytes received
+  RadioBearerSampleStats_t m_delay; ///< delay of the PDUs received, in nanoseconds
+  RadioBearerSampleStats_t m_pduSize; ///< size of the PDUs received
+
+  /// Reset the counters at the beginning of an epoch
+  void Reset (void);
+};
+
+/// Statistics of a radio bearer, identified by its (IMSI, LCID) pair
+struct RadioBearerStatsRecord_t
+{
+  uint64_t m_imsi; ///< IMSI of the UE
+  LteFlowId_t m_flowId; ///< last (RNTI, LCID) of the bearer
+  uint16_t m_ulCellId; ///< cell of the last UL PDU
+  uint16_t m_dlCellId; ///< cell of the last DL PDU
+  RadioBearerDirectionStats_t m_ul; ///< UL counters
+  RadioBearerDirectionStats_t m_dl; ///< DL counters
+};
 
 /**
  * \ingroup lte
@@ -66,6 +107,11 @@ typedef std::map<ImsiLcidPair_t, LteFlowId_t> FlowIdMap;
  *   - Average, min, max and standard deviation of PDU delay (delay is
  *     calculated from the generation of the PDU to its reception)
  *   - Average, min, max and standard deviation of PDU size
+ *
+ * All the statistics of a radio bearer are kept in one record of a
+ * dense array. The index of the record is looked up once per bearer by
+ * RadioBearerStatsConnector with GetBearerIndex, and then passed along
+ * with every PDU.
  */
 class RadioBearerStatsCalculator : public LteStatsCalculator
 {
@@ -203,6 +249,56 @@ public:
   void
   DlRxPdu (uint16_t cellId, uint64_t imsi, uint16_t rnti, uint8_t lcid, uint32_t packetSize, uint64_t delay);
 
+  /**
+   * Gets the index of the record of a radio bearer, which is created if
+   * needed. The index remains valid for the lifetime of the calculator.
+   * @param imsi IMSI of the UE
+   * @param lcid LCID of the bearer
+   * @return the index of the record of the bearer
+   */
+  uint32_t
+  GetBearerIndex (uint64_t imsi, uint8_t lcid);
+
+  /**
+   * Notifies the stats calculator that an uplink transmission has occurred.
+   * @param bearerIndex index of the bearer, as returned by GetBearerIndex
+   * @param cellId CellId of the attached Enb
+   * @param rnti C-RNTI of the UE who transmitted the PDU
+   * @param packetSize size of the PDU in bytes
+   */
+  void
+  UlTxPdu (uint32_t bearerIndex, uint16_t cellId, uint16_t rnti, uint32_t packetSize);
+
+  /**
+   * Notifies the stats calculator that an uplink reception has occurred.
+   * @param bearerIndex index of the bearer, as returned by GetBearerIndex
+   * @param cellId CellId of the attached Enb
+   * @param packetSize size of the PDU in bytes
+   * @param delay RLC to RLC delay in nanoseconds
+   */
+  void
+  UlRxPdu (uint32_t bearerIndex, uint16_t cellId, uint32_t packetSize, uint64_t delay);
+
+  /**
+   * Notifies the stats calculator that a downlink transmission has occurred.
+   * @param bearerIndex index of the bearer, as returned by GetBearerIndex
+   * @param cellId CellId of the attached Enb
+   * @param rnti C-RNTI of the UE who is receiving the PDU
+   * @param packetSize size of the PDU in bytes
+   */
+  void
+  DlTxPdu (uint32_t bearerIndex, uint16_t cellId, uint16_t rnti, uint32_t packetSize);
+
+  /**
+   * Notifies the stats calculator that a downlink reception has occurred.
+   * @param bearerIndex index of the bearer, as returned by GetBearerIndex
+   * @param cellId CellId of the attached Enb
+   * @param packetSize size of the PDU in bytes
+   * @param delay RLC to RLC delay in nanoseconds
+   */
+  void
+  DlRxPdu (uint32_t bearerIndex, uint16_t cellId, uint32_t packetSize, uint64_t delay);
+
   /**
    * Gets the number of transmitted uplink packets.
    * @param imsi IMSI of the UE
@@ -348,30 +444,46 @@ public:
   GetDlPduSizeStats (uint64_t imsi, uint8_t lcid);
 
 private:
+  /**
+   * @param imsi IMSI of the UE
+   * @param lcid LCID of the bearer
+   * @return the record of the bearer, or 0 if no PDU of the bearer has
+   *         been notified
+   */
+  const RadioBearerStatsRecord_t*
+  FindBearer (uint64_t imsi, uint8_t lcid) const;
+
   /**
    * Called after each epoch to write collected
    * statistics to output files. During first call
    * it opens output files and write columns descriptions.
-   * During next calls it opens output files in append mode.
+   * EndEpoch flushes the rows once written, and the UL and DL files
+   * are closed on disposal or when the simulator is destroyed.
    */
   void
   ShowResults (void);
 
   /**
-   * Writes collected statistics to UL output file and
-   * closes UL output file.
-   * @param outFile ofstream for UL statistics
+   * Creates the writer of an output file and declares its columns
+   * @param filename name of the output file
+   * @return the writer
+   */
+  Ptr<LteStatsWriter>
+  CreateWriter (std::string filename);
+
+  /**
+   * Writes collected statistics to UL output file.
+   * @param writer writer of the UL statistics
    */
   void
-  WriteUlResults (std::ofstream& outFile);
+  WriteUlResults (Ptr<LteStatsWriter> writer);
 
   /**
-   * Writes collected statistics to DL output file and
-   * closes DL output file.
-   * @param outFile ofstream for DL statistics
+   * Writes collected statistics to DL output file.
+   * @param writer writer of the DL statistics
    */
   void
-  WriteDlResults (std::ofstream& outFile);
+  WriteDlResults (Ptr<LteStatsWriter> writer);
 
   /**
    * Erases collected statistics
@@ -394,23 +506,8 @@ private:
 
   EventId m_endEpochEvent; //!< Event id for next end epoch event
 
-  FlowIdMap m_flowId; //!< List of FlowIds, ie. (RNTI, LCID) by (IMSI, LCID) pair
-
-  Uint32Map m_dlCellId; //!< List of DL CellIds by (IMSI, LCID) pair
-  Uint32Map m_dlTxPackets; //!< Number of DL TX Packets by (IMSI, LCID) pair
-  Uint32Map m_dlRxPackets; //!< Number of DL RX Packets by (IMSI, LCID) pair
-  Uint64Map m_dlTxData; //!< Amount of DL TX Data by (IMSI, LCID) pair
-  Uint64Map m_dlRxData; //!< Amount of DL RX Data by (IMSI, LCID) pair
-  Uint64StatsMap m_dlDelay; //!< DL delay by (IMSI, LCID) pair
-  Uint32StatsMap m_dlPduSize; //!< DL PDU Size by (IMSI, LCID) pair
-
-  Uint32Map m_ulCellId; //!< List of UL CellIds by (IMSI, LCID) pair
-  Uint32Map m_ulTxPackets; //!< Number of UL TX Packets by (IMSI, LCID) pair
-  Uint32Map m_ulRxPackets; //!< Number of UL RX Packets by (IMSI, LCID) pair
-  Uint64Map m_ulTxData; //!< Amount of UL TX Data by (IMSI, LCID) pair
-  Uint64Map m_ulRxData; //!< Amount of UL RX Data by (IMSI, LCID) pair
-  Uint64StatsMap m_ulDelay; //!< UL delay by (IMSI, LCID) pair
-  Uint32StatsMap m_ulPduSize; //!< UL PDU Size by (IMSI, LCID) pair
+  std::vector<RadioBearerStatsRecord_t> m_bearers; //!< Statistics of the bearers, by bearer index
+  std::map<ImsiLcidPair_t, uint32_t> m_bearerIndex; //!< Bearer index by (IMSI, LCID) pair
 
   /**
    * Start time of the on going epoch
@@ -423,9 +520,16 @@ private:
   Time m_epochDuration;
 
   /**
-   * true if output files have not been opened yet
+   * Writer of the UL statistics, which opens the output file
+   * upon the first write
+   */
+  Ptr<LteStatsWriter> m_ulWriter;
+
+  /**
+   * Writer of the DL statistics, which opens the output file
+   * upon the first write
    */
-  bool m_firstWrite;
+  Ptr<LteStatsWriter> m_dlWriter;
 
   /**
    * true if any output is pending
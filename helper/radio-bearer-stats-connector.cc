@@ -47,13 +47,51 @@ operator < (const RadioBearerStatsConnector::CellIdRnti& a, const RadioBearerSta
  * sources and RadioBearerStatsCalculator. It stores
  * and provides calculators with cellId and IMSI,
  * because most trace sources do not provide it.
+ * It also caches the index of the stats record of
+ * each LCID of the UE, so that the calculator is
+ * searched only once per bearer.
  */
 struct BoundCallbackArgument : public SimpleRefCount<BoundCallbackArgument>
 {
 public:
+  /// LCIDs are 5-bit fields of the MAC subheaders
+  static const uint8_t MAX_LCID = 32;
+
+  BoundCallbackArgument ()
+    : imsi (0),
+      cellId (0)
+  {
+    for (uint8_t lcid = 0; lcid < MAX_LCID; ++lcid)
+      {
+        bearerIndex[lcid] = INVALID_INDEX;
+      }
+  }
+
+  /**
+   * \param lcid the LCID of a bearer of the UE
+   * \return the index of its record in the calculator
+   */
+  uint32_t GetBearerIndex (uint8_t lcid)
+  {
+    if (lcid >= MAX_LCID)
+      {
+        return stats->GetBearerIndex (imsi, lcid);
+      }
+    if (bearerIndex[lcid] == INVALID_INDEX)
+      {
+        bearerIndex[lcid] = stats->GetBearerIndex (imsi, lcid);
+      }
+    return bearerIndex[lcid];
+  }
+
   Ptr<RadioBearerStatsCalculator> stats;  //!< statistics calculator
   uint64_t imsi; //!< imsi
   uint16_t cellId; //!< cellId
+
+private:
+  /// value of the entries of bearerIndex not looked up yet
+  static const uint32_t INVALID_INDEX = 0xffffffff;
+  uint32_t bearerIndex[MAX_LCID]; //!< stats record index per LCID
 };
 
 /**
@@ -69,7 +107,7 @@ DlTxPduCallback (Ptr<BoundCallbackArgument> arg, std::string path,
                  uint16_t rnti, uint8_t lcid, uint32_t packetSize)
 {
   NS_LOG_FUNCTION (path << rnti << (uint16_t)lcid << packetSize);
-  arg->stats->DlTxPdu (arg->cellId, arg->imsi, rnti, lcid, packetSize);
+  arg->stats->DlTxPdu (arg->GetBearerIndex (lcid), arg->cellId, rnti, packetSize);
 }
 
 /**
@@ -86,7 +124,7 @@ DlRxPduCallback (Ptr<BoundCallbackArgument> arg, std::string path,
                  uint16_t rnti, uint8_t lcid, uint32_t packetSize, uint64_t delay)
 {
   NS_LOG_FUNCTION (path << rnti << (uint16_t)lcid << packetSize << delay);
-  arg->stats->DlRxPdu (arg->cellId, arg->imsi, rnti, lcid, packetSize, delay);
+  arg->stats->DlRxPdu (arg->GetBearerIndex (lcid), arg->cellId, packetSize, delay);
 }
 
 /**
@@ -103,7 +141,7 @@ UlTxPduCallback (Ptr<BoundCallbackArgument> arg, std::string path,
 {
   NS_LOG_FUNCTION (path << rnti << (uint16_t)lcid << packetSize);
  
-  arg->stats->UlTxPdu (arg->cellId, arg->imsi, rnti, lcid, packetSize);
+  arg->stats->UlTxPdu (arg->GetBearerIndex (lcid), arg->cellId, rnti, packetSize);
 }
 
 /**
@@ -121,7 +159,7 @@ UlRxPduCallback (Ptr<BoundCallbackArgument> arg, std::string path,
 {
   NS_LOG_FUNCTION (path << rnti << (uint16_t)lcid << packetSize << delay);
  
-  arg->stats->UlRxPdu (arg->cellId, arg->imsi, rnti, lcid, packetSize, delay);
+  arg->stats->UlRxPdu (arg->GetBearerIndex (lcid), arg->cellId, packetSize, delay);
 }
 
 
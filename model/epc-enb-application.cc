@@ -30,16 +30,21 @@
 #include "ns3/ipv4.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 
 #include "epc-gtpu-header.h"
 #include "eps-bearer-tag.h"
 
+#include <time.h>
+
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EpcEnbApplication");
 
 EpcEnbApplication::EpsFlowId_t::EpsFlowId_t ()
+  : m_rnti (0),
+    m_bid (0)
 {
 }
 
@@ -67,7 +72,14 @@ EpcEnbApplication::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::EpcEnbApplication")
     .SetParent<Object> ()
-    .SetGroupName("Lte");
+    .SetGroupName("Lte")
+    .AddAttribute ("EnablePacketTiming",
+                   "If true, the wall-clock time spent by the application "
+                   "on each uplink and downlink packet is measured",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&EpcEnbApplication::m_enablePacketTiming),
+                   MakeBooleanChecker ())
+    ;
   return tid;
 }
 
@@ -90,6 +102,7 @@ EpcEnbApplication::EpcEnbApplication (Ptr<Socket> lteSocket, Ptr<Socket> s1uSock
     m_gtpuUdpPort (2152), // fixed by the standard
     m_s1SapUser (0),
     m_s1apSapMme (0),
+    m_enablePacketTiming (false),
     m_cellId (cellId)
 {
   NS_LOG_FUNCTION (this << lteSocket << s1uSocket << sgwS1uAddress);
@@ -97,6 +110,10 @@ EpcEnbApplication::EpcEnbApplication (Ptr<Socket> lteSocket, Ptr<Socket> s1uSock
   m_lteSocket->SetRecvCallback (MakeCallback (&EpcEnbApplication::RecvFromLteSocket, this));
   m_s1SapProvider = new MemberEpcEnbS1SapProvider<EpcEnbApplication> (this);
   m_s1apSapEnb = new MemberEpcS1apSapEnb<EpcEnbApplication> (this);
+  m_ulStats.packets = 0;
+  m_ulStats.nanoseconds = 0;
+  m_dlStats.packets = 0;
+  m_dlStats.nanoseconds = 0;
 }
 
 
@@ -132,6 +149,73 @@ EpcEnbApplication::GetS1apSapEnb ()
   return m_s1apSapEnb;
 }
 
+EpcEnbApplication::PacketProcessingStats
+EpcEnbApplication::GetUlPacketProcessingStats () const
+{
+  return m_ulStats;
+}
+
+EpcEnbApplication::PacketProcessingStats
+EpcEnbApplication::GetDlPacketProcessingStats () const
+{
+  return m_dlStats;
+}
+
+uint64_t
+EpcEnbApplication::GetWallClockNs ()
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void
+EpcEnbApplication::AddTeid (uint32_t teid, uint16_t rnti, uint8_t bid)
+{
+  NS_LOG_FUNCTION (this << teid << rnti << (uint16_t) bid);
+  NS_ASSERT_MSG (bid < 16, "invalid EPS bearer ID " << (uint16_t) bid);
+
+  uint32_t slot = AllocateUeSlot (rnti);
+  m_ulTeidTable[(slot << 4) | bid] = teid;
+
+  m_teidRbidMap[teid] = EpsFlowId_t (rnti, bid);
+}
+
+uint32_t
+EpcEnbApplication::AllocateUeSlot (uint16_t rnti)
+{
+  std::map<uint16_t, uint32_t>::iterator it = m_ueSlotByRnti.find (rnti);
+  if (it != m_ueSlotByRnti.end ())
+    {
+      return it->second;
+    }
+  uint32_t slot;
+  if (!m_freeUeSlots.empty ())
+    {
+      slot = m_freeUeSlots.back ();
+      m_freeUeSlots.pop_back ();
+    }
+  else
+    {
+      slot = m_ulTeidTable.size () >> 4;
+      m_ulTeidTable.resize ((slot + 1) << 4, 0);
+    }
+  NS_LOG_LOGIC ("RNTI " << rnti << " in UE slot " << slot);
+  m_ueSlotByRnti[rnti] = slot;
+  return slot;
+}
+
+uint32_t
+EpcEnbApplication::GetUlTeid (uint16_t rnti, uint8_t bid) const
+{
+  std::map<uint16_t, uint32_t>::const_iterator it = m_ueSlotByRnti.find (rnti);
+  if (it == m_ueSlotByRnti.end ())
+    {
+      return 0;
+    }
+  return m_ulTeidTable[(it->second << 4) | (bid & 0x0f)];
+}
+
 void 
 EpcEnbApplication::DoInitialUeMessage (uint64_t imsi, uint16_t rnti)
 {
@@ -162,10 +246,7 @@ EpcEnbApplication::DoPathSwitchRequest (EpcEnbS1SapProvider::PathSwitchRequestPa
       flowId.m_bid = bit->epsBearerId;
       uint32_t teid = bit->teid;
       
-      EpsFlowId_t rbid (params.rnti, bit->epsBearerId);
-      // side effect: create entries if not exist
-      m_rbidTeidMap[params.rnti][bit->epsBearerId] = teid;
-      m_teidRbidMap[teid] = rbid;
+      AddTeid (teid, params.rnti, bit->epsBearerId);
 
       EpcS1apSapMme::ErabSwitchedInDownlinkItem erab;
       erab.erabId = bit->epsBearerId;
@@ -181,18 +262,23 @@ void
 EpcEnbApplication::DoUeContextRelease (uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << rnti);
-  std::map<uint16_t, std::map<uint8_t, uint32_t> >::iterator rntiIt = m_rbidTeidMap.find (rnti);
-  if (rntiIt != m_rbidTeidMap.end ())
+  std::map<uint16_t, uint32_t>::iterator it = m_ueSlotByRnti.find (rnti);
+  if (it == m_ueSlotByRnti.end ())
+    {
+      return;
+    }
+  uint32_t slot = it->second;
+  for (uint8_t bid = 0; bid < 16; ++bid)
     {
-      for (std::map<uint8_t, uint32_t>::iterator bidIt = rntiIt->second.begin ();
-           bidIt != rntiIt->second.end ();
-           ++bidIt)
+      uint32_t& teid = m_ulTeidTable[(slot << 4) | bid];
+      if (teid != 0)
         {
-          uint32_t teid = bidIt->second;
           m_teidRbidMap.erase (teid);
+          teid = 0;
         }
-      m_rbidTeidMap.erase (rntiIt);
     }
+  m_freeUeSlots.push_back (slot);
+  m_ueSlotByRnti.erase (it);
 }
 
 void 
@@ -218,10 +304,7 @@ EpcEnbApplication::DoInitialContextSetupRequest (uint64_t mmeUeS1Id, uint16_t en
       params.gtpTeid = erabIt->sgwTeid;
       m_s1SapUser->DataRadioBearerSetupRequest (params);
 
-      EpsFlowId_t rbid (rnti, erabIt->erabId);
-      // side effect: create entries if not exist
-      m_rbidTeidMap[rnti][erabIt->erabId] = params.gtpTeid;
-      m_teidRbidMap[params.gtpTeid] = rbid;
+      AddTeid (params.gtpTeid, rnti, erabIt->erabId);
 
     }
 }
@@ -245,6 +328,7 @@ EpcEnbApplication::RecvFromLteSocket (Ptr<Socket> socket)
 {
   NS_LOG_FUNCTION (this);  
   NS_ASSERT (socket == m_lteSocket);
+  uint64_t startNs = m_enablePacketTiming ? GetWallClockNs () : 0;
   Ptr<Packet> packet = socket->Recv ();
 
   /// \internal
@@ -258,18 +342,20 @@ EpcEnbApplication::RecvFromLteSocket (Ptr<Socket> socket)
   uint16_t rnti = tag.GetRnti ();
   uint8_t bid = tag.GetBid ();
   NS_LOG_LOGIC ("received packet with RNTI=" << (uint32_t) rnti << ", BID=" << (uint32_t)  bid);
-  std::map<uint16_t, std::map<uint8_t, uint32_t> >::iterator rntiIt = m_rbidTeidMap.find (rnti);
-  if (rntiIt == m_rbidTeidMap.end ())
+  uint32_t teid = GetUlTeid (rnti, bid);
+  if (teid == 0)
     {
       NS_LOG_WARN ("UE context not found, discarding packet when receiving from lteSocket");
     }
   else
     {
-      std::map<uint8_t, uint32_t>::iterator bidIt = rntiIt->second.find (bid);
-      NS_ASSERT (bidIt != rntiIt->second.end ());
-      uint32_t teid = bidIt->second;
       SendToS1uSocket (packet, teid);
     }
+  if (m_enablePacketTiming)
+    {
+      ++m_ulStats.packets;
+      m_ulStats.nanoseconds += GetWallClockNs () - startNs;
+    }
 }
 
 void 
@@ -277,6 +363,7 @@ EpcEnbApplication::RecvFromS1uSocket (Ptr<Socket> socket)
 {
   NS_LOG_FUNCTION (this << socket);  
   NS_ASSERT (socket == m_s1uSocket);
+  uint64_t startNs = m_enablePacketTiming ? GetWallClockNs () : 0;
   Ptr<Packet> packet = socket->Recv ();
   GtpuHeader gtpu;
   packet->RemoveHeader (gtpu);
@@ -297,6 +384,11 @@ EpcEnbApplication::RecvFromS1uSocket (Ptr<Socket> socket)
       packet = 0;
       NS_LOG_DEBUG("UE context not found, discarding packet when receiving from s1uSocket");
     }  
+  if (m_enablePacketTiming)
+    {
+      ++m_dlStats.packets;
+      m_dlStats.nanoseconds += GetWallClockNs () - startNs;
+    }
 }
 
 void 
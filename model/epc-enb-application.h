@@ -35,6 +35,7 @@
 #include <ns3/epc-enb-s1-sap.h>
 #include <ns3/epc-s1ap-sap.h>
 #include <map>
+#include <vector>
 
 namespace ns3 {
 class EpcEnbS1SapUser;
@@ -137,6 +138,30 @@ public:
     friend bool operator < (const EpsFlowId_t &a, const EpsFlowId_t &b);
   };
 
+  /**
+   * wall-clock processing statistics of the user plane packets
+   * handled by this application in one direction
+   */
+  struct PacketProcessingStats
+  {
+    uint64_t packets;      ///< number of packets processed
+    uint64_t nanoseconds;  ///< total wall-clock time spent processing them
+  };
+
+  /**
+   * \return the processing statistics of the uplink packets (LTE
+   * socket to S1-U). Only updated if the EnablePacketTiming attribute
+   * is set.
+   */
+  PacketProcessingStats GetUlPacketProcessingStats () const;
+
+  /**
+   * \return the processing statistics of the downlink packets (S1-U
+   * to LTE socket). Only updated if the EnablePacketTiming attribute
+   * is set.
+   */
+  PacketProcessingStats GetDlPacketProcessingStats () const;
+
 
 private:
 
@@ -186,6 +211,37 @@ private:
    */
   void SetupS1Bearer (uint32_t teid, uint16_t rnti, uint8_t bid);
 
+  /** 
+   * store the association between a S1-U TEID and a (RNTI, BID) pair
+   * in the TEID table and map
+   * 
+   * \param teid 
+   * \param rnti 
+   * \param bid 
+   */
+  void AddTeid (uint32_t teid, uint16_t rnti, uint8_t bid);
+
+  /** 
+   * \param rnti 
+   * 
+   * \return the slot of the UE in the uplink TEID table, allocated if
+   * the UE has none yet
+   */
+  uint32_t AllocateUeSlot (uint16_t rnti);
+
+  /** 
+   * \param rnti 
+   * \param bid 
+   * 
+   * \return the uplink S1-U TEID of the bearer, 0 if unknown
+   */
+  uint32_t GetUlTeid (uint16_t rnti, uint8_t bid) const;
+
+  /** 
+   * \return the current wall-clock time in nanoseconds
+   */
+  static uint64_t GetWallClockNs ();
+
   /**
    * raw packet socket to send and receive the packets to and from the LTE radio interface
    */
@@ -207,16 +263,39 @@ private:
   Ipv4Address m_sgwS1uAddress;
 
   /**
-   * map of maps telling for each RNTI and BID the corresponding  S1-U TEID
-   * 
+   * map telling for each RNTI the slot of the UE in the uplink TEID
+   * table. Slots are allocated when the first bearer of the UE is set
+   * up and freed when its context is released, so the table grows
+   * with the UEs served at the same time rather than with the RNTIs.
    */
-  std::map<uint16_t, std::map<uint8_t, uint32_t> > m_rbidTeidMap;  
+  std::map<uint16_t, uint32_t> m_ueSlotByRnti;
 
   /**
-   * map telling for each S1-U TEID the corresponding RNTI,BID
-   * 
+   * table telling for each (UE slot, BID) the corresponding S1-U TEID,
+   * indexed by (slot << 4) | BID. 0 marks an unused entry.
+   */
+  std::vector<uint32_t> m_ulTeidTable;
+
+  /**
+   * released UE slots, reused before the table is extended
+   */
+  std::vector<uint32_t> m_freeUeSlots;
+
+  /**
+   * map telling for each S1-U TEID the corresponding RNTI,BID. The
+   * TEIDs are allocated by the SGW for all the eNBs, so those of an
+   * eNB are sparse and a table indexed by TEID would grow with the
+   * whole network.
    */
   std::map<uint32_t, EpsFlowId_t> m_teidRbidMap;
+
+  /**
+   * if true, the wall-clock time spent per packet is measured
+   */
+  bool m_enablePacketTiming;
+
+  PacketProcessingStats m_ulStats;
+  PacketProcessingStats m_dlStats;
  
   /**
    * UDP port to be used for GTP
@@ -31,6 +31,12 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/epc-gtpu-header.h"
 #include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/node.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/udp-header.h"
+#include "ns3/udp-l4-protocol.h"
+#include "ns3/ipv4-l3-protocol.h"
 
 namespace ns3 {
 
@@ -106,7 +112,18 @@ EpcSgwPgwApplication::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::EpcSgwPgwApplication")
     .SetParent<Object> ()
-    .SetGroupName("Lte");
+    .SetGroupName("Lte")
+    .AddAttribute ("DirectS1uDelivery",
+                   "If true, downlink GTP-U packets are encapsulated in UDP/IP "
+                   "by the application itself and handed directly to the "
+                   "S1-U NetDevice towards the eNB, bypassing the S1-U socket "
+                   "and the IP routing of the SGW/PGW node. Only eNBs whose "
+                   "S1-U NetDevice has been notified with SetS1uDevice are "
+                   "served this way; the others still use the socket.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&EpcSgwPgwApplication::m_directS1uDelivery),
+                   MakeBooleanChecker ())
+    ;
   return tid;
 }
 
@@ -116,6 +133,7 @@ EpcSgwPgwApplication::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_s1uSocket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
   m_s1uSocket = 0;
+  m_s1uDeviceByEnbAddrMap.clear ();
   delete (m_s11SapSgw);
 }
 
@@ -126,7 +144,9 @@ EpcSgwPgwApplication::EpcSgwPgwApplication (const Ptr<VirtualNetDevice> tunDevic
     m_tunDevice (tunDevice),
     m_gtpuUdpPort (2152), // fixed by the standard
     m_teidCount (0),
-    m_s11SapMme (0)
+    m_s11SapMme (0),
+    m_directS1uDelivery (false),
+    m_ipv4Identification (0)
 {
   NS_LOG_FUNCTION (this << tunDevice << s1uSocket);
   m_s1uSocket->SetRecvCallback (MakeCallback (&EpcSgwPgwApplication::RecvFromS1uSocket, this));
@@ -145,11 +165,12 @@ EpcSgwPgwApplication::RecvFromTunDevice (Ptr<Packet> packet, const Address& sour
 {
   NS_LOG_FUNCTION (this << source << dest << packet << packet->GetSize ());
 
-  // get IP address of UE
-  Ptr<Packet> pCopy = packet->Copy ();
-  Ipv4Header ipv4Header;
-  pCopy->RemoveHeader (ipv4Header);
-  Ipv4Address ueAddr =  ipv4Header.GetDestination ();
+  // get IP address of UE, reading it in place from the IPv4 header
+  // (RFC 791) rather than deserializing a copy of the packet
+  uint8_t buf[20];
+  uint32_t size = packet->CopyData (buf, 20);
+  NS_ASSERT_MSG (size == 20, "packet too short for an IPv4 header");
+  Ipv4Address ueAddr (((uint32_t) buf[16] << 24) | ((uint32_t) buf[17] << 16) | ((uint32_t) buf[18] << 8) | buf[19]);
   NS_LOG_LOGIC ("packet addressed to UE " << ueAddr);
 
   // find corresponding UeInfo address
@@ -166,7 +187,7 @@ EpcSgwPgwApplication::RecvFromTunDevice (Ptr<Packet> packet, const Address& sour
         {
           NS_LOG_WARN ("no matching bearer for this packet");                   
         }
-      else
+      else if (!m_directS1uDelivery || !SendToS1uDevice (packet, enbAddr, teid))
         {
           SendToS1uSocket (packet, enbAddr, teid);
         }
@@ -219,6 +240,65 @@ EpcSgwPgwApplication::SendToS1uSocket (Ptr<Packet> packet, Ipv4Address enbAddr,
   m_s1uSocket->SendTo (packet, flags, InetSocketAddress (enbAddr, m_gtpuUdpPort));
 }
 
+bool
+EpcSgwPgwApplication::SendToS1uDevice (Ptr<Packet> packet, Ipv4Address enbAddr, uint32_t teid)
+{
+  NS_LOG_FUNCTION (this << packet << enbAddr << teid);
+
+  std::map<Ipv4Address, S1uDeviceInfo>::iterator it = m_s1uDeviceByEnbAddrMap.find (enbAddr);
+  if (it == m_s1uDeviceByEnbAddrMap.end ())
+    {
+      NS_LOG_LOGIC ("no S1-U device for eNB " << enbAddr);
+      return false;
+    }
+
+  GtpuHeader gtpu;
+  gtpu.SetTeid (teid);
+  // From 3GPP TS 29.281 v10.0.0 Section 5.1
+  // Length of the payload + the non obligatory GTP-U header
+  gtpu.SetLength (packet->GetSize () + gtpu.GetSerializedSize () - 8);
+
+  UdpHeader udp;
+  udp.SetSourcePort (m_gtpuUdpPort);
+  udp.SetDestinationPort (m_gtpuUdpPort);
+
+  Ipv4Header ipv4;
+  ipv4.SetSource (it->second.sgwAddr);
+  ipv4.SetDestination (enbAddr);
+  ipv4.SetProtocol (UdpL4Protocol::PROT_NUMBER);
+  ipv4.SetTtl (64);
+  ipv4.SetIdentification (m_ipv4Identification);
+  uint32_t ipPayloadSize = packet->GetSize () + gtpu.GetSerializedSize () + udp.GetSerializedSize ();
+  ipv4.SetPayloadSize (ipPayloadSize);
+
+  if (ipPayloadSize + ipv4.GetSerializedSize () > it->second.device->GetMtu ())
+    {
+      // let the IP stack of the SGW/PGW take care of fragmentation
+      NS_LOG_LOGIC ("packet exceeds the S1-U MTU");
+      return false;
+    }
+
+  if (Node::ChecksumEnabled ())
+    {
+      udp.EnableChecksums ();
+      udp.InitializeChecksum (it->second.sgwAddr, enbAddr, UdpL4Protocol::PROT_NUMBER);
+      ipv4.EnableChecksum ();
+    }
+
+  // all the tunneling headers are added back to back, before the
+  // packet is handed to the device
+  packet->AddHeader (gtpu);
+  packet->AddHeader (udp);
+  packet->AddHeader (ipv4);
+  ++m_ipv4Identification;
+  if (!it->second.device->Send (packet, it->second.device->GetBroadcast (), Ipv4L3Protocol::PROT_NUMBER))
+    {
+      // same as a drop in the device queue when sending through the socket
+      NS_LOG_WARN ("S1-U device dropped the packet");
+    }
+  return true;
+}
+
 
 void 
 EpcSgwPgwApplication::SetS11SapMme (EpcS11SapMme * s)
@@ -242,6 +322,16 @@ EpcSgwPgwApplication::AddEnb (uint16_t cellId, Ipv4Address enbAddr, Ipv4Address
   m_enbInfoByCellId[cellId] = enbInfo;
 }
 
+void 
+EpcSgwPgwApplication::SetS1uDevice (Ipv4Address enbAddr, Ipv4Address sgwAddr, Ptr<NetDevice> sgwS1uDevice)
+{
+  NS_LOG_FUNCTION (this << enbAddr << sgwAddr << sgwS1uDevice);
+  S1uDeviceInfo info;
+  info.device = sgwS1uDevice;
+  info.sgwAddr = sgwAddr;
+  m_s1uDeviceByEnbAddrMap[enbAddr] = info;
+}
+
 void 
 EpcSgwPgwApplication::AddUe (uint64_t imsi)
 {
@@ -36,6 +36,7 @@
 #include <ns3/application.h>
 #include <ns3/epc-s1ap-sap.h>
 #include <ns3/epc-s11-sap.h>
+#include <ns3/net-device.h>
 #include <map>
 
 namespace ns3 {
@@ -110,6 +111,21 @@ public:
    * \param teid the Tunnel Enpoint IDentifier
    */
   void SendToS1uSocket (Ptr<Packet> packet, Ipv4Address enbS1uAddress, uint32_t teid);
+
+  /** 
+   * Send a packet to the eNB via the S1-U interface, writing the
+   * GTP-U/UDP/IP headers directly and handing the resulting datagram
+   * to the S1-U NetDevice, without going through the UDP socket and
+   * the IP routing of the SGW/PGW node. 
+   * 
+   * \param packet packet to be sent
+   * \param enbS1uAddress the address of the eNB
+   * \param teid the Tunnel Enpoint IDentifier
+   *
+   * \return false if the packet could not be sent directly, in which
+   * case it has not been modified
+   */
+  bool SendToS1uDevice (Ptr<Packet> packet, Ipv4Address enbS1uAddress, uint32_t teid);
   
 
   /** 
@@ -135,6 +151,17 @@ public:
    */
   void AddEnb (uint16_t cellId, Ipv4Address enbAddr, Ipv4Address sgwAddr);
 
+  /** 
+   * Let the SGW know the NetDevice of the point-to-point S1-U link
+   * towards an eNB. This is needed only if the DirectS1uDelivery
+   * attribute is set.
+   * 
+   * \param enbAddr the address of the eNB
+   * \param sgwAddr the address of the SGW on the S1-U link
+   * \param sgwS1uDevice the NetDevice of the SGW on the S1-U link
+   */
+  void SetS1uDevice (Ipv4Address enbAddr, Ipv4Address sgwAddr, Ptr<NetDevice> sgwS1uDevice);
+
   /** 
    * Let the SGW be aware of a new UE
    * 
@@ -273,6 +300,30 @@ public:
   };
 
   std::map<uint16_t, EnbInfo> m_enbInfoByCellId;
+
+  struct S1uDeviceInfo
+  {
+    Ptr<NetDevice> device;
+    Ipv4Address sgwAddr;
+  };
+
+  /**
+   * Map telling for each eNB address the S1-U NetDevice to be used
+   * for direct delivery
+   */
+  std::map<Ipv4Address, S1uDeviceInfo> m_s1uDeviceByEnbAddrMap;
+
+  /**
+   * true if the GTP-U packets are to be sent directly through the
+   * S1-U NetDevice instead of the S1-U socket
+   */
+  bool m_directS1uDelivery;
+
+  /**
+   * identification field of the IPv4 header of the GTP-U packets sent
+   * directly through the S1-U NetDevice
+   */
+  uint16_t m_ipv4Identification;
 };
 
 } //namespace ns3
@@ -28,11 +28,9 @@
 
 #include "epc-tft-classifier.h"
 #include "epc-tft.h"
+#include "lte-profiler.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
-#include "ns3/ipv4-header.h"
-#include "ns3/udp-header.h"
-#include "ns3/tcp-header.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/tcp-l4-protocol.h"
 
@@ -40,7 +38,55 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EpcTftClassifier");
 
+/// maximum number of buckets of the exact-match table (must be a power of 2)
+static const uint32_t EXACT_TABLE_MAX_SIZE = 64;
+
+/// number of entries of the per-flow cache (must be a power of 2)
+static const uint32_t FLOW_CACHE_SIZE = 256;
+
+/// minimum number of range filters for which the per-flow cache is used
+static const uint32_t FLOW_CACHE_MIN_FILTERS = 4;
+
+/// maximum length of the IPv4 header plus the port fields of UDP/TCP
+static const uint32_t MAX_PEEK_SIZE = 64;
+
+
+bool
+EpcTftClassifier::FlowKey::operator== (const FlowKey& other) const
+{
+  return (remoteAddress == other.remoteAddress)
+    && (localAddress == other.localAddress)
+    && (remotePort == other.remotePort)
+    && (localPort == other.localPort)
+    && (direction == other.direction)
+    && (tos == other.tos);
+}
+
+uint32_t
+EpcTftClassifier::FlowKey::Hash () const
+{
+  uint32_t h = remoteAddress * 0x9e3779b1U;
+  h ^= localAddress + 0x7f4a7c15U + (h << 6) + (h >> 2);
+  h ^= ((uint32_t) remotePort << 16 | localPort) + 0x7f4a7c15U + (h << 6) + (h >> 2);
+  h ^= ((uint32_t) direction << 8 | tos) + 0x7f4a7c15U + (h << 6) + (h >> 2);
+  return h;
+}
+
+bool
+EpcTftClassifier::CompiledFilter::Matches (const FlowKey& k) const
+{
+  return (k.direction & direction)
+    && ((k.remoteAddress & remoteMask) == remoteAddress)
+    && ((k.localAddress & localMask) == localAddress)
+    && (k.remotePort >= remotePortStart) && (k.remotePort <= remotePortEnd)
+    && (k.localPort >= localPortStart) && (k.localPort <= localPortEnd)
+    && ((k.tos & tosMask) == tos);
+}
+
+
 EpcTftClassifier::EpcTftClassifier ()
+  : m_exactTableMask (0),
+    m_dirty (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -50,8 +96,7 @@ EpcTftClassifier::Add (Ptr<EpcTft> tft, uint32_t id)
 {
   NS_LOG_FUNCTION (this << tft);
   m_tftMap[id] = tft;  
-
-
+  m_dirty = true;
   
   // simple sanity check: there shouldn't be more than 16 bearers (hence TFTs) per UE
   NS_ASSERT (m_tftMap.size () <= 16);
@@ -62,101 +107,281 @@ EpcTftClassifier::Delete (uint32_t id)
 {
   NS_LOG_FUNCTION (this << id);
   m_tftMap.erase (id);
+  m_dirty = true;
 }
 
- 
-uint32_t 
-EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
+Ptr<EpcTft>
+EpcTftClassifier::GetTft (uint32_t id) const
 {
-  NS_LOG_FUNCTION (this << p << " on direction " << direction);
+  std::map <uint32_t, Ptr<EpcTft> >::const_iterator it = m_tftMap.find (id);
+  if (it == m_tftMap.end ())
+    {
+      return 0;
+    }
+  return it->second;
+}
 
-  Ptr<Packet> pCopy = p->Copy ();
+void
+EpcTftClassifier::Compile ()
+{
+  NS_LOG_FUNCTION (this);
+  m_rangeFilters.clear ();
+  std::vector<ExactEntry> exactEntries;
+  for (std::map <uint32_t, Ptr<EpcTft> >::const_iterator it = m_tftMap.begin ();
+       it != m_tftMap.end ();
+       ++it)
+    {
+      CompileTft (it->second, it->first, exactEntries);
+    }
 
-  Ipv4Header ipv4Header;
-  pCopy->RemoveHeader (ipv4Header);
+  // one bucket per entry, up to the maximum size of the table
+  uint32_t nBuckets = 0;
+  if (!exactEntries.empty ())
+    {
+      nBuckets = 1;
+      while ((nBuckets < exactEntries.size ()) && (nBuckets < EXACT_TABLE_MAX_SIZE))
+        {
+          nBuckets <<= 1;
+        }
+    }
+  std::vector<std::vector<ExactEntry> > (nBuckets).swap (m_exactTable);
+  m_exactTableMask = (nBuckets > 0) ? nBuckets - 1 : 0;
+  for (std::vector<ExactEntry>::const_iterator it = exactEntries.begin ();
+       it != exactEntries.end ();
+       ++it)
+    {
+      m_exactTable[it->key.Hash () & m_exactTableMask].push_back (*it);
+    }
 
-  Ipv4Address localAddress;
-  Ipv4Address remoteAddress;
+  // with a few range filters, a lookup costs about as much as the
+  // cache itself. The cache is allocated on the first classification.
+  if (m_rangeFilters.size () < FLOW_CACHE_MIN_FILTERS)
+    {
+      std::vector<CacheEntry> ().swap (m_flowCache);
+    }
+  FlushFlowCache ();
+  m_dirty = false;
+}
+
+void
+EpcTftClassifier::CompileTft (Ptr<EpcTft> tft, uint32_t id, std::vector<ExactEntry>& exactEntries)
+{
+  NS_LOG_FUNCTION (this << tft << id);
+  std::list<EpcTft::PacketFilter> filters = tft->GetPacketFilters ();
+  for (std::list<EpcTft::PacketFilter>::const_iterator it = filters.begin ();
+       it != filters.end ();
+       ++it)
+    {
+      bool exact = (it->remoteMask.Get () == 0xffffffff)
+        && (it->localMask.Get () == 0xffffffff)
+        && (it->remotePortStart == it->remotePortEnd)
+        && (it->localPortStart == it->localPortEnd)
+        && (it->typeOfServiceMask == 0);
+      if (exact)
+        {
+          // one entry per direction, so that lookups use the direction
+          // of the packet as part of the key
+          for (uint8_t d = EpcTft::DOWNLINK; d <= EpcTft::UPLINK; ++d)
+            {
+              if (d & it->direction)
+                {
+                  ExactEntry e;
+                  e.key.remoteAddress = it->remoteAddress.Get ();
+                  e.key.localAddress = it->localAddress.Get ();
+                  e.key.remotePort = it->remotePortStart;
+                  e.key.localPort = it->localPortStart;
+                  e.key.direction = d;
+                  e.key.tos = 0;
+                  e.id = id;
+                  exactEntries.push_back (e);
+                }
+            }
+        }
+      else
+        {
+          CompiledFilter f;
+          f.id = id;
+          f.direction = it->direction;
+          f.remoteMask = it->remoteMask.Get ();
+          f.remoteAddress = it->remoteAddress.Get () & f.remoteMask;
+          f.localMask = it->localMask.Get ();
+          f.localAddress = it->localAddress.Get () & f.localMask;
+          f.remotePortStart = it->remotePortStart;
+          f.remotePortEnd = it->remotePortEnd;
+          f.localPortStart = it->localPortStart;
+          f.localPortEnd = it->localPortEnd;
+          f.tosMask = it->typeOfServiceMask;
+          f.tos = it->typeOfService & f.tosMask;
+
+          // keep the list sorted by decreasing TFT id, and the filters
+          // of the same TFT in precedence order
+          std::vector<CompiledFilter>::iterator pos = m_rangeFilters.begin ();
+          while ((pos != m_rangeFilters.end ()) && (pos->id >= id))
+            {
+              ++pos;
+            }
+          m_rangeFilters.insert (pos, f);
+        }
+    }
+}
+
+void
+EpcTftClassifier::FlushFlowCache ()
+{
+  for (std::vector<CacheEntry>::iterator it = m_flowCache.begin ();
+       it != m_flowCache.end ();
+       ++it)
+    {
+      it->valid = false;
+    }
+}
+
+bool
+EpcTftClassifier::ReadFlowKey (Ptr<Packet> p, EpcTft::Direction direction, FlowKey& key)
+{
+  // read the first bytes of the packet without copying nor
+  // deserializing it. The layout is that of RFC 791 and RFC 768 / 793.
+  uint8_t buf[MAX_PEEK_SIZE];
+  uint32_t size = p->CopyData (buf, MAX_PEEK_SIZE);
+  if (size < 20)
+    {
+      NS_LOG_INFO ("packet too short for an IPv4 header: " << size << " bytes");
+      return false;
+    }
+
+  uint32_t ihl = (buf[0] & 0x0f) * 4;
+  uint8_t tos = buf[1];
+  uint8_t protocol = buf[9];
+  uint32_t source = ((uint32_t) buf[12] << 24) | ((uint32_t) buf[13] << 16) | ((uint32_t) buf[14] << 8) | buf[15];
+  uint32_t destination = ((uint32_t) buf[16] << 24) | ((uint32_t) buf[17] << 16) | ((uint32_t) buf[18] << 8) | buf[19];
+
+  if ((protocol != UdpL4Protocol::PROT_NUMBER) && (protocol != TcpL4Protocol::PROT_NUMBER))
+    {
+      NS_LOG_INFO ("Unknown protocol: " << (uint16_t) protocol);
+      return false;
+    }
+  if ((ihl < 20) || (size < ihl + 4))
+    {
+      NS_LOG_INFO ("packet too short for the transport ports: " << size << " bytes, IHL " << ihl);
+      return false;
+    }
+
+  // source and destination ports are at the same offsets in UDP and TCP
+  uint16_t sourcePort = ((uint16_t) buf[ihl] << 8) | buf[ihl + 1];
+  uint16_t destinationPort = ((uint16_t) buf[ihl + 2] << 8) | buf[ihl + 3];
 
-  
   if (direction ==  EpcTft::UPLINK)
     {
-      localAddress = ipv4Header.GetSource ();
-      remoteAddress = ipv4Header.GetDestination ();
+      key.localAddress = source;
+      key.remoteAddress = destination;
+      key.localPort = sourcePort;
+      key.remotePort = destinationPort;
     }
   else
     { 
       NS_ASSERT (direction ==  EpcTft::DOWNLINK);
-      remoteAddress = ipv4Header.GetSource ();
-      localAddress = ipv4Header.GetDestination ();      
+      key.remoteAddress = source;
+      key.localAddress = destination;
+      key.remotePort = sourcePort;
+      key.localPort = destinationPort;
     }
-  
-  uint8_t protocol = ipv4Header.GetProtocol ();
-
-  uint8_t tos = ipv4Header.GetTos ();
+  key.direction = direction;
+  key.tos = tos;
+  return true;
+}
 
-  uint16_t localPort = 0;
-  uint16_t remotePort = 0;
+uint32_t
+EpcTftClassifier::DoClassify (const FlowKey& key) const
+{
+  // the TFT with the highest id is preferred, since filter priority is
+  // not implemented properly. This way, since the default bearer is
+  // expected to be added first, it will be evaluated last.
+  uint32_t exactId = 0;
+  if (!m_exactTable.empty ())
+    {
+      FlowKey exactKey = key;
+      exactKey.tos = 0;
+      const std::vector<ExactEntry>& bucket = m_exactTable[exactKey.Hash () & m_exactTableMask];
+      for (std::vector<ExactEntry>::const_iterator it = bucket.begin ();
+           it != bucket.end ();
+           ++it)
+        {
+          if ((it->key == exactKey) && (it->id > exactId))
+            {
+              exactId = it->id;
+            }
+        }
+    }
 
-  if (protocol == UdpL4Protocol::PROT_NUMBER)
+  // only the range filters of TFTs with a higher id can take over
+  for (std::vector<CompiledFilter>::const_iterator it = m_rangeFilters.begin ();
+       (it != m_rangeFilters.end ()) && (it->id > exactId);
+       ++it)
     {
-      UdpHeader udpHeader;
-      pCopy->RemoveHeader (udpHeader);
+      if (it->Matches (key))
+        {
+          return it->id;
+        }
+    }
+  return exactId;
+}
+ 
+uint32_t 
+EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
+{
+  NS_LOG_FUNCTION (this << p << " on direction " << direction);
+  LTE_PROFILE_SCOPE (TFT_CLASSIFY);
 
-      if (direction ==  EpcTft::UPLINK)
-	{
-	  localPort = udpHeader.GetSourcePort ();
-	  remotePort = udpHeader.GetDestinationPort ();
-	}
-      else
-	{
-	  remotePort = udpHeader.GetSourcePort ();
-	  localPort = udpHeader.GetDestinationPort ();
-	}
-    }
-  else if (protocol == TcpL4Protocol::PROT_NUMBER)
-    {
-      TcpHeader tcpHeader;
-      pCopy->RemoveHeader (tcpHeader);
-      if (direction ==  EpcTft::UPLINK)
-	{
-	  localPort = tcpHeader.GetSourcePort ();
-	  remotePort = tcpHeader.GetDestinationPort ();
-	}
-      else
-	{
-	  remotePort = tcpHeader.GetSourcePort ();
-	  localPort = tcpHeader.GetDestinationPort ();
-	}
+  if (m_dirty)
+    {
+      Compile ();
     }
-  else
+
+  FlowKey key;
+  if (!ReadFlowKey (p, direction, key))
     {
-      NS_LOG_INFO ("Unknown protocol: " << protocol);
       return 0;  // no match
     }
 
   NS_LOG_INFO ("Classifing packet:"
-	       << " localAddr="  << localAddress 
-	       << " remoteAddr=" << remoteAddress 
-	       << " localPort="  << localPort 
-	       << " remotePort=" << remotePort 
-	       << " tos=0x" << (uint16_t) tos );
-
-  // now it is possible to classify the packet!
-  // we use a reverse iterator since filter priority is not implemented properly.
-  // This way, since the default bearer is expected to be added first, it will be evaluated last.
-  std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it;
-  for (it = m_tftMap.rbegin (); it != m_tftMap.rend (); ++it)
-    {
-      Ptr<EpcTft> tft = it->second;         
-      if (tft->Matches (direction, remoteAddress, localAddress, remotePort, localPort, tos))
+	       << " localAddr="  << Ipv4Address (key.localAddress)
+	       << " remoteAddr=" << Ipv4Address (key.remoteAddress)
+	       << " localPort="  << key.localPort 
+	       << " remotePort=" << key.remotePort 
+	       << " tos=0x" << (uint16_t) key.tos );
+
+  uint32_t id;
+  if (m_rangeFilters.size () < FLOW_CACHE_MIN_FILTERS)
+    {
+      id = DoClassify (key);
+    }
+  else
+    {
+      if (m_flowCache.empty ())
+        {
+          m_flowCache.resize (FLOW_CACHE_SIZE);
+          FlushFlowCache ();
+        }
+      CacheEntry& entry = m_flowCache[key.Hash () & (FLOW_CACHE_SIZE - 1)];
+      if (entry.valid && (entry.key == key))
         {
-	  NS_LOG_INFO ("matches with TFT ID = " << it->first);
-	  return it->first; // the id of the matching TFT
+          NS_LOG_INFO ("cached match with TFT ID = " << entry.id);
+          return entry.id;
         }
+      id = DoClassify (key);
+      entry.key = key;
+      entry.id = id;
+      entry.valid = true;
+    }
+  if (id != 0)
+    {
+      NS_LOG_INFO ("matches with TFT ID = " << id);
+    }
+  else
+    {
+      NS_LOG_WARN ("no match");
     }
-  NS_LOG_WARN ("no match");
-  return 0;  // no match
+  return id;
 }
 
 
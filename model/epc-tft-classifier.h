@@ -28,6 +28,7 @@
 #include "ns3/epc-tft.h"
 
 #include <map>
+#include <vector>
 
 
 namespace ns3 {
@@ -37,7 +38,22 @@ class Packet;
 
 /**
  * \brief classifies IP packets accoding to Traffic Flow Templates (TFTs)
- * 
+ *
+ * The packet filters of all the TFTs are compiled at the first
+ * classification following the addition or the deletion of a TFT. A
+ * packet filter added to a TFT afterwards is only taken into account
+ * once the TFT is added again. Fully specified
+ * filters (host addresses, single ports, no ToS mask) are stored in an
+ * exact-match hash table keyed by the 5-tuple, with as many buckets as
+ * entries up to 64; all the other filters (address masks, port ranges,
+ * ToS masks) are kept in a list sorted by decreasing TFT id. With at
+ * least 4 of these, the result of each classification is additionally
+ * stored in a direct-mapped per-flow cache, allocated on the first
+ * classification and flushed whenever the filters are compiled.
+ *
+ * The header fields are read directly from the packet buffer, hence
+ * the packet is never copied nor modified.
+ *
  * \note this implementation works with IPv4 only.
  */
 class EpcTftClassifier : public SimpleRefCount<EpcTftClassifier>
@@ -47,10 +63,10 @@ public:
   EpcTftClassifier ();
   
   /** 
-   * add a TFT to the Classifier
+   * add a TFT to the Classifier, or replace the TFT with the same id
    * 
    * \param tft the TFT to be added
-   * 
+   * \param id the identifier of the TFT
    */
   void Add (Ptr<EpcTft> tft, uint32_t id);
 
@@ -60,6 +76,13 @@ public:
    * \param id the identifier of the TFT to be deleted
    */
   void Delete (uint32_t id);
+
+  /** 
+   * \param id the identifier of a TFT
+   * 
+   * \return the TFT added with the given identifier, 0 if none
+   */
+  Ptr<EpcTft> GetTft (uint32_t id) const;
   
 
   /** 
@@ -74,6 +97,107 @@ public:
 protected:
   
   std::map <uint32_t, Ptr<EpcTft> > m_tftMap;
+
+private:
+
+  /**
+   * the fields of a packet that are relevant for classification
+   */
+  struct FlowKey
+  {
+    uint32_t remoteAddress;
+    uint32_t localAddress;
+    uint16_t remotePort;
+    uint16_t localPort;
+    uint8_t direction;
+    uint8_t tos;
+
+    bool operator== (const FlowKey& other) const;
+    uint32_t Hash () const;
+  };
+
+  /**
+   * a PacketFilter whose addresses have already been masked
+   */
+  struct CompiledFilter
+  {
+    uint32_t id;
+    uint8_t direction;
+    uint32_t remoteAddress;
+    uint32_t remoteMask;
+    uint32_t localAddress;
+    uint32_t localMask;
+    uint16_t remotePortStart;
+    uint16_t remotePortEnd;
+    uint16_t localPortStart;
+    uint16_t localPortEnd;
+    uint8_t tos;
+    uint8_t tosMask;
+
+    bool Matches (const FlowKey& k) const;
+  };
+
+  struct ExactEntry
+  {
+    FlowKey key;
+    uint32_t id;
+  };
+
+  struct CacheEntry
+  {
+    FlowKey key;
+    uint32_t id;
+    bool valid;
+  };
+
+  /**
+   * rebuild the exact-match table and the range filter list from the
+   * packet filters of all the TFTs
+   */
+  void Compile ();
+
+  /**
+   * compile the packet filters of a TFT, appending the fully specified
+   * ones to the exact-match entries and inserting the others in the
+   * range filter list
+   *
+   * \param tft the TFT
+   * \param id the identifier of the TFT
+   * \param exactEntries the exact-match entries
+   */
+  void CompileTft (Ptr<EpcTft> tft, uint32_t id, std::vector<ExactEntry>& exactEntries);
+
+  /**
+   * invalidate all the entries of the per-flow cache
+   */
+  void FlushFlowCache ();
+
+  /**
+   * extract the classification fields from the packet buffer
+   *
+   * \param p the IP packet
+   * \param direction the direction
+   * \param key the extracted fields
+   *
+   * \return false if the transport protocol is neither UDP nor TCP, or
+   * if the packet is too short for the IPv4 header and the ports
+   */
+  static bool ReadFlowKey (Ptr<Packet> p, EpcTft::Direction direction, FlowKey& key);
+
+  /**
+   * classify a flow, bypassing the per-flow cache
+   *
+   * \param key the flow
+   *
+   * \return the identifier of the matching TFT, 0 if no TFT matched
+   */
+  uint32_t DoClassify (const FlowKey& key) const;
+
+  std::vector<std::vector<ExactEntry> > m_exactTable; ///< empty without fully specified filters
+  uint32_t m_exactTableMask;
+  std::vector<CompiledFilter> m_rangeFilters; ///< sorted by decreasing TFT id
+  std::vector<CacheEntry> m_flowCache; ///< empty until used
+  bool m_dirty; ///< whether a TFT was added or deleted since the filters were compiled
   
 };
 
@@ -150,6 +150,11 @@ public:
 		  uint16_t localPort,
 		  uint8_t typeOfService);
 
+  /**
+   *
+   * \return the packet filters of this TFT, sorted by precedence
+   */
+  std::list<PacketFilter> GetPacketFilters () const;
 
 private:
 
@@ -217,6 +217,12 @@ EpcUeNas::ActivateEpsBearer (EpsBearer bearer, Ptr<EpcTft> tft)
     }
 }
 
+Ptr<EpcTft>
+EpcUeNas::GetTft (uint8_t bid) const
+{
+  return m_tftClassifier.GetTft (bid);
+}
+
 bool
 EpcUeNas::Send (Ptr<Packet> packet)
 {
@@ -142,6 +142,13 @@ public:
    */
   void ActivateEpsBearer (EpsBearer bearer, Ptr<EpcTft> tft);
 
+  /** 
+   * \param bid the EPS bearer identity of an active bearer
+   * 
+   * \return the TFT of the bearer, 0 if the bearer is not active
+   */
+  Ptr<EpcTft> GetTft (uint8_t bid) const;
+
   /** 
    * Enqueue an IP packet on the proper bearer for uplink transmission
    * 
@@ -0,0 +1,149 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ff-mac-ul-sinr-cache.h"
+
+#include <ns3/log.h>
+#include <ns3/assert.h>
+#include <cfloat>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FfMacUlSinrCache");
+
+const uint16_t FfMacUlSinrCache::MAX_UL_RB;
+
+FfMacUlSinrCache::FfMacUlSinrCache ()
+  : m_ulBandwidth (0),
+    m_validity (0),
+    m_initialSinr (NO_SINR),
+    m_tti (0)
+{
+}
+
+void
+FfMacUlSinrCache::Configure (uint16_t ulBandwidth, uint32_t validity, double initialSinr)
+{
+  NS_LOG_FUNCTION (this << ulBandwidth << validity << initialSinr);
+  NS_ASSERT_MSG (ulBandwidth <= MAX_UL_RB, "UL bandwidth of " << ulBandwidth << " RBs not supported");
+  m_ulBandwidth = ulBandwidth;
+  m_validity = validity;
+  m_initialSinr = initialSinr;
+}
+
+void
+FfMacUlSinrCache::NewTti ()
+{
+  m_tti++;
+}
+
+bool
+FfMacUlSinrCache::IsValid (const UeSinr_t& ue) const
+{
+  return (m_tti - ue.m_lastUpdate <= m_validity);
+}
+
+FfMacUlSinrCache::UeSinr_t*
+FfMacUlSinrCache::Find (uint16_t rnti)
+{
+  std::map <uint16_t, UeSinr_t>::iterator it = m_ueSinr.find (rnti);
+  if (it == m_ueSinr.end () || !IsValid (it->second))
+    {
+      return 0;
+    }
+  return &it->second;
+}
+
+FfMacUlSinrCache::UeSinr_t*
+FfMacUlSinrCache::Update (uint16_t rnti)
+{
+  std::map <uint16_t, UeSinr_t>::iterator it = m_ueSinr.find (rnti);
+  bool created = false;
+  if (it == m_ueSinr.end ())
+    {
+      it = m_ueSinr.insert (std::pair <uint16_t, UeSinr_t> (rnti, UeSinr_t ())).first;
+      created = true;
+    }
+  UeSinr_t& ue = it->second;
+  if (created || !IsValid (ue))
+    {
+      NS_LOG_LOGIC (this << " new UL-CQI for user " << rnti);
+      bool available = (m_initialSinr != NO_SINR);
+      for (uint16_t i = 0; i < m_ulBandwidth; i++)
+        {
+          ue.m_sinr[i] = m_initialSinr;
+        }
+      ue.m_sinrSum = available ? m_initialSinr * m_ulBandwidth : 0;
+      ue.m_sinrNum = available ? m_ulBandwidth : 0;
+    }
+  ue.m_lastUpdate = m_tti;
+  return &ue;
+}
+
+void
+FfMacUlSinrCache::SetSinr (UeSinr_t* ue, uint16_t rb, double sinr)
+{
+  NS_ASSERT (rb < m_ulBandwidth);
+  if (ue->m_sinr[rb] != NO_SINR)
+    {
+      ue->m_sinrSum -= ue->m_sinr[rb];
+      ue->m_sinrNum--;
+    }
+  if (sinr != NO_SINR)
+    {
+      ue->m_sinrSum += sinr;
+      ue->m_sinrNum++;
+    }
+  ue->m_sinr[rb] = sinr;
+}
+
+double
+FfMacUlSinrCache::GetSinr (UeSinr_t* ue, uint16_t rb)
+{
+  NS_ASSERT (rb < m_ulBandwidth);
+  if (ue->m_sinr[rb] == NO_SINR)
+    {
+      // take the average SINR value among the available
+      double estimatedSinr = (ue->m_sinrNum > 0) ? (ue->m_sinrSum / ue->m_sinrNum) : DBL_MAX;
+      // store the value
+      SetSinr (ue, rb, estimatedSinr);
+    }
+  return ue->m_sinr[rb];
+}
+
+void
+FfMacUlSinrCache::Remove (uint16_t rnti)
+{
+  NS_LOG_FUNCTION (this << rnti);
+  m_ueSinr.erase (rnti);
+}
+
+std::map <uint16_t, std::vector <double> >
+FfMacUlSinrCache::GetSinrMap () const
+{
+  std::map <uint16_t, std::vector <double> > sinrMap;
+  for (std::map <uint16_t, UeSinr_t>::const_iterator it = m_ueSinr.begin (); it != m_ueSinr.end (); ++it)
+    {
+      if (IsValid (it->second))
+        {
+          sinrMap.insert (std::pair <uint16_t, std::vector <double> >
+                          (it->first, std::vector <double> (it->second.m_sinr, it->second.m_sinr + m_ulBandwidth)));
+        }
+    }
+  return sinrMap;
+}
+
+} // namespace ns3
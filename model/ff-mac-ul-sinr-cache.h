@@ -0,0 +1,130 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FF_MAC_UL_SINR_CACHE_H
+#define FF_MAC_UL_SINR_CACHE_H
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+// value for SINR outside the range defined by FF-API, used to indicate that there
+// is no CQI for this element
+#define NO_SINR -5000
+
+namespace ns3 {
+
+/**
+ * \ingroup ff-api
+ * \brief UL SINR of the UEs served by a scheduler, per RB
+ *
+ * Each UE has a fixed-size entry, updated in place by the SRS and PUSCH
+ * UL-CQI reports, which keeps the SINR of each UL RB together with the
+ * sum of the values reported, so that the RBs without a report are
+ * estimated with the wideband average without scanning the band.
+ *
+ * An entry is valid for a given number of UL TTIs after its last report,
+ * as told by a timestamp compared with the TTI counter of the cache, and
+ * is reinitialized in place by the first report after it expires.
+ */
+class FfMacUlSinrCache
+{
+public:
+  /// Largest UL bandwidth, in RBs
+  static const uint16_t MAX_UL_RB = 100;
+
+  /// UL SINR reported by a UE
+  struct UeSinr_t
+  {
+    double m_sinr[MAX_UL_RB]; ///< SINR of each RB, or the initial value
+    double m_sinrSum;         ///< sum of the SINR values other than NO_SINR
+    uint16_t m_sinrNum;       ///< number of the SINR values other than NO_SINR
+    uint32_t m_lastUpdate;    ///< UL TTI of the last report
+  };
+
+  FfMacUlSinrCache ();
+
+  /**
+   * \param ulBandwidth the UL bandwidth in RBs
+   * \param validity number of UL TTIs for which a report is valid
+   * \param initialSinr SINR of the RBs of a UE until they are reported
+   */
+  void Configure (uint16_t ulBandwidth, uint32_t validity, double initialSinr = NO_SINR);
+
+  /**
+   * Ages the entries by one UL TTI, to be called at each UL trigger
+   */
+  void NewTti ();
+
+  /**
+   * \param rnti the RNTI of the UE
+   * \return the SINR of the UE, or 0 if the UE has no valid report
+   */
+  UeSinr_t* Find (uint16_t rnti);
+
+  /**
+   * Marks the SINR of a UE as reported now, creating it or reinitializing
+   * it if expired
+   *
+   * \param rnti the RNTI of the UE
+   * \return the SINR of the UE, to be updated with SetSinr
+   */
+  UeSinr_t* Update (uint16_t rnti);
+
+  /**
+   * \param ue the SINR of the UE
+   * \param rb the RB
+   * \param sinr the SINR reported for the RB
+   */
+  void SetSinr (UeSinr_t* ue, uint16_t rb, double sinr);
+
+  /**
+   * \param ue the SINR of the UE
+   * \param rb the RB
+   * \return the SINR of the RB; when not reported, the wideband average
+   *         of the RBs reported, which is then stored for the RB
+   */
+  double GetSinr (UeSinr_t* ue, uint16_t rb);
+
+  /**
+   * \param rnti the RNTI of the UE released
+   */
+  void Remove (uint16_t rnti);
+
+  /**
+   * \return the valid SINR of each UE in the per-RB map passed to the FFR
+   *         algorithm
+   */
+  std::map <uint16_t, std::vector <double> > GetSinrMap () const;
+
+private:
+  /**
+   * \param ue the SINR of the UE
+   * \return true if the SINR of the UE is reported since less than the
+   *         validity period
+   */
+  bool IsValid (const UeSinr_t& ue) const;
+
+  uint16_t m_ulBandwidth;
+  uint32_t m_validity;
+  double m_initialSinr;
+  uint32_t m_tti; ///< number of UL TTIs elapsed
+  std::map <uint16_t, UeSinr_t> m_ueSinr;
+};
+
+} // namespace ns3
+
+#endif // FF_MAC_UL_SINR_CACHE_H
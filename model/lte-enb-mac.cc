@@ -37,6 +37,7 @@
 #include <ns3/lte-ue-phy.h>
 #include "ns3/lte-mac-sap.h"
 #include <ns3/lte-common.h>
+#include <ns3/lte-profiler.h>
 #include "ns3/vector.h"
 #include <limits>
 
@@ -48,6 +49,19 @@ NS_LOG_COMPONENT_DEFINE ("LteEnbMac");
 NS_OBJECT_ENSURE_REGISTERED (LteEnbMac);
 
 
+void
+DlHarqProcessesBuffer_t::Clear ()
+{
+  for (uint8_t layer = 0; layer < N_LAYERS; layer++)
+    {
+      for (uint8_t id = 0; id < N_PROCESSES; id++)
+        {
+          m_packets[layer][id].clear ();
+        }
+    }
+}
+
+
 
 // //////////////////////////////////////
 // member SAP forwarders
@@ -255,6 +269,7 @@ public:
 
   // inherited from LteEnbPhySapUser
   virtual void ReceivePhyPdu (Ptr<Packet> p);
+  virtual void ReceivePhyPdus (const std::vector<Ptr<Packet> >& pdus);
   virtual void SubframeIndication (uint32_t frameNo, uint32_t subframeNo);
   virtual void ReceiveLteControlMessage (Ptr<LteControlMessage> msg);
   virtual void ReceiveRachPreamble (Ptr<RachPreambleLteControlMessage> msg);
@@ -277,6 +292,12 @@ EnbMacMemberLteEnbPhySapUser::ReceivePhyPdu (Ptr<Packet> p)
   m_mac->DoReceivePhyPdu (p);
 }
 
+void
+EnbMacMemberLteEnbPhySapUser::ReceivePhyPdus (const std::vector<Ptr<Packet> >& pdus)
+{
+  m_mac->DoReceivePhyPdus (pdus);
+}
+
 void
 EnbMacMemberLteEnbPhySapUser::SubframeIndication (uint32_t frameNo, uint32_t subframeNo)
 {
@@ -388,6 +409,7 @@ LteEnbMac::GetTypeId (void)
 
 
 LteEnbMac::LteEnbMac ()
+  : m_traceSamplerCellId (0)
 {
   NS_LOG_FUNCTION (this);
   m_macSapProvider = new EnbMacMemberLteMacSapProvider<LteEnbMac> (this);
@@ -415,7 +437,18 @@ LteEnbMac::DoDispose ()
   m_ulCeReceived.clear ();
   m_dlInfoListReceived.clear ();
   m_ulInfoListReceived.clear ();
+  for (std::map <uint16_t, DlHarqProcessesBuffer_t*>::iterator it = m_miDlHarqProcessesPackets.begin ();
+       it != m_miDlHarqProcessesPackets.end (); ++it)
+    {
+      delete it->second;
+    }
   m_miDlHarqProcessesPackets.clear ();
+  for (std::vector <DlHarqProcessesBuffer_t*>::iterator it = m_dlHarqProcessesBufferPool.begin ();
+       it != m_dlHarqProcessesBufferPool.end (); ++it)
+    {
+      delete *it;
+    }
+  m_dlHarqProcessesBufferPool.clear ();
   delete m_macSapProvider;
   delete m_cmacSapProvider;
   delete m_schedSapUser;
@@ -499,6 +532,14 @@ LteEnbMac::GetPrachMode() const
   return m_realPrach;
 }
 
+void
+LteEnbMac::SetTraceSampler (const LteTraceSampler& sampler, uint16_t cellId)
+{
+  NS_LOG_FUNCTION (this << cellId);
+  m_traceSampler = sampler;
+  m_traceSamplerCellId = cellId;
+}
+
 void
 LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
 {
@@ -513,23 +554,23 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
   // Send Dl-CQI info to the scheduler
   if (m_dlCqiReceived.size () > 0)
     {
-      FfMacSchedSapProvider::SchedDlCqiInfoReqParameters dlcqiInfoReq;
-      dlcqiInfoReq.m_sfnSf = ((0x3FF & frameNo) << 4) | (0xF & subframeNo);
+      m_dlCqiInfoReq.m_sfnSf = ((0x3FF & frameNo) << 4) | (0xF & subframeNo);
 
       int cqiNum = m_dlCqiReceived.size ();
       if (cqiNum > MAX_CQI_LIST)
         {
           cqiNum = MAX_CQI_LIST;
         }
-      dlcqiInfoReq.m_cqiList.insert (dlcqiInfoReq.m_cqiList.begin (), m_dlCqiReceived.begin (), m_dlCqiReceived.end ());
-      m_dlCqiReceived.erase (m_dlCqiReceived.begin (), m_dlCqiReceived.end ());
-      m_schedSapProvider->SchedDlCqiInfoReq (dlcqiInfoReq);
+      // the CQIs are handed over to the request by swapping the lists,
+      // which both keep their capacity from one TTI to the next
+      m_dlCqiInfoReq.m_cqiList.swap (m_dlCqiReceived);
+      m_schedSapProvider->SchedDlCqiInfoReq (m_dlCqiInfoReq);
+      m_dlCqiInfoReq.m_cqiList.clear ();
     }
 
   if (!m_receivedRachPreambleCount.empty ())
     {
       // process received RACH preambles and notify the scheduler
-      FfMacSchedSapProvider::SchedDlRachInfoReqParameters rachInfoReqParams;
       NS_ASSERT (subframeNo > 0 && subframeNo <= 10); // subframe in 1..10
       std::map<uint8_t, Vector>::const_iterator it = m_receivedRachPreambleCount.begin();
       while (it != m_receivedRachPreambleCount.end ())
@@ -591,14 +632,41 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
               RachListElement_s rachLe;
               rachLe.m_rnti = rnti;
               rachLe.m_estimatedSize = 144; // to be confirmed
-              rachInfoReqParams.m_rachList.push_back (rachLe);
+              m_dlRachInfoReq.m_rachList.push_back (rachLe);
               m_rapIdRntiMap.insert (std::pair <uint16_t, uint32_t> (rnti, it->first)); // it->first is the rapId
             }
           it = iterPair.second;
         }
-      m_schedSapProvider->SchedDlRachInfoReq (rachInfoReqParams);
+      m_schedSapProvider->SchedDlRachInfoReq (m_dlRachInfoReq);
+      m_dlRachInfoReq.m_rachList.clear ();
       m_receivedRachPreambleCount.clear ();
     }
+  // Send the last RLC buffer status of the bearers reported during last TTI
+  for (std::vector <LteFlowId_t>::iterator itFlow = m_dlRlcBufferDirty.begin ();
+       itFlow != m_dlRlcBufferDirty.end ();
+       ++itFlow)
+    {
+      std::map <uint16_t, std::vector<DlRlcBufferStatus> >::iterator rntiIt = m_dlRlcBufferStatus.find (itFlow->m_rnti);
+      if (rntiIt == m_dlRlcBufferStatus.end () || itFlow->m_lcId >= rntiIt->second.size ()
+          || !rntiIt->second[itFlow->m_lcId].dirty)
+        {
+          // released in the meantime
+          continue;
+        }
+      DlRlcBufferStatus& status = rntiIt->second[itFlow->m_lcId];
+      status.dirty = false;
+      FfMacSchedSapProvider::SchedDlRlcBufferReqParameters req;
+      req.m_rnti = status.params.rnti;
+      req.m_logicalChannelIdentity = status.params.lcid;
+      req.m_rlcTransmissionQueueSize = status.params.txQueueSize;
+      req.m_rlcTransmissionQueueHolDelay = status.params.txQueueHolDelay;
+      req.m_rlcRetransmissionQueueSize = status.params.retxQueueSize;
+      req.m_rlcRetransmissionHolDelay = status.params.retxQueueHolDelay;
+      req.m_rlcStatusPduSize = status.params.statusPduSize;
+      m_schedSapProvider->SchedDlRlcBufferReq (req);
+    }
+  m_dlRlcBufferDirty.clear ();
+
   // Get downlink transmission opportunities
   uint32_t dlSchedFrameNo = m_frameNo;
   uint32_t dlSchedSubframeNo = m_subframeNo;
@@ -612,18 +680,16 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
     {
       dlSchedSubframeNo = dlSchedSubframeNo + m_macChTtiDelay;
     }
-  FfMacSchedSapProvider::SchedDlTriggerReqParameters dlparams;
-  dlparams.m_sfnSf = ((0x3FF & dlSchedFrameNo) << 4) | (0xF & dlSchedSubframeNo);
+  m_dlTriggerReq.m_sfnSf = ((0x3FF & dlSchedFrameNo) << 4) | (0xF & dlSchedSubframeNo);
 
   // Forward DL HARQ feebacks collected during last TTI
-  if (m_dlInfoListReceived.size () > 0)
-    {
-      dlparams.m_dlInfoList = m_dlInfoListReceived;
-      // empty local buffer
-      m_dlInfoListReceived.clear ();
-    }
+  m_dlTriggerReq.m_dlInfoList.swap (m_dlInfoListReceived);
 
-  m_schedSapProvider->SchedDlTriggerReq (dlparams);
+  {
+    LTE_PROFILE_SCOPE (SCHED_DL_TRIGGER);
+    m_schedSapProvider->SchedDlTriggerReq (m_dlTriggerReq);
+  }
+  m_dlTriggerReq.m_dlInfoList.clear ();
 
 
   // --- UPLINK ---
@@ -646,11 +712,10 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
   // Send BSR reports to the scheduler
   if (m_ulCeReceived.size () > 0)
     {
-      FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters ulMacReq;
-      ulMacReq.m_sfnSf = ((0x3FF & frameNo) << 4) | (0xF & subframeNo);
-      ulMacReq.m_macCeList.insert (ulMacReq.m_macCeList.begin (), m_ulCeReceived.begin (), m_ulCeReceived.end ());
-      m_ulCeReceived.erase (m_ulCeReceived.begin (), m_ulCeReceived.end ());
-      m_schedSapProvider->SchedUlMacCtrlInfoReq (ulMacReq);
+      m_ulMacCtrlInfoReq.m_sfnSf = ((0x3FF & frameNo) << 4) | (0xF & subframeNo);
+      m_ulMacCtrlInfoReq.m_macCeList.swap (m_ulCeReceived);
+      m_schedSapProvider->SchedUlMacCtrlInfoReq (m_ulMacCtrlInfoReq);
+      m_ulMacCtrlInfoReq.m_macCeList.clear ();
     }
 
 
@@ -668,18 +733,16 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
       ulSchedSubframeNo = ulSchedSubframeNo + (m_macChTtiDelay + UL_PUSCH_TTIS_DELAY);
     }
 
-  FfMacSchedSapProvider::SchedUlTriggerReqParameters ulparams;
-  ulparams.m_sfnSf = ((0x3FF & ulSchedFrameNo) << 4) | (0xF & ulSchedSubframeNo);
+  m_ulTriggerReq.m_sfnSf = ((0x3FF & ulSchedFrameNo) << 4) | (0xF & ulSchedSubframeNo);
 
   // Forward DL HARQ feebacks collected during last TTI
-  if (m_ulInfoListReceived.size () > 0)
-    {
-     ulparams.m_ulInfoList = m_ulInfoListReceived;
-      // empty local buffer
-      m_ulInfoListReceived.clear ();
-    }
+  m_ulTriggerReq.m_ulInfoList.swap (m_ulInfoListReceived);
 
-  m_schedSapProvider->SchedUlTriggerReq (ulparams);
+  {
+    LTE_PROFILE_SCOPE (SCHED_UL_TRIGGER);
+    m_schedSapProvider->SchedUlTriggerReq (m_ulTriggerReq);
+  }
+  m_ulTriggerReq.m_ulInfoList.clear ();
 
 }
 
@@ -800,15 +863,43 @@ LteEnbMac::DoReceivePhyPdu (Ptr<Packet> p)
   // forward the packet to the correspondent RLC
   uint16_t rnti = tag.GetRnti ();
   uint8_t lcid = tag.GetLcid ();
-  std::map <uint16_t, std::map<uint8_t, LteMacSapUser*> >::iterator rntiIt = m_rlcAttached.find (rnti);
+  std::map <uint16_t, std::vector<LteMacSapUser*> >::iterator rntiIt = m_rlcAttached.find (rnti);
   NS_ASSERT_MSG (rntiIt != m_rlcAttached.end (), "could not find RNTI" << rnti);
-  std::map<uint8_t, LteMacSapUser*>::iterator lcidIt = rntiIt->second.find (lcid);
-  //NS_ASSERT_MSG (lcidIt != rntiIt->second.end (), "could not find LCID" << lcid);
 
   //Receive PDU only if LCID is found
-  if (lcidIt != rntiIt->second.end ())
+  if (lcid < rntiIt->second.size () && rntiIt->second[lcid] != 0)
+    {
+      rntiIt->second[lcid]->ReceivePdu (p);
+    }
+}
+
+void
+LteEnbMac::DoReceivePhyPdus (const std::vector<Ptr<Packet> >& pdus)
+{
+  NS_LOG_FUNCTION (this << pdus.size ());
+  // the PDUs of a UE come in a row, from the same packet burst, hence the
+  // LC table of the UE is looked up once for all of them. The table stays
+  // valid while the PDUs are delivered, even if the RRC adds LCs meanwhile.
+  uint16_t rnti = 0;
+  std::vector<LteMacSapUser*>* rlcs = 0;
+  for (std::vector<Ptr<Packet> >::const_iterator it = pdus.begin (); it != pdus.end (); ++it)
     {
-      (*lcidIt).second->ReceivePdu (p);
+      LteRadioBearerTag tag;
+      (*it)->RemovePacketTag (tag);
+      if (rlcs == 0 || tag.GetRnti () != rnti)
+        {
+          rnti = tag.GetRnti ();
+          std::map <uint16_t, std::vector<LteMacSapUser*> >::iterator rntiIt = m_rlcAttached.find (rnti);
+          NS_ASSERT_MSG (rntiIt != m_rlcAttached.end (), "could not find RNTI" << rnti);
+          rlcs = &rntiIt->second;
+        }
+
+      //Receive PDU only if LCID is found
+      uint8_t lcid = tag.GetLcid ();
+      if (lcid < rlcs->size () && (*rlcs)[lcid] != 0)
+        {
+          (*rlcs)[lcid]->ReceivePdu (*it);
+        }
     }
 }
 
@@ -836,11 +927,12 @@ void
 LteEnbMac::DoAddUe (uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << " rnti=" << rnti);
-  std::map<uint8_t, LteMacSapUser*> empty;
-  std::pair <std::map <uint16_t, std::map<uint8_t, LteMacSapUser*> >::iterator, bool> 
-    ret = m_rlcAttached.insert (std::pair <uint16_t,  std::map<uint8_t, LteMacSapUser*> > 
+  std::vector<LteMacSapUser*> empty;
+  std::pair <std::map <uint16_t, std::vector<LteMacSapUser*> >::iterator, bool> 
+    ret = m_rlcAttached.insert (std::pair <uint16_t,  std::vector<LteMacSapUser*> > 
                                 (rnti, empty));
   NS_ASSERT_MSG (ret.second, "element already present, RNTI already existed");
+  m_dlRlcBufferStatus[rnti].clear ();
 
   FfMacCschedSapProvider::CschedUeConfigReqParameters params;
   params.m_rnti = rnti;
@@ -848,25 +940,19 @@ LteEnbMac::DoAddUe (uint16_t rnti)
 
   m_cschedSapProvider->CschedUeConfigReq (params);
 
-  // Create DL trasmission HARQ buffers
-  std::vector < Ptr<PacketBurst> > dlHarqLayer0pkt;
-  dlHarqLayer0pkt.resize (8);
-  for (uint8_t i = 0; i < 8; i++)
+  // Take the DL trasmission HARQ buffers from the pool, if any is left
+  // by a removed UE (they are emptied when the UE is removed)
+  DlHarqProcessesBuffer_t* buf;
+  if (m_dlHarqProcessesBufferPool.empty ())
     {
-      Ptr<PacketBurst> pb = CreateObject <PacketBurst> ();
-      dlHarqLayer0pkt.at (i) = pb;
+      buf = new DlHarqProcessesBuffer_t;
     }
-  std::vector < Ptr<PacketBurst> > dlHarqLayer1pkt;
-  dlHarqLayer1pkt.resize (8);
-  for (uint8_t i = 0; i < 8; i++)
+  else
     {
-      Ptr<PacketBurst> pb = CreateObject <PacketBurst> ();
-      dlHarqLayer1pkt.at (i) = pb;
+      buf = m_dlHarqProcessesBufferPool.back ();
+      m_dlHarqProcessesBufferPool.pop_back ();
     }
-  DlHarqProcessesBuffer_t buf;
-  buf.push_back (dlHarqLayer0pkt);
-  buf.push_back (dlHarqLayer1pkt);
-  m_miDlHarqProcessesPackets.insert (std::pair <uint16_t, DlHarqProcessesBuffer_t> (rnti, buf));
+  m_miDlHarqProcessesPackets.insert (std::pair <uint16_t, DlHarqProcessesBuffer_t*> (rnti, buf));
 }
 
 void
@@ -878,7 +964,14 @@ LteEnbMac::DoRemoveUe (uint16_t rnti)
   params.m_rnti = rnti;
   m_cschedSapProvider->CschedUeReleaseReq (params);
   m_rlcAttached.erase (rnti);
-  m_miDlHarqProcessesPackets.erase (rnti);
+  m_dlRlcBufferStatus.erase (rnti);
+  std::map <uint16_t, DlHarqProcessesBuffer_t*>::iterator it = m_miDlHarqProcessesPackets.find (rnti);
+  if (it != m_miDlHarqProcessesPackets.end ())
+    {
+      it->second->Clear ();
+      m_dlHarqProcessesBufferPool.push_back (it->second);
+      m_miDlHarqProcessesPackets.erase (it);
+    }
 }
 
 void
@@ -890,12 +983,16 @@ LteEnbMac::DoAddLc (LteEnbCmacSapProvider::LcInfo lcinfo, LteMacSapUser* msu)
   
   LteFlowId_t flow (lcinfo.rnti, lcinfo.lcId);
   
-  std::map <uint16_t, std::map<uint8_t, LteMacSapUser*> >::iterator rntiIt = m_rlcAttached.find (lcinfo.rnti);
+  std::map <uint16_t, std::vector<LteMacSapUser*> >::iterator rntiIt = m_rlcAttached.find (lcinfo.rnti);
   NS_ASSERT_MSG (rntiIt != m_rlcAttached.end (), "RNTI not found");
-  std::map<uint8_t, LteMacSapUser*>::iterator lcidIt = rntiIt->second.find (lcinfo.lcId);
-  if (lcidIt == rntiIt->second.end ())
+  if (lcinfo.lcId >= rntiIt->second.size ())
+    {
+      rntiIt->second.resize (lcinfo.lcId + 1, 0);
+      m_dlRlcBufferStatus[lcinfo.rnti].resize (lcinfo.lcId + 1, DlRlcBufferStatus ());
+    }
+  if (rntiIt->second[lcinfo.lcId] == 0)
     {
-      rntiIt->second.insert (std::pair<uint8_t, LteMacSapUser*> (lcinfo.lcId, msu));
+      rntiIt->second[lcinfo.lcId] = msu;
     }
   else
     {
@@ -938,11 +1035,15 @@ void
 LteEnbMac::DoReleaseLc (uint16_t rnti) 
 {
   //Find user based on rnti and then erase lcid stored against the same
-  std::map <uint16_t, std::map<uint8_t, LteMacSapUser*> >::iterator rntiIt = m_rlcAttached.find (rnti);
+  std::map <uint16_t, std::vector<LteMacSapUser*> >::iterator rntiIt = m_rlcAttached.find (rnti);
   // cycle on all the LC and delete one by one
-  for( std::map <uint8_t, LteMacSapUser*>::iterator lcidIt = rntiIt->second.begin(); lcidIt != rntiIt->second.end(); ++lcidIt) {
-    this->DoReleaseLc(rnti, lcidIt->first);
-  }
+  for (uint16_t lcid = 0; lcid < rntiIt->second.size (); ++lcid)
+    {
+      if (rntiIt->second[lcid] != 0)
+        {
+          this->DoReleaseLc (rnti, lcid);
+        }
+    }
 }
 
 void
@@ -950,8 +1051,13 @@ LteEnbMac::DoReleaseLc (uint16_t rnti, uint8_t lcid)
 {
   NS_LOG_FUNCTION (this);
   //Find user based on rnti and then erase lcid stored against the same
-  std::map <uint16_t, std::map<uint8_t, LteMacSapUser*> >::iterator rntiIt = m_rlcAttached.find (rnti);
-  rntiIt->second.erase (lcid);
+  std::map <uint16_t, std::vector<LteMacSapUser*> >::iterator rntiIt = m_rlcAttached.find (rnti);
+  if (lcid < rntiIt->second.size ())
+    {
+      rntiIt->second[lcid] = 0;
+      // a report still pending is dropped
+      m_dlRlcBufferStatus[rnti][lcid].dirty = false;
+    }
 
   struct FfMacCschedSapProvider::CschedLcReleaseReqParameters params;
   params.m_rnti = rnti;
@@ -1039,12 +1145,12 @@ LteEnbMac::DoTransmitPdu (LteMacSapProvider::TransmitPduParameters params)
   LteRadioBearerTag tag (params.rnti, params.lcid, params.layer);
   params.pdu->AddPacketTag (tag);
   // Store pkt in HARQ buffer
-  std::map <uint16_t, DlHarqProcessesBuffer_t>::iterator it =  m_miDlHarqProcessesPackets.find (params.rnti);
+  std::map <uint16_t, DlHarqProcessesBuffer_t*>::iterator it =  m_miDlHarqProcessesPackets.find (params.rnti);
   NS_ASSERT (it != m_miDlHarqProcessesPackets.end ());
+  NS_ASSERT (params.layer < DlHarqProcessesBuffer_t::N_LAYERS && params.harqProcessId < DlHarqProcessesBuffer_t::N_PROCESSES);
   NS_LOG_DEBUG (this << " LAYER " << (uint16_t)tag.GetLayer () << " HARQ ID " << (uint16_t)params.harqProcessId);
   
-  //(*it).second.at (params.layer).at (params.harqProcessId) = params.pdu;//->Copy ();
-  (*it).second.at (params.layer).at (params.harqProcessId)->AddPacket (params.pdu);
+  (*it).second->m_packets[params.layer][params.harqProcessId].push_back (params.pdu);
   m_enbPhySapProvider->SendMacPdu (params.pdu);
 }
 
@@ -1052,15 +1158,22 @@ void
 LteEnbMac::DoReportBufferStatus (LteMacSapProvider::ReportBufferStatusParameters params)
 {
   NS_LOG_FUNCTION (this);
-  FfMacSchedSapProvider::SchedDlRlcBufferReqParameters req;
-  req.m_rnti = params.rnti;
-  req.m_logicalChannelIdentity = params.lcid;
-  req.m_rlcTransmissionQueueSize = params.txQueueSize;
-  req.m_rlcTransmissionQueueHolDelay = params.txQueueHolDelay;
-  req.m_rlcRetransmissionQueueSize = params.retxQueueSize;
-  req.m_rlcRetransmissionHolDelay = params.retxQueueHolDelay;
-  req.m_rlcStatusPduSize = params.statusPduSize;
-  m_schedSapProvider->SchedDlRlcBufferReq (req);
+  // the RLC reports at each SDU received: the report is only stored, and
+  // the last one of the bearer is forwarded to the scheduler at the next
+  // subframe
+  std::map <uint16_t, std::vector<DlRlcBufferStatus> >::iterator rntiIt = m_dlRlcBufferStatus.find (params.rnti);
+  if (rntiIt == m_dlRlcBufferStatus.end () || params.lcid >= rntiIt->second.size ())
+    {
+      NS_LOG_LOGIC (this << " buffer status of an unknown LC, RNTI " << params.rnti << " LCID " << (uint16_t) params.lcid);
+      return;
+    }
+  DlRlcBufferStatus& status = rntiIt->second[params.lcid];
+  status.params = params;
+  if (!status.dirty)
+    {
+      status.dirty = true;
+      m_dlRlcBufferDirty.push_back (LteFlowId_t (params.rnti, params.lcid));
+    }
 }
 
 
@@ -1072,11 +1185,9 @@ LteEnbMac::DoReportBufferStatus (LteMacSapProvider::ReportBufferStatusParameters
 
 
 void
-LteEnbMac::DoSchedDlConfigInd (FfMacSchedSapUser::SchedDlConfigIndParameters ind)
+LteEnbMac::DoSchedDlConfigInd (const FfMacSchedSapUser::SchedDlConfigIndParameters& ind)
 {
   NS_LOG_FUNCTION (this);
-  // Create DL PHY PDU
-  Ptr<PacketBurst> pb = CreateObject<PacketBurst> ();
   std::map <LteFlowId_t, LteMacSapUser* >::iterator it;
 
   for (unsigned int i = 0; i < ind.m_buildDataList.size (); i++)
@@ -1086,12 +1197,11 @@ LteEnbMac::DoSchedDlConfigInd (FfMacSchedSapUser::SchedDlConfigIndParameters ind
           if (ind.m_buildDataList.at (i).m_dci.m_ndi.at (layer) == 1)
             {
               // new data -> force emptying correspondent harq pkt buffer
-              std::map <uint16_t, DlHarqProcessesBuffer_t>::iterator it = m_miDlHarqProcessesPackets.find (ind.m_buildDataList.at (i).m_rnti);
+              std::map <uint16_t, DlHarqProcessesBuffer_t*>::iterator it = m_miDlHarqProcessesPackets.find (ind.m_buildDataList.at (i).m_rnti);
               NS_ASSERT (it != m_miDlHarqProcessesPackets.end ());
-              for (uint16_t lcId = 0; lcId < (*it).second.size (); lcId++)
+              for (uint8_t lcId = 0; lcId < DlHarqProcessesBuffer_t::N_LAYERS; lcId++)
                 {
-                  Ptr<PacketBurst> pb = CreateObject <PacketBurst> ();
-                  (*it).second.at (lcId).at (ind.m_buildDataList.at (i).m_dci.m_harqProcess) = pb;
+                  (*it).second->m_packets[lcId][ind.m_buildDataList.at (i).m_dci.m_harqProcess].clear ();
                 }
             }
         }
@@ -1104,25 +1214,25 @@ LteEnbMac::DoSchedDlConfigInd (FfMacSchedSapUser::SchedDlConfigIndParameters ind
                   // New Data -> retrieve it from RLC
                   uint16_t rnti = ind.m_buildDataList.at (i).m_rnti;
                   uint8_t lcid = ind.m_buildDataList.at (i).m_rlcPduList.at (j).at (k).m_logicalChannelIdentity;
-                  std::map <uint16_t, std::map<uint8_t, LteMacSapUser*> >::iterator rntiIt = m_rlcAttached.find (rnti);
+                  std::map <uint16_t, std::vector<LteMacSapUser*> >::iterator rntiIt = m_rlcAttached.find (rnti);
                   NS_ASSERT_MSG (rntiIt != m_rlcAttached.end (), "could not find RNTI" << rnti);
-                  std::map<uint8_t, LteMacSapUser*>::iterator lcidIt = rntiIt->second.find (lcid);
-                  NS_ASSERT_MSG (lcidIt != rntiIt->second.end (), "could not find LCID" << lcid);
+                  NS_ASSERT_MSG (lcid < rntiIt->second.size () && rntiIt->second[lcid] != 0, "could not find LCID" << lcid);
                   NS_LOG_DEBUG (this << " rnti= " << rnti << " lcid= " << (uint32_t) lcid << " layer= " << k);
-                  (*lcidIt).second->NotifyTxOpportunity (ind.m_buildDataList.at (i).m_rlcPduList.at (j).at (k).m_size, k, ind.m_buildDataList.at (i).m_dci.m_harqProcess);
+                  rntiIt->second[lcid]->NotifyTxOpportunity (ind.m_buildDataList.at (i).m_rlcPduList.at (j).at (k).m_size, k, ind.m_buildDataList.at (i).m_dci.m_harqProcess);
                 }
               else
                 {
                   if (ind.m_buildDataList.at (i).m_dci.m_tbsSize.at (k) > 0)
                     {
                       // HARQ retransmission -> retrieve TB from HARQ buffer
-                      std::map <uint16_t, DlHarqProcessesBuffer_t>::iterator it = m_miDlHarqProcessesPackets.find (ind.m_buildDataList.at (i).m_rnti);
+                      // the channel copies the transmitted packets, hence the
+                      // buffered ones are sent as they are
+                      std::map <uint16_t, DlHarqProcessesBuffer_t*>::iterator it = m_miDlHarqProcessesPackets.find (ind.m_buildDataList.at (i).m_rnti);
                       NS_ASSERT (it != m_miDlHarqProcessesPackets.end ());
-                      Ptr<PacketBurst> pb = (*it).second.at (k).at ( ind.m_buildDataList.at (i).m_dci.m_harqProcess);
-                      for (std::list<Ptr<Packet> >::const_iterator j = pb->Begin (); j != pb->End (); ++j)
+                      const std::vector < Ptr<Packet> >& pkts = (*it).second->m_packets[k][ind.m_buildDataList.at (i).m_dci.m_harqProcess];
+                      for (std::vector < Ptr<Packet> >::const_iterator j = pkts.begin (); j != pkts.end (); ++j)
                         {
-                          Ptr<Packet> pkt = (*j)->Copy ();
-                          m_enbPhySapProvider->SendMacPdu (pkt);
+                          m_enbPhySapProvider->SendMacPdu (*j);
                         }
                     }
                 }
@@ -1137,6 +1247,10 @@ LteEnbMac::DoSchedDlConfigInd (FfMacSchedSapUser::SchedDlConfigIndParameters ind
   // Fire the trace with the DL information
   for (  uint32_t i  = 0; i < ind.m_buildDataList.size (); i++ )
     {
+      if (!m_traceSampler.IsSampled (m_traceSamplerCellId, ind.m_buildDataList.at (i).m_dci.m_rnti))
+        {
+          continue;
+        }
       // Only one TB used
       if (ind.m_buildDataList.at (i).m_dci.m_tbsSize.size () == 1)
         {
@@ -1200,7 +1314,7 @@ LteEnbMac::DoSchedDlConfigInd (FfMacSchedSapUser::SchedDlConfigIndParameters ind
 
 
 void
-LteEnbMac::DoSchedUlConfigInd (FfMacSchedSapUser::SchedUlConfigIndParameters ind)
+LteEnbMac::DoSchedUlConfigInd (const FfMacSchedSapUser::SchedUlConfigIndParameters& ind)
 {
   NS_LOG_FUNCTION (this);
 
@@ -1215,6 +1329,10 @@ LteEnbMac::DoSchedUlConfigInd (FfMacSchedSapUser::SchedUlConfigIndParameters ind
   // Fire the trace with the UL information
   for (  uint32_t i  = 0; i < ind.m_dciList.size (); i++ )
     {
+      if (!m_traceSampler.IsSampled (m_traceSamplerCellId, ind.m_dciList.at (i).m_rnti))
+        {
+          continue;
+        }
       m_ulScheduling (m_frameNo, m_subframeNo, ind.m_dciList.at (i).m_rnti,
                       ind.m_dciList.at (i).m_mcs, ind.m_dciList.at (i).m_tbSize);
     }
@@ -1232,19 +1350,19 @@ LteEnbMac::DoSchedUlConfigInd (FfMacSchedSapUser::SchedUlConfigIndParameters ind
 
 
 void
-LteEnbMac::DoCschedCellConfigCnf (FfMacCschedSapUser::CschedCellConfigCnfParameters params)
+LteEnbMac::DoCschedCellConfigCnf (const FfMacCschedSapUser::CschedCellConfigCnfParameters& params)
 {
   NS_LOG_FUNCTION (this);
 }
 
 void
-LteEnbMac::DoCschedUeConfigCnf (FfMacCschedSapUser::CschedUeConfigCnfParameters params)
+LteEnbMac::DoCschedUeConfigCnf (const FfMacCschedSapUser::CschedUeConfigCnfParameters& params)
 {
   NS_LOG_FUNCTION (this);
 }
 
 void
-LteEnbMac::DoCschedLcConfigCnf (FfMacCschedSapUser::CschedLcConfigCnfParameters params)
+LteEnbMac::DoCschedLcConfigCnf (const FfMacCschedSapUser::CschedLcConfigCnfParameters& params)
 {
   NS_LOG_FUNCTION (this);
   // Call the CSCHED primitive
@@ -1252,19 +1370,19 @@ LteEnbMac::DoCschedLcConfigCnf (FfMacCschedSapUser::CschedLcConfigCnfParameters
 }
 
 void
-LteEnbMac::DoCschedLcReleaseCnf (FfMacCschedSapUser::CschedLcReleaseCnfParameters params)
+LteEnbMac::DoCschedLcReleaseCnf (const FfMacCschedSapUser::CschedLcReleaseCnfParameters& params)
 {
   NS_LOG_FUNCTION (this);
 }
 
 void
-LteEnbMac::DoCschedUeReleaseCnf (FfMacCschedSapUser::CschedUeReleaseCnfParameters params)
+LteEnbMac::DoCschedUeReleaseCnf (const FfMacCschedSapUser::CschedUeReleaseCnfParameters& params)
 {
   NS_LOG_FUNCTION (this);
 }
 
 void
-LteEnbMac::DoCschedUeConfigUpdateInd (FfMacCschedSapUser::CschedUeConfigUpdateIndParameters params)
+LteEnbMac::DoCschedUeConfigUpdateInd (const FfMacCschedSapUser::CschedUeConfigUpdateIndParameters& params)
 {
   NS_LOG_FUNCTION (this);
   // propagates to RRC
@@ -1275,7 +1393,7 @@ LteEnbMac::DoCschedUeConfigUpdateInd (FfMacCschedSapUser::CschedUeConfigUpdateIn
 }
 
 void
-LteEnbMac::DoCschedCellConfigUpdateInd (FfMacCschedSapUser::CschedCellConfigUpdateIndParameters params)
+LteEnbMac::DoCschedCellConfigUpdateInd (const FfMacCschedSapUser::CschedCellConfigUpdateIndParameters& params)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -1292,15 +1410,14 @@ LteEnbMac::DoDlInfoListElementHarqFeeback (DlInfoListElement_s params)
 {
   NS_LOG_FUNCTION (this);
   // Update HARQ buffer
-  std::map <uint16_t, DlHarqProcessesBuffer_t>::iterator it =  m_miDlHarqProcessesPackets.find (params.m_rnti);
+  std::map <uint16_t, DlHarqProcessesBuffer_t*>::iterator it =  m_miDlHarqProcessesPackets.find (params.m_rnti);
   NS_ASSERT (it != m_miDlHarqProcessesPackets.end ());
   for (uint8_t layer = 0; layer < params.m_harqStatus.size (); layer++)
     {
       if (params.m_harqStatus.at (layer) == DlInfoListElement_s::ACK)
         {
           // discard buffer
-          Ptr<PacketBurst> emptyBuf = CreateObject <PacketBurst> ();
-          (*it).second.at (layer).at (params.m_harqProcessId) = emptyBuf;
+          (*it).second->m_packets[layer][params.m_harqProcessId].clear ();
           NS_LOG_DEBUG (this << " HARQ-ACK UE " << params.m_rnti << " harqId " << (uint16_t)params.m_harqProcessId << " layer " << (uint16_t)layer);
         }
       else if (params.m_harqStatus.at (layer) == DlInfoListElement_s::NACK)
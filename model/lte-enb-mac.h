@@ -40,6 +40,7 @@
 #include <ns3/packet.h>
 #include <ns3/packet-burst.h>
 #include "ns3/vector.h"
+#include <ns3/lte-trace-sampler.h>
 
 
 namespace ns3 {
@@ -48,7 +49,20 @@ class DlCqiLteControlMessage;
 class UlCqiLteControlMessage;
 class PdcchMapLteControlMessage;
 
-typedef std::vector <std::vector < Ptr<PacketBurst> > > DlHarqProcessesBuffer_t;
+/**
+ * DL HARQ buffers of a UE: the packets under transmission of each HARQ
+ * process of each layer. The buffers are emptied in place when a process
+ * is freed, so that their storage is reused by the following transmissions.
+ */
+struct DlHarqProcessesBuffer_t
+{
+  static const uint8_t N_LAYERS = 2;
+  static const uint8_t N_PROCESSES = 8;
+
+  void Clear ();
+
+  std::vector < Ptr<Packet> > m_packets[N_LAYERS][N_PROCESSES];
+};
 typedef std::multimap<uint8_t, Vector> RapIdPositionMap_t;
 
 /**
@@ -134,6 +148,13 @@ public:
   void SetPrachMode(bool ideal);
   bool GetPrachMode() const;
 
+  /**
+   * Set the sampling policy of the DlScheduling and UlScheduling traces
+   * \param sampler the sampling policy
+   * \param cellId the cell ID of this MAC, which it is otherwise unaware of
+   */
+  void SetTraceSampler (const LteTraceSampler& sampler, uint16_t cellId);
+
   /**
    * TracedCallback signature for DL scheduling events.
    *
@@ -221,17 +242,17 @@ private:
 
 
   // forwarded from FfMacCchedSapUser
-  void DoCschedCellConfigCnf (FfMacCschedSapUser::CschedCellConfigCnfParameters params);
-  void DoCschedUeConfigCnf (FfMacCschedSapUser::CschedUeConfigCnfParameters params);
-  void DoCschedLcConfigCnf (FfMacCschedSapUser::CschedLcConfigCnfParameters params);
-  void DoCschedLcReleaseCnf (FfMacCschedSapUser::CschedLcReleaseCnfParameters params);
-  void DoCschedUeReleaseCnf (FfMacCschedSapUser::CschedUeReleaseCnfParameters params);
-  void DoCschedUeConfigUpdateInd (FfMacCschedSapUser::CschedUeConfigUpdateIndParameters params);
-  void DoCschedCellConfigUpdateInd (FfMacCschedSapUser::CschedCellConfigUpdateIndParameters params);
+  void DoCschedCellConfigCnf (const FfMacCschedSapUser::CschedCellConfigCnfParameters& params);
+  void DoCschedUeConfigCnf (const FfMacCschedSapUser::CschedUeConfigCnfParameters& params);
+  void DoCschedLcConfigCnf (const FfMacCschedSapUser::CschedLcConfigCnfParameters& params);
+  void DoCschedLcReleaseCnf (const FfMacCschedSapUser::CschedLcReleaseCnfParameters& params);
+  void DoCschedUeReleaseCnf (const FfMacCschedSapUser::CschedUeReleaseCnfParameters& params);
+  void DoCschedUeConfigUpdateInd (const FfMacCschedSapUser::CschedUeConfigUpdateIndParameters& params);
+  void DoCschedCellConfigUpdateInd (const FfMacCschedSapUser::CschedCellConfigUpdateIndParameters& params);
 
   // forwarded from FfMacSchedSapUser
-  void DoSchedDlConfigInd (FfMacSchedSapUser::SchedDlConfigIndParameters ind);
-  void DoSchedUlConfigInd (FfMacSchedSapUser::SchedUlConfigIndParameters params);
+  void DoSchedDlConfigInd (const FfMacSchedSapUser::SchedDlConfigIndParameters& ind);
+  void DoSchedUlConfigInd (const FfMacSchedSapUser::SchedUlConfigIndParameters& ind);
 
   // forwarded from LteEnbPhySapUser
   void DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo);
@@ -240,6 +261,7 @@ private:
 public:
   // legacy public for use the Phy callback
   void DoReceivePhyPdu (Ptr<Packet> p);
+  void DoReceivePhyPdus (const std::vector<Ptr<Packet> >& pdus);
 
 private:
   void DoUlInfoListElementHarqFeeback (UlInfoListElement_s params);
@@ -250,17 +272,41 @@ private:
    */ 
   bool EvaluateCollisionProbability(std::list<Vector> pointList);
 
-  //            rnti,             lcid, SAP of the RLC instance
-  std::map <uint16_t, std::map<uint8_t, LteMacSapUser*> > m_rlcAttached;
+  // rnti, SAP of the RLC instance of each lcid (0 if the LC is not attached)
+  std::map <uint16_t, std::vector<LteMacSapUser*> > m_rlcAttached;
 
   std::vector <CqiListElement_s> m_dlCqiReceived; // DL-CQI received
   std::vector <FfMacSchedSapProvider::SchedUlCqiInfoReqParameters> m_ulCqiReceived; // UL-CQI received
   std::vector <MacCeListElement_s> m_ulCeReceived; // CE received (BSR up to now)
 
+  /**
+   * last buffer status reported by the RLC of a bearer, forwarded to the
+   * scheduler at the next TTI
+   */
+  struct DlRlcBufferStatus
+  {
+    LteMacSapProvider::ReportBufferStatusParameters params; ///< last report
+    bool dirty; ///< true if reported since the last TTI
+  };
+  // rnti, last RLC buffer status of each lcid, indexed as m_rlcAttached
+  std::map <uint16_t, std::vector<DlRlcBufferStatus> > m_dlRlcBufferStatus;
+  // bearers reported during the current TTI, each listed once
+  std::vector <LteFlowId_t> m_dlRlcBufferDirty;
+
   std::vector <DlInfoListElement_s> m_dlInfoListReceived; // DL HARQ feedback received
 
   std::vector <UlInfoListElement_s> m_ulInfoListReceived; // UL HARQ feedback received
 
+  /*
+   * Requests to the scheduler, reused at each TTI so that their lists
+   * keep their capacity
+   */
+  FfMacSchedSapProvider::SchedDlCqiInfoReqParameters m_dlCqiInfoReq;
+  FfMacSchedSapProvider::SchedDlRachInfoReqParameters m_dlRachInfoReq;
+  FfMacSchedSapProvider::SchedDlTriggerReqParameters m_dlTriggerReq;
+  FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters m_ulMacCtrlInfoReq;
+  FfMacSchedSapProvider::SchedUlTriggerReqParameters m_ulTriggerReq;
+
   bool m_message3Received;
   /*
   * Map of UE's info element (see 4.3.12 of FF MAC Scheduler API)
@@ -301,6 +347,9 @@ private:
   TracedCallback<uint32_t, uint32_t, uint16_t,
                  uint8_t, uint16_t> m_ulScheduling;  
 
+  LteTraceSampler m_traceSampler; ///< sampling policy of the scheduling traces
+  uint16_t m_traceSamplerCellId; ///< the cell ID passed to m_traceSampler
+
   /**
    * Trace information regarding rach preamble rx 
    */
@@ -309,7 +358,8 @@ private:
   uint8_t m_macChTtiDelay; // delay of MAC, PHY and channel in terms of TTIs
 
 
-  std::map <uint16_t, DlHarqProcessesBuffer_t> m_miDlHarqProcessesPackets; // Packet under trasmission of the DL HARQ process
+  std::map <uint16_t, DlHarqProcessesBuffer_t*> m_miDlHarqProcessesPackets; // Packet under trasmission of the DL HARQ process
+  std::vector <DlHarqProcessesBuffer_t*> m_dlHarqProcessesBufferPool; // HARQ buffers of the removed UEs, reused by the new ones
   
   uint8_t m_numberOfRaPreambles;
   uint8_t m_preambleTransMax;
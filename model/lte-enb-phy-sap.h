@@ -89,6 +89,14 @@ public:
    */
   virtual void ReceivePhyPdu (Ptr<Packet> p) = 0;
 
+  /**
+   * Called by the Phy to notify the MAC of the reception of all the
+   * PHY-PDUs decoded correctly in a subframe
+   *
+   * \param pdus the PHY-PDUs, in the order of reception
+   */
+  virtual void ReceivePhyPdus (const std::vector<Ptr<Packet> >& pdus) = 0;
+
   /**
    * \brief Trigger the start from a new frame (input from Phy layer)
    * \param frameNo frame number
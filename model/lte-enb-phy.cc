@@ -48,6 +48,7 @@
 #include <ns3/node.h>
 #include <ns3/lte-ue-net-device.h>
 #include <ns3/pointer.h>
+#include <ns3/lte-profiler.h>
 
 namespace ns3 {
 
@@ -277,7 +278,7 @@ LteEnbPhy::DoInitialize ()
     }
   else
     {
-      Simulator::ScheduleNow (&LteEnbPhy::StartFrame, this);
+      LteEventProfiler::ScheduleNow ("LteEnbPhy::StartFrame", &LteEnbPhy::StartFrame, this);
     }
   Ptr<SpectrumValue> noisePsd = LteSpectrumValueHelper::CreateNoisePowerSpectralDensity (m_ulEarfcn, m_ulBandwidth, m_noiseFigure);
   m_uplinkSpectrumPhy->SetNoisePowerSpectralDensity (noisePsd);
@@ -444,6 +445,13 @@ LteEnbPhy::PhyPduReceived (Ptr<Packet> p)
   m_enbPhySapUser->ReceivePhyPdu (p);
 }
 
+void
+LteEnbPhy::PhyPdusReceived (const std::vector<Ptr<Packet> >& pdus)
+{
+  NS_LOG_FUNCTION (this << pdus.size ());
+  m_enbPhySapUser->ReceivePhyPdus (pdus);
+}
+
 void
 LteEnbPhy::SetDownlinkSubChannels (std::vector<int> mask)
 {
@@ -703,20 +711,23 @@ LteEnbPhy::StartSubFrame (void)
                   mask = (mask << 1);
                 }
               // fire trace of DL Tx PHY stats
-              for (uint8_t i = 0; i < dci->GetDci ().m_mcs.size (); i++)
+              if (m_traceSampler.IsSampled (m_cellId, dci->GetDci ().m_rnti))
                 {
-                  PhyTransmissionStatParameters params;
-                  params.m_cellId = m_cellId;
-                  params.m_imsi = 0; // it will be set by DlPhyTransmissionCallback in LteHelper
-                  params.m_timestamp = Simulator::Now ().GetMilliSeconds ();
-                  params.m_rnti = dci->GetDci ().m_rnti;
-                  params.m_txMode = 0; // TBD
-                  params.m_layer = i;
-                  params.m_mcs = dci->GetDci ().m_mcs.at (i);
-                  params.m_size = dci->GetDci ().m_tbsSize.at (i);
-                  params.m_rv = dci->GetDci ().m_rv.at (i);
-                  params.m_ndi = dci->GetDci ().m_ndi.at (i);
-                  m_dlPhyTransmission (params);
+                  for (uint8_t i = 0; i < dci->GetDci ().m_mcs.size (); i++)
+                    {
+                      PhyTransmissionStatParameters params;
+                      params.m_cellId = m_cellId;
+                      params.m_imsi = 0; // it will be set by DlPhyTransmissionCallback in LteHelper
+                      params.m_timestamp = Simulator::Now ().GetMilliSeconds ();
+                      params.m_rnti = dci->GetDci ().m_rnti;
+                      params.m_txMode = 0; // TBD
+                      params.m_layer = i;
+                      params.m_mcs = dci->GetDci ().m_mcs.at (i);
+                      params.m_size = dci->GetDci ().m_tbsSize.at (i);
+                      params.m_rv = dci->GetDci ().m_rv.at (i);
+                      params.m_ndi = dci->GetDci ().m_ndi.at (i);
+                      m_dlPhyTransmission (params);
+                    }
                 }
 
             }
@@ -770,9 +781,9 @@ LteEnbPhy::StartSubFrame (void)
   // trigger the MAC
   m_enbPhySapUser->SubframeIndication (m_nrFrames, m_nrSubFrames);
 
-  Simulator::Schedule (Seconds (GetTti ()),
-                       &LteEnbPhy::EndSubFrame,
-                       this);
+  LteEventProfiler::Schedule ("LteEnbPhy::EndSubFrame", Seconds (GetTti ()),
+                              &LteEnbPhy::EndSubFrame,
+                              this);
 
 }
 
@@ -816,11 +827,11 @@ LteEnbPhy::EndSubFrame (void)
   NS_LOG_FUNCTION (this << Simulator::Now ().GetSeconds ());
   if (m_nrSubFrames == 10)
     {
-      Simulator::ScheduleNow (&LteEnbPhy::EndFrame, this);
+      LteEventProfiler::ScheduleNow ("LteEnbPhy::EndFrame", &LteEnbPhy::EndFrame, this);
     }
   else
     {
-      Simulator::ScheduleNow (&LteEnbPhy::StartSubFrame, this);
+      LteEventProfiler::ScheduleNow ("LteEnbPhy::StartSubFrame", &LteEnbPhy::StartSubFrame, this);
     }
 }
 
@@ -829,7 +840,7 @@ void
 LteEnbPhy::EndFrame (void)
 {
   NS_LOG_FUNCTION (this << Simulator::Now ().GetSeconds ());
-  Simulator::ScheduleNow (&LteEnbPhy::StartFrame, this);
+  LteEventProfiler::ScheduleNow ("LteEnbPhy::StartFrame", &LteEnbPhy::StartFrame, this);
 }
 
 
@@ -1024,7 +1035,10 @@ LteEnbPhy::CreateSrsReport (uint16_t rnti, double srs)
   (*it).second++;
   if ((*it).second == m_srsSamplePeriod)
     {
-      m_reportUeSinr (m_cellId, rnti, srs);
+      if (m_traceSampler.IsSampled (m_cellId, rnti))
+        {
+          m_reportUeSinr (m_cellId, rnti, srs);
+        }
       (*it).second = 0;
     }
 }
@@ -267,6 +267,11 @@ public:
    */
   void PhyPduReceived (Ptr<Packet> p);
 
+  /**
+   * \brief PhySpectrum received the PHY-PDUs of a subframe
+   */
+  void PhyPdusReceived (const std::vector<Ptr<Packet> >& pdus);
+
   /**
   * \brief PhySpectrum received a new list of LteControlMessage
   */
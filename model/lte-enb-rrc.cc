@@ -44,6 +44,8 @@
 #include <ns3/lte-rlc-um.h>
 #include <ns3/lte-rlc-am.h>
 #include <ns3/lte-pdcp.h>
+#include <ns3/lte-traffic-generator.h>
+#include <ns3/lte-profiler.h>
 
 
 
@@ -249,15 +251,15 @@ UeManager::DoInitialize ()
   switch (m_state)
     {
     case INITIAL_RANDOM_ACCESS:
-      m_connectionRequestTimeout = Simulator::Schedule (m_rrc->m_connectionRequestTimeoutDuration,
-                                                        &LteEnbRrc::ConnectionRequestTimeout,
-                                                        m_rrc, m_rnti);
+      m_connectionRequestTimeout = LteEventProfiler::Schedule ("LteEnbRrc::ConnectionRequestTimeout", m_rrc->m_connectionRequestTimeoutDuration,
+                                                               &LteEnbRrc::ConnectionRequestTimeout,
+                                                               m_rrc, m_rnti);
       break;
 
     case HANDOVER_JOINING:
-      m_handoverJoiningTimeout = Simulator::Schedule (m_rrc->m_handoverJoiningTimeoutDuration,
-                                                      &LteEnbRrc::HandoverJoiningTimeout,
-                                                      m_rrc, m_rnti);
+      m_handoverJoiningTimeout = LteEventProfiler::Schedule ("LteEnbRrc::HandoverJoiningTimeout", m_rrc->m_handoverJoiningTimeoutDuration,
+                                                             &LteEnbRrc::HandoverJoiningTimeout,
+                                                             m_rrc, m_rnti);
       break;
 
     default:
@@ -346,6 +348,7 @@ UeManager::SetupDataRadioBearer (EpsBearer bearer, uint8_t bearerId, uint32_t gt
   uint8_t lcid = Drbid2Lcid (drbid); 
   uint8_t bid = Drbid2Bid (drbid);
   NS_ASSERT_MSG ( bearerId == 0 || bid == bearerId, "bearer ID mismatch (" << (uint32_t) bid << " != " << (uint32_t) bearerId << ", the assumption that ID are allocated in the same way by MME and RRC is not valid any more");
+  drbInfo->m_epsBearer = bearer;
   drbInfo->m_epsBearerIdentity = bid;
   drbInfo->m_drbIdentity = drbid;
   drbInfo->m_logicalChannelIdentity = lcid;
@@ -386,6 +389,19 @@ UeManager::SetupDataRadioBearer (EpsBearer bearer, uint8_t bearerId, uint32_t gt
       pdcp->SetLteRlcSapProvider (rlc->GetLteRlcSapProvider ());
       rlc->SetLteRlcSapUser (pdcp->GetLteRlcSapUser ());
       drbInfo->m_pdcp = pdcp;
+
+      if (m_rrc->m_useTrafficGenerator)
+        {
+          // DL traffic generated here, started with the bearer
+          Ptr<LteTrafficGenerator> generator = m_rrc->m_trafficGeneratorFactory.Create<LteTrafficGenerator> ();
+          generator->SetRnti (m_rnti);
+          generator->SetLcId (lcid);
+          generator->SetLtePdcpSapProvider (pdcp->GetLtePdcpSapProvider ());
+          generator->SetLteRlcSapProvider (rlc->GetLteRlcSapProvider ());
+          generator->SetTxBufferSizeCallback (MakeCallback (&LteRlc::GetTxBufferSize, rlc));
+          m_rrc->AssignTrafficGeneratorStreams (generator);
+          drbInfo->m_trafficGenerator = generator;
+        }
     }
 
   LteEnbCmacSapProvider::LcInfo lcinfo;
@@ -452,10 +468,40 @@ UeManager::StartDataRadioBearers ()
         {
           drbIt->second->m_pdcp->Initialize ();
         }
+      if (drbIt->second->m_trafficGenerator)
+        {
+          drbIt->second->m_trafficGenerator->Initialize ();
+        }
     }
   m_drbsToBeStarted.clear ();
 }
 
+LteRrcSap::RrcConnectionReconfiguration
+UeManager::RestoreConnection (uint64_t imsi)
+{
+  NS_LOG_FUNCTION (this << imsi);
+  NS_ASSERT_MSG (m_state == INITIAL_RANDOM_ACCESS,
+                 "method unexpected in state " << ToString (m_state));
+  m_connectionRequestTimeout.Cancel ();
+  m_imsi = imsi;
+  if (m_rrc->m_s1SapProvider != 0)
+    {
+      // the S1-AP and S11 procedures run synchronously, hence the
+      // bearers known by the MME are set up before this call returns
+      m_rrc->m_s1SapProvider->InitialUeMessage (m_imsi, m_rnti);
+    }
+
+  // the DRBs are configured in the UE together with SRB1, no need to
+  // send a separate reconfiguration
+  m_pendingRrcConnectionReconfiguration = false;
+  LteRrcSap::RrcConnectionReconfiguration msg = BuildRrcConnectionReconfiguration ();
+  RecordDataRadioBearersToBeStarted ();
+  StartDataRadioBearers ();
+  SwitchToState (CONNECTED_NORMALLY);
+  m_rrc->m_connectionEstablishedTrace (m_imsi, m_rrc->m_cellId, m_rnti);
+  return msg;
+}
+
 
 void
 UeManager::ReleaseDataRadioBearer (uint8_t drbid)
@@ -627,9 +673,9 @@ UeManager::RecvHandoverRequestAck (EpcX2SapUser::HandoverRequestAckParams params
   LteRrcSap::RrcConnectionReconfiguration handoverCommand = m_rrc->m_rrcSapUser->DecodeHandoverCommand (encodedHandoverCommand);
   m_rrc->m_rrcSapUser->SendRrcConnectionReconfiguration (m_rnti, handoverCommand);
   SwitchToState (HANDOVER_LEAVING);
-  m_handoverLeavingTimeout = Simulator::Schedule (m_rrc->m_handoverLeavingTimeoutDuration, 
-                                                  &LteEnbRrc::HandoverLeavingTimeout, 
-                                                  m_rrc, m_rnti);
+  m_handoverLeavingTimeout = LteEventProfiler::Schedule ("LteEnbRrc::HandoverLeavingTimeout", m_rrc->m_handoverLeavingTimeoutDuration, 
+                                                         &LteEnbRrc::HandoverLeavingTimeout, 
+                                                         m_rrc, m_rnti);
   NS_ASSERT (handoverCommand.haveMobilityControlInfo);
   m_rrc->m_handoverStartTrace (m_imsi, m_rrc->m_cellId, m_rnti, handoverCommand.mobilityControlInfo.targetPhysCellId);
 
@@ -852,7 +898,8 @@ UeManager::RecvRrcConnectionRequest (LteRrcSap::RrcConnectionRequest msg)
             m_rrc->m_rrcSapUser->SendRrcConnectionSetup (m_rnti, msg2);
 
             RecordDataRadioBearersToBeStarted ();
-            m_connectionSetupTimeout = Simulator::Schedule (
+            m_connectionSetupTimeout = LteEventProfiler::Schedule (
+                "LteEnbRrc::ConnectionSetupTimeout",
                 m_rrc->m_connectionSetupTimeoutDuration,
                 &LteEnbRrc::ConnectionSetupTimeout, m_rrc, m_rnti);
             SwitchToState (CONNECTION_SETUP);
@@ -866,7 +913,8 @@ UeManager::RecvRrcConnectionRequest (LteRrcSap::RrcConnectionRequest msg)
             rejectMsg.waitTime = 3;
             m_rrc->m_rrcSapUser->SendRrcConnectionReject (m_rnti, rejectMsg);
 
-            m_connectionRejectedTimeout = Simulator::Schedule (
+            m_connectionRejectedTimeout = LteEventProfiler::Schedule (
+                "LteEnbRrc::ConnectionRejectedTimeout",
                 m_rrc->m_connectionRejectedTimeoutDuration,
                 &LteEnbRrc::ConnectionRejectedTimeout, m_rrc, m_rnti);
             SwitchToState (CONNECTION_REJECTED);
@@ -1335,7 +1383,10 @@ LteEnbRrc::LteEnbRrc ()
     m_lastAllocatedRnti (0),
     m_srsCurrentPeriodicityId (0),
     m_lastAllocatedConfigurationIndex (0),
-    m_reconfigureUes (false)
+    m_reconfigureUes (false),
+    m_useTrafficGenerator (false),
+    m_trafficGeneratorStream (-1),
+    m_trafficGeneratorCount (0)
 {
   NS_LOG_FUNCTION (this);
   m_cmacSapUser = new EnbRrcMemberLteEnbCmacSapUser (this);
@@ -1494,6 +1545,13 @@ LteEnbRrc::GetTypeId (void)
                    UintegerValue (4),
                    MakeUintegerAccessor (&LteEnbRrc::m_rsrqFilterCoefficient),
                    MakeUintegerChecker<uint8_t> (0))
+    .AddAttribute ("MaxTrafficGenerators",
+                   "Number of traffic generators for which AssignStreams "
+                   "reserves streams, two each, in the order in which the "
+                   "data radio bearers are set up",
+                   UintegerValue (4096),
+                   MakeUintegerAccessor (&LteEnbRrc::m_maxTrafficGenerators),
+                   MakeUintegerChecker<uint32_t> (1))
 
     // Trace sources
     .AddTraceSource ("NewUeContext",
@@ -1821,7 +1879,7 @@ LteEnbRrc::ConfigureCell (uint8_t ulBandwidth, uint8_t dlBandwidth,
    * regularly transmitted every 80 ms by default (set the
    * SystemInformationPeriodicity attribute to configure this).
    */
-  Simulator::Schedule (MilliSeconds (16), &LteEnbRrc::SendSystemInformation, this);
+  LteEventProfiler::Schedule ("LteEnbRrc::SendSystemInformation", MilliSeconds (16), &LteEnbRrc::SendSystemInformation, this);
 
   m_configured = true;
 
@@ -1858,6 +1916,39 @@ LteEnbRrc::SetForwardUpCallback (Callback <void, Ptr<Packet> > cb)
   m_forwardUpCallback = cb;
 }
 
+void
+LteEnbRrc::SetTrafficGeneratorFactory (ObjectFactory factory)
+{
+  NS_LOG_FUNCTION (this);
+  m_useTrafficGenerator = true;
+  m_trafficGeneratorFactory = factory;
+}
+
+int64_t
+LteEnbRrc::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_trafficGeneratorStream = stream;
+  m_trafficGeneratorCount = 0;
+  return 2 * m_maxTrafficGenerators;
+}
+
+void
+LteEnbRrc::AssignTrafficGeneratorStreams (Ptr<LteTrafficGenerator> generator)
+{
+  if (m_trafficGeneratorStream < 0)
+    {
+      return;
+    }
+  // a new pair of streams for each generator, so that a UE reusing the
+  // RNTI of a released one does not replay its traffic
+  NS_ABORT_MSG_IF (m_trafficGeneratorCount >= m_maxTrafficGenerators,
+                   "more than " << m_maxTrafficGenerators << " traffic generators in cell "
+                   << m_cellId << ", increase the MaxTrafficGenerators attribute");
+  generator->AssignStreams (m_trafficGeneratorStream + 2 * m_trafficGeneratorCount);
+  ++m_trafficGeneratorCount;
+}
+
 void
 LteEnbRrc::ConnectionRequestTimeout (uint16_t rnti)
 {
@@ -1921,6 +2012,7 @@ void
 LteEnbRrc::DoCompleteSetupUe (uint16_t rnti, LteEnbRrcSapProvider::CompleteSetupUeParameters params)
 {
   NS_LOG_FUNCTION (this << rnti);
+  LTE_PROFILE_SCOPE (ENB_RRC_PROCEDURE);
   GetUeManager (rnti)->CompleteSetupUe (params);
 }
 
@@ -1928,6 +2020,7 @@ void
 LteEnbRrc::DoRecvRrcConnectionRequest (uint16_t rnti, LteRrcSap::RrcConnectionRequest msg)
 {
   NS_LOG_FUNCTION (this << rnti);
+  LTE_PROFILE_SCOPE (ENB_RRC_PROCEDURE);
   GetUeManager (rnti)->RecvRrcConnectionRequest (msg);
 }
 
@@ -1935,6 +2028,7 @@ void
 LteEnbRrc::DoRecvRrcConnectionSetupCompleted (uint16_t rnti, LteRrcSap::RrcConnectionSetupCompleted msg)
 {
   NS_LOG_FUNCTION (this << rnti);
+  LTE_PROFILE_SCOPE (ENB_RRC_PROCEDURE);
   GetUeManager (rnti)->RecvRrcConnectionSetupCompleted (msg);
 }
 
@@ -1942,6 +2036,7 @@ void
 LteEnbRrc::DoRecvRrcConnectionReconfigurationCompleted (uint16_t rnti, LteRrcSap::RrcConnectionReconfigurationCompleted msg)
 {
   NS_LOG_FUNCTION (this << rnti);
+  LTE_PROFILE_SCOPE (ENB_RRC_PROCEDURE);
   GetUeManager (rnti)->RecvRrcConnectionReconfigurationCompleted (msg);
 }
 
@@ -1949,6 +2044,7 @@ void
 LteEnbRrc::DoRecvRrcConnectionReestablishmentRequest (uint16_t rnti, LteRrcSap::RrcConnectionReestablishmentRequest msg)
 {
   NS_LOG_FUNCTION (this << rnti);
+  LTE_PROFILE_SCOPE (ENB_RRC_PROCEDURE);
   GetUeManager (rnti)->RecvRrcConnectionReestablishmentRequest (msg);
 }
 
@@ -1956,6 +2052,7 @@ void
 LteEnbRrc::DoRecvRrcConnectionReestablishmentComplete (uint16_t rnti, LteRrcSap::RrcConnectionReestablishmentComplete msg)
 {
   NS_LOG_FUNCTION (this << rnti);
+  LTE_PROFILE_SCOPE (ENB_RRC_PROCEDURE);
   GetUeManager (rnti)->RecvRrcConnectionReestablishmentComplete (msg);
 }
 
@@ -1963,12 +2060,14 @@ void
 LteEnbRrc::DoRecvMeasurementReport (uint16_t rnti, LteRrcSap::MeasurementReport msg)
 {
   NS_LOG_FUNCTION (this << rnti);
+  LTE_PROFILE_SCOPE (ENB_RRC_PROCEDURE);
   GetUeManager (rnti)->RecvMeasurementReport (msg);
 }
 
 void 
 LteEnbRrc::DoDataRadioBearerSetupRequest (EpcEnbS1SapUser::DataRadioBearerSetupRequestParameters request)
 {
+  LTE_PROFILE_SCOPE (ENB_RRC_PROCEDURE);
   Ptr<UeManager> ueManager = GetUeManager (request.rnti);
   ueManager->SetupDataRadioBearer (request.bearer, request.bearerId, request.gtpTeid, request.transportLayerAddress);
 }
@@ -1976,6 +2075,7 @@ LteEnbRrc::DoDataRadioBearerSetupRequest (EpcEnbS1SapUser::DataRadioBearerSetupR
 void 
 LteEnbRrc::DoPathSwitchRequestAcknowledge (EpcEnbS1SapUser::PathSwitchRequestAcknowledgeParameters params)
 {
+  LTE_PROFILE_SCOPE (ENB_RRC_PROCEDURE);
   Ptr<UeManager> ueManager = GetUeManager (params.rnti);
   ueManager->SendUeContextRelease ();
 }
@@ -1984,6 +2084,7 @@ void
 LteEnbRrc::DoRecvHandoverRequest (EpcX2SapUser::HandoverRequestParams req)
 {
   NS_LOG_FUNCTION (this);
+  LTE_PROFILE_SCOPE (ENB_RRC_PROCEDURE);
 
   NS_LOG_LOGIC ("Recv X2 message: HANDOVER REQUEST");
 
@@ -2074,6 +2175,7 @@ void
 LteEnbRrc::DoRecvHandoverRequestAck (EpcX2SapUser::HandoverRequestAckParams params)
 {
   NS_LOG_FUNCTION (this);
+  LTE_PROFILE_SCOPE (ENB_RRC_PROCEDURE);
 
   NS_LOG_LOGIC ("Recv X2 message: HANDOVER REQUEST ACK");
 
@@ -2091,6 +2193,7 @@ void
 LteEnbRrc::DoRecvHandoverPreparationFailure (EpcX2SapUser::HandoverPreparationFailureParams params)
 {
   NS_LOG_FUNCTION (this);
+  LTE_PROFILE_SCOPE (ENB_RRC_PROCEDURE);
 
   NS_LOG_LOGIC ("Recv X2 message: HANDOVER PREPARATION FAILURE");
 
@@ -2125,6 +2228,7 @@ void
 LteEnbRrc::DoRecvUeContextRelease (EpcX2SapUser::UeContextReleaseParams params)
 {
   NS_LOG_FUNCTION (this);
+  LTE_PROFILE_SCOPE (ENB_RRC_PROCEDURE);
 
   NS_LOG_LOGIC ("Recv X2 message: UE CONTEXT RELEASE");
 
@@ -2319,6 +2423,62 @@ LteEnbRrc::AddUe (UeManager::State state)
   return rnti;
 }
 
+LteRrcSap::RrcConnectionReconfiguration
+LteEnbRrc::RestoreUe (uint16_t rnti, uint64_t imsi, uint16_t srsConfigIndex)
+{
+  NS_LOG_FUNCTION (this << rnti << imsi << srsConfigIndex);
+  NS_ASSERT_MSG (rnti != 0, "RNTI 0 is reserved");
+  NS_ASSERT_MSG (m_ueMap.find (rnti) == m_ueMap.end (),
+                 "RNTI " << rnti << " already in use in cell " << m_cellId);
+  Ptr<UeManager> ueManager = CreateObject<UeManager> (this, rnti, UeManager::INITIAL_RANDOM_ACCESS);
+  m_ueMap.insert (std::pair<uint16_t, Ptr<UeManager> > (rnti, ueManager));
+  ueManager->Initialize ();
+
+  // the UEs were not restored in the order in which they connected,
+  // hence the index allocated by UeManager::DoInitialize may differ
+  uint16_t srsCi = ueManager->GetSrsConfigurationIndex ();
+  if (srsCi != srsConfigIndex)
+    {
+      NS_ABORT_MSG_IF (m_ueSrsConfigurationIndexSet.find (srsConfigIndex) != m_ueSrsConfigurationIndexSet.end (),
+                       "SRS configuration index " << srsConfigIndex << " of RNTI " << rnti
+                       << " already in use in cell " << m_cellId);
+      RemoveSrsConfigurationIndex (srsCi);
+      m_ueSrsConfigurationIndexSet.insert (srsConfigIndex);
+      ueManager->SetSrsConfigurationIndex (srsConfigIndex);
+    }
+  NS_LOG_INFO (this << " Restored UE RNTI " << rnti << " IMSI " << imsi << " cellId " << m_cellId);
+  m_newUeContextTrace (m_cellId, rnti);
+  return ueManager->RestoreConnection (imsi);
+}
+
+uint16_t
+LteEnbRrc::GetLastAllocatedRnti () const
+{
+  return m_lastAllocatedRnti;
+}
+
+void
+LteEnbRrc::RestoreLastAllocatedRnti (uint16_t rnti)
+{
+  NS_LOG_FUNCTION (this << rnti);
+  m_lastAllocatedRnti = rnti;
+}
+
+LteRrcSap::MasterInformationBlock
+LteEnbRrc::GetMasterInformationBlock () const
+{
+  LteRrcSap::MasterInformationBlock mib;
+  mib.dlBandwidth = m_dlBandwidth;
+  mib.systemFrameNumber = 0;
+  return mib;
+}
+
+LteRrcSap::SystemInformationBlockType1
+LteEnbRrc::GetSystemInformationBlockType1 () const
+{
+  return m_sib1;
+}
+
 // stub function
 bool
 LteEnbRrc::RemoveUeByImsi (uint16_t rnti) {
@@ -2335,7 +2495,7 @@ LteEnbRrc::RemoveUeByImsi (uint16_t rnti) {
         { // disconnect only if the UE is connected normally
           it->second->SendRrcConnectionRelease();
           // remove the ue after some time just to let the enb send the message
-          Simulator::Schedule(Seconds(0.2), &ns3::LteEnbRrc::RemoveUe, this, rnti);
+          LteEventProfiler::Schedule("LteEnbRrc::RemoveUe", Seconds(0.2), &ns3::LteEnbRrc::RemoveUe, this, rnti);
           return true;
         }
       else
@@ -2560,11 +2720,9 @@ LteEnbRrc::GetLogicalChannelPriority (EpsBearer bearer)
   return bearer.qci;
 }
 
-void
-LteEnbRrc::SendSystemInformation ()
+LteRrcSap::SystemInformation
+LteEnbRrc::BuildSystemInformation ()
 {
-  // NS_LOG_FUNCTION (this);
-
   /*
    * For simplicity, we use the same periodicity for all SIBs. Note that in real
    * systems the periodicy of each SIBs could be different.
@@ -2587,9 +2745,15 @@ LteEnbRrc::SendSystemInformation ()
   rachConfigCommon.raSupervisionInfo.contentionResolutionTimer = rc.contentionResolutionTimer;
 
   si.sib2.radioResourceConfigCommon.rachConfigCommon = rachConfigCommon;
+  return si;
+}
 
-  m_rrcSapUser->SendSystemInformation (si);
-  Simulator::Schedule (m_systemInformationPeriodicity, &LteEnbRrc::SendSystemInformation, this);
+void
+LteEnbRrc::SendSystemInformation ()
+{
+  // NS_LOG_FUNCTION (this);
+  m_rrcSapUser->SendSystemInformation (BuildSystemInformation ());
+  LteEventProfiler::Schedule ("LteEnbRrc::SendSystemInformation", m_systemInformationPeriodicity, &LteEnbRrc::SendSystemInformation, this);
 }
 
 
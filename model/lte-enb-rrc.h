@@ -29,6 +29,7 @@
 
 #include <ns3/nstime.h>
 #include <ns3/object.h>
+#include <ns3/object-factory.h>
 #include <ns3/traced-callback.h>
 #include <ns3/event-id.h>
 
@@ -53,6 +54,7 @@ namespace ns3 {
 class LteRadioBearerInfo;
 class LteSignalingRadioBearerInfo;
 class LteDataRadioBearerInfo;
+class LteTrafficGenerator;
 class LteEnbRrc;
 class Packet;
 
@@ -153,6 +155,19 @@ public:
    */
   void StartDataRadioBearers ();
 
+  /** 
+   * Bring a UeManager created in INITIAL_RANDOM_ACCESS state straight
+   * to CONNECTED_NORMALLY without any RRC message exchange with the UE.
+   * The S1 initial UE message is still sent, so that the EPC sets up
+   * the bearers stored in the MME exactly as in a regular attach.
+   * 
+   * \param imsi the IMSI of the UE
+   * 
+   * \return the RRC connection reconfiguration the UE has to apply to
+   * obtain the same SRB, DRB and measurement configuration
+   */
+  LteRrcSap::RrcConnectionReconfiguration RestoreConnection (uint64_t imsi);
+
   /**
    *
    * Release a given radio bearer
@@ -767,6 +782,25 @@ public:
    */
   void SetForwardUpCallback (Callback <void, Ptr<Packet> > cb);
 
+  /** 
+   * Attach a traffic generator, created by the given factory, to each data
+   * radio bearer set up from now on (see LteTrafficGenerator).
+   * 
+   * \param factory the factory of ns3::LteTrafficGenerator objects
+   */
+  void SetTrafficGeneratorFactory (ObjectFactory factory);
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * of the traffic generators set up from now on: each new generator
+   * takes the next two streams of a block sized by the
+   * MaxTrafficGenerators attribute.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices (possibly) assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
   /** 
    * Method triggered when a UE is expected to request for connection but does
    * not do so in a reasonable time. The method will remove the UE context.
@@ -887,6 +921,52 @@ public:
    * \param rnti
    */
   bool RemoveUeByImsi ( uint16_t rnti );
+
+  /**
+   * \brief Restore the context of a UE connected to this cell
+   * \param rnti the C-RNTI the UE had when the snapshot was taken
+   * \param imsi the IMSI of the UE
+   * \param srsConfigIndex the SRS configuration index the UE had when
+   *        the snapshot was taken
+   * \return the RRC connection reconfiguration to be applied by the UE
+   *
+   * Used by LteHelper::RestoreConnectedState to skip random access and
+   * RRC connection establishment. The UE is expected to apply the
+   * returned configuration through LteUeRrc::RestoreConnection.
+   */
+  LteRrcSap::RrcConnectionReconfiguration RestoreUe (uint16_t rnti, uint64_t imsi, uint16_t srsConfigIndex);
+
+  /**
+   * \return the C-RNTI allocated last by this cell, after which the
+   *         search for a free one starts
+   */
+  uint16_t GetLastAllocatedRnti () const;
+
+  /**
+   * \brief Restore the state of the C-RNTI allocation
+   * \param rnti the value of GetLastAllocatedRnti when the snapshot was
+   *        taken
+   *
+   * Called by LteHelper::RestoreConnectedState once the UEs of the cell
+   * are restored, so that the UEs connecting afterwards get the same
+   * C-RNTIs as in the original run.
+   */
+  void RestoreLastAllocatedRnti (uint16_t rnti);
+
+  /**
+   * \return the MIB broadcast by this cell
+   */
+  LteRrcSap::MasterInformationBlock GetMasterInformationBlock () const;
+
+  /**
+   * \return the SIB1 broadcast by this cell
+   */
+  LteRrcSap::SystemInformationBlockType1 GetSystemInformationBlockType1 () const;
+
+  /**
+   * \return the System Information (SIB2) periodically broadcast by this cell
+   */
+  LteRrcSap::SystemInformation BuildSystemInformation ();
   
   
 private:
@@ -1072,6 +1152,25 @@ private:
 
   Callback <void, Ptr<Packet> > m_forwardUpCallback;
 
+  /**
+   * Give the next two streams reserved by AssignStreams to a new traffic
+   * generator, if AssignStreams was called.
+   *
+   * \param generator the traffic generator
+   */
+  void AssignTrafficGeneratorStreams (Ptr<LteTrafficGenerator> generator);
+
+  /// True if a traffic generator is attached to each data radio bearer.
+  bool m_useTrafficGenerator;
+  /// Factory of the traffic generators of the data radio bearers.
+  ObjectFactory m_trafficGeneratorFactory;
+  /// First stream of the traffic generators, or -1 if not assigned.
+  int64_t m_trafficGeneratorStream;
+  /// Number of traffic generators given streams since AssignStreams.
+  uint32_t m_trafficGeneratorCount;
+  /// The `MaxTrafficGenerators` attribute.
+  uint32_t m_maxTrafficGenerators;
+
   /// Interface to receive messages from neighbour eNodeB over the X2 interface.
   EpcX2SapUser* m_x2SapUser;
   /// Interface to send messages to neighbour eNodeB over the X2 interface.
@@ -25,6 +25,7 @@
 
 #include "lte-interference.h"
 #include "lte-chunk-processor.h"
+#include "lte-profiler.h"
 
 #include <ns3/simulator.h>
 #include <ns3/log.h>
@@ -185,7 +186,7 @@ LteInterference::AddSignal (Ptr<const SpectrumValue> spd, const Time duration)
       // boundary further.
       m_lastSignalIdBeforeReset += 0x10000000;
     }
-  Simulator::Schedule (duration, &LteInterference::DoSubtractSignal, this, spd, signalId);
+  LteEventProfiler::Schedule ("LteInterference::DoSubtractSignal", duration, &LteInterference::DoSubtractSignal, this, spd, signalId);
 }
 
 
@@ -218,6 +219,7 @@ void
 LteInterference::ConditionallyEvaluateChunk ()
 {
   NS_LOG_FUNCTION (this);
+  LTE_PROFILE_SCOPE (INTERFERENCE_EVALUATE_CHUNK);
   if (m_receiving)
     {
       NS_LOG_DEBUG (this << " Receiving");
@@ -140,6 +140,14 @@ LtePhy::SetTti (double tti)
 }
 
 
+void
+LtePhy::SetTraceSampler (const LteTraceSampler& sampler)
+{
+  NS_LOG_FUNCTION (this);
+  m_traceSampler = sampler;
+}
+
+
 double
 LtePhy::GetTti (void) const
 {
@@ -38,6 +38,7 @@
 #include <ns3/spectrum-interference.h>
 #include <ns3/generic-phy.h>
 #include <ns3/lte-spectrum-phy.h>
+#include <ns3/lte-trace-sampler.h>
 
 namespace ns3 {
 
@@ -133,6 +134,11 @@ public:
    */
   double GetTti (void) const;
 
+  /**
+   * \param sampler the sampling policy of the per-TTI traces of this PHY
+   */
+  void SetTraceSampler (const LteTraceSampler& sampler);
+
   /** 
    * 
    * \param cellId the Cell Identifier
@@ -308,6 +314,11 @@ protected:
    */
   uint16_t m_cellId;
 
+  /**
+   * Sampling policy of the per-TTI traces.
+   */
+  LteTraceSampler m_traceSampler;
+
 }; // end of `class LtePhy`
 
 
@@ -0,0 +1,411 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-profiler.h"
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/node-list.h>
+#include <ns3/node.h>
+#include <ns3/lte-enb-net-device.h>
+#include <ns3/lte-ue-net-device.h>
+#include <fstream>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteProfiler");
+
+/// Counters of all the entry points in one context
+struct LteProfilerCounters
+{
+  LteProfilerCounters ()
+  {
+    for (int i = 0; i < LteProfiler::N_PROBES; ++i)
+      {
+        calls[i] = 0;
+        cycles[i] = 0;
+      }
+  }
+
+  uint64_t calls[LteProfiler::N_PROBES]; ///< number of calls
+  uint64_t cycles[LteProfiler::N_PROBES]; ///< cycles spent
+};
+
+/**
+ * \return the counters, indexed by context + 1, slot 0 being for the
+ *         code run outside of any context
+ */
+static std::vector<LteProfilerCounters>&
+GetCountersByContext (void)
+{
+  static std::vector<LteProfilerCounters> counters;
+  return counters;
+}
+
+/**
+ * \param context a simulation context
+ * \return the index of its counters
+ */
+static uint32_t
+GetSlot (uint32_t context)
+{
+  return context == Simulator::NO_CONTEXT ? 0 : context + 1;
+}
+
+/// Kind of the nodes in the report
+enum LteProfilerReportKind
+{
+  REPORT_CELL = 0,
+  REPORT_UE,
+  REPORT_OTHER_NODE,
+  REPORT_NO_CONTEXT
+};
+
+/// Line of the report, ordered by kind then ID
+typedef std::pair<LteProfilerReportKind, uint32_t> LteProfilerReportGroup;
+
+/**
+ * \param context a simulation context
+ * \return the line of the report where it is accounted for
+ */
+static LteProfilerReportGroup
+GetLteProfilerReportGroup (uint32_t context)
+{
+  if (context == Simulator::NO_CONTEXT)
+    {
+      return LteProfilerReportGroup (REPORT_NO_CONTEXT, 0);
+    }
+  if (context >= NodeList::GetNNodes ())
+    {
+      return LteProfilerReportGroup (REPORT_OTHER_NODE, context);
+    }
+  Ptr<Node> node = NodeList::GetNode (context);
+  for (uint32_t i = 0; i < node->GetNDevices (); ++i)
+    {
+      Ptr<LteEnbNetDevice> enbDev = node->GetDevice (i)->GetObject<LteEnbNetDevice> ();
+      if (enbDev != 0)
+        {
+          return LteProfilerReportGroup (REPORT_CELL, enbDev->GetCellId ());
+        }
+      if (node->GetDevice (i)->GetObject<LteUeNetDevice> () != 0)
+        {
+          return LteProfilerReportGroup (REPORT_UE, 0);
+        }
+    }
+  return LteProfilerReportGroup (REPORT_OTHER_NODE, context);
+}
+
+void
+LteProfiler::Record (Probe probe, uint64_t cycles)
+{
+  std::vector<LteProfilerCounters>& counters = GetCountersByContext ();
+  uint32_t slot = GetSlot (Simulator::GetContext ());
+  if (slot >= counters.size ())
+    {
+      counters.resize (slot + 1);
+    }
+  counters[slot].calls[probe]++;
+  counters[slot].cycles[probe] += cycles;
+}
+
+uint64_t
+LteProfiler::GetCalls (Probe probe, uint32_t context)
+{
+  std::vector<LteProfilerCounters>& counters = GetCountersByContext ();
+  uint32_t slot = GetSlot (context);
+  return slot < counters.size () ? counters[slot].calls[probe] : 0;
+}
+
+uint64_t
+LteProfiler::GetCycles (Probe probe, uint32_t context)
+{
+  std::vector<LteProfilerCounters>& counters = GetCountersByContext ();
+  uint32_t slot = GetSlot (context);
+  return slot < counters.size () ? counters[slot].cycles[probe] : 0;
+}
+
+const char*
+LteProfiler::GetProbeName (Probe probe)
+{
+  switch (probe)
+    {
+    case PHY_START_RX:
+      return "LteSpectrumPhy::StartRx";
+    case PHY_END_RX_DATA:
+      return "LteSpectrumPhy::EndRxData";
+    case PHY_END_RX_PRACH:
+      return "LteSpectrumPhy::EndRxPrach";
+    case INTERFERENCE_EVALUATE_CHUNK:
+      return "LteInterference::ConditionallyEvaluateChunk";
+    case SCHED_DL_TRIGGER:
+      return "FfMacScheduler::SchedDlTriggerReq";
+    case SCHED_UL_TRIGGER:
+      return "FfMacScheduler::SchedUlTriggerReq";
+    case RLC_AM_TX_OPPORTUNITY:
+      return "LteRlcAm::DoNotifyTxOpportunity";
+    case ENB_RRC_PROCEDURE:
+      return "LteEnbRrc procedures";
+    case TFT_CLASSIFY:
+      return "EpcTftClassifier::Classify";
+    default:
+      return "unknown";
+    }
+}
+
+void
+LteProfiler::Print (std::ostream& os)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  std::vector<LteProfilerCounters>& counters = GetCountersByContext ();
+  std::map<LteProfilerReportGroup, LteProfilerCounters> report;
+  for (uint32_t slot = 0; slot < counters.size (); ++slot)
+    {
+      uint32_t context = slot == 0 ? Simulator::NO_CONTEXT : slot - 1;
+      LteProfilerCounters& total = report[GetLteProfilerReportGroup (context)];
+      for (int i = 0; i < N_PROBES; ++i)
+        {
+          total.calls[i] += counters[slot].calls[i];
+          total.cycles[i] += counters[slot].cycles[i];
+        }
+    }
+
+  os << "% probe\tentity\tcalls\tcycles\tcyclesPerCall" << std::endl;
+  for (int i = 0; i < N_PROBES; ++i)
+    {
+      for (std::map<LteProfilerReportGroup, LteProfilerCounters>::const_iterator it = report.begin ();
+           it != report.end (); ++it)
+        {
+          if (it->second.calls[i] == 0)
+            {
+              continue;
+            }
+          os << GetProbeName (static_cast<Probe> (i)) << "\t";
+          switch (it->first.first)
+            {
+            case REPORT_CELL:
+              os << "cell " << it->first.second;
+              break;
+            case REPORT_UE:
+              os << "UEs";
+              break;
+            case REPORT_OTHER_NODE:
+              os << "node " << it->first.second;
+              break;
+            default:
+              os << "-";
+              break;
+            }
+          os << "\t" << it->second.calls[i]
+             << "\t" << it->second.cycles[i]
+             << "\t" << it->second.cycles[i] / it->second.calls[i]
+             << std::endl;
+        }
+    }
+}
+
+bool
+LteProfiler::Dump (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  std::ofstream outFile (filename.c_str ());
+  if (!outFile.is_open ())
+    {
+      NS_LOG_ERROR ("Can't open file " << filename.c_str ());
+      return false;
+    }
+  Print (outFile);
+  return true;
+}
+
+void
+LteProfiler::Reset (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  GetCountersByContext ().clear ();
+}
+
+
+/// Counters of the events, per handler and context
+typedef std::map<std::pair<const char*, uint32_t>, LteEventCounters> LteEventCountersMap;
+
+/**
+ * \return the counters of the events. The handlers are identified by
+ *         the address of their name, and merged by name in the report.
+ */
+static LteEventCountersMap&
+GetEventCounters (void)
+{
+  static LteEventCountersMap counters;
+  return counters;
+}
+
+/**
+ * \return the events scheduled and not yet destroyed
+ */
+static std::set<LteProfiledEvent*>&
+GetLiveEvents (void)
+{
+  static std::set<LteProfiledEvent*> events;
+  return events;
+}
+
+Ptr<EventImpl>
+LteEventProfiler::Wrap (const char* handler, EventImpl* event)
+{
+  LteEventCounters* counters = &GetEventCounters ()[std::make_pair (handler, Simulator::GetContext ())];
+  counters->scheduled++;
+  LteProfiledEvent* profiledEvent = new LteProfiledEvent (counters, event);
+  GetLiveEvents ().insert (profiledEvent);
+  return Ptr<EventImpl> (profiledEvent, false);
+}
+
+void
+LteEventProfiler::Print (std::ostream& os)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  // the events still in the queue, which may have been cancelled already
+  std::map<LteEventCounters*, uint64_t> pending;
+  std::map<LteEventCounters*, uint64_t> cancelledPending;
+  std::set<LteProfiledEvent*>& live = GetLiveEvents ();
+  for (std::set<LteProfiledEvent*>::const_iterator it = live.begin (); it != live.end (); ++it)
+    {
+      if ((*it)->IsCancelled ())
+        {
+          cancelledPending[(*it)->GetCounters ()]++;
+        }
+      else
+        {
+          pending[(*it)->GetCounters ()]++;
+        }
+    }
+
+  typedef std::pair<std::string, LteProfilerReportGroup> Line;
+  std::map<Line, LteEventCounters> report;
+  std::map<Line, uint64_t> reportPending;
+  LteEventCountersMap& counters = GetEventCounters ();
+  for (LteEventCountersMap::iterator it = counters.begin (); it != counters.end (); ++it)
+    {
+      Line line (it->first.first, GetLteProfilerReportGroup (it->first.second));
+      LteEventCounters& total = report[line];
+      total.scheduled += it->second.scheduled;
+      total.executed += it->second.executed;
+      total.cancelled += it->second.cancelled + cancelledPending[&it->second];
+      total.residence += it->second.residence;
+      reportPending[line] += pending[&it->second];
+    }
+
+  os << "% handler\tentity\tscheduled\texecuted\tcancelled\tpending\tcancelledRatio\tavgResidenceMs" << std::endl;
+  for (std::map<Line, LteEventCounters>::const_iterator it = report.begin (); it != report.end (); ++it)
+    {
+      if (it->second.scheduled == 0)
+        {
+          continue;
+        }
+      os << it->first.first << "\t";
+      switch (it->first.second.first)
+        {
+        case REPORT_CELL:
+          os << "cell " << it->first.second.second;
+          break;
+        case REPORT_UE:
+          os << "UEs";
+          break;
+        case REPORT_OTHER_NODE:
+          os << "node " << it->first.second.second;
+          break;
+        default:
+          os << "-";
+          break;
+        }
+      double avgResidence = 0;
+      if (it->second.executed > 0)
+        {
+          avgResidence = TimeStep (it->second.residence / it->second.executed).GetSeconds () * 1000;
+        }
+      os << "\t" << it->second.scheduled
+         << "\t" << it->second.executed
+         << "\t" << it->second.cancelled
+         << "\t" << reportPending[it->first]
+         << "\t" << static_cast<double> (it->second.cancelled) / it->second.scheduled
+         << "\t" << avgResidence
+         << std::endl;
+    }
+}
+
+bool
+LteEventProfiler::Dump (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  std::ofstream outFile (filename.c_str ());
+  if (!outFile.is_open ())
+    {
+      NS_LOG_ERROR ("Can't open file " << filename.c_str ());
+      return false;
+    }
+  Print (outFile);
+  return true;
+}
+
+void
+LteEventProfiler::Reset (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  // the live events keep pointers to their counters
+  LteEventCountersMap& counters = GetEventCounters ();
+  for (LteEventCountersMap::iterator it = counters.begin (); it != counters.end (); ++it)
+    {
+      it->second = LteEventCounters ();
+    }
+}
+
+
+LteProfiledEvent::LteProfiledEvent (LteEventCounters* counters, EventImpl* event)
+  : m_counters (counters),
+    m_event (event),
+    m_scheduleTs (Simulator::Now ().GetTimeStep ()),
+    m_executed (false)
+{
+}
+
+LteProfiledEvent::~LteProfiledEvent ()
+{
+  // may run within Simulator::Destroy, hence no call to the simulator
+  if (!m_executed && IsCancelled ())
+    {
+      m_counters->cancelled++;
+    }
+  GetLiveEvents ().erase (this);
+  m_event->Unref ();
+}
+
+LteEventCounters*
+LteProfiledEvent::GetCounters (void) const
+{
+  return m_counters;
+}
+
+void
+LteProfiledEvent::Notify (void)
+{
+  m_executed = true;
+  m_counters->executed++;
+  m_counters->residence += Simulator::Now ().GetTimeStep () - m_scheduleTs;
+  m_event->Invoke ();
+}
+
+} // namespace ns3
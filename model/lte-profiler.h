@@ -0,0 +1,391 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_PROFILER_H
+#define LTE_PROFILER_H
+
+#include <ns3/simulator.h>
+#include <ns3/event-impl.h>
+#include <ns3/make-event.h>
+#include <ns3/nstime.h>
+#include <stdint.h>
+#include <ostream>
+#include <string>
+
+#if !defined (__i386__) && !defined (__x86_64__)
+#include <time.h>
+#endif
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * Call counts and CPU cycles spent in the hot entry points of the LTE
+ * protocol entities, to tell whether a scenario is PHY-bound,
+ * scheduler-bound or stats-bound without an external profiler.
+ *
+ * The entry points are instrumented with LTE_PROFILE_SCOPE, which
+ * expands to nothing unless the module is configured with
+ * --enable-lte-profiling (which defines NS3_LTE_PROFILING). The cycles
+ * of a probe are inclusive of the nested probes, e.g., those of
+ * PHY_START_RX include the evaluation of the interference.
+ *
+ * The counters are aggregated per simulation context, i.e., per node,
+ * and reported per cell for the eNB nodes. The UE nodes are reported
+ * together, and the other nodes (e.g., the PGW) individually. Print or
+ * Dump must be called before Simulator::Destroy, while the nodes still
+ * exist.
+ */
+class LteProfiler
+{
+public:
+  /// The instrumented entry points
+  enum Probe
+  {
+    PHY_START_RX = 0,
+    PHY_END_RX_DATA,
+    PHY_END_RX_PRACH,
+    INTERFERENCE_EVALUATE_CHUNK,
+    SCHED_DL_TRIGGER,
+    SCHED_UL_TRIGGER,
+    RLC_AM_TX_OPPORTUNITY,
+    ENB_RRC_PROCEDURE,
+    TFT_CLASSIFY,
+    N_PROBES
+  };
+
+  /**
+   * Account for one call of an entry point in the current context
+   * \param probe the entry point
+   * \param cycles the cycles spent in the call
+   */
+  static void Record (Probe probe, uint64_t cycles);
+
+  /**
+   * \param probe the entry point
+   * \param context the simulation context (node ID)
+   * \return the number of calls of the entry point in this context
+   */
+  static uint64_t GetCalls (Probe probe, uint32_t context);
+
+  /**
+   * \param probe the entry point
+   * \param context the simulation context (node ID)
+   * \return the cycles spent in the entry point in this context
+   */
+  static uint64_t GetCycles (Probe probe, uint32_t context);
+
+  /**
+   * \param probe the entry point
+   * \return the name of the entry point
+   */
+  static const char* GetProbeName (Probe probe);
+
+  /**
+   * Write the counters, one line per entry point and cell
+   * \param os the output stream
+   */
+  static void Print (std::ostream& os);
+
+  /**
+   * Write the counters to a file
+   * \param filename the name of the file
+   * \return false if the file could not be created
+   */
+  static bool Dump (std::string filename);
+
+  /**
+   * Zero all the counters
+   */
+  static void Reset (void);
+
+  /**
+   * \return the time stamp counter of the processor, or a nanosecond
+   *         clock where it is not available
+   */
+  static inline uint64_t ReadCycleCounter (void)
+  {
+#if defined (__i386__) || defined (__x86_64__)
+    uint32_t lo, hi;
+    __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+    return (static_cast<uint64_t> (hi) << 32) | lo;
+#else
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t> (ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+  }
+};
+
+
+/**
+ * \ingroup lte
+ *
+ * Records the cycles spent between its construction and its
+ * destruction with LteProfiler. Instantiated by LTE_PROFILE_SCOPE.
+ */
+class LteProfilerScope
+{
+public:
+  /**
+   * \param probe the entry point being executed
+   */
+  LteProfilerScope (LteProfiler::Probe probe)
+    : m_probe (probe),
+      m_start (LteProfiler::ReadCycleCounter ())
+  {
+  }
+
+  ~LteProfilerScope ()
+  {
+    LteProfiler::Record (m_probe, LteProfiler::ReadCycleCounter () - m_start);
+  }
+
+private:
+  LteProfiler::Probe m_probe; ///< the entry point
+  uint64_t m_start; ///< the cycle counter at the entry
+};
+
+
+/**
+ * \ingroup lte
+ *
+ * Accounting of the events scheduled by the LTE protocol entities, to
+ * tell which of them fill the event queue of the simulator.
+ *
+ * The events are scheduled through LteEventProfiler::Schedule and
+ * ScheduleNow, which take the name of the handler in addition to the
+ * arguments of Simulator::Schedule. Unless the module is configured
+ * with --enable-lte-profiling, these are plain inline forwards to
+ * Simulator::Schedule and ScheduleNow. Otherwise, each event is wrapped
+ * in an LteProfiledEvent which counts its execution or cancellation,
+ * and the simulated time it spent in the queue.
+ *
+ * The counters are aggregated per handler and per simulation context,
+ * and reported per cell as those of LteProfiler. Print or Dump must be
+ * called before Simulator::Destroy.
+ */
+class LteEventProfiler
+{
+public:
+  /**
+   * Schedule an event, accounted for as the given handler
+   * \param handler the name of the handler, a string literal
+   * \param delay the delay of the event
+   * \param mem_ptr member method pointer to invoke
+   * \param obj the object on which to invoke the member method
+   * \return the id of the event
+   */
+  template <typename MEM, typename OBJ>
+  static EventId Schedule (const char* handler, Time const &delay, MEM mem_ptr, OBJ obj);
+
+  /**
+   * \copydoc Schedule(const char*,Time const&,MEM,OBJ)
+   * \param a1 the first argument of the method
+   */
+  template <typename MEM, typename OBJ, typename T1>
+  static EventId Schedule (const char* handler, Time const &delay, MEM mem_ptr, OBJ obj, T1 a1);
+
+  /**
+   * \copydoc Schedule(const char*,Time const&,MEM,OBJ,T1)
+   * \param a2 the second argument of the method
+   */
+  template <typename MEM, typename OBJ, typename T1, typename T2>
+  static EventId Schedule (const char* handler, Time const &delay, MEM mem_ptr, OBJ obj, T1 a1, T2 a2);
+
+  /**
+   * \copydoc Schedule(const char*,Time const&,MEM,OBJ,T1,T2)
+   * \param a3 the third argument of the method
+   */
+  template <typename MEM, typename OBJ, typename T1, typename T2, typename T3>
+  static EventId Schedule (const char* handler, Time const &delay, MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3);
+
+  /**
+   * Schedule an event to expire now, accounted for as the given handler
+   * \param handler the name of the handler, a string literal
+   * \param mem_ptr member method pointer to invoke
+   * \param obj the object on which to invoke the member method
+   * \return the id of the event
+   */
+  template <typename MEM, typename OBJ>
+  static EventId ScheduleNow (const char* handler, MEM mem_ptr, OBJ obj);
+
+  /**
+   * \copydoc ScheduleNow(const char*,MEM,OBJ)
+   * \param a1 the first argument of the method
+   */
+  template <typename MEM, typename OBJ, typename T1>
+  static EventId ScheduleNow (const char* handler, MEM mem_ptr, OBJ obj, T1 a1);
+
+  /**
+   * \param handler the name of the handler
+   * \param event the event to be accounted for
+   * \return the event, wrapped in an LteProfiledEvent
+   */
+  static Ptr<EventImpl> Wrap (const char* handler, EventImpl* event);
+
+  /**
+   * Write the counters, one line per handler and cell
+   * \param os the output stream
+   */
+  static void Print (std::ostream& os);
+
+  /**
+   * Write the counters to a file
+   * \param filename the name of the file
+   * \return false if the file could not be created
+   */
+  static bool Dump (std::string filename);
+
+  /**
+   * Zero all the counters
+   */
+  static void Reset (void);
+};
+
+
+/// Counters of the events of one handler in one context
+struct LteEventCounters
+{
+  LteEventCounters ()
+    : scheduled (0),
+      executed (0),
+      cancelled (0),
+      residence (0)
+  {
+  }
+
+  uint64_t scheduled; ///< number of events scheduled
+  uint64_t executed; ///< number of events executed
+  uint64_t cancelled; ///< number of cancelled events removed from the queue
+  int64_t residence; ///< total time steps spent in the queue by the executed events
+};
+
+/**
+ * \ingroup lte
+ *
+ * An event scheduled through LteEventProfiler, which updates the
+ * counters of its handler when it is executed or destroyed.
+ */
+class LteProfiledEvent : public EventImpl
+{
+public:
+  /**
+   * \param counters the counters of the handler in the current context
+   * \param event the wrapped event, owned by this one
+   */
+  LteProfiledEvent (LteEventCounters* counters, EventImpl* event);
+  virtual ~LteProfiledEvent ();
+
+  /**
+   * \return the counters of the handler
+   */
+  LteEventCounters* GetCounters (void) const;
+
+protected:
+  virtual void Notify (void);
+
+private:
+  LteEventCounters* m_counters; ///< the counters of the handler
+  EventImpl* m_event; ///< the wrapped event
+  int64_t m_scheduleTs; ///< the time step at which the event was scheduled
+  bool m_executed; ///< whether the event was executed
+};
+
+
+template <typename MEM, typename OBJ>
+EventId
+LteEventProfiler::Schedule (const char* handler, Time const &delay, MEM mem_ptr, OBJ obj)
+{
+#ifdef NS3_LTE_PROFILING
+  return Simulator::Schedule (delay, Wrap (handler, MakeEvent (mem_ptr, obj)));
+#else
+  return Simulator::Schedule (delay, mem_ptr, obj);
+#endif
+}
+
+template <typename MEM, typename OBJ, typename T1>
+EventId
+LteEventProfiler::Schedule (const char* handler, Time const &delay, MEM mem_ptr, OBJ obj, T1 a1)
+{
+#ifdef NS3_LTE_PROFILING
+  return Simulator::Schedule (delay, Wrap (handler, MakeEvent (mem_ptr, obj, a1)));
+#else
+  return Simulator::Schedule (delay, mem_ptr, obj, a1);
+#endif
+}
+
+template <typename MEM, typename OBJ, typename T1, typename T2>
+EventId
+LteEventProfiler::Schedule (const char* handler, Time const &delay, MEM mem_ptr, OBJ obj, T1 a1, T2 a2)
+{
+#ifdef NS3_LTE_PROFILING
+  return Simulator::Schedule (delay, Wrap (handler, MakeEvent (mem_ptr, obj, a1, a2)));
+#else
+  return Simulator::Schedule (delay, mem_ptr, obj, a1, a2);
+#endif
+}
+
+template <typename MEM, typename OBJ, typename T1, typename T2, typename T3>
+EventId
+LteEventProfiler::Schedule (const char* handler, Time const &delay, MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3)
+{
+#ifdef NS3_LTE_PROFILING
+  return Simulator::Schedule (delay, Wrap (handler, MakeEvent (mem_ptr, obj, a1, a2, a3)));
+#else
+  return Simulator::Schedule (delay, mem_ptr, obj, a1, a2, a3);
+#endif
+}
+
+template <typename MEM, typename OBJ>
+EventId
+LteEventProfiler::ScheduleNow (const char* handler, MEM mem_ptr, OBJ obj)
+{
+#ifdef NS3_LTE_PROFILING
+  return Simulator::ScheduleNow (Wrap (handler, MakeEvent (mem_ptr, obj)));
+#else
+  return Simulator::ScheduleNow (mem_ptr, obj);
+#endif
+}
+
+template <typename MEM, typename OBJ, typename T1>
+EventId
+LteEventProfiler::ScheduleNow (const char* handler, MEM mem_ptr, OBJ obj, T1 a1)
+{
+#ifdef NS3_LTE_PROFILING
+  return Simulator::ScheduleNow (Wrap (handler, MakeEvent (mem_ptr, obj, a1)));
+#else
+  return Simulator::ScheduleNow (mem_ptr, obj, a1);
+#endif
+}
+
+} // namespace ns3
+
+/**
+ * \ingroup lte
+ *
+ * Profile the rest of the enclosing block as the given
+ * LteProfiler::Probe, if NS3_LTE_PROFILING is defined
+ */
+#ifdef NS3_LTE_PROFILING
+#define LTE_PROFILE_SCOPE(probe)                                        \
+  ns3::LteProfilerScope lteProfilerScope (ns3::LteProfiler::probe)
+#else
+#define LTE_PROFILE_SCOPE(probe)
+#endif
+
+#endif /* LTE_PROFILER_H */
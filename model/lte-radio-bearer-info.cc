@@ -22,6 +22,7 @@
 #include "lte-ue-rrc.h"
 #include "lte-rlc.h"
 #include "lte-pdcp.h"
+#include "lte-traffic-generator.h"
 
 #include <ns3/log.h>
 
@@ -83,6 +84,10 @@ LteDataRadioBearerInfo::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&LteRadioBearerInfo::m_pdcp),
                    MakePointerChecker<LtePdcp> ())
+    .AddAttribute ("LteTrafficGenerator", "Traffic generator of the radio bearer, if any.",
+                   PointerValue (),
+                   MakePointerAccessor (&LteDataRadioBearerInfo::m_trafficGenerator),
+                   MakePointerChecker<LteTrafficGenerator> ())
     ;
   return tid;
 }
@@ -31,6 +31,7 @@ namespace ns3 {
 
 class LteRlc;
 class LtePdcp;
+class LteTrafficGenerator;
 
 /**
  * store information on active radio bearer instance
@@ -82,6 +83,7 @@ public:
   LteRrcSap::LogicalChannelConfig m_logicalChannelConfig;
   uint32_t m_gtpTeid; /**< S1-bearer GTP tunnel endpoint identifier, see 36.423 9.2.1 */
   Ipv4Address m_transportLayerAddress; /**< IP Address of the SGW, see 36.423 9.2.1 */
+  Ptr<LteTrafficGenerator> m_trafficGenerator; /**< traffic source of the bearer, if any */
 };
 
 
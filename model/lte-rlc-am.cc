@@ -25,11 +25,15 @@
 
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/boolean.h"
 
 #include "ns3/lte-rlc-am-header.h"
 #include "ns3/lte-rlc-am.h"
 #include "ns3/lte-rlc-sdu-status-tag.h"
 #include "ns3/lte-rlc-tag.h"
+#include "ns3/lte-profiler.h"
+
+#include <bitset>
 
 
 namespace ns3 {
@@ -44,7 +48,6 @@ LteRlcAm::LteRlcAm ()
   NS_LOG_FUNCTION (this);
 
   // Buffers
-  m_txonBufferSize = 0;
   m_retxBuffer.resize (1024);
   m_retxBufferSize = 0;
   m_txedBuffer.resize (1024);
@@ -123,11 +126,39 @@ LteRlcAm::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&LteRlcAm::m_txOpportunityForRetxAlwaysBigEnough),
                    MakeBooleanChecker ())
+    .AddAttribute ("SduTags",
+                   "If true, the SDUs carry an RlcTag with their arrival time "
+                   "and their segments an LteRlcSduStatusTag, for the code "
+                   "relying on them. The RLC itself keeps this information "
+                   "in its transmission buffer.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteRlcAm::SetSduTags,
+                                        &LteRlcAm::GetSduTags),
+                   MakeBooleanChecker ())
 
     ;
   return tid;
 }
 
+void
+LteRlcAm::SetSduTags (bool enable)
+{
+  NS_LOG_FUNCTION (this << enable);
+  m_txonBuffer.SetSduTags (enable);
+}
+
+bool
+LteRlcAm::GetSduTags (void) const
+{
+  return m_txonBuffer.GetSduTags ();
+}
+
+uint32_t
+LteRlcAm::GetTxBufferSize (void) const
+{
+  return m_txonBuffer.GetNBytes ();
+}
+
 void
 LteRlcAm::DoDispose ()
 {
@@ -137,13 +168,12 @@ LteRlcAm::DoDispose ()
   m_statusProhibitTimer.Cancel ();
   m_rbsTimer.Cancel ();
 
-  m_txonBuffer.clear ();
-  m_txonBufferSize = 0;
+  m_txonBuffer.Clear ();
   m_txedBuffer.clear ();
   m_txedBufferSize = 0;
   m_retxBuffer.clear ();
   m_retxBufferSize = 0;
-  m_rxonBuffer.clear ();
+  m_rxonBuffer.Clear ();
   m_sdusBuffer.clear ();
   m_keepS0 = 0;
   m_controlPduBuffer = 0;
@@ -161,27 +191,15 @@ LteRlcAm::DoTransmitPdcpPdu (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this << m_rnti << (uint32_t) m_lcid << p->GetSize ());
 
-  /** Store arrival time */
-  Time now = Simulator::Now ();
-  RlcTag timeTag (now);
-  p->AddPacketTag (timeTag);
-
-  /** Store PDCP PDU */
-
-  LteRlcSduStatusTag tag;
-  tag.SetStatus (LteRlcSduStatusTag::FULL_SDU);
-  p->AddPacketTag (tag);
-
+  /** Store PDCP PDU, with its arrival time */
   NS_LOG_LOGIC ("Txon Buffer: New packet added");
-  m_txonBuffer.push_back (p);
-  m_txonBufferSize += p->GetSize ();
-  NS_LOG_LOGIC ("NumOfBuffers = " << m_txonBuffer.size() );
-  NS_LOG_LOGIC ("txonBufferSize = " << m_txonBufferSize);
+  m_txonBuffer.Push (p, Simulator::Now ());
+  NS_LOG_LOGIC ("NumOfBuffers = " << m_txonBuffer.GetNSdus () );
+  NS_LOG_LOGIC ("txonBufferSize = " << m_txonBuffer.GetNBytes ());
 
   /** Report Buffer Status */
   DoReportBufferStatus ();
-  m_rbsTimer.Cancel ();
-  m_rbsTimer = Simulator::Schedule (m_rbsTimerValue, &LteRlcAm::ExpireRbsTimer, this);
+  RestartRbsTimer (m_rbsTimerValue);
 }
 
 
@@ -193,6 +211,7 @@ void
 LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
 {
   NS_LOG_FUNCTION (this << m_rnti << (uint32_t) m_lcid << bytes);
+  LTE_PROFILE_SCOPE (RLC_AM_TX_OPPORTUNITY);
 
   if (bytes < 4)
     {
@@ -224,7 +243,6 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
       NS_LOG_LOGIC ("Check for SNs to NACK from " << m_vrR.GetValue() << " to " << m_vrMs.GetValue());
       SequenceNumber10 sn;
       sn.SetModulusBase (m_vrR);
-      std::map<uint16_t, PduBuffer>::iterator pduIt;
       for (sn = m_vrR; sn < m_vrMs; sn++) 
         {
           NS_LOG_LOGIC ("SN = " << sn);          
@@ -233,8 +251,7 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
               NS_LOG_LOGIC ("Can't fit more NACKs in STATUS PDU");
               break;
             }          
-          pduIt = m_rxonBuffer.find (sn.GetValue ());
-          if (pduIt == m_rxonBuffer.end () || (!(pduIt->second.m_pduComplete)))
+          if (! m_rxonBuffer.IsPresent (sn.GetValue ()))
             {
               NS_LOG_LOGIC ("adding NACK_SN " << sn.GetValue ());
               rlcAmHeader.PushNack (sn.GetValue ());              
@@ -244,13 +261,11 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
       // 3GPP TS 36.322 section 6.2.2.1.4 ACK SN
       // find the  SN of the next not received RLC Data PDU 
       // which is not reported as missing in the STATUS PDU. 
-      pduIt = m_rxonBuffer.find (sn.GetValue ());
-      while ((sn < m_vrMs) && (pduIt != m_rxonBuffer.end ()) && (pduIt->second.m_pduComplete))            
+      while ((sn < m_vrMs) && m_rxonBuffer.IsPresent (sn.GetValue ()))
         {
           NS_LOG_LOGIC ("SN = " << sn << " < " << m_vrMs << " = " << (sn < m_vrMs));
           sn++;
           NS_LOG_LOGIC ("SN = " << sn);
-          pduIt = m_rxonBuffer.find (sn.GetValue ());
         }
       
       NS_ASSERT_MSG (sn <= m_vrMs, "first SN not reported as missing = " << sn << ", VR(MS) = " << m_vrMs);      
@@ -272,8 +287,8 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
 
       m_statusPduRequested = false;
       m_statusPduBufferSize = 0;
-      m_statusProhibitTimer = Simulator::Schedule (m_statusProhibitTimerValue,
-                                                   &LteRlcAm::ExpireStatusProhibitTimer, this);
+      m_statusProhibitTimer = LteEventProfiler::Schedule ("LteRlcAm::ExpireStatusProhibitTimer", m_statusProhibitTimerValue,
+                                                          &LteRlcAm::ExpireStatusProhibitTimer, this);
       return;
     }
   else if ( m_retxBufferSize > 0 )
@@ -292,6 +307,8 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
           if (m_retxBuffer.at (seqNumberValue).m_pdu != 0)
             {            
 
+              // the stored PDU is shared by the buffers and never modified:
+              // the header is rebuilt on a copy
               Ptr<Packet> packet = m_retxBuffer.at (seqNumberValue).m_pdu->Copy ();
               
               if (( packet->GetSize () <= bytes )
@@ -306,10 +323,10 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
                   // Calculate the Polling Bit (5.2.2.1)
                   rlcAmHeader.SetPollingBit (LteRlcAmHeader::STATUS_REPORT_NOT_REQUESTED);
 
-                  NS_LOG_LOGIC ("polling conditions: m_txonBuffer.empty=" << m_txonBuffer.empty () 
+                  NS_LOG_LOGIC ("polling conditions: m_txonBuffer.empty=" << m_txonBuffer.IsEmpty () 
                                 << " retxBufferSize="  << m_retxBufferSize
                                 << " packet->GetSize ()=" << packet->GetSize ());
-                  if (((m_txonBuffer.empty ()) && (m_retxBufferSize == packet->GetSize () + rlcAmHeader.GetSerializedSize ())) 
+                  if (((m_txonBuffer.IsEmpty ()) && (m_retxBufferSize == packet->GetSize () + rlcAmHeader.GetSerializedSize ())) 
                       || (m_vtS >= m_vtMs)
                       || m_pollRetransmitTimerJustExpired)
                     {
@@ -325,16 +342,16 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
                         {
                           NS_LOG_LOGIC ("Start PollRetransmit timer");
 
-                          m_pollRetransmitTimer = Simulator::Schedule (m_pollRetransmitTimerValue,
-                                                                       &LteRlcAm::ExpirePollRetransmitTimer, this);
+                          m_pollRetransmitTimer = LteEventProfiler::Schedule ("LteRlcAm::ExpirePollRetransmitTimer", m_pollRetransmitTimerValue,
+                                                                              &LteRlcAm::ExpirePollRetransmitTimer, this);
                         }
                       else
                         {
                           NS_LOG_LOGIC ("Restart PollRetransmit timer");
 
                           m_pollRetransmitTimer.Cancel ();
-                          m_pollRetransmitTimer = Simulator::Schedule (m_pollRetransmitTimerValue,
-                                                                       &LteRlcAm::ExpirePollRetransmitTimer, this);
+                          m_pollRetransmitTimer = LteEventProfiler::Schedule ("LteRlcAm::ExpirePollRetransmitTimer", m_pollRetransmitTimerValue,
+                                                                              &LteRlcAm::ExpirePollRetransmitTimer, this);
                         }
                     }
 
@@ -359,7 +376,7 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
                     }
 
                   NS_LOG_INFO ("Move SN = " << seqNumberValue << " back to txedBuffer");
-                  m_txedBuffer.at (seqNumberValue).m_pdu = m_retxBuffer.at (seqNumberValue).m_pdu->Copy ();
+                  m_txedBuffer.at (seqNumberValue).m_pdu = m_retxBuffer.at (seqNumberValue).m_pdu;
                   m_txedBuffer.at (seqNumberValue).m_retxCount = m_retxBuffer.at (seqNumberValue).m_retxCount;
                   m_txedBufferSize += m_txedBuffer.at (seqNumberValue).m_pdu->GetSize ();
 
@@ -381,7 +398,7 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
         }
       NS_ASSERT_MSG (found, "m_retxBufferSize > 0, but no PDU considered for retx found");
     }
-  else if ( m_txonBufferSize > 0 )
+  else if ( !m_txonBuffer.IsEmpty () )
     {
       if (bytes < 7)
       {
@@ -423,103 +440,55 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
   uint32_t dataFieldTotalSize = 0;
   uint32_t dataFieldAddedSize = 0;
   std::vector < Ptr<Packet> > dataField;
+  // position in their SDUs of the first and of the last segment of the data field
+  LteRlcSduStatusTag::SduStatus_t firstSegmentStatus = LteRlcSduStatusTag::FULL_SDU;
+  LteRlcSduStatusTag::SduStatus_t lastSegmentStatus = LteRlcSduStatusTag::FULL_SDU;
 
-  // Remove the first packet from the transmission buffer.
-  // If only a segment of the packet is taken, then the remaining is given back later
-  if ( m_txonBuffer.size () == 0 )
+  // Take the SDUs, or segments of them, from the head of the transmission buffer.
+  if ( m_txonBuffer.IsEmpty () )
     {
       NS_LOG_LOGIC ("No data pending");
       return;
     }
 
-  NS_LOG_LOGIC ("SDUs in TxonBuffer  = " << m_txonBuffer.size ());
-  NS_LOG_LOGIC ("First SDU buffer  = " << *(m_txonBuffer.begin()));
-  NS_LOG_LOGIC ("First SDU size    = " << (*(m_txonBuffer.begin()))->GetSize ());
+  NS_LOG_LOGIC ("SDUs in TxonBuffer  = " << m_txonBuffer.GetNSdus ());
+  NS_LOG_LOGIC ("First SDU buffer  = " << m_txonBuffer.Peek ());
+  NS_LOG_LOGIC ("First SDU size    = " << m_txonBuffer.GetFrontSize ());
   NS_LOG_LOGIC ("Next segment size = " << nextSegmentSize);
-  NS_LOG_LOGIC ("Remove SDU from TxBuffer");
-  Ptr<Packet> firstSegment = (*(m_txonBuffer.begin ()))->Copy ();
-  m_txonBufferSize -= (*(m_txonBuffer.begin()))->GetSize ();
-  NS_LOG_LOGIC ("txBufferSize      = " << m_txonBufferSize );
-  m_txonBuffer.erase (m_txonBuffer.begin ());
 
-  while ( firstSegment && (firstSegment->GetSize () > 0) && (nextSegmentSize > 0) )
+  while ( !m_txonBuffer.IsEmpty () && (nextSegmentSize > 0) )
     {
-      NS_LOG_LOGIC ("WHILE ( firstSegment && firstSegment->GetSize > 0 && nextSegmentSize > 0 )");
-      NS_LOG_LOGIC ("    firstSegment size = " << firstSegment->GetSize ());
+      uint32_t firstSegmentSize = m_txonBuffer.GetFrontSize ();
+      NS_LOG_LOGIC ("WHILE ( !txonBuffer.empty && nextSegmentSize > 0 )");
+      NS_LOG_LOGIC ("    firstSegment size = " << firstSegmentSize);
       NS_LOG_LOGIC ("    nextSegmentSize   = " << nextSegmentSize);
-      if ( (firstSegment->GetSize () > nextSegmentSize) ||
+      if ( (firstSegmentSize > nextSegmentSize) ||
            // Segment larger than 2047 octets can only be mapped to the end of the Data field
-           (firstSegment->GetSize () > 2047)
+           (firstSegmentSize > 2047)
          )
         {
           // Take the minimum size, due to the 2047-bytes 3GPP exception
           // This exception is due to the length of the LI field (just 11 bits)
-          uint32_t currSegmentSize = std::min (firstSegment->GetSize (), nextSegmentSize);
+          uint32_t currSegmentSize = std::min (firstSegmentSize, nextSegmentSize);
 
           NS_LOG_LOGIC ("    IF ( firstSegment > nextSegmentSize ||");
           NS_LOG_LOGIC ("         firstSegment > 2047 )");
 
-          // Segment txBuffer.FirstBuffer and
-          // Give back the remaining segment to the transmission buffer
-          Ptr<Packet> newSegment = firstSegment->CreateFragment (0, currSegmentSize);
-          NS_LOG_LOGIC ("    newSegment size   = " << newSegment->GetSize ());
-
-          // Status tag of the new and remaining segments
-          // Note: This is the only place where a PDU is segmented and
-          // therefore its status can change
-          LteRlcSduStatusTag oldTag, newTag;
-          firstSegment->RemovePacketTag (oldTag);
-          newSegment->RemovePacketTag (newTag);
-          if (oldTag.GetStatus () == LteRlcSduStatusTag::FULL_SDU)
-            {
-              newTag.SetStatus (LteRlcSduStatusTag::FIRST_SEGMENT);
-              oldTag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
-            }
-          else if (oldTag.GetStatus () == LteRlcSduStatusTag::LAST_SEGMENT)
-            {
-              newTag.SetStatus (LteRlcSduStatusTag::MIDDLE_SEGMENT);
-              //oldTag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
-            }
-
-          // Give back the remaining segment to the transmission buffer
-          firstSegment->RemoveAtStart (currSegmentSize);
-          NS_LOG_LOGIC ("    firstSegment size (after RemoveAtStart) = " << firstSegment->GetSize ());
-          if (firstSegment->GetSize () > 0)
-            {
-              firstSegment->AddPacketTag (oldTag);
-
-              m_txonBuffer.insert (m_txonBuffer.begin (), firstSegment);
-              m_txonBufferSize += (*(m_txonBuffer.begin()))->GetSize ();
-
-              NS_LOG_LOGIC ("    Txon buffer: Give back the remaining segment");
-              NS_LOG_LOGIC ("    Txon buffers = " << m_txonBuffer.size ());
-              NS_LOG_LOGIC ("    Front buffer size = " << (*(m_txonBuffer.begin()))->GetSize ());
-              NS_LOG_LOGIC ("    txonBufferSize = " << m_txonBufferSize );
-            }
-          else
+          // Segment the first SDU; the remaining bytes stay at the head
+          // of the transmission buffer
+          Ptr<Packet> newSegment = m_txonBuffer.Pop (currSegmentSize, lastSegmentStatus);
+          if (dataField.empty ())
             {
-              // Whole segment was taken, so adjust tag
-              if (newTag.GetStatus () == LteRlcSduStatusTag::FIRST_SEGMENT)
-                {
-                  newTag.SetStatus (LteRlcSduStatusTag::FULL_SDU);
-                }
-              else if (newTag.GetStatus () == LteRlcSduStatusTag::MIDDLE_SEGMENT)
-                {
-                  newTag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
-                }
+              firstSegmentStatus = lastSegmentStatus;
             }
-          // Segment is completely taken or
-          // the remaining segment is given back to the transmission buffer
-          firstSegment = 0;
-
-          // Put status tag once it has been adjusted
-          newSegment->AddPacketTag (newTag);
+          NS_LOG_LOGIC ("    newSegment size   = " << newSegment->GetSize ());
+          NS_LOG_LOGIC ("    Txon buffers = " << m_txonBuffer.GetNSdus ());
+          NS_LOG_LOGIC ("    txonBufferSize = " << m_txonBuffer.GetNBytes ());
 
           // Add Segment to Data field
           dataFieldAddedSize = newSegment->GetSize ();
           dataFieldTotalSize += dataFieldAddedSize;
           dataField.push_back (newSegment);
-          newSegment = 0;
 
           // ExtensionBit (Next_Segment - 1) = 0
           rlcAmHeader.PushExtensionBit (LteRlcAmHeader::DATA_FIELD_FOLLOWS);
@@ -532,17 +501,20 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
           // nextSegmentSize MUST be zero (only if segment is smaller or equal to 2047)
 
           // (NO more segments) ? exit
-          // break;
+          break;
         }
-      else if ( (nextSegmentSize - firstSegment->GetSize () <= 2) || (m_txonBuffer.size () == 0) )
+      else if ( (nextSegmentSize - firstSegmentSize <= 2) || (m_txonBuffer.GetNSdus () == 1) )
         {
-          NS_LOG_LOGIC ("    IF nextSegmentSize - firstSegment->GetSize () <= 2 || txonBuffer.size == 0");
-
+          NS_LOG_LOGIC ("    IF nextSegmentSize - firstSegment->GetSize () <= 2 || txonBuffer.size == 1");
           // Add txBuffer.FirstBuffer to DataField
-          dataFieldAddedSize = firstSegment->GetSize ();
+          Ptr<Packet> firstSegment = m_txonBuffer.Pop (firstSegmentSize, lastSegmentStatus);
+          if (dataField.empty ())
+            {
+              firstSegmentStatus = lastSegmentStatus;
+            }
+          dataFieldAddedSize = firstSegmentSize;
           dataFieldTotalSize += dataFieldAddedSize;
           dataField.push_back (firstSegment);
-          firstSegment = 0;
 
           // ExtensionBit (Next_Segment - 1) = 0
           rlcAmHeader.PushExtensionBit (LteRlcAmHeader::DATA_FIELD_FOLLOWS);
@@ -552,24 +524,24 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
           nextSegmentSize -= dataFieldAddedSize;
           nextSegmentId++;
 
-          NS_LOG_LOGIC ("        SDUs in TxBuffer  = " << m_txonBuffer.size ());
-          if (m_txonBuffer.size () > 0)
-            {
-              NS_LOG_LOGIC ("        First SDU buffer  = " << *(m_txonBuffer.begin()));
-              NS_LOG_LOGIC ("        First SDU size    = " << (*(m_txonBuffer.begin()))->GetSize ());
-            }
+          NS_LOG_LOGIC ("        SDUs in TxBuffer  = " << m_txonBuffer.GetNSdus ());
           NS_LOG_LOGIC ("        Next segment size = " << nextSegmentSize);
 
           // nextSegmentSize <= 2 (only if txBuffer is not empty)
 
           // (NO more segments) ? exit
-          // break;
+          break;
         }
-      else // (firstSegment->GetSize () < m_nextSegmentSize) && (m_txBuffer.size () > 0)
+      else // (firstSegment->GetSize () < m_nextSegmentSize) && (m_txonBuffer.size () > 1)
         {
-          NS_LOG_LOGIC ("    IF firstSegment < NextSegmentSize && txonBuffer.size > 0");
+          NS_LOG_LOGIC ("    IF firstSegment < NextSegmentSize && txonBuffer.size > 1");
           // Add txBuffer.FirstBuffer to DataField
-          dataFieldAddedSize = firstSegment->GetSize ();
+          Ptr<Packet> firstSegment = m_txonBuffer.Pop (firstSegmentSize, lastSegmentStatus);
+          if (dataField.empty ())
+            {
+              firstSegmentStatus = lastSegmentStatus;
+            }
+          dataFieldAddedSize = firstSegmentSize;
           dataFieldTotalSize += dataFieldAddedSize;
           dataField.push_back (firstSegment);
 
@@ -577,25 +549,16 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
           rlcAmHeader.PushExtensionBit (LteRlcAmHeader::E_LI_FIELDS_FOLLOWS);
 
           // LengthIndicator (Next_Segment)  = txBuffer.FirstBuffer.length()
-          rlcAmHeader.PushLengthIndicator (firstSegment->GetSize ());
+          rlcAmHeader.PushLengthIndicator (firstSegmentSize);
 
           nextSegmentSize -= ((nextSegmentId % 2) ? (2) : (1)) + dataFieldAddedSize;
           nextSegmentId++;
 
-          NS_LOG_LOGIC ("        SDUs in TxBuffer  = " << m_txonBuffer.size ());
-          if (m_txonBuffer.size () > 0)
-            {
-              NS_LOG_LOGIC ("        First SDU buffer  = " << *(m_txonBuffer.begin()));
-              NS_LOG_LOGIC ("        First SDU size    = " << (*(m_txonBuffer.begin()))->GetSize ());
-            }
+          NS_LOG_LOGIC ("        SDUs in TxBuffer  = " << m_txonBuffer.GetNSdus ());
           NS_LOG_LOGIC ("        Next segment size = " << nextSegmentSize);
-          NS_LOG_LOGIC ("        Remove SDU from TxBuffer");
+          NS_LOG_LOGIC ("        txonBufferSize = " << m_txonBuffer.GetNBytes ());
 
           // (more segments)
-          firstSegment = (*(m_txonBuffer.begin ()))->Copy ();
-          m_txonBufferSize -= (*(m_txonBuffer.begin()))->GetSize ();
-          m_txonBuffer.erase (m_txonBuffer.begin ());
-          NS_LOG_LOGIC ("        txBufferSize = " << m_txonBufferSize );
         }
 
     }
@@ -618,10 +581,8 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
   it = dataField.begin ();
 
   // FIRST SEGMENT
-  LteRlcSduStatusTag tag;
-  (*it)->RemovePacketTag (tag);
-  if ( (tag.GetStatus () == LteRlcSduStatusTag::FULL_SDU) ||
-       (tag.GetStatus () == LteRlcSduStatusTag::FIRST_SEGMENT)
+  if ( (firstSegmentStatus == LteRlcSduStatusTag::FULL_SDU) ||
+       (firstSegmentStatus == LteRlcSduStatusTag::FIRST_SEGMENT)
      )
     {
       framingInfo |= LteRlcAmHeader::FIRST_BYTE;
@@ -630,7 +591,6 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
     {
       framingInfo |= LteRlcAmHeader::NO_FIRST_BYTE;
     }
-  (*it)->AddPacketTag (tag);
 
   // Add all SDUs (in DataField) to the Packet
   while (it < dataField.end ())
@@ -642,10 +602,8 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
     }
 
   // LAST SEGMENT (Note: There could be only one and be the first one)
-  it--;
-  (*it)->RemovePacketTag (tag);
-  if ( (tag.GetStatus () == LteRlcSduStatusTag::FULL_SDU) ||
-        (tag.GetStatus () == LteRlcSduStatusTag::LAST_SEGMENT) )
+  if ( (lastSegmentStatus == LteRlcSduStatusTag::FULL_SDU) ||
+        (lastSegmentStatus == LteRlcSduStatusTag::LAST_SEGMENT) )
     {
       framingInfo |= LteRlcAmHeader::LAST_BYTE;
     }
@@ -653,7 +611,6 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
     {
       framingInfo |= LteRlcAmHeader::NO_LAST_BYTE;
     }
-  (*it)->AddPacketTag (tag);
 
   // Set the FramingInfo flag after the calculation
   rlcAmHeader.SetFramingInfo (framingInfo);
@@ -668,7 +625,7 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
   NS_LOG_LOGIC ("BYTE_WITHOUT_POLL = " << m_byteWithoutPoll);
 
   if ( (m_pduWithoutPoll >= m_pollPdu) || (m_byteWithoutPoll >= m_pollByte) ||
-       ( (m_txonBuffer.empty ()) && (m_retxBufferSize == 0) ) ||
+       ( (m_txonBuffer.IsEmpty ()) && (m_retxBufferSize == 0) ) ||
        (m_vtS >= m_vtMs)
        || m_pollRetransmitTimerJustExpired
      )
@@ -685,16 +642,16 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
         {
           NS_LOG_LOGIC ("Start PollRetransmit timer");
 
-          m_pollRetransmitTimer = Simulator::Schedule (m_pollRetransmitTimerValue,
-                                                       &LteRlcAm::ExpirePollRetransmitTimer, this);
+          m_pollRetransmitTimer = LteEventProfiler::Schedule ("LteRlcAm::ExpirePollRetransmitTimer", m_pollRetransmitTimerValue,
+                                                              &LteRlcAm::ExpirePollRetransmitTimer, this);
         }
       else
         {
           NS_LOG_LOGIC ("Restart PollRetransmit timer");
 
           m_pollRetransmitTimer.Cancel ();
-          m_pollRetransmitTimer = Simulator::Schedule (m_pollRetransmitTimerValue,
-                                                       &LteRlcAm::ExpirePollRetransmitTimer, this);
+          m_pollRetransmitTimer = LteEventProfiler::Schedule ("LteRlcAm::ExpirePollRetransmitTimer", m_pollRetransmitTimerValue,
+                                                              &LteRlcAm::ExpirePollRetransmitTimer, this);
         }
     }
 
@@ -872,18 +829,14 @@ LteRlcAm::DoReceivePdu (Ptr<Packet> p)
           //         - discard the duplicate byte segments.
           // note: re-segmentation of AMD PDU is currently not supported, 
           // so we just check that the segment was not received before
-          std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (seqNumber.GetValue ());
-          if (it != m_rxonBuffer.end () )
+          if (m_rxonBuffer.IsPresent (seqNumber.GetValue ()))
             {
-              NS_ASSERT (it->second.m_byteSegments.size () > 0);
-              NS_ASSERT_MSG (it->second.m_byteSegments.size () == 1, "re-segmentation not supported");
               NS_LOG_LOGIC ("PDU segment already received, discarded");
             }
           else
             {
               NS_LOG_LOGIC ("Place PDU in the reception buffer ( SN = " << seqNumber << " )");
-              m_rxonBuffer[ seqNumber.GetValue () ].m_byteSegments.push_back (p);
-              m_rxonBuffer[ seqNumber.GetValue () ].m_pduComplete = true;
+              m_rxonBuffer.Insert (seqNumber.GetValue (), p);
             }
 
 
@@ -906,20 +859,9 @@ LteRlcAm::DoReceivePdu (Ptr<Packet> p)
       //     - update VR(MS) to the SN of the first AMD PDU with SN > current VR(MS) for
       //       which not all byte segments have been received;
 
-      std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (m_vrMs.GetValue ());
-      if ( it != m_rxonBuffer.end () &&
-           it->second.m_pduComplete )
+      if ( m_rxonBuffer.IsPresent (m_vrMs.GetValue ()) )
         {
-          int firstVrMs = m_vrMs.GetValue ();
-          while ( it != m_rxonBuffer.end () &&
-                  it->second.m_pduComplete )
-            {
-              m_vrMs++;
-              it = m_rxonBuffer.find (m_vrMs.GetValue ());
-              NS_LOG_LOGIC ("Incr VR(MS) = " << m_vrMs);
-
-              NS_ASSERT_MSG (firstVrMs != m_vrMs.GetValue (), "Infinite loop in RxonBuffer");
-            }
+          m_vrMs = m_rxonBuffer.FindNextMissing (m_vrMs.GetValue ());
           NS_LOG_LOGIC ("New VR(MS) = " << m_vrMs);
         }
 
@@ -931,29 +873,18 @@ LteRlcAm::DoReceivePdu (Ptr<Packet> p)
 
       if ( seqNumber == m_vrR )
         {
-          std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (seqNumber.GetValue ());
-          if ( it != m_rxonBuffer.end () &&
-               it->second.m_pduComplete )
+          if ( m_rxonBuffer.IsPresent (seqNumber.GetValue ()) )
             {
-              it = m_rxonBuffer.find (m_vrR.GetValue ());
-              int firstVrR = m_vrR.GetValue ();
-              while ( it != m_rxonBuffer.end () &&
-                      it->second.m_pduComplete )
+              while ( m_rxonBuffer.IsPresent (m_vrR.GetValue ()) )
                 {
                   NS_LOG_LOGIC ("Reassemble and Deliver ( SN = " << m_vrR << " )");
-                  NS_ASSERT_MSG (it->second.m_byteSegments.size () == 1,
-                                "Too many segments. PDU Reassembly process didn't work");
-                  ReassembleAndDeliver (it->second.m_byteSegments.front ());
-                  m_rxonBuffer.erase (m_vrR.GetValue ());
+                  ReassembleAndDeliver (m_rxonBuffer.Remove (m_vrR.GetValue ()));
 
                   m_vrR++;
                   m_vrR.SetModulusBase (m_vrR);
                   m_vrX.SetModulusBase (m_vrR);
                   m_vrMs.SetModulusBase (m_vrR);
                   m_vrH.SetModulusBase (m_vrR);
-                  it = m_rxonBuffer.find (m_vrR.GetValue ());
-
-                  NS_ASSERT_MSG (firstVrR != m_vrR.GetValue (), "Infinite loop in RxonBuffer");
                 }
               NS_LOG_LOGIC ("New VR(R)  = " << m_vrR);
               m_vrMr = m_vrR + m_windowSize;
@@ -992,8 +923,8 @@ LteRlcAm::DoReceivePdu (Ptr<Packet> p)
           if ( m_vrH > m_vrR )
             {
               NS_LOG_LOGIC ("Start reordering timer");
-              m_reorderingTimer = Simulator::Schedule (m_reorderingTimerValue,
-                                                       &LteRlcAm::ExpireReorderingTimer ,this);
+              m_reorderingTimer = LteEventProfiler::Schedule ("LteRlcAm::ExpireReorderingTimer", m_reorderingTimerValue,
+                                                              &LteRlcAm::ExpireReorderingTimer ,this);
               m_vrX = m_vrH;
               NS_LOG_LOGIC ("New VR(X) = " << m_vrX);
             }
@@ -1020,6 +951,14 @@ LteRlcAm::DoReceivePdu (Ptr<Packet> p)
 
       bool incrementVtA = true; 
 
+      // NACK_SNs of the STATUS PDU, indexed by SN
+      std::bitset<1024> nackSns;
+      int nack;
+      while ((nack = rlcAmHeader.PopNack ()) != -1)
+        {
+          nackSns.set (nack);
+        }
+
       for (sn = m_vtA; sn < ackSn && sn < m_vtS; sn++)
         {
           NS_LOG_LOGIC ("sn = " << sn);
@@ -1032,7 +971,7 @@ LteRlcAm::DoReceivePdu (Ptr<Packet> p)
               m_pollRetransmitTimer.Cancel ();
             }
 
-          if (rlcAmHeader.IsNackPresent (sn))
+          if (nackSns.test (seqNumberValue))
             {
               NS_LOG_LOGIC ("sn " << sn << " is NACKed");
 
@@ -1041,7 +980,7 @@ LteRlcAm::DoReceivePdu (Ptr<Packet> p)
               if (m_txedBuffer.at (seqNumberValue).m_pdu != 0)
                 {
                   NS_LOG_INFO ("Move SN = " << seqNumberValue << " to retxBuffer");
-                  m_retxBuffer.at (seqNumberValue).m_pdu = m_txedBuffer.at (seqNumberValue).m_pdu->Copy ();
+                  m_retxBuffer.at (seqNumberValue).m_pdu = m_txedBuffer.at (seqNumberValue).m_pdu;
                   m_retxBuffer.at (seqNumberValue).m_retxCount = m_txedBuffer.at (seqNumberValue).m_retxCount;
                   m_retxBufferSize += m_retxBuffer.at (seqNumberValue).m_pdu->GetSize ();
 
@@ -1554,7 +1493,7 @@ LteRlcAm::DoReportBufferStatus (void)
 
   Time now = Simulator::Now ();
 
-  NS_LOG_LOGIC ("txonBufferSize = " << m_txonBufferSize);
+  NS_LOG_LOGIC ("txonBufferSize = " << m_txonBuffer.GetNBytes ());
   NS_LOG_LOGIC ("retxBufferSize = " << m_retxBufferSize);
   NS_LOG_LOGIC ("txedBufferSize = " << m_txedBufferSize);
   NS_LOG_LOGIC ("VT(A) = " << m_vtA);
@@ -1562,11 +1501,9 @@ LteRlcAm::DoReportBufferStatus (void)
 
   // Transmission Queue HOL time
   Time txonQueueHolDelay (0);
-  if ( m_txonBufferSize > 0 )
+  if ( !m_txonBuffer.IsEmpty () )
     {
-      RlcTag txonQueueHolTimeTag;
-      m_txonBuffer.front ()->PeekPacketTag (txonQueueHolTimeTag);
-      txonQueueHolDelay = now - txonQueueHolTimeTag.GetSenderTimestamp ();
+      txonQueueHolDelay = now - m_txonBuffer.GetFrontArrivalTime ();
     }
 
   // Retransmission Queue HOL time
@@ -1592,7 +1529,7 @@ LteRlcAm::DoReportBufferStatus (void)
   LteMacSapProvider::ReportBufferStatusParameters r;
   r.rnti = m_rnti;
   r.lcid = m_lcid;
-  r.txQueueSize = m_txonBufferSize;
+  r.txQueueSize = m_txonBuffer.GetNBytes ();
   r.txQueueHolDelay = txonQueueHolDelay.GetMilliSeconds ();
   r.retxQueueSize = m_retxBufferSize + m_txedBufferSize;
   r.retxQueueHolDelay = retxQueueHolDelay.GetMilliSeconds ();
@@ -1637,23 +1574,14 @@ LteRlcAm::ExpireReorderingTimer (void)
   //    - set VR(X) to VR(H).
 
   m_vrMs = m_vrX;
-  int firstVrMs = m_vrMs.GetValue ();
-  std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (m_vrMs.GetValue ());
-  while ( it != m_rxonBuffer.end () &&
-          it->second.m_pduComplete )
-    {
-      m_vrMs++;
-      it = m_rxonBuffer.find (m_vrMs.GetValue ());
-
-      NS_ASSERT_MSG (firstVrMs != m_vrMs.GetValue (), "Infinite loop in ExpireReorderingTimer");
-    }
+  m_vrMs = m_rxonBuffer.FindNextMissing (m_vrMs.GetValue ());
   NS_LOG_LOGIC ("New VR(MS) = " << m_vrMs);
 
   if ( m_vrH > m_vrMs )
     {
       NS_LOG_LOGIC ("Start reordering timer");
-      m_reorderingTimer = Simulator::Schedule (m_reorderingTimerValue,
-                                              &LteRlcAm::ExpireReorderingTimer ,this);
+      m_reorderingTimer = LteEventProfiler::Schedule ("LteRlcAm::ExpireReorderingTimer", m_reorderingTimerValue,
+                                                      &LteRlcAm::ExpireReorderingTimer ,this);
       m_vrX = m_vrH;
       NS_LOG_LOGIC ("New VR(MS) = " << m_vrMs);
     }
@@ -1670,7 +1598,7 @@ LteRlcAm::ExpirePollRetransmitTimer (void)
   NS_LOG_FUNCTION (this);
   NS_LOG_LOGIC ("PollRetransmit Timer has expired");
 
-  NS_LOG_LOGIC ("txonBufferSize = " << m_txonBufferSize);
+  NS_LOG_LOGIC ("txonBufferSize = " << m_txonBuffer.GetNBytes ());
   NS_LOG_LOGIC ("retxBufferSize = " << m_retxBufferSize);
   NS_LOG_LOGIC ("txedBufferSize = " << m_txedBufferSize);
   NS_LOG_LOGIC ("statusPduRequested = " << m_statusPduRequested);
@@ -1680,7 +1608,7 @@ LteRlcAm::ExpirePollRetransmitTimer (void)
   // see section 5.2.2.3
   // note the difference between Rel 8 and Rel 11 specs; we follow Rel 11 here
   NS_ASSERT (m_vtS <= m_vtMs);
-  if ((m_txonBufferSize == 0 && m_retxBufferSize == 0)
+  if ((m_txonBuffer.IsEmpty () && m_retxBufferSize == 0)
       || (m_vtS == m_vtMs))
     {
       NS_LOG_INFO ("txonBuffer and retxBuffer empty. Move PDUs up to = " << m_vtS.GetValue () - 1 << " to retxBuffer");
@@ -1692,7 +1620,7 @@ LteRlcAm::ExpirePollRetransmitTimer (void)
            if ( pduAvailable )
              {
                NS_LOG_INFO ("Move PDU " << sn << " from txedBuffer to retxBuffer");
-               m_retxBuffer.at (sn).m_pdu = m_txedBuffer.at (sn).m_pdu->Copy ();
+               m_retxBuffer.at (sn).m_pdu = m_txedBuffer.at (sn).m_pdu;
                m_retxBuffer.at (sn).m_retxCount = m_txedBuffer.at (sn).m_retxCount;
                m_retxBufferSize += m_retxBuffer.at (sn).m_pdu->GetSize ();
 
@@ -1713,15 +1641,39 @@ LteRlcAm::ExpireStatusProhibitTimer (void)
   NS_LOG_FUNCTION (this);
 }
 
+void
+LteRlcAm::RestartRbsTimer (Time delay)
+{
+  // only the deadline is moved: the event already pending, which cannot
+  // expire after it, re-arms itself up to the new deadline
+  m_rbsDeadline = Simulator::Now () + delay;
+  if (! m_rbsTimer.IsRunning ())
+    {
+      m_rbsTimer = LteEventProfiler::Schedule ("LteRlcAm::ExpireRbsTimer", delay, &LteRlcAm::ExpireRbsTimer, this);
+    }
+}
+
 void
 LteRlcAm::ExpireRbsTimer (void)
 {
+  if (m_rbsDeadline.IsZero ())
+    {
+      // stopped
+      return;
+    }
+  if (Simulator::Now () < m_rbsDeadline)
+    {
+      m_rbsTimer = LteEventProfiler::Schedule ("LteRlcAm::ExpireRbsTimer", m_rbsDeadline - Simulator::Now (), &LteRlcAm::ExpireRbsTimer, this);
+      return;
+    }
+
   NS_LOG_LOGIC ("RBS Timer expires");
+  m_rbsDeadline = Seconds (0);
 
-  if (m_txonBufferSize + m_txedBufferSize + m_retxBufferSize > 0)
+  if (m_txonBuffer.GetNBytes () + m_txedBufferSize + m_retxBufferSize > 0)
     {
       DoReportBufferStatus ();
-      m_rbsTimer = Simulator::Schedule (m_rbsTimerValue, &LteRlcAm::ExpireRbsTimer, this);
+      RestartRbsTimer (m_rbsTimerValue);
     }
 }
 
@@ -28,6 +28,8 @@
 #include <ns3/event-id.h>
 #include <ns3/lte-rlc-sequence-number.h>
 #include <ns3/lte-rlc.h>
+#include <ns3/lte-rlc-sdu-queue.h>
+#include <ns3/lte-rlc-rx-window.h>
 
 #include <vector>
 #include <map>
@@ -58,6 +60,20 @@ public:
   virtual void DoReceivePdu (Ptr<Packet> p);
   // virtual void DoSendMessage3Rach (uint32_t bytes, uint8_t layer, uint8_t harqId);
 
+  /**
+   * \param enable whether the SDUs carry an RlcTag and their segments an
+   *               LteRlcSduStatusTag (see LteRlcSduQueue)
+   */
+  void SetSduTags (bool enable);
+
+  /**
+   * \return whether the SDUs and their segments carry the tags
+   */
+  bool GetSduTags (void) const;
+
+  // inherited from LteRlc
+  virtual uint32_t GetTxBufferSize (void) const;
+
 private:
   /**
    * This method will schedule a timeout at WaitReplyTimeout interval
@@ -67,6 +83,11 @@ private:
   void ExpireReorderingTimer (void);
   void ExpirePollRetransmitTimer (void);
   void ExpireRbsTimer (void);
+  /**
+   * (Re)start the timer of the periodic buffer status report
+   * \param delay the time to expiry
+   */
+  void RestartRbsTimer (Time delay);
 
   /** 
    * method called when the T_status_prohibit timer expires
@@ -84,11 +105,11 @@ private:
   void DoReportBufferStatus ();
 
 private:
-    std::vector < Ptr<Packet> > m_txonBuffer;       // Transmission buffer
+    LteRlcSduQueue m_txonBuffer;       // Transmission buffer
 
     struct RetxPdu
     {
-      Ptr<Packet> m_pdu;
+      Ptr<const Packet> m_pdu; ///< the PDU, shared by the buffers and never modified
       uint16_t    m_retxCount;
     };
 
@@ -97,22 +118,13 @@ private:
                                        ///< for retransmission 
   std::vector <RetxPdu> m_retxBuffer;  ///< Buffer for PDUs considered for retransmission
 
-    uint32_t m_txonBufferSize;
     uint32_t m_retxBufferSize;
     uint32_t m_txedBufferSize;
 
     bool     m_statusPduRequested;
     uint32_t m_statusPduBufferSize;
 
-    struct PduBuffer
-    {
-      SequenceNumber10  m_seqNumber;
-      std::list < Ptr<Packet> >  m_byteSegments;
-
-      bool      m_pduComplete;
-    };
-
-    std::map <uint16_t, PduBuffer > m_rxonBuffer; // Reception buffer
+    LteRlcRxWindow m_rxonBuffer; // Reception buffer
 
     Ptr<Packet> m_controlPduBuffer;               // Control PDU buffer (just one PDU)
 
@@ -159,6 +171,7 @@ private:
   Time    m_statusProhibitTimerValue;
   EventId m_rbsTimer;
   Time    m_rbsTimerValue;
+  Time    m_rbsDeadline; ///< expiry of m_rbsTimer, zero when stopped
 
   /**
    * Configurable parameters. See section 7.4 in TS 36.322
@@ -0,0 +1,166 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-rlc-rx-window.h"
+#include <ns3/log.h>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteRlcRxWindow");
+
+const uint16_t LteRlcRxWindow::SN_MODULUS;
+
+/**
+ * \param word a non-zero word
+ * \return the index of the least significant bit set in word
+ */
+static uint32_t
+LowestBitSet (uint32_t word)
+{
+  // de Bruijn sequence lookup of the isolated lowest bit
+  static const uint32_t index[32] =
+  {
+    0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+    31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+  };
+  return index[((word & (~word + 1)) * 0x077CB531U) >> 27];
+}
+
+LteRlcRxWindow::LteRlcRxWindow ()
+  : m_singleSn (0),
+    m_nPdus (0)
+{
+  for (uint32_t i = 0; i < SN_MODULUS / 32; ++i)
+    {
+      m_present[i] = 0;
+    }
+}
+
+void
+LteRlcRxWindow::Insert (uint16_t sn, Ptr<Packet> pdu)
+{
+  NS_LOG_FUNCTION (this << sn << pdu);
+  NS_ASSERT (sn < SN_MODULUS);
+  if (!IsPresent (sn))
+    {
+      m_present[sn / 32] |= (1U << (sn % 32));
+      m_nPdus++;
+    }
+  if (m_pdus.empty ())
+    {
+      if (m_nPdus == 1)
+        {
+          // in sequence, or the same SN again
+          m_single = pdu;
+          m_singleSn = sn;
+          return;
+        }
+      // first PDU held out of order
+      NS_LOG_LOGIC (this << " out of order PDU " << sn << ", allocating the buffer");
+      m_pdus.resize (SN_MODULUS);
+      m_pdus[m_singleSn] = m_single;
+      m_single = 0;
+    }
+  m_pdus[sn] = pdu;
+}
+
+Ptr<Packet>
+LteRlcRxWindow::Remove (uint16_t sn)
+{
+  NS_LOG_FUNCTION (this << sn);
+  NS_ASSERT_MSG (IsPresent (sn), "no PDU with SN " << sn);
+  m_present[sn / 32] &= ~(1U << (sn % 32));
+  m_nPdus--;
+  Ptr<Packet> pdu;
+  if (m_pdus.empty ())
+    {
+      NS_ASSERT (sn == m_singleSn);
+      pdu = m_single;
+      m_single = 0;
+      return pdu;
+    }
+  pdu = m_pdus[sn];
+  m_pdus[sn] = 0;
+  return pdu;
+}
+
+bool
+LteRlcRxWindow::IsPresent (uint16_t sn) const
+{
+  NS_ASSERT (sn < SN_MODULUS);
+  return (m_present[sn / 32] >> (sn % 32)) & 1;
+}
+
+uint16_t
+LteRlcRxWindow::FindNextMissing (uint16_t sn) const
+{
+  NS_ASSERT_MSG (m_nPdus < SN_MODULUS, "the reception buffer is full");
+  uint32_t pos = sn;
+  while (true)
+    {
+      uint32_t missing = ~m_present[pos / 32] >> (pos % 32);
+      if (missing != 0)
+        {
+          return (pos + LowestBitSet (missing)) % SN_MODULUS;
+        }
+      pos = (pos - pos % 32 + 32) % SN_MODULUS;
+    }
+}
+
+uint16_t
+LteRlcRxWindow::FindNextPresent (uint16_t sn, uint16_t end) const
+{
+  uint32_t pos = sn;
+  uint32_t remaining = (end - sn + SN_MODULUS) % SN_MODULUS;
+  while (remaining > 0 && m_nPdus > 0)
+    {
+      uint32_t span = std::min (32 - pos % 32, remaining);
+      uint32_t present = m_present[pos / 32] >> (pos % 32);
+      if (span < 32)
+        {
+          present &= (1U << span) - 1;
+        }
+      if (present != 0)
+        {
+          return (pos + LowestBitSet (present)) % SN_MODULUS;
+        }
+      pos = (pos + span) % SN_MODULUS;
+      remaining -= span;
+    }
+  return end;
+}
+
+bool
+LteRlcRxWindow::IsEmpty (void) const
+{
+  return m_nPdus == 0;
+}
+
+void
+LteRlcRxWindow::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_single = 0;
+  std::fill (m_pdus.begin (), m_pdus.end (), Ptr<Packet> ());
+  for (uint32_t i = 0; i < SN_MODULUS / 32; ++i)
+    {
+      m_present[i] = 0;
+    }
+  m_nPdus = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,104 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_RLC_RX_WINDOW_H
+#define LTE_RLC_RX_WINDOW_H
+
+#include <ns3/packet.h>
+#include <ns3/ptr.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * Reception buffer of the UM and AM RLC entities, holding the received
+ * PDUs which have not been reassembled yet.
+ *
+ * While the PDUs are received in sequence the buffer holds at most one
+ * of them, kept aside. The first out-of-order PDU allocates a circular
+ * array indexed by the 10-bit SN, which covers twice the UM and AM
+ * window sizes, so that only the entities which ever lose a PDU pay for
+ * it. The array is then kept for the lifetime of the entity, rather
+ * than freed and allocated again on every loss. An
+ * occupancy bitmap allows to find the next missing or the next received
+ * SN by scanning 32 SNs at a time.
+ */
+class LteRlcRxWindow
+{
+public:
+  LteRlcRxWindow ();
+
+  /**
+   * Store a PDU, replacing the one with the same SN, if any
+   * \param sn the SN of the PDU
+   * \param pdu the PDU
+   */
+  void Insert (uint16_t sn, Ptr<Packet> pdu);
+
+  /**
+   * Remove a PDU from the buffer
+   * \param sn the SN of the PDU, which must be present
+   * \return the PDU
+   */
+  Ptr<Packet> Remove (uint16_t sn);
+
+  /**
+   * \param sn a SN
+   * \return true if the PDU with this SN is in the buffer
+   */
+  bool IsPresent (uint16_t sn) const;
+
+  /**
+   * \param sn a SN
+   * \return the first SN, starting from sn and in ascending SN order,
+   *         whose PDU is not in the buffer
+   */
+  uint16_t FindNextMissing (uint16_t sn) const;
+
+  /**
+   * \param sn the first SN of the interval
+   * \param end the SN following the interval
+   * \return the first SN in [sn, end), in ascending SN order, whose PDU
+   *         is in the buffer, or end if there is none
+   */
+  uint16_t FindNextPresent (uint16_t sn, uint16_t end) const;
+
+  /**
+   * \return true if the buffer holds no PDU
+   */
+  bool IsEmpty (void) const;
+
+  /**
+   * Remove all the PDUs
+   */
+  void Clear (void);
+
+  /// number of SNs, i.e., of entries of the buffer
+  static const uint16_t SN_MODULUS = 1024;
+
+private:
+  Ptr<Packet> m_single; ///< the only PDU of the buffer, while m_pdus is not allocated
+  uint16_t m_singleSn; ///< the SN of m_single
+  std::vector<Ptr<Packet> > m_pdus; ///< the PDUs, indexed by SN, empty until a PDU is out of order
+  uint32_t m_present[SN_MODULUS / 32]; ///< occupancy bitmap
+  uint32_t m_nPdus; ///< number of PDUs in the buffer
+};
+
+} // namespace ns3
+
+#endif /* LTE_RLC_RX_WINDOW_H */
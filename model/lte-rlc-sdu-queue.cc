@@ -0,0 +1,181 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-rlc-sdu-queue.h"
+#include "lte-rlc-tag.h"
+#include <ns3/log.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteRlcSduQueue");
+
+LteRlcSduQueue::LteRlcSduQueue ()
+  : m_sdus (16),
+    m_head (0),
+    m_nSdus (0),
+    m_nBytes (0),
+    m_offset (0),
+    m_sduTags (false)
+{
+}
+
+void
+LteRlcSduQueue::SetSduTags (bool enable)
+{
+  m_sduTags = enable;
+}
+
+bool
+LteRlcSduQueue::GetSduTags (void) const
+{
+  return m_sduTags;
+}
+
+void
+LteRlcSduQueue::Push (Ptr<Packet> sdu, Time arrivalTime)
+{
+  NS_LOG_FUNCTION (this << sdu << arrivalTime);
+  if (m_nSdus == m_sdus.size ())
+    {
+      // move the SDUs to a buffer twice as large, the head at index 0
+      std::vector<Sdu> sdus (2 * m_sdus.size ());
+      for (uint32_t i = 0; i < m_nSdus; ++i)
+        {
+          sdus[i] = m_sdus[(m_head + i) % m_sdus.size ()];
+        }
+      m_sdus.swap (sdus);
+      m_head = 0;
+    }
+  if (m_sduTags)
+    {
+      RlcTag timeTag (arrivalTime);
+      sdu->AddPacketTag (timeTag);
+      LteRlcSduStatusTag tag;
+      tag.SetStatus (LteRlcSduStatusTag::FULL_SDU);
+      sdu->AddPacketTag (tag);
+    }
+  Sdu& entry = m_sdus[(m_head + m_nSdus) % m_sdus.size ()];
+  entry.m_packet = sdu;
+  entry.m_arrivalTime = arrivalTime;
+  m_nSdus++;
+  m_nBytes += sdu->GetSize ();
+}
+
+Ptr<Packet>
+LteRlcSduQueue::Pop (uint32_t bytes, LteRlcSduStatusTag::SduStatus_t& status)
+{
+  NS_LOG_FUNCTION (this << bytes);
+  NS_ASSERT_MSG (m_nSdus > 0, "no SDU to transmit");
+  Sdu& entry = m_sdus[m_head];
+  uint32_t sduSize = entry.m_packet->GetSize ();
+  NS_ASSERT_MSG (bytes > 0 && m_offset + bytes <= sduSize, "invalid segment size " << bytes);
+
+  Ptr<Packet> segment;
+  if (m_offset == 0 && bytes == sduSize)
+    {
+      segment = entry.m_packet;
+      status = LteRlcSduStatusTag::FULL_SDU;
+    }
+  else
+    {
+      segment = entry.m_packet->CreateFragment (m_offset, bytes);
+      if (m_offset == 0)
+        {
+          status = LteRlcSduStatusTag::FIRST_SEGMENT;
+        }
+      else if (m_offset + bytes == sduSize)
+        {
+          status = LteRlcSduStatusTag::LAST_SEGMENT;
+        }
+      else
+        {
+          status = LteRlcSduStatusTag::MIDDLE_SEGMENT;
+        }
+      if (m_sduTags)
+        {
+          LteRlcSduStatusTag tag;
+          segment->RemovePacketTag (tag);
+          tag.SetStatus (status);
+          segment->AddPacketTag (tag);
+        }
+    }
+
+  m_nBytes -= bytes;
+  m_offset += bytes;
+  if (m_offset == sduSize)
+    {
+      entry.m_packet = 0;
+      m_head = (m_head + 1) % m_sdus.size ();
+      m_nSdus--;
+      m_offset = 0;
+    }
+  return segment;
+}
+
+Ptr<Packet>
+LteRlcSduQueue::Peek (void) const
+{
+  NS_ASSERT_MSG (m_nSdus > 0, "empty queue");
+  return m_sdus[m_head].m_packet;
+}
+
+uint32_t
+LteRlcSduQueue::GetFrontSize (void) const
+{
+  NS_ASSERT_MSG (m_nSdus > 0, "empty queue");
+  return m_sdus[m_head].m_packet->GetSize () - m_offset;
+}
+
+Time
+LteRlcSduQueue::GetFrontArrivalTime (void) const
+{
+  NS_ASSERT_MSG (m_nSdus > 0, "empty queue");
+  return m_sdus[m_head].m_arrivalTime;
+}
+
+bool
+LteRlcSduQueue::IsEmpty (void) const
+{
+  return m_nSdus == 0;
+}
+
+uint32_t
+LteRlcSduQueue::GetNSdus (void) const
+{
+  return m_nSdus;
+}
+
+uint32_t
+LteRlcSduQueue::GetNBytes (void) const
+{
+  return m_nBytes;
+}
+
+void
+LteRlcSduQueue::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_sdus.size (); ++i)
+    {
+      m_sdus[i].m_packet = 0;
+    }
+  m_head = 0;
+  m_nSdus = 0;
+  m_nBytes = 0;
+  m_offset = 0;
+}
+
+} // namespace ns3
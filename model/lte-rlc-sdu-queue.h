@@ -0,0 +1,135 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_RLC_SDU_QUEUE_H
+#define LTE_RLC_SDU_QUEUE_H
+
+#include <ns3/packet.h>
+#include <ns3/ptr.h>
+#include <ns3/nstime.h>
+#include <ns3/lte-rlc-sdu-status-tag.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * FIFO of the RLC SDUs waiting for their first transmission, used by
+ * LteRlcUm and LteRlcAm.
+ *
+ * The SDUs are kept in a ring buffer, so that both ends are accessed in
+ * constant time. The SDU at the head can be consumed in several
+ * segments: the queue keeps the offset of the next byte to be
+ * transmitted, and each segment is a fragment of the SDU. The SDU leaves
+ * the queue with its last segment, and a SDU taken at once leaves it
+ * without being copied. The number of bytes still to be transmitted is
+ * kept up to date.
+ *
+ * The arrival time of each SDU and the status of each segment are kept
+ * by the queue and returned explicitly, rather than carried by packet
+ * tags. If SetSduTags is enabled, the SDUs also carry an RlcTag with
+ * their arrival time and the segments an LteRlcSduStatusTag, as the
+ * SDUs of the RLC used to.
+ */
+class LteRlcSduQueue
+{
+public:
+  LteRlcSduQueue ();
+
+  /**
+   * \param enable whether the SDUs and their segments carry the RlcTag and
+   *               the LteRlcSduStatusTag
+   */
+  void SetSduTags (bool enable);
+
+  /**
+   * \return whether the SDUs and their segments carry the tags
+   */
+  bool GetSduTags (void) const;
+
+  /**
+   * Add a SDU at the tail of the queue
+   * \param sdu the SDU
+   * \param arrivalTime the time of arrival of the SDU in the RLC
+   */
+  void Push (Ptr<Packet> sdu, Time arrivalTime);
+
+  /**
+   * Take the next segment of the SDU at the head of the queue
+   * \param bytes the size of the segment, at most GetFrontSize ()
+   * \param status set to the position of the segment in the SDU
+   * \return the segment, which is the SDU itself if it is taken whole
+   */
+  Ptr<Packet> Pop (uint32_t bytes, LteRlcSduStatusTag::SduStatus_t& status);
+
+  /**
+   * \return the SDU at the head of the queue, including its bytes
+   *         already transmitted
+   */
+  Ptr<Packet> Peek (void) const;
+
+  /**
+   * \return the number of bytes of the SDU at the head of the queue
+   *         which are still to be transmitted
+   */
+  uint32_t GetFrontSize (void) const;
+
+  /**
+   * \return the time of arrival of the SDU at the head of the queue
+   */
+  Time GetFrontArrivalTime (void) const;
+
+  /**
+   * \return true if the queue is empty
+   */
+  bool IsEmpty (void) const;
+
+  /**
+   * \return the number of SDUs, including the one at the head if it is
+   *         partially transmitted
+   */
+  uint32_t GetNSdus (void) const;
+
+  /**
+   * \return the number of bytes still to be transmitted
+   */
+  uint32_t GetNBytes (void) const;
+
+  /**
+   * Remove all the SDUs
+   */
+  void Clear (void);
+
+private:
+  /// SDU and its metadata
+  struct Sdu
+  {
+    Ptr<Packet> m_packet;
+    Time m_arrivalTime;
+  };
+
+  std::vector<Sdu> m_sdus; ///< ring buffer of the SDUs
+  uint32_t m_head; ///< index of the SDU at the head
+  uint32_t m_nSdus; ///< number of SDUs
+  uint32_t m_nBytes; ///< number of bytes still to be transmitted
+  uint32_t m_offset; ///< number of bytes of the head SDU already transmitted
+  bool m_sduTags; ///< whether the SDUs and their segments carry the tags
+};
+
+} // namespace ns3
+
+#endif /* LTE_RLC_SDU_QUEUE_H */
@@ -28,6 +28,7 @@
 
 #include "ns3/lte-rlc-tm.h"
 #include "ns3/lte-rlc-tag.h"
+#include "ns3/lte-profiler.h"
 
 #include <ns3/random-variable-stream.h>
 
@@ -78,6 +79,12 @@ LteRlcTm::DoDispose ()
   LteRlc::DoDispose ();
 }
 
+uint32_t
+LteRlcTm::GetTxBufferSize (void) const
+{
+  return m_txBufferSize;
+}
+
 
 /**
  * RLC SAP
@@ -111,7 +118,7 @@ LteRlcTm::DoTransmitPdcpPdu (Ptr<Packet> p)
 
   /** Report Buffer Status */
   DoReportBufferStatus ();
-  m_rbsTimer.Cancel ();
+  m_rbsDeadline = Seconds (0);
 }
 
 
@@ -156,7 +163,7 @@ LteRlcTm::DoSendMessage3Rach (uint32_t bytes, uint8_t layer, uint8_t harqId)
   if (! m_txBuffer.empty ())
     {
       m_rbsTimer.Cancel ();
-      m_rbsTimer = Simulator::Schedule (MilliSeconds (10), &LteRlcTm::ExpireRbsTimer, this);
+      m_rbsTimer = LteEventProfiler::Schedule ("LteRlcTm::ExpireRbsTimer", MilliSeconds (10), &LteRlcTm::ExpireRbsTimer, this);
     }
   // NS_ASSERT_MSG(false, "It is not possible to send RACH message 3 through TM rlc");
 
@@ -212,8 +219,7 @@ LteRlcTm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
 
   if (! m_txBuffer.empty ())
     {
-      m_rbsTimer.Cancel ();
-      m_rbsTimer = Simulator::Schedule (MilliSeconds (10), &LteRlcTm::ExpireRbsTimer, this);
+      RestartRbsTimer (MilliSeconds (10));
     }
 }
 
@@ -274,15 +280,39 @@ LteRlcTm::DoReportBufferStatus (void)
   m_macSapProvider->ReportBufferStatus (r);
 }
 
+void
+LteRlcTm::RestartRbsTimer (Time delay)
+{
+  // only the deadline is moved: the event already pending, which cannot
+  // expire after it, re-arms itself up to the new deadline
+  m_rbsDeadline = Simulator::Now () + delay;
+  if (! m_rbsTimer.IsRunning ())
+    {
+      m_rbsTimer = LteEventProfiler::Schedule ("LteRlcTm::ExpireRbsTimer", delay, &LteRlcTm::ExpireRbsTimer, this);
+    }
+}
+
 void
 LteRlcTm::ExpireRbsTimer (void)
 {
+  if (m_rbsDeadline.IsZero ())
+    {
+      // stopped
+      return;
+    }
+  if (Simulator::Now () < m_rbsDeadline)
+    {
+      m_rbsTimer = LteEventProfiler::Schedule ("LteRlcTm::ExpireRbsTimer", m_rbsDeadline - Simulator::Now (), &LteRlcTm::ExpireRbsTimer, this);
+      return;
+    }
+
   NS_LOG_LOGIC ("RBS Timer expires");
+  m_rbsDeadline = Seconds (0);
 
   if (! m_txBuffer.empty ())
     {
       DoReportBufferStatus ();
-      m_rbsTimer = Simulator::Schedule (MilliSeconds (10), &LteRlcTm::ExpireRbsTimer, this);
+      RestartRbsTimer (MilliSeconds (10));
     }
 }
 
@@ -58,9 +58,16 @@ public:
   virtual void DoReceivePdu (Ptr<Packet> p);
   // virtual void DoSendMessage3Rach (uint32_t bytes, uint8_t layer, uint8_t harqId);
 
+  // inherited from LteRlc
+  virtual uint32_t GetTxBufferSize (void) const;
 
 private:
   void ExpireRbsTimer (void);
+  /**
+   * (Re)start the timer of the periodic buffer status report
+   * \param delay the time to expiry
+   */
+  void RestartRbsTimer (Time delay);
   void DoReportBufferStatus ();
 
 private:
@@ -71,6 +78,7 @@ private:
   uint32_t m_tmsi;
 
   EventId m_rbsTimer;
+  Time m_rbsDeadline; ///< expiry of m_rbsTimer, zero when stopped
 
 };
 
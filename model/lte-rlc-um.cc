@@ -24,11 +24,13 @@
 
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/boolean.h"
 
 #include "ns3/lte-rlc-header.h"
 #include "ns3/lte-rlc-um.h"
 #include "ns3/lte-rlc-sdu-status-tag.h"
 #include "ns3/lte-rlc-tag.h"
+#include "ns3/lte-profiler.h"
 
 namespace ns3 {
 
@@ -38,7 +40,6 @@ NS_OBJECT_ENSURE_REGISTERED (LteRlcUm);
 
 LteRlcUm::LteRlcUm ()
   : m_maxTxBufferSize (10 * 1024),
-    m_txBufferSize (0),
     m_sequenceNumber (0),
     m_vrUr (0),
     m_vrUx (0),
@@ -67,10 +68,38 @@ LteRlcUm::GetTypeId (void)
                    UintegerValue (10 * 1024),
                    MakeUintegerAccessor (&LteRlcUm::m_maxTxBufferSize),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("SduTags",
+                   "If true, the SDUs carry an RlcTag with their arrival time "
+                   "and their segments an LteRlcSduStatusTag, for the code "
+                   "relying on them. The RLC itself keeps this information "
+                   "in its transmission buffer.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteRlcUm::SetSduTags,
+                                        &LteRlcUm::GetSduTags),
+                   MakeBooleanChecker ())
     ;
   return tid;
 }
 
+void
+LteRlcUm::SetSduTags (bool enable)
+{
+  NS_LOG_FUNCTION (this << enable);
+  m_txBuffer.SetSduTags (enable);
+}
+
+bool
+LteRlcUm::GetSduTags (void) const
+{
+  return m_txBuffer.GetSduTags ();
+}
+
+uint32_t
+LteRlcUm::GetTxBufferSize (void) const
+{
+  return m_txBuffer.GetNBytes ();
+}
+
 void
 LteRlcUm::DoDispose ()
 {
@@ -90,36 +119,26 @@ LteRlcUm::DoTransmitPdcpPdu (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this << m_rnti << (uint32_t) m_lcid << p->GetSize ());
 
-  if (m_txBufferSize + p->GetSize () <= m_maxTxBufferSize)
+  if (m_txBuffer.GetNBytes () + p->GetSize () <= m_maxTxBufferSize)
     {
-      /** Store arrival time */
-      RlcTag timeTag (Simulator::Now ());
-      p->AddPacketTag (timeTag);
-
-      /** Store PDCP PDU */
-
-      LteRlcSduStatusTag tag;
-      tag.SetStatus (LteRlcSduStatusTag::FULL_SDU);
-      p->AddPacketTag (tag);
-
+      /** Store PDCP PDU, with its arrival time */
       NS_LOG_LOGIC ("Tx Buffer: New packet added");
-      m_txBuffer.push_back (p);
-      m_txBufferSize += p->GetSize ();
-      NS_LOG_LOGIC ("NumOfBuffers = " << m_txBuffer.size() );
-      NS_LOG_LOGIC ("txBufferSize = " << m_txBufferSize);
+      m_txBuffer.Push (p, Simulator::Now ());
+      NS_LOG_LOGIC ("NumOfBuffers = " << m_txBuffer.GetNSdus () );
+      NS_LOG_LOGIC ("txBufferSize = " << m_txBuffer.GetNBytes ());
     }
   else
     {
       // Discard full RLC SDU
       NS_LOG_LOGIC ("TxBuffer is full. RLC SDU discarded");
       NS_LOG_LOGIC ("MaxTxBufferSize = " << m_maxTxBufferSize);
-      NS_LOG_LOGIC ("txBufferSize    = " << m_txBufferSize);
+      NS_LOG_LOGIC ("txBufferSize    = " << m_txBuffer.GetNBytes ());
       NS_LOG_LOGIC ("packet size     = " << p->GetSize ());
     }
 
   /** Report Buffer Status */
   DoReportBufferStatus ();
-  m_rbsTimer.Cancel ();
+  m_rbsDeadline = Seconds (0);
 }
 
 
@@ -155,103 +174,55 @@ LteRlcUm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
   uint32_t dataFieldTotalSize = 0;
   uint32_t dataFieldAddedSize = 0;
   std::vector < Ptr<Packet> > dataField;
+  // position in their SDUs of the first and of the last segment of the data field
+  LteRlcSduStatusTag::SduStatus_t firstSegmentStatus = LteRlcSduStatusTag::FULL_SDU;
+  LteRlcSduStatusTag::SduStatus_t lastSegmentStatus = LteRlcSduStatusTag::FULL_SDU;
 
-  // Remove the first packet from the transmission buffer.
-  // If only a segment of the packet is taken, then the remaining is given back later
-  if ( m_txBuffer.size () == 0 )
+  // Take the SDUs, or segments of them, from the head of the transmission buffer.
+  if ( m_txBuffer.IsEmpty () )
     {
       NS_LOG_LOGIC ("No data pending");
       return;
     }
 
-  NS_LOG_LOGIC ("SDUs in TxBuffer  = " << m_txBuffer.size ());
-  NS_LOG_LOGIC ("First SDU buffer  = " << *(m_txBuffer.begin()));
-  NS_LOG_LOGIC ("First SDU size    = " << (*(m_txBuffer.begin()))->GetSize ());
+  NS_LOG_LOGIC ("SDUs in TxBuffer  = " << m_txBuffer.GetNSdus ());
+  NS_LOG_LOGIC ("First SDU buffer  = " << m_txBuffer.Peek ());
+  NS_LOG_LOGIC ("First SDU size    = " << m_txBuffer.GetFrontSize ());
   NS_LOG_LOGIC ("Next segment size = " << nextSegmentSize);
-  NS_LOG_LOGIC ("Remove SDU from TxBuffer");
-  Ptr<Packet> firstSegment = (*(m_txBuffer.begin ()))->Copy ();
-  m_txBufferSize -= (*(m_txBuffer.begin()))->GetSize ();
-  NS_LOG_LOGIC ("txBufferSize      = " << m_txBufferSize );
-  m_txBuffer.erase (m_txBuffer.begin ());
 
-  while ( firstSegment && (firstSegment->GetSize () > 0) && (nextSegmentSize > 0) )
+  while ( !m_txBuffer.IsEmpty () && (nextSegmentSize > 0) )
     {
-      NS_LOG_LOGIC ("WHILE ( firstSegment && firstSegment->GetSize > 0 && nextSegmentSize > 0 )");
-      NS_LOG_LOGIC ("    firstSegment size = " << firstSegment->GetSize ());
+      uint32_t firstSegmentSize = m_txBuffer.GetFrontSize ();
+      NS_LOG_LOGIC ("WHILE ( !txBuffer.empty && nextSegmentSize > 0 )");
+      NS_LOG_LOGIC ("    firstSegment size = " << firstSegmentSize);
       NS_LOG_LOGIC ("    nextSegmentSize   = " << nextSegmentSize);
-      if ( (firstSegment->GetSize () > nextSegmentSize) ||
+      if ( (firstSegmentSize > nextSegmentSize) ||
            // Segment larger than 2047 octets can only be mapped to the end of the Data field
-           (firstSegment->GetSize () > 2047)
+           (firstSegmentSize > 2047)
          )
         {
           // Take the minimum size, due to the 2047-bytes 3GPP exception
           // This exception is due to the length of the LI field (just 11 bits)
-          uint32_t currSegmentSize = std::min (firstSegment->GetSize (), nextSegmentSize);
+          uint32_t currSegmentSize = std::min (firstSegmentSize, nextSegmentSize);
 
           NS_LOG_LOGIC ("    IF ( firstSegment > nextSegmentSize ||");
           NS_LOG_LOGIC ("         firstSegment > 2047 )");
 
-          // Segment txBuffer.FirstBuffer and
-          // Give back the remaining segment to the transmission buffer
-          Ptr<Packet> newSegment = firstSegment->CreateFragment (0, currSegmentSize);
-          NS_LOG_LOGIC ("    newSegment size   = " << newSegment->GetSize ());
-
-          // Status tag of the new and remaining segments
-          // Note: This is the only place where a PDU is segmented and
-          // therefore its status can change
-          LteRlcSduStatusTag oldTag, newTag;
-          firstSegment->RemovePacketTag (oldTag);
-          newSegment->RemovePacketTag (newTag);
-          if (oldTag.GetStatus () == LteRlcSduStatusTag::FULL_SDU)
+          // Segment the first SDU; the remaining bytes stay at the head
+          // of the transmission buffer
+          Ptr<Packet> newSegment = m_txBuffer.Pop (currSegmentSize, lastSegmentStatus);
+          if (dataField.empty ())
             {
-              newTag.SetStatus (LteRlcSduStatusTag::FIRST_SEGMENT);
-              oldTag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
+              firstSegmentStatus = lastSegmentStatus;
             }
-          else if (oldTag.GetStatus () == LteRlcSduStatusTag::LAST_SEGMENT)
-            {
-              newTag.SetStatus (LteRlcSduStatusTag::MIDDLE_SEGMENT);
-              //oldTag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
-            }
-
-          // Give back the remaining segment to the transmission buffer
-          firstSegment->RemoveAtStart (currSegmentSize);
-          NS_LOG_LOGIC ("    firstSegment size (after RemoveAtStart) = " << firstSegment->GetSize ());
-          if (firstSegment->GetSize () > 0)
-            {
-              firstSegment->AddPacketTag (oldTag);
-
-              m_txBuffer.insert (m_txBuffer.begin (), firstSegment);
-              m_txBufferSize += (*(m_txBuffer.begin()))->GetSize ();
-
-              NS_LOG_LOGIC ("    TX buffer: Give back the remaining segment");
-              NS_LOG_LOGIC ("    TX buffers = " << m_txBuffer.size ());
-              NS_LOG_LOGIC ("    Front buffer size = " << (*(m_txBuffer.begin()))->GetSize ());
-              NS_LOG_LOGIC ("    txBufferSize = " << m_txBufferSize );
-            }
-          else
-            {
-              // Whole segment was taken, so adjust tag
-              if (newTag.GetStatus () == LteRlcSduStatusTag::FIRST_SEGMENT)
-                {
-                  newTag.SetStatus (LteRlcSduStatusTag::FULL_SDU);
-                }
-              else if (newTag.GetStatus () == LteRlcSduStatusTag::MIDDLE_SEGMENT)
-                {
-                  newTag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
-                }
-            }
-          // Segment is completely taken or
-          // the remaining segment is given back to the transmission buffer
-          firstSegment = 0;
-
-          // Put status tag once it has been adjusted
-          newSegment->AddPacketTag (newTag);
+          NS_LOG_LOGIC ("    newSegment size   = " << newSegment->GetSize ());
+          NS_LOG_LOGIC ("    TX buffers = " << m_txBuffer.GetNSdus ());
+          NS_LOG_LOGIC ("    txBufferSize = " << m_txBuffer.GetNBytes ());
 
           // Add Segment to Data field
           dataFieldAddedSize = newSegment->GetSize ();
           dataFieldTotalSize += dataFieldAddedSize;
           dataField.push_back (newSegment);
-          newSegment = 0;
 
           // ExtensionBit (Next_Segment - 1) = 0
           rlcHeader.PushExtensionBit (LteRlcHeader::DATA_FIELD_FOLLOWS);
@@ -264,16 +235,20 @@ LteRlcUm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
           // nextSegmentSize MUST be zero (only if segment is smaller or equal to 2047)
 
           // (NO more segments) → exit
-          // break;
+          break;
         }
-      else if ( (nextSegmentSize - firstSegment->GetSize () <= 2) || (m_txBuffer.size () == 0) )
+      else if ( (nextSegmentSize - firstSegmentSize <= 2) || (m_txBuffer.GetNSdus () == 1) )
         {
-          NS_LOG_LOGIC ("    IF nextSegmentSize - firstSegment->GetSize () <= 2 || txBuffer.size == 0");
+          NS_LOG_LOGIC ("    IF nextSegmentSize - firstSegment->GetSize () <= 2 || txBuffer.size == 1");
           // Add txBuffer.FirstBuffer to DataField
-          dataFieldAddedSize = firstSegment->GetSize ();
+          Ptr<Packet> firstSegment = m_txBuffer.Pop (firstSegmentSize, lastSegmentStatus);
+          if (dataField.empty ())
+            {
+              firstSegmentStatus = lastSegmentStatus;
+            }
+          dataFieldAddedSize = firstSegmentSize;
           dataFieldTotalSize += dataFieldAddedSize;
           dataField.push_back (firstSegment);
-          firstSegment = 0;
 
           // ExtensionBit (Next_Segment - 1) = 0
           rlcHeader.PushExtensionBit (LteRlcHeader::DATA_FIELD_FOLLOWS);
@@ -283,24 +258,24 @@ LteRlcUm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
           nextSegmentSize -= dataFieldAddedSize;
           nextSegmentId++;
 
-          NS_LOG_LOGIC ("        SDUs in TxBuffer  = " << m_txBuffer.size ());
-          if (m_txBuffer.size () > 0)
-            {
-              NS_LOG_LOGIC ("        First SDU buffer  = " << *(m_txBuffer.begin()));
-              NS_LOG_LOGIC ("        First SDU size    = " << (*(m_txBuffer.begin()))->GetSize ());
-            }
+          NS_LOG_LOGIC ("        SDUs in TxBuffer  = " << m_txBuffer.GetNSdus ());
           NS_LOG_LOGIC ("        Next segment size = " << nextSegmentSize);
 
           // nextSegmentSize <= 2 (only if txBuffer is not empty)
 
           // (NO more segments) → exit
-          // break;
+          break;
         }
-      else // (firstSegment->GetSize () < m_nextSegmentSize) && (m_txBuffer.size () > 0)
+      else // (firstSegment->GetSize () < m_nextSegmentSize) && (m_txBuffer.size () > 1)
         {
-          NS_LOG_LOGIC ("    IF firstSegment < NextSegmentSize && txBuffer.size > 0");
+          NS_LOG_LOGIC ("    IF firstSegment < NextSegmentSize && txBuffer.size > 1");
           // Add txBuffer.FirstBuffer to DataField
-          dataFieldAddedSize = firstSegment->GetSize ();
+          Ptr<Packet> firstSegment = m_txBuffer.Pop (firstSegmentSize, lastSegmentStatus);
+          if (dataField.empty ())
+            {
+              firstSegmentStatus = lastSegmentStatus;
+            }
+          dataFieldAddedSize = firstSegmentSize;
           dataFieldTotalSize += dataFieldAddedSize;
           dataField.push_back (firstSegment);
 
@@ -308,25 +283,16 @@ LteRlcUm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
           rlcHeader.PushExtensionBit (LteRlcHeader::E_LI_FIELDS_FOLLOWS);
 
           // LengthIndicator (Next_Segment)  = txBuffer.FirstBuffer.length()
-          rlcHeader.PushLengthIndicator (firstSegment->GetSize ());
+          rlcHeader.PushLengthIndicator (firstSegmentSize);
 
           nextSegmentSize -= ((nextSegmentId % 2) ? (2) : (1)) + dataFieldAddedSize;
           nextSegmentId++;
 
-          NS_LOG_LOGIC ("        SDUs in TxBuffer  = " << m_txBuffer.size ());
-          if (m_txBuffer.size () > 0)
-            {
-              NS_LOG_LOGIC ("        First SDU buffer  = " << *(m_txBuffer.begin()));
-              NS_LOG_LOGIC ("        First SDU size    = " << (*(m_txBuffer.begin()))->GetSize ());
-            }
+          NS_LOG_LOGIC ("        SDUs in TxBuffer  = " << m_txBuffer.GetNSdus ());
           NS_LOG_LOGIC ("        Next segment size = " << nextSegmentSize);
-          NS_LOG_LOGIC ("        Remove SDU from TxBuffer");
+          NS_LOG_LOGIC ("        txBufferSize = " << m_txBuffer.GetNBytes ());
 
           // (more segments)
-          firstSegment = (*(m_txBuffer.begin ()))->Copy ();
-          m_txBufferSize -= (*(m_txBuffer.begin()))->GetSize ();
-          m_txBuffer.erase (m_txBuffer.begin ());
-          NS_LOG_LOGIC ("        txBufferSize = " << m_txBufferSize );
         }
 
     }
@@ -341,10 +307,8 @@ LteRlcUm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
   uint8_t framingInfo = 0;
 
   // FIRST SEGMENT
-  LteRlcSduStatusTag tag;
-  (*it)->RemovePacketTag (tag);
-  if ( (tag.GetStatus () == LteRlcSduStatusTag::FULL_SDU) ||
-        (tag.GetStatus () == LteRlcSduStatusTag::FIRST_SEGMENT) )
+  if ( (firstSegmentStatus == LteRlcSduStatusTag::FULL_SDU) ||
+        (firstSegmentStatus == LteRlcSduStatusTag::FIRST_SEGMENT) )
     {
       framingInfo |= LteRlcHeader::FIRST_BYTE;
     }
@@ -352,7 +316,6 @@ LteRlcUm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
     {
       framingInfo |= LteRlcHeader::NO_FIRST_BYTE;
     }
-  (*it)->AddPacketTag (tag);
 
   while (it < dataField.end ())
     {
@@ -363,10 +326,8 @@ LteRlcUm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
     }
 
   // LAST SEGMENT (Note: There could be only one and be the first one)
-  it--;
-  (*it)->RemovePacketTag (tag);
-  if ( (tag.GetStatus () == LteRlcSduStatusTag::FULL_SDU) ||
-        (tag.GetStatus () == LteRlcSduStatusTag::LAST_SEGMENT) )
+  if ( (lastSegmentStatus == LteRlcSduStatusTag::FULL_SDU) ||
+        (lastSegmentStatus == LteRlcSduStatusTag::LAST_SEGMENT) )
     {
       framingInfo |= LteRlcHeader::LAST_BYTE;
     }
@@ -374,7 +335,6 @@ LteRlcUm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
     {
       framingInfo |= LteRlcHeader::NO_LAST_BYTE;
     }
-  (*it)->AddPacketTag (tag);
 
   rlcHeader.SetFramingInfo (framingInfo);
 
@@ -396,10 +356,9 @@ LteRlcUm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
 
   m_macSapProvider->TransmitPdu (params);
 
-  if (! m_txBuffer.empty ())
+  if (! m_txBuffer.IsEmpty ())
     {
-      m_rbsTimer.Cancel ();
-      m_rbsTimer = Simulator::Schedule (MilliSeconds (10), &LteRlcUm::ExpireRbsTimer, this);
+      RestartRbsTimer (MilliSeconds (10));
     }
 }
 
@@ -459,7 +418,7 @@ LteRlcUm::DoReceivePdu (Ptr<Packet> p)
   m_vrUh.SetModulusBase (m_vrUh - m_windowSize);
   seqNumber.SetModulusBase (m_vrUh - m_windowSize);
 
-  if ( ( (m_vrUr < seqNumber) && (seqNumber < m_vrUh) && (m_rxBuffer.count (seqNumber.GetValue ()) > 0) ) ||
+  if ( ( (m_vrUr < seqNumber) && (seqNumber < m_vrUh) && m_rxBuffer.IsPresent (seqNumber.GetValue ()) ) ||
        ( ((m_vrUh - m_windowSize) <= seqNumber) && (seqNumber < m_vrUr) )
      )
     {
@@ -470,7 +429,7 @@ LteRlcUm::DoReceivePdu (Ptr<Packet> p)
   else
     {
       NS_LOG_LOGIC ("Place PDU in the reception buffer");
-      m_rxBuffer[seqNumber.GetValue ()] = p;
+      m_rxBuffer.Insert (seqNumber.GetValue (), p);
     }
 
 
@@ -508,21 +467,12 @@ LteRlcUm::DoReceivePdu (Ptr<Packet> p)
   //      so and deliver the reassembled RLC SDUs to upper layer in ascending order of the RLC SN if not delivered
   //      before;
 
-  if ( m_rxBuffer.count (m_vrUr.GetValue ()) > 0 )
+  if ( m_rxBuffer.IsPresent (m_vrUr.GetValue ()) )
     {
       NS_LOG_LOGIC ("Reception buffer contains SN = " << m_vrUr);
 
-      std::map <uint16_t, Ptr<Packet> >::iterator it;
-      uint16_t newVrUr;
       SequenceNumber10 oldVrUr = m_vrUr;
-
-      it = m_rxBuffer.find (m_vrUr.GetValue ());
-      newVrUr = (it->first) + 1;
-      while ( m_rxBuffer.count (newVrUr) > 0 )
-        {
-          newVrUr++;
-        }
-      m_vrUr = newVrUr;
+      m_vrUr = m_rxBuffer.FindNextMissing (m_vrUr.GetValue ());
       NS_LOG_LOGIC ("New VR(UR) = " << m_vrUr);
 
       ReassembleSnInterval (oldVrUr, m_vrUr);
@@ -562,8 +512,8 @@ LteRlcUm::DoReceivePdu (Ptr<Packet> p)
         {
           NS_LOG_LOGIC ("VR(UH) > VR(UR)");
           NS_LOG_LOGIC ("Start reordering timer");
-          m_reorderingTimer = Simulator::Schedule (Time ("0.1s"),
-                                                   &LteRlcUm::ExpireReorderingTimer ,this);
+          m_reorderingTimer = LteEventProfiler::Schedule ("LteRlcUm::ExpireReorderingTimer", Time ("0.1s"),
+                                                          &LteRlcUm::ExpireReorderingTimer ,this);
           m_vrUx = m_vrUh;
           NS_LOG_LOGIC ("New VR(UX) = " << m_vrUx);
         }
@@ -1067,24 +1017,22 @@ LteRlcUm::ReassembleOutsideWindow (void)
 {
   NS_LOG_LOGIC ("Reassemble Outside Window");
 
-  std::map <uint16_t, Ptr<Packet> >::iterator it;
-  it = m_rxBuffer.begin ();
-
-  while ( (it != m_rxBuffer.end ()) && ! IsInsideReorderingWindow (SequenceNumber10 (it->first)) )
+  // the PDUs in the reception buffer have SN >= VR(UR): those outside
+  // of the reordering window are in [VR(UR), VR(UH) - UM_Window_Size)
+  if (IsInsideReorderingWindow (m_vrUr))
     {
-      NS_LOG_LOGIC ("SN = " << it->first);
+      return;
+    }
+  uint16_t windowStart = (m_vrUh - m_windowSize).GetValue ();
+  uint16_t sn = m_rxBuffer.FindNextPresent (m_vrUr.GetValue (), windowStart);
+  while (sn != windowStart)
+    {
+      NS_LOG_LOGIC ("SN = " << sn);
 
       // Reassemble RLC SDUs and deliver the PDCP PDU to upper layer
-      ReassembleAndDeliver (it->second);
-
-      std::map <uint16_t, Ptr<Packet> >::iterator it_tmp = it;
-      ++it;
-      m_rxBuffer.erase (it_tmp);
-    }
+      ReassembleAndDeliver (m_rxBuffer.Remove (sn));
 
-  if (it != m_rxBuffer.end ())
-    {
-      NS_LOG_LOGIC ("(SN = " << it->first << ") is inside the reordering window");
+      sn = m_rxBuffer.FindNextPresent ((sn + 1) % LteRlcRxWindow::SN_MODULUS, windowStart);
     }
 }
 
@@ -1093,28 +1041,15 @@ LteRlcUm::ReassembleSnInterval (SequenceNumber10 lowSeqNumber, SequenceNumber10
 {
   NS_LOG_LOGIC ("Reassemble SN between " << lowSeqNumber << " and " << highSeqNumber);
 
-  std::map <uint16_t, Ptr<Packet> >::iterator it;
-
-  SequenceNumber10 reassembleSn = lowSeqNumber;
-  NS_LOG_LOGIC ("reassembleSN = " << reassembleSn);
-  NS_LOG_LOGIC ("highSeqNumber = " << highSeqNumber);
-  while (reassembleSn < highSeqNumber)
+  uint16_t sn = m_rxBuffer.FindNextPresent (lowSeqNumber.GetValue (), highSeqNumber.GetValue ());
+  while (sn != highSeqNumber.GetValue ())
     {
-      NS_LOG_LOGIC ("reassembleSn < highSeqNumber");
-      it = m_rxBuffer.find (reassembleSn.GetValue ());
-      NS_LOG_LOGIC ("it->first  = " << it->first);
-      NS_LOG_LOGIC ("it->second = " << it->second);
-      if (it != m_rxBuffer.end () )
-        {
-          NS_LOG_LOGIC ("SN = " << it->first);
+      NS_LOG_LOGIC ("SN = " << sn);
 
-          // Reassemble RLC SDUs and deliver the PDCP PDU to upper layer
-          ReassembleAndDeliver (it->second);
+      // Reassemble RLC SDUs and deliver the PDCP PDU to upper layer
+      ReassembleAndDeliver (m_rxBuffer.Remove (sn));
 
-          m_rxBuffer.erase (it);
-        }
-        
-      reassembleSn++;
+      sn = m_rxBuffer.FindNextPresent ((sn + 1) % LteRlcRxWindow::SN_MODULUS, highSeqNumber.GetValue ());
     }
 }
 
@@ -1125,13 +1060,11 @@ LteRlcUm::DoReportBufferStatus (void)
   Time holDelay (0);
   uint32_t queueSize = 0;
 
-  if (! m_txBuffer.empty ())
+  if (! m_txBuffer.IsEmpty ())
     {
-      RlcTag holTimeTag;
-      m_txBuffer.front ()->PeekPacketTag (holTimeTag);
-      holDelay = Simulator::Now () - holTimeTag.GetSenderTimestamp ();
+      holDelay = Simulator::Now () - m_txBuffer.GetFrontArrivalTime ();
 
-      queueSize = m_txBufferSize + 2 * m_txBuffer.size (); // Data in tx queue + estimated headers size
+      queueSize = m_txBuffer.GetNBytes () + 2 * m_txBuffer.GetNSdus (); // Data in tx queue + estimated headers size
     }
 
   LteMacSapProvider::ReportBufferStatusParameters r;
@@ -1163,13 +1096,8 @@ LteRlcUm::ExpireReorderingTimer (void)
   //    - start t-Reordering;
   //    - set VR(UX) to VR(UH).
 
-  std::map <uint16_t, Ptr<Packet> >::iterator it;
   SequenceNumber10 newVrUr = m_vrUx;
-
-  while ( (it = m_rxBuffer.find (newVrUr.GetValue ())) != m_rxBuffer.end () )
-    {
-      newVrUr++;
-    }
+  newVrUr = m_rxBuffer.FindNextMissing (newVrUr.GetValue ());
   SequenceNumber10 oldVrUr = m_vrUr;
   m_vrUr = newVrUr;
   NS_LOG_LOGIC ("New VR(UR) = " << m_vrUr);
@@ -1179,23 +1107,47 @@ LteRlcUm::ExpireReorderingTimer (void)
   if ( m_vrUh > m_vrUr)
     {
       NS_LOG_LOGIC ("Start reordering timer");
-      m_reorderingTimer = Simulator::Schedule (Time ("0.1s"),
-                                               &LteRlcUm::ExpireReorderingTimer, this);
+      m_reorderingTimer = LteEventProfiler::Schedule ("LteRlcUm::ExpireReorderingTimer", Time ("0.1s"),
+                                                      &LteRlcUm::ExpireReorderingTimer, this);
       m_vrUx = m_vrUh;
       NS_LOG_LOGIC ("New VR(UX) = " << m_vrUx);
     }
 }
 
 
+void
+LteRlcUm::RestartRbsTimer (Time delay)
+{
+  // only the deadline is moved: the event already pending, which cannot
+  // expire after it, re-arms itself up to the new deadline
+  m_rbsDeadline = Simulator::Now () + delay;
+  if (! m_rbsTimer.IsRunning ())
+    {
+      m_rbsTimer = LteEventProfiler::Schedule ("LteRlcUm::ExpireRbsTimer", delay, &LteRlcUm::ExpireRbsTimer, this);
+    }
+}
+
 void
 LteRlcUm::ExpireRbsTimer (void)
 {
+  if (m_rbsDeadline.IsZero ())
+    {
+      // stopped
+      return;
+    }
+  if (Simulator::Now () < m_rbsDeadline)
+    {
+      m_rbsTimer = LteEventProfiler::Schedule ("LteRlcUm::ExpireRbsTimer", m_rbsDeadline - Simulator::Now (), &LteRlcUm::ExpireRbsTimer, this);
+      return;
+    }
+
   NS_LOG_LOGIC ("RBS Timer expires");
+  m_rbsDeadline = Seconds (0);
 
-  if (! m_txBuffer.empty ())
+  if (! m_txBuffer.IsEmpty ())
     {
       DoReportBufferStatus ();
-      m_rbsTimer = Simulator::Schedule (MilliSeconds (10), &LteRlcUm::ExpireRbsTimer, this);
+      RestartRbsTimer (MilliSeconds (10));
     }
 }
 
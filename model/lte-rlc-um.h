@@ -27,6 +27,8 @@
 
 #include "ns3/lte-rlc-sequence-number.h"
 #include "ns3/lte-rlc.h"
+#include "ns3/lte-rlc-sdu-queue.h"
+#include "ns3/lte-rlc-rx-window.h"
 
 #include <ns3/event-id.h>
 #include <map>
@@ -57,10 +59,29 @@ public:
   virtual void DoReceivePdu (Ptr<Packet> p);
   // virtual void DoSendMessage3Rach (uint32_t bytes, uint8_t layer, uint8_t harqId);
 
+  /**
+   * \param enable whether the SDUs carry an RlcTag and their segments an
+   *               LteRlcSduStatusTag (see LteRlcSduQueue)
+   */
+  void SetSduTags (bool enable);
+
+  /**
+   * \return whether the SDUs and their segments carry the tags
+   */
+  bool GetSduTags (void) const;
+
+  // inherited from LteRlc
+  virtual uint32_t GetTxBufferSize (void) const;
+
 
 private:
   void ExpireReorderingTimer (void);
   void ExpireRbsTimer (void);
+  /**
+   * (Re)start the timer of the periodic buffer status report
+   * \param delay the time to expiry
+   */
+  void RestartRbsTimer (Time delay);
 
   bool IsInsideReorderingWindow (SequenceNumber10 seqNumber);
 
@@ -73,9 +94,8 @@ private:
 
 private:
   uint32_t m_maxTxBufferSize;
-  uint32_t m_txBufferSize;
-  std::vector < Ptr<Packet> > m_txBuffer;       // Transmission buffer
-  std::map <uint16_t, Ptr<Packet> > m_rxBuffer; // Reception buffer
+  LteRlcSduQueue m_txBuffer;       // Transmission buffer
+  LteRlcRxWindow m_rxBuffer; // Reception buffer
   std::vector < Ptr<Packet> > m_reasBuffer;     // Reassembling buffer
 
   std::list < Ptr<Packet> > m_sdusBuffer;       // List of SDUs in a packet
@@ -99,6 +119,7 @@ private:
    */
   EventId m_reorderingTimer;
   EventId m_rbsTimer;
+  Time m_rbsDeadline; ///< expiry of m_rbsTimer, zero when stopped
 
   /**
    * Reassembling state
@@ -103,6 +103,12 @@ public:
    */
   LteMacSapUser* GetLteMacSapUser ();
 
+  /**
+   * \return the number of bytes of the SDUs waiting for their first
+   *         transmission, 0 if the RLC keeps no SDU
+   */
+  virtual uint32_t GetTxBufferSize (void) const;
+
 
   /**
    * TracedCallback signature for NotifyTxOpportunity events.
@@ -30,6 +30,7 @@
 #include "lte-enb-rrc.h"
 #include "lte-enb-net-device.h"
 #include "lte-ue-net-device.h"
+#include "lte-profiler.h"
 
 namespace ns3 {
 
@@ -87,6 +88,14 @@ LteUeRrcProtocolIdeal::SetUeRrc (Ptr<LteUeRrc> rrc)
   m_rrc = rrc;
 }
 
+void
+LteUeRrcProtocolIdeal::NotifyConnectionRestored ()
+{
+  NS_LOG_FUNCTION (this);
+  m_rnti = m_rrc->GetRnti ();
+  SetEnbRrcSapProvider ();
+}
+
 void 
 LteUeRrcProtocolIdeal::DoSetup (LteUeRrcSapUser::SetupParameters params)
 {
@@ -101,21 +110,21 @@ LteUeRrcProtocolIdeal::DoSendRrcConnectionRequest (LteRrcSap::RrcConnectionReque
   // eNB we are currently attached to
   m_rnti = m_rrc->GetRnti ();
   SetEnbRrcSapProvider ();
-  Simulator::Schedule (RRC_IDEAL_MSG_DELAY, 
-                       &LteEnbRrcSapProvider::RecvRrcConnectionRequest,
-                       m_enbRrcSapProvider,
-                       m_rnti, 
-                       msg);
+  LteEventProfiler::Schedule ("LteEnbRrcSapProvider::RecvRrcConnectionRequest", RRC_IDEAL_MSG_DELAY, 
+                              &LteEnbRrcSapProvider::RecvRrcConnectionRequest,
+                              m_enbRrcSapProvider,
+                              m_rnti,
+                              msg);
 }
 
 void 
 LteUeRrcProtocolIdeal::DoSendRrcConnectionSetupCompleted (LteRrcSap::RrcConnectionSetupCompleted msg)
 {
-  Simulator::Schedule (RRC_IDEAL_MSG_DELAY, 
-		       &LteEnbRrcSapProvider::RecvRrcConnectionSetupCompleted,
-                       m_enbRrcSapProvider,
-		       m_rnti, 
-		       msg);
+  LteEventProfiler::Schedule ("LteEnbRrcSapProvider::RecvRrcConnectionSetupCompleted", RRC_IDEAL_MSG_DELAY, 
+                              &LteEnbRrcSapProvider::RecvRrcConnectionSetupCompleted,
+                              m_enbRrcSapProvider,
+                              m_rnti,
+                              msg);
 }
 
 void 
@@ -126,41 +135,41 @@ LteUeRrcProtocolIdeal::DoSendRrcConnectionReconfigurationCompleted (LteRrcSap::R
   m_rnti = m_rrc->GetRnti ();
   SetEnbRrcSapProvider (); // assigns the value to m_enbRrdSapProvider
     
-   Simulator::Schedule (RRC_IDEAL_MSG_DELAY, 
-                        &LteEnbRrcSapProvider::RecvRrcConnectionReconfigurationCompleted,
-                        m_enbRrcSapProvider,
-                        m_rnti, 
-                        msg);
+   LteEventProfiler::Schedule ("LteEnbRrcSapProvider::RecvRrcConnectionReconfigurationCompleted", RRC_IDEAL_MSG_DELAY, 
+                               &LteEnbRrcSapProvider::RecvRrcConnectionReconfigurationCompleted,
+                               m_enbRrcSapProvider,
+                               m_rnti,
+                               msg);
 }
 
 void 
 LteUeRrcProtocolIdeal::DoSendRrcConnectionReestablishmentRequest (LteRrcSap::RrcConnectionReestablishmentRequest msg)
 {
-   Simulator::Schedule (RRC_IDEAL_MSG_DELAY, 
-		       &LteEnbRrcSapProvider::RecvRrcConnectionReestablishmentRequest,
-                       m_enbRrcSapProvider,
-		       m_rnti, 
-                        msg);
+   LteEventProfiler::Schedule ("LteEnbRrcSapProvider::RecvRrcConnectionReestablishmentRequest", RRC_IDEAL_MSG_DELAY, 
+                               &LteEnbRrcSapProvider::RecvRrcConnectionReestablishmentRequest,
+                               m_enbRrcSapProvider,
+                               m_rnti,
+                               msg);
 }
 
 void 
 LteUeRrcProtocolIdeal::DoSendRrcConnectionReestablishmentComplete (LteRrcSap::RrcConnectionReestablishmentComplete msg)
 {
-   Simulator::Schedule (RRC_IDEAL_MSG_DELAY, 
-		       &LteEnbRrcSapProvider::RecvRrcConnectionReestablishmentComplete,
-                       m_enbRrcSapProvider,
-		       m_rnti, 
-msg);
+   LteEventProfiler::Schedule ("LteEnbRrcSapProvider::RecvRrcConnectionReestablishmentComplete", RRC_IDEAL_MSG_DELAY, 
+                               &LteEnbRrcSapProvider::RecvRrcConnectionReestablishmentComplete,
+                               m_enbRrcSapProvider,
+                               m_rnti,
+                               msg);
 }
 
 void 
 LteUeRrcProtocolIdeal::DoSendMeasurementReport (LteRrcSap::MeasurementReport msg)
 {
-   Simulator::Schedule (RRC_IDEAL_MSG_DELAY, 
-                        &LteEnbRrcSapProvider::RecvMeasurementReport,
-                        m_enbRrcSapProvider,
-                        m_rnti, 
-                        msg);
+   LteEventProfiler::Schedule ("LteEnbRrcSapProvider::RecvMeasurementReport", RRC_IDEAL_MSG_DELAY, 
+                               &LteEnbRrcSapProvider::RecvMeasurementReport,
+                               m_enbRrcSapProvider,
+                               m_rnti,
+                               msg);
 }
 
 void 
@@ -342,10 +351,10 @@ LteEnbRrcProtocolIdeal::DoSendSystemInformation (LteRrcSap::SystemInformation ms
                 {       
                   NS_LOG_LOGIC ("sending SI to IMSI " << ueDev->GetImsi ());
                   ueRrc->GetLteUeRrcSapProvider ()->RecvSystemInformation (msg);
-                  Simulator::Schedule (RRC_IDEAL_MSG_DELAY, 
-                                       &LteUeRrcSapProvider::RecvSystemInformation,
-                                       ueRrc->GetLteUeRrcSapProvider (), 
-                                       msg);          
+                  LteEventProfiler::Schedule ("LteUeRrcSapProvider::RecvSystemInformation", RRC_IDEAL_MSG_DELAY, 
+                                              &LteUeRrcSapProvider::RecvSystemInformation,
+                                              ueRrc->GetLteUeRrcSapProvider (),
+                                              msg);
                 }             
             }
         }
@@ -355,55 +364,55 @@ LteEnbRrcProtocolIdeal::DoSendSystemInformation (LteRrcSap::SystemInformation ms
 void 
 LteEnbRrcProtocolIdeal::DoSendRrcConnectionSetup (uint16_t rnti, LteRrcSap::RrcConnectionSetup msg)
 {
-  Simulator::Schedule (RRC_IDEAL_MSG_DELAY, 
-		       &LteUeRrcSapProvider::RecvRrcConnectionSetup,
-		       GetUeRrcSapProvider (rnti), 
-		       msg);
+  LteEventProfiler::Schedule ("LteUeRrcSapProvider::RecvRrcConnectionSetup", RRC_IDEAL_MSG_DELAY, 
+                              &LteUeRrcSapProvider::RecvRrcConnectionSetup,
+                              GetUeRrcSapProvider (rnti),
+                              msg);
 }
 
 void 
 LteEnbRrcProtocolIdeal::DoSendRrcConnectionReconfiguration (uint16_t rnti, LteRrcSap::RrcConnectionReconfiguration msg)
 {
-  Simulator::Schedule (RRC_IDEAL_MSG_DELAY, 
-		       &LteUeRrcSapProvider::RecvRrcConnectionReconfiguration,
-		       GetUeRrcSapProvider (rnti), 
-		       msg);
+  LteEventProfiler::Schedule ("LteUeRrcSapProvider::RecvRrcConnectionReconfiguration", RRC_IDEAL_MSG_DELAY, 
+                              &LteUeRrcSapProvider::RecvRrcConnectionReconfiguration,
+                              GetUeRrcSapProvider (rnti),
+                              msg);
 }
 
 void 
 LteEnbRrcProtocolIdeal::DoSendRrcConnectionReestablishment (uint16_t rnti, LteRrcSap::RrcConnectionReestablishment msg)
 {
-  Simulator::Schedule (RRC_IDEAL_MSG_DELAY, 
-		       &LteUeRrcSapProvider::RecvRrcConnectionReestablishment,
-		       GetUeRrcSapProvider (rnti), 
-		       msg);
+  LteEventProfiler::Schedule ("LteUeRrcSapProvider::RecvRrcConnectionReestablishment", RRC_IDEAL_MSG_DELAY, 
+                              &LteUeRrcSapProvider::RecvRrcConnectionReestablishment,
+                              GetUeRrcSapProvider (rnti),
+                              msg);
 }
 
 void 
 LteEnbRrcProtocolIdeal::DoSendRrcConnectionReestablishmentReject (uint16_t rnti, LteRrcSap::RrcConnectionReestablishmentReject msg)
 {
-  Simulator::Schedule (RRC_IDEAL_MSG_DELAY, 
-		       &LteUeRrcSapProvider::RecvRrcConnectionReestablishmentReject,
-		       GetUeRrcSapProvider (rnti), 
-		       msg);
+  LteEventProfiler::Schedule ("LteUeRrcSapProvider::RecvRrcConnectionReestablishmentReject", RRC_IDEAL_MSG_DELAY, 
+                              &LteUeRrcSapProvider::RecvRrcConnectionReestablishmentReject,
+                              GetUeRrcSapProvider (rnti),
+                              msg);
 }
 
 void 
 LteEnbRrcProtocolIdeal::DoSendRrcConnectionRelease (uint16_t rnti, LteRrcSap::RrcConnectionRelease msg)
 {
-  Simulator::Schedule (RRC_IDEAL_MSG_DELAY, 
-		       &LteUeRrcSapProvider::RecvRrcConnectionRelease,
-		       GetUeRrcSapProvider (rnti), 
-		       msg);
+  LteEventProfiler::Schedule ("LteUeRrcSapProvider::RecvRrcConnectionRelease", RRC_IDEAL_MSG_DELAY, 
+                              &LteUeRrcSapProvider::RecvRrcConnectionRelease,
+                              GetUeRrcSapProvider (rnti),
+                              msg);
 }
 
 void 
 LteEnbRrcProtocolIdeal::DoSendRrcConnectionReject (uint16_t rnti, LteRrcSap::RrcConnectionReject msg)
 {
-  Simulator::Schedule (RRC_IDEAL_MSG_DELAY, 
-		       &LteUeRrcSapProvider::RecvRrcConnectionReject,
-		       GetUeRrcSapProvider (rnti), 
-		       msg);
+  LteEventProfiler::Schedule ("LteUeRrcSapProvider::RecvRrcConnectionReject", RRC_IDEAL_MSG_DELAY, 
+                              &LteUeRrcSapProvider::RecvRrcConnectionReject,
+                              GetUeRrcSapProvider (rnti),
+                              msg);
 }
 
 /*
@@ -60,6 +60,12 @@ public:
   LteUeRrcSapUser* GetLteUeRrcSapUser ();
   
   void SetUeRrc (Ptr<LteUeRrc> rrc);
+
+  /**
+   * Bind to the RRC of the serving eNB without sending any message,
+   * for a UE whose connection was restored by LteUeRrc::RestoreConnection
+   */
+  void NotifyConnectionRestored ();
   
 
 private:
@@ -35,6 +35,7 @@
 #include "lte-enb-rrc.h"
 #include "lte-enb-net-device.h"
 #include "lte-ue-net-device.h"
+#include "lte-profiler.h"
 
 namespace ns3 {
 
@@ -96,6 +97,14 @@ LteUeRrcProtocolReal::SetUeRrc (Ptr<LteUeRrc> rrc)
   m_rrc = rrc;
 }
 
+void
+LteUeRrcProtocolReal::NotifyConnectionRestored ()
+{
+  NS_LOG_FUNCTION (this);
+  m_rnti = m_rrc->GetRnti ();
+  SetEnbRrcSapProvider ();
+}
+
 void 
 LteUeRrcProtocolReal::DoSetup (LteUeRrcSapUser::SetupParameters params)
 {
@@ -531,10 +540,10 @@ LteEnbRrcProtocolReal::DoSendSystemInformation (LteRrcSap::SystemInformation msg
                 {
                   NS_LOG_LOGIC ("sending SI to IMSI " << ueDev->GetImsi ());
                   ueRrc->GetLteUeRrcSapProvider ()->RecvSystemInformation (msg);
-                  Simulator::Schedule (RRC_REAL_MSG_DELAY, 
-                                       &LteUeRrcSapProvider::RecvSystemInformation,
-                                       ueRrc->GetLteUeRrcSapProvider (), 
-                                       msg);
+                  LteEventProfiler::Schedule ("LteUeRrcSapProvider::RecvSystemInformation", RRC_REAL_MSG_DELAY, 
+                                              &LteUeRrcSapProvider::RecvSystemInformation,
+                                              ueRrc->GetLteUeRrcSapProvider (), 
+                                              msg);
                 }
             }
         }
@@ -67,6 +67,12 @@ public:
 
   void SetUeRrc (Ptr<LteUeRrc> rrc);
 
+  /**
+   * Bind to the RRC of the serving eNB without sending any message,
+   * for a UE whose connection was restored by LteUeRrc::RestoreConnection
+   */
+  void NotifyConnectionRestored ();
+
 
 private:
   // methods forwarded from LteUeRrcSapUser
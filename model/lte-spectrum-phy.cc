@@ -43,6 +43,7 @@
 #include <ns3/double.h>
 #include <ns3/config.h>
 #include "lte-interference-multiple-rx.h"
+#include "lte-profiler.h"
 
 namespace ns3 {
 
@@ -158,6 +159,7 @@ void LteSpectrumPhy::DoDispose ()
   m_interferencePrach = 0;
   m_ltePhyRxDataEndErrorCallback = MakeNullCallback< void > ();
   m_ltePhyRxDataEndOkCallback    = MakeNullCallback< void, Ptr<Packet> >  ();
+  m_ltePhyRxDataEndOkListCallback = MakeNullCallback< void, const std::vector<Ptr<Packet> >& > ();
   m_ltePhyRxCtrlEndOkCallback = MakeNullCallback< void, std::list<Ptr<LteControlMessage> > > ();
   m_ltePhyRxCtrlEndErrorCallback = MakeNullCallback< void > ();
   m_ltePhyDlHarqFeedbackCallback = MakeNullCallback< void, DlInfoListElement_s > ();
@@ -372,6 +374,13 @@ LteSpectrumPhy::SetLtePhyRxDataEndOkCallback (LtePhyRxDataEndOkCallback c)
   m_ltePhyRxDataEndOkCallback = c;
 }
 
+void
+LteSpectrumPhy::SetLtePhyRxDataEndOkListCallback (LtePhyRxDataEndOkListCallback c)
+{
+  NS_LOG_FUNCTION (this);
+  m_ltePhyRxDataEndOkListCallback = c;
+}
+
 void
 LteSpectrumPhy::SetLtePhyRxCtrlEndOkCallback (LtePhyRxCtrlEndOkCallback c)
 {
@@ -458,6 +467,13 @@ LteSpectrumPhy::SetHarqPhyModule (Ptr<LteHarqPhy> harq)
   m_harqPhyModule = harq;
 }
 
+void
+LteSpectrumPhy::SetTraceSampler (const LteTraceSampler& sampler)
+{
+  NS_LOG_FUNCTION (this);
+  m_traceSampler = sampler;
+}
+
 bool
 LteSpectrumPhy::StartTxMsg3Frame (Ptr<PacketBurst> pb, std::list<Ptr<LteControlMessage> > ctrlMsgList, Time duration)
 {
@@ -517,7 +533,7 @@ LteSpectrumPhy::StartTxDataFrame (Ptr<PacketBurst> pb, std::list<Ptr<LteControlM
       txParams->cellId = m_cellId;
       txParams->isMsg3 = m_msg3;
       m_channel->StartTx (txParams);
-      m_endTxEvent = Simulator::Schedule (duration, &LteSpectrumPhy::EndTxData, this);
+      m_endTxEvent = LteEventProfiler::Schedule ("LteSpectrumPhy::EndTxData", duration, &LteSpectrumPhy::EndTxData, this);
       m_msg3 = false;
     }
     return false;
@@ -580,7 +596,7 @@ LteSpectrumPhy::StartTxPrachFrame (std::list<Ptr<LteControlMessage> > prachMsgLi
       txParams->cellId = m_cellId;
       txParams->prachMsgList = prachMsgList; // to carry RACH preamble
       m_channel->StartTx (txParams);
-      m_endTxEvent = Simulator::Schedule (duration, &LteSpectrumPhy::EndTxPrach, this);
+      m_endTxEvent = LteEventProfiler::Schedule ("LteSpectrumPhy::EndTxPrach", duration, &LteSpectrumPhy::EndTxPrach, this);
     }
     return false;
     break;
@@ -640,7 +656,7 @@ LteSpectrumPhy::StartTxDlCtrlFrame (std::list<Ptr<LteControlMessage> > ctrlMsgLi
       txParams->pss = pss;
       txParams->ctrlMsgList = ctrlMsgList;
       m_channel->StartTx (txParams);
-      m_endTxEvent = Simulator::Schedule (DL_CTRL_DURATION, &LteSpectrumPhy::EndTxDlCtrl, this);
+      m_endTxEvent = LteEventProfiler::Schedule ("LteSpectrumPhy::EndTxDlCtrl", DL_CTRL_DURATION, &LteSpectrumPhy::EndTxDlCtrl, this);
     }
     return false;
     break;
@@ -698,7 +714,7 @@ LteSpectrumPhy::StartTxUlSrsFrame ()
       txParams->psd = m_txPsd;
       txParams->cellId = m_cellId;
       m_channel->StartTx (txParams);
-      m_endTxEvent = Simulator::Schedule (UL_SRS_DURATION, &LteSpectrumPhy::EndTxUlSrs, this);
+      m_endTxEvent = LteEventProfiler::Schedule ("LteSpectrumPhy::EndTxUlSrs", UL_SRS_DURATION, &LteSpectrumPhy::EndTxUlSrs, this);
     }
     return false;
     break;
@@ -762,6 +778,7 @@ void
 LteSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> spectrumRxParams)
 {
   NS_LOG_FUNCTION (this << spectrumRxParams);
+  LTE_PROFILE_SCOPE (PHY_START_RX);
   NS_LOG_LOGIC (this << " state: " << m_state);
 
   Ptr <const SpectrumValue> rxPsd = spectrumRxParams->psd;
@@ -841,7 +858,7 @@ LteSpectrumPhy::StartRxData (Ptr<LteSpectrumSignalParametersDataFrame> params)
                   m_firstRxStart = Simulator::Now ();
                   m_firstRxDuration = params->duration;
                   NS_LOG_INFO (this << " scheduling EndRx with delay " << params->duration.GetSeconds () << "s");
-                  m_endRxDataEvent = Simulator::Schedule (params->duration, &LteSpectrumPhy::EndRxData, this);
+                  m_endRxDataEvent = LteEventProfiler::Schedule ("LteSpectrumPhy::EndRxData", params->duration, &LteSpectrumPhy::EndRxData, this);
                 }
               else
                 {
@@ -939,7 +956,7 @@ LteSpectrumPhy::StartRxPrach (Ptr<LteSpectrumSignalParametersPrachFrame> ltePrac
           m_rxpRachMessageList[m_numPrachAccess] = (ltePrachRxParams->prachMsgList).front();
           m_interferencePrach->StartRx (ltePrachRxParams->psd, m_numPrachAccess);            
 
-          Simulator::Schedule (ltePrachRxParams->duration, &LteSpectrumPhy::EndRxPrach, this, m_numPrachAccess);
+          LteEventProfiler::Schedule ("LteSpectrumPhy::EndRxPrach", ltePrachRxParams->duration, &LteSpectrumPhy::EndRxPrach, this, m_numPrachAccess);
 
         }
       else
@@ -963,7 +980,7 @@ LteSpectrumPhy::StartRxPrach (Ptr<LteSpectrumSignalParametersPrachFrame> ltePrac
           m_numPrachAccess = 0;
           NS_ASSERT_MSG(ltePrachRxParams->prachMsgList.size() == 1, "It is possible to send only one RACH preamble per message");
           m_rxpRachMessageList[m_numPrachAccess] = (ltePrachRxParams->prachMsgList).front();
-          m_endRxPrachEvent = Simulator::Schedule (ltePrachRxParams->duration, &LteSpectrumPhy::EndRxPrach, this, m_numPrachAccess);
+          m_endRxPrachEvent = LteEventProfiler::Schedule ("LteSpectrumPhy::EndRxPrach", ltePrachRxParams->duration, &LteSpectrumPhy::EndRxPrach, this, m_numPrachAccess);
           ChangeState (RX_RACH);
           m_interferencePrach->StartRx (ltePrachRxParams->psd, m_numPrachAccess);            
         }
@@ -1040,7 +1057,7 @@ LteSpectrumPhy::StartRxDlCtrl (Ptr<LteSpectrumSignalParametersDlCtrlFrame> lteDl
               
               // store the DCIs
               m_rxControlMessageList = lteDlCtrlRxParams->ctrlMsgList;
-              m_endRxDlCtrlEvent = Simulator::Schedule (lteDlCtrlRxParams->duration, &LteSpectrumPhy::EndRxDlCtrl, this);
+              m_endRxDlCtrlEvent = LteEventProfiler::Schedule ("LteSpectrumPhy::EndRxDlCtrl", lteDlCtrlRxParams->duration, &LteSpectrumPhy::EndRxDlCtrl, this);
               ChangeState (RX_DL_CTRL);
               m_interferenceCtrl->StartRx (lteDlCtrlRxParams->psd);            
             }
@@ -1110,7 +1127,7 @@ LteSpectrumPhy::StartRxUlSrs (Ptr<LteSpectrumSignalParametersUlSrsFrame> lteUlSr
                 m_firstRxDuration = lteUlSrsRxParams->duration;
                 NS_LOG_LOGIC (this << " scheduling EndRx with delay " << lteUlSrsRxParams->duration);
 
-                m_endRxUlSrsEvent = Simulator::Schedule (lteUlSrsRxParams->duration, &LteSpectrumPhy::EndRxUlSrs, this);
+                m_endRxUlSrsEvent = LteEventProfiler::Schedule ("LteSpectrumPhy::EndRxUlSrs", lteUlSrsRxParams->duration, &LteSpectrumPhy::EndRxUlSrs, this);
               }
             else if (m_state == RX_UL_SRS)
               {
@@ -1180,6 +1197,7 @@ void
 LteSpectrumPhy::EndRxData ()
 {
   NS_LOG_FUNCTION (this);
+  LTE_PROFILE_SCOPE (PHY_END_RX_DATA);
   NS_LOG_LOGIC (this << " state: " << m_state);
 
   NS_ASSERT (m_state == RX_DATA);
@@ -1235,28 +1253,31 @@ LteSpectrumPhy::EndRxData ()
 
               NS_LOG_INFO (this << " RNTI " << (*itTb).first.m_rnti << " size " << (*itTb).second.size << " mcs " << (uint32_t)(*itTb).second.mcs << " bitmap " << (*itTb).second.rbBitmap.size () << " layer " << (uint16_t)(*itTb).first.m_layer << " TBLER " << tbStats.tbler << " corrupted " << (*itTb).second.corrupt);
               // fire traces on DL/UL reception PHY stats
-              PhyReceptionStatParameters params;
-              params.m_timestamp = Simulator::Now ().GetMilliSeconds ();
-              params.m_cellId = m_cellId;
-              params.m_imsi = 0; // it will be set by DlPhyTransmissionCallback in LteHelper
-              params.m_rnti = (*itTb).first.m_rnti;
-              params.m_txMode = m_transmissionMode;
-              params.m_layer =  (*itTb).first.m_layer;
-              params.m_mcs = (*itTb).second.mcs;
-              params.m_size = (*itTb).second.size;
-              params.m_rv = (*itTb).second.rv;
-              params.m_ndi = (*itTb).second.ndi;
-              params.m_correctness = (uint8_t)!(*itTb).second.corrupt;
-              if ((*itTb).second.downlink)
+              if (m_traceSampler.IsSampled (m_cellId, (*itTb).first.m_rnti))
                 {
-                  // DL
-                  m_dlPhyReception (params);
-                }
-              else
-                {
-                  // UL
-                  params.m_rv = harqInfoList.size ();
-                  m_ulPhyReception (params);
+                  PhyReceptionStatParameters params;
+                  params.m_timestamp = Simulator::Now ().GetMilliSeconds ();
+                  params.m_cellId = m_cellId;
+                  params.m_imsi = 0; // it will be set by DlPhyTransmissionCallback in LteHelper
+                  params.m_rnti = (*itTb).first.m_rnti;
+                  params.m_txMode = m_transmissionMode;
+                  params.m_layer =  (*itTb).first.m_layer;
+                  params.m_mcs = (*itTb).second.mcs;
+                  params.m_size = (*itTb).second.size;
+                  params.m_rv = (*itTb).second.rv;
+                  params.m_ndi = (*itTb).second.ndi;
+                  params.m_correctness = (uint8_t)!(*itTb).second.corrupt;
+                  if ((*itTb).second.downlink)
+                    {
+                      // DL
+                      m_dlPhyReception (params);
+                    }
+                  else
+                    {
+                      // UL
+                      params.m_rv = harqInfoList.size ();
+                      m_ulPhyReception (params);
+                    }
                 }
            }
           
@@ -1282,7 +1303,12 @@ LteSpectrumPhy::EndRxData ()
                       {
                         m_phyRxEndOkTrace (*j);
                     
-                        if (!m_ltePhyRxDataEndOkCallback.IsNull ())
+                        if (!m_ltePhyRxDataEndOkListCallback.IsNull ())
+                          {
+                            // delivered with the others after the loop
+                            m_rxDataOkPackets.push_back (*j);
+                          }
+                        else if (!m_ltePhyRxDataEndOkCallback.IsNull ())
                           {
                             m_ltePhyRxDataEndOkCallback (*j);
                           }
@@ -1364,6 +1390,12 @@ LteSpectrumPhy::EndRxData ()
                   }
               }
           }
+      // forward the data received correctly in this subframe to LtePhy
+      if (!m_rxDataOkPackets.empty ())
+        {
+          m_ltePhyRxDataEndOkListCallback (m_rxDataOkPackets);
+          m_rxDataOkPackets.clear ();
+        }
 
       // send DL HARQ feedback to LtePhy
       std::map <uint16_t, DlInfoListElement_s>::iterator itHarq;
@@ -1393,6 +1425,7 @@ void
 LteSpectrumPhy::EndRxPrach (uint32_t numPrachAccess)
 {
   NS_LOG_FUNCTION (this);
+  LTE_PROFILE_SCOPE (PHY_END_RX_PRACH);
   NS_LOG_LOGIC (this << " state: " << m_state); 
 
   NS_ASSERT (m_state == RX_RACH || numPrachAccess > 1);
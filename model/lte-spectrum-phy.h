@@ -45,6 +45,7 @@
 #include <ns3/ff-mac-common.h>
 #include <ns3/lte-harq-phy.h>
 #include <ns3/lte-common.h>
+#include <ns3/lte-trace-sampler.h>
 #include "lte-interference-multiple-rx.h"
 
 namespace ns3 {
@@ -110,6 +111,14 @@ typedef Callback< void > LtePhyRxDataEndErrorCallback;
 */
 typedef Callback< void, Ptr<Packet> > LtePhyRxDataEndOkCallback;
 
+/**
+* This method is used by the LteSpectrumPhy to notify the PHY of all the
+* packets of the TBs correctly received in a subframe at once.
+*
+* @param packets the received Packets
+*/
+typedef Callback< void, const std::vector<Ptr<Packet> >& > LtePhyRxDataEndOkListCallback;
+
 
 /**
 * This method is used by the LteSpectrumPhy to notify the PHY that a
@@ -207,6 +216,12 @@ public:
 
   void SetHarqPhyModule (Ptr<LteHarqPhy> harq);
 
+  /**
+   * \param sampler the sampling policy of the DlPhyReception and
+   *        UlPhyReception traces
+   */
+  void SetTraceSampler (const LteTraceSampler& sampler);
+
   /**
    * set the Power Spectral Density of outgoing signals in W/Hz.
    *
@@ -316,6 +331,15 @@ public:
    * @param c the callback
    */
   void SetLtePhyRxDataEndOkCallback (LtePhyRxDataEndOkCallback c);
+
+  /**
+   * set the callback for the successful end of a RX, delivering all the
+   * packets received correctly in the subframe in a single call. When
+   * set, it is used in place of the per-packet LtePhyRxDataEndOkCallback.
+   *
+   * @param c the callback
+   */
+  void SetLtePhyRxDataEndOkListCallback (LtePhyRxDataEndOkListCallback c);
   
   /**
   * set the callback for the successful end of a RX ctrl frame, as part 
@@ -559,6 +583,8 @@ private:
 
   LtePhyRxDataEndErrorCallback   m_ltePhyRxDataEndErrorCallback;
   LtePhyRxDataEndOkCallback      m_ltePhyRxDataEndOkCallback;
+  LtePhyRxDataEndOkListCallback  m_ltePhyRxDataEndOkListCallback;
+  std::vector<Ptr<Packet> >      m_rxDataOkPackets; ///< packets received correctly in the subframe, reused
   
   LtePhyRxCtrlEndOkCallback     m_ltePhyRxCtrlEndOkCallback;
   LtePhyRxPrachEndOkCallback    m_ltePhyRxPrachEndOkCallback;
@@ -588,6 +614,7 @@ private:
   std::vector <double> m_txModeGain; // duplicate value of LteUePhy
 
   Ptr<LteHarqPhy> m_harqPhyModule;
+  LteTraceSampler m_traceSampler; ///< sampling policy of the reception traces
   LtePhyDlHarqFeedbackCallback m_ltePhyDlHarqFeedbackCallback;
   LtePhyUlHarqFeedbackCallback m_ltePhyUlHarqFeedbackCallback;
 
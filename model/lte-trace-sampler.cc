@@ -0,0 +1,86 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-trace-sampler.h"
+#include <ns3/log.h>
+#include <ns3/abort.h>
+#include <ns3/rng-seed-manager.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteTraceSampler");
+
+const uint32_t LteTraceSampler::ALL_UES;
+
+LteTraceSampler::LteTraceSampler ()
+  : m_all (true),
+    m_ttiPeriod (1),
+    m_ueThreshold (ALL_UES),
+    m_ueSeed (0)
+{
+}
+
+void
+LteTraceSampler::SetTtiPeriod (uint32_t period)
+{
+  NS_LOG_FUNCTION (this << period);
+  NS_ABORT_MSG_IF (period == 0, "the TTI period must be positive");
+  m_ttiPeriod = period;
+  UpdateAll ();
+}
+
+void
+LteTraceSampler::SetUeFraction (double fraction)
+{
+  NS_LOG_FUNCTION (this << fraction);
+  NS_ABORT_MSG_IF (fraction < 0 || fraction > 1, "the fraction of UEs must be in [0, 1]");
+  m_ueThreshold = static_cast<uint32_t> (fraction * ALL_UES);
+  m_ueSeed = static_cast<uint32_t> (RngSeedManager::GetRun ()) * 0x9e3779b9u + RngSeedManager::GetSeed ();
+  UpdateAll ();
+}
+
+void
+LteTraceSampler::AddCell (uint16_t cellId)
+{
+  NS_LOG_FUNCTION (this << cellId);
+  if (cellId >= m_cells.size ())
+    {
+      m_cells.resize (cellId + 1, false);
+    }
+  m_cells[cellId] = true;
+  UpdateAll ();
+}
+
+uint32_t
+LteTraceSampler::Hash (uint16_t cellId, uint16_t rnti) const
+{
+  // finalizer of MurmurHash3
+  uint32_t h = ((static_cast<uint32_t> (cellId) << 16) | rnti) ^ m_ueSeed;
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+}
+
+void
+LteTraceSampler::UpdateAll (void)
+{
+  m_all = m_ttiPeriod == 1 && m_ueThreshold == ALL_UES && m_cells.empty ();
+}
+
+} // namespace ns3
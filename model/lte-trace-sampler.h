@@ -0,0 +1,118 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_TRACE_SAMPLER_H
+#define LTE_TRACE_SAMPLER_H
+
+#include <ns3/simulator.h>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * Sampling policy of the trace sources which fire per UE and per TTI
+ * (DlScheduling, UlScheduling, DlPhyTransmission, UlPhyTransmission,
+ * DlPhyReception, UlPhyReception, ReportUeSinr and
+ * ReportCurrentCellRsrpSinr). The entities owning these trace sources
+ * check IsSampled before filling the parameters of the trace, so that
+ * the samples left out cost neither a callback nor any formatting.
+ *
+ * The policies can be combined, a sample being kept only if all of
+ * them keep it:
+ *   - every Nth TTI, N being the TTI period;
+ *   - a random subset of the UEs, each UE (identified by its cell ID
+ *     and RNTI) being kept with the given probability, consistently
+ *     across the layers and the entities;
+ *   - only the selected cells.
+ *
+ * A default-constructed sampler keeps all the samples. The sampler is
+ * usually configured through LteHelper::SetTraceSampler.
+ */
+class LteTraceSampler
+{
+public:
+  /**
+   * Create a sampler keeping all the samples
+   */
+  LteTraceSampler ();
+
+  /**
+   * \param period keep the samples of one TTI every period TTIs
+   */
+  void SetTtiPeriod (uint32_t period);
+
+  /**
+   * \param fraction the probability of keeping the samples of a UE, the
+   *        UEs being selected with the run number of the simulation
+   */
+  void SetUeFraction (double fraction);
+
+  /**
+   * Keep the samples of this cell. If no cell is added, the samples of
+   * all the cells are kept.
+   * \param cellId the cell ID
+   */
+  void AddCell (uint16_t cellId);
+
+  /**
+   * \param cellId the cell ID of the sample
+   * \param rnti the RNTI of the UE of the sample
+   * \return true if the sample, taken now, is to be traced
+   */
+  inline bool IsSampled (uint16_t cellId, uint16_t rnti) const
+  {
+    if (m_all)
+      {
+        return true;
+      }
+    if (!m_cells.empty () && (cellId >= m_cells.size () || !m_cells[cellId]))
+      {
+        return false;
+      }
+    if (m_ttiPeriod > 1 && Simulator::Now ().GetMilliSeconds () % m_ttiPeriod != 0)
+      {
+        return false;
+      }
+    return m_ueThreshold == ALL_UES || Hash (cellId, rnti) <= m_ueThreshold;
+  }
+
+private:
+  /// value of m_ueThreshold keeping all the UEs
+  static const uint32_t ALL_UES = 0xffffffff;
+
+  /**
+   * \param cellId the cell ID
+   * \param rnti the RNTI
+   * \return a pseudo-random value, uniform over the UEs
+   */
+  uint32_t Hash (uint16_t cellId, uint16_t rnti) const;
+
+  /// update m_all after a change of the policy
+  void UpdateAll (void);
+
+  bool m_all; ///< true if all the samples are kept
+  uint32_t m_ttiPeriod; ///< the TTI period
+  uint32_t m_ueThreshold; ///< the UEs whose hash is up to this are kept
+  uint32_t m_ueSeed; ///< the seed of the hash of the UEs
+  std::vector<bool> m_cells; ///< the selected cells, indexed by cell ID
+};
+
+} // namespace ns3
+
+#endif /* LTE_TRACE_SAMPLER_H */
@@ -0,0 +1,307 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-traffic-generator.h"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/enum.h>
+#include <ns3/uinteger.h>
+#include <ns3/boolean.h>
+#include <ns3/trace-source-accessor.h>
+
+#include <ns3/lte-pdcp-header.h>
+#include <ns3/lte-pdcp-tag.h>
+#include <ns3/lte-profiler.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteTrafficGenerator");
+
+NS_OBJECT_ENSURE_REGISTERED (LteTrafficGenerator);
+
+/// Largest PDCP SN, as in LtePdcp
+static const uint16_t MAX_PDCP_SN = 4095;
+
+/// Period in seconds at which the RLC buffer is topped up by the full buffer model
+static const double FULL_BUFFER_PERIOD = 0.001;
+
+LteTrafficGenerator::LteTrafficGenerator ()
+  : m_rnti (0),
+    m_lcid (0),
+    m_pdcpSapProvider (0),
+    m_rlcSapProvider (0),
+    m_pdcpSequenceNumber (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_exponential = CreateObject<ExponentialRandomVariable> ();
+  m_uniform = CreateObject<UniformRandomVariable> ();
+}
+
+LteTrafficGenerator::~LteTrafficGenerator ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+LteTrafficGenerator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LteTrafficGenerator")
+    .SetParent<Object> ()
+    .SetGroupName("Lte")
+    .AddConstructor<LteTrafficGenerator> ()
+    .AddAttribute ("Model",
+                   "The traffic model of the bearer.",
+                   EnumValue (LteTrafficGenerator::FULL_BUFFER),
+                   MakeEnumAccessor (&LteTrafficGenerator::m_model),
+                   MakeEnumChecker (LteTrafficGenerator::FULL_BUFFER, "FullBuffer",
+                                    LteTrafficGenerator::POISSON, "Poisson",
+                                    LteTrafficGenerator::ON_OFF, "OnOff",
+                                    LteTrafficGenerator::PERIODIC, "Periodic"))
+    .AddAttribute ("PacketSize",
+                   "Size in bytes of the generated packets.",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&LteTrafficGenerator::m_packetSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Interval",
+                   "Mean interarrival time (Poisson), packet interval during "
+                   "the on periods (OnOff) or report period (Periodic).",
+                   TimeValue (MilliSeconds (10)),
+                   MakeTimeAccessor (&LteTrafficGenerator::m_interval),
+                   MakeTimeChecker ())
+    .AddAttribute ("OnTime",
+                   "Mean duration of the on periods (OnOff).",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&LteTrafficGenerator::m_onTime),
+                   MakeTimeChecker ())
+    .AddAttribute ("OffTime",
+                   "Mean duration of the off periods (OnOff).",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&LteTrafficGenerator::m_offTime),
+                   MakeTimeChecker ())
+    .AddAttribute ("Jitter",
+                   "Each report is delayed from its nominal time by a uniform "
+                   "jitter in [0, Jitter], Jitter < Interval (Periodic).",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&LteTrafficGenerator::m_jitter),
+                   MakeTimeChecker ())
+    .AddAttribute ("FullBufferBacklog",
+                   "Number of bytes kept in the RLC transmission buffer by the full "
+                   "buffer model, topped up every millisecond. It should exceed what "
+                   "the bearer can send in a TTI; the packets which do not fit in the "
+                   "buffer of a RLC/UM are dropped by the RLC.",
+                   UintegerValue (20000),
+                   MakeUintegerAccessor (&LteTrafficGenerator::m_fullBufferBacklog),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("BypassPdcp",
+                   "If true, the packets are sent directly to the RLC.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteTrafficGenerator::m_bypassPdcp),
+                   MakeBooleanChecker ())
+    .AddTraceSource ("Tx",
+                     "Packet generated on the bearer.",
+                     MakeTraceSourceAccessor (&LteTrafficGenerator::m_txTrace),
+                     "ns3::LteTrafficGenerator::TxTracedCallback")
+    ;
+  return tid;
+}
+
+void
+LteTrafficGenerator::SetRnti (uint16_t rnti)
+{
+  NS_LOG_FUNCTION (this << rnti);
+  m_rnti = rnti;
+}
+
+void
+LteTrafficGenerator::SetLcId (uint8_t lcId)
+{
+  NS_LOG_FUNCTION (this << (uint32_t) lcId);
+  m_lcid = lcId;
+}
+
+void
+LteTrafficGenerator::SetLtePdcpSapProvider (LtePdcpSapProvider* s)
+{
+  NS_LOG_FUNCTION (this << s);
+  m_pdcpSapProvider = s;
+}
+
+void
+LteTrafficGenerator::SetLteRlcSapProvider (LteRlcSapProvider* s)
+{
+  NS_LOG_FUNCTION (this << s);
+  m_rlcSapProvider = s;
+}
+
+void
+LteTrafficGenerator::SetTxBufferSizeCallback (Callback<uint32_t> cb)
+{
+  NS_LOG_FUNCTION (this);
+  m_txBufferSizeCallback = cb;
+}
+
+int64_t
+LteTrafficGenerator::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_exponential->SetStream (stream);
+  m_uniform->SetStream (stream + 1);
+  return 2;
+}
+
+void
+LteTrafficGenerator::DoInitialize ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_bypassPdcp ? m_rlcSapProvider != 0 : m_pdcpSapProvider != 0,
+                 "traffic generator not attached to the bearer");
+  NS_ASSERT_MSG (m_model != FULL_BUFFER || !m_txBufferSizeCallback.IsNull (),
+                 "the full buffer model needs the size of the RLC buffer");
+  Time delay;
+  switch (m_model)
+    {
+    case FULL_BUFFER:
+      delay = Seconds (0);
+      break;
+
+    case POISSON:
+      delay = Seconds (m_exponential->GetValue (m_interval.GetSeconds (), 0));
+      break;
+
+    case ON_OFF:
+      // start in an off period, so that the bearers do not start together
+      m_onPeriodEnd = Simulator::Now ();
+      delay = Seconds (m_exponential->GetValue (m_offTime.GetSeconds (), 0));
+      break;
+
+    case PERIODIC:
+      NS_ASSERT_MSG (m_jitter < m_interval, "the jitter must be lower than the report interval");
+      // random phase, so that the reports of the bearers are not synchronized
+      m_nextReport = Simulator::Now () + Seconds (m_uniform->GetValue (0, m_interval.GetSeconds ()));
+      delay = m_nextReport - Simulator::Now () + Seconds (m_uniform->GetValue (0, m_jitter.GetSeconds ()));
+      break;
+
+    default:
+      NS_FATAL_ERROR ("unknown traffic model " << m_model);
+      break;
+    }
+  m_generateEvent = LteEventProfiler::Schedule ("LteTrafficGenerator::Generate", delay, &LteTrafficGenerator::Generate, this);
+  Object::DoInitialize ();
+}
+
+void
+LteTrafficGenerator::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  m_generateEvent.Cancel ();
+  m_pdcpSapProvider = 0;
+  m_rlcSapProvider = 0;
+  m_txBufferSizeCallback = MakeNullCallback<uint32_t> ();
+  Object::DoDispose ();
+}
+
+void
+LteTrafficGenerator::Generate ()
+{
+  NS_LOG_FUNCTION (this);
+  Time delay;
+  switch (m_model)
+    {
+    case FULL_BUFFER:
+      {
+        uint32_t backlog = m_txBufferSizeCallback ();
+        while (backlog < m_fullBufferBacklog)
+          {
+            Send ();
+            uint32_t newBacklog = m_txBufferSizeCallback ();
+            if (newBacklog <= backlog)
+              {
+                // dropped by the RLC, whose buffer is full
+                break;
+              }
+            backlog = newBacklog;
+          }
+        delay = Seconds (FULL_BUFFER_PERIOD);
+      }
+      break;
+
+    case POISSON:
+      Send ();
+      delay = Seconds (m_exponential->GetValue (m_interval.GetSeconds (), 0));
+      break;
+
+    case ON_OFF:
+      if (Simulator::Now () >= m_onPeriodEnd)
+        {
+          // first packet of a new on period
+          m_onPeriodEnd = Simulator::Now () + Seconds (m_exponential->GetValue (m_onTime.GetSeconds (), 0));
+        }
+      Send ();
+      delay = m_interval;
+      if (Simulator::Now () + delay >= m_onPeriodEnd)
+        {
+          delay = m_onPeriodEnd - Simulator::Now () + Seconds (m_exponential->GetValue (m_offTime.GetSeconds (), 0));
+        }
+      break;
+
+    case PERIODIC:
+      Send ();
+      m_nextReport += m_interval;
+      delay = m_nextReport - Simulator::Now () + Seconds (m_uniform->GetValue (0, m_jitter.GetSeconds ()));
+      break;
+
+    default:
+      NS_FATAL_ERROR ("unknown traffic model " << m_model);
+      break;
+    }
+  m_generateEvent = LteEventProfiler::Schedule ("LteTrafficGenerator::Generate", delay, &LteTrafficGenerator::Generate, this);
+}
+
+void
+LteTrafficGenerator::Send ()
+{
+  NS_LOG_FUNCTION (this << m_rnti << (uint32_t) m_lcid << m_packetSize);
+  Ptr<Packet> p = Create<Packet> (m_packetSize);
+  m_txTrace (m_rnti, m_lcid, m_packetSize);
+  if (m_bypassPdcp)
+    {
+      // do what the PDCP would do, so that the receiving PDCP is unaffected
+      LtePdcpHeader pdcpHeader;
+      pdcpHeader.SetSequenceNumber (m_pdcpSequenceNumber);
+      m_pdcpSequenceNumber = (m_pdcpSequenceNumber == MAX_PDCP_SN) ? 0 : m_pdcpSequenceNumber + 1;
+      pdcpHeader.SetDcBit (LtePdcpHeader::DATA_PDU);
+      p->AddHeader (pdcpHeader);
+      PdcpTag pdcpTag (Simulator::Now ());
+      p->AddByteTag (pdcpTag);
+
+      LteRlcSapProvider::TransmitPdcpPduParameters params;
+      params.rnti = m_rnti;
+      params.lcid = m_lcid;
+      params.pdcpPdu = p;
+      m_rlcSapProvider->TransmitPdcpPdu (params);
+    }
+  else
+    {
+      LtePdcpSapProvider::TransmitPdcpSduParameters params;
+      params.rnti = m_rnti;
+      params.lcid = m_lcid;
+      params.pdcpSdu = p;
+      m_pdcpSapProvider->TransmitPdcpSdu (params);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,157 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_TRAFFIC_GENERATOR_H
+#define LTE_TRAFFIC_GENERATOR_H
+
+#include <ns3/object.h>
+#include <ns3/nstime.h>
+#include <ns3/event-id.h>
+#include <ns3/callback.h>
+#include <ns3/traced-callback.h>
+#include <ns3/random-variable-stream.h>
+
+#include <ns3/lte-pdcp-sap.h>
+#include <ns3/lte-rlc-sap.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * Traffic source of a single radio bearer, feeding the PDCP (or directly
+ * the RLC) of the bearer without any IP stack, socket or EPC node. It is
+ * created by the RRC for each data radio bearer when enabled in the
+ * LteHelper (see LteHelper::SetDlTrafficGeneratorAttribute), and starts
+ * generating when the bearer is started.
+ *
+ * The delay of each packet is reported by the RxPDU trace of the PDCP at
+ * the receiving side, since the PDCP timestamps the SDUs when they are
+ * generated. When the PDCP is bypassed, the generator adds the PDCP header
+ * and the timestamp itself, so that the receiving PDCP is unaffected.
+ *
+ * The full buffer model keeps the transmission buffer of the RLC filled
+ * up to FullBufferBacklog bytes, as told by the callback set with
+ * SetTxBufferSizeCallback, so that the bearer always has data to send
+ * without queuing more than the RLC can hold.
+ *
+ * The bearers served by RLC/SM have no PDCP and are not fed.
+ */
+class LteTrafficGenerator : public Object
+{
+public:
+  /// Traffic models
+  enum Model
+  {
+    FULL_BUFFER, ///< keeps FullBufferBacklog bytes in the RLC buffer
+    POISSON,     ///< exponential interarrival times of mean Interval
+    ON_OFF,      ///< one packet each Interval during exponential on periods
+    PERIODIC     ///< one report each Interval, delayed by a uniform jitter
+  };
+
+  LteTrafficGenerator ();
+  virtual ~LteTrafficGenerator ();
+  static TypeId GetTypeId (void);
+
+  /**
+   * \param rnti the RNTI of the UE of the bearer
+   */
+  void SetRnti (uint16_t rnti);
+
+  /**
+   * \param lcId the logical channel of the bearer
+   */
+  void SetLcId (uint8_t lcId);
+
+  /**
+   * \param s the PDCP SAP Provider of the bearer
+   */
+  void SetLtePdcpSapProvider (LtePdcpSapProvider* s);
+
+  /**
+   * \param s the RLC SAP Provider of the bearer, used in place of the PDCP
+   *          when the BypassPdcp attribute is set
+   */
+  void SetLteRlcSapProvider (LteRlcSapProvider* s);
+
+  /**
+   * \param cb returns the number of bytes waiting in the transmission
+   *           buffer of the RLC of the bearer, needed by the full buffer
+   *           model (see LteRlc::GetTxBufferSize)
+   */
+  void SetTxBufferSizeCallback (Callback<uint32_t> cb);
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this generator. Return the number of streams (possibly zero)
+   * that have been assigned.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this generator
+   */
+  int64_t AssignStreams (int64_t stream);
+
+  /**
+   * TracedCallback signature for the generated packets.
+   *
+   * \param [in] rnti C-RNTI of the UE.
+   * \param [in] lcid Logical channel id.
+   * \param [in] size Packet size in bytes.
+   */
+  typedef void (* TxTracedCallback)
+    (uint16_t rnti, uint8_t lcid, uint32_t size);
+
+protected:
+  // inherited from Object
+  virtual void DoInitialize ();
+  virtual void DoDispose ();
+
+private:
+  /// Sends the packets due now and schedules the next generation.
+  void Generate ();
+
+  /// Sends a packet of m_packetSize bytes on the bearer.
+  void Send ();
+
+  Model m_model;
+  uint32_t m_packetSize;
+  Time m_interval;
+  Time m_onTime;
+  Time m_offTime;
+  Time m_jitter;
+  uint32_t m_fullBufferBacklog;
+  bool m_bypassPdcp;
+
+  uint16_t m_rnti;
+  uint8_t m_lcid;
+  LtePdcpSapProvider* m_pdcpSapProvider;
+  LteRlcSapProvider* m_rlcSapProvider;
+  Callback<uint32_t> m_txBufferSizeCallback; ///< backlog of the RLC (FULL_BUFFER)
+  uint16_t m_pdcpSequenceNumber; ///< next PDCP SN, used when the PDCP is bypassed
+
+  EventId m_generateEvent;
+  Time m_onPeriodEnd;       ///< end of the current on period (ON_OFF)
+  Time m_nextReport;        ///< nominal time of the next report (PERIODIC)
+
+  Ptr<ExponentialRandomVariable> m_exponential;
+  Ptr<UniformRandomVariable> m_uniform;
+
+  TracedCallback<uint16_t, uint8_t, uint32_t> m_txTrace;
+};
+
+} // namespace ns3
+
+#endif // LTE_TRAFFIC_GENERATOR_H
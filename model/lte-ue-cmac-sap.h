@@ -120,6 +120,14 @@ public:
    * 
    */
   virtual void NotifyConnectionSuccessful () = 0;  
+
+  /** 
+   * set the C-RNTI without running the random access procedure, used
+   * when the connected state is restored from a snapshot
+   * 
+   * \param rnti the C-RNTI assigned by the eNB
+   */
+  virtual void SetRnti (uint16_t rnti) = 0;
   
 };
 
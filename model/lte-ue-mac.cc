@@ -39,6 +39,7 @@
 #include <ns3/lte-control-messages.h>
 #include <ns3/simulator.h>
 #include <ns3/lte-common.h>
+#include <ns3/lte-profiler.h>
 
 
 
@@ -68,6 +69,7 @@ public:
   virtual void Reset ();
   virtual void NotifyConnectionExpired();
   virtual void NotifyConnectionSuccessful();
+  virtual void SetRnti (uint16_t rnti);
 
 private:
   LteUeMac* m_mac;
@@ -128,6 +130,12 @@ UeMemberLteUeCmacSapProvider::NotifyConnectionSuccessful ()
   m_mac->DoNotifyConnectionSuccessful ();
 }
 
+void
+UeMemberLteUeCmacSapProvider::SetRnti (uint16_t rnti)
+{
+  m_mac->DoSetRnti (rnti);
+}
+
 class UeMemberLteMacSapProvider : public LteMacSapProvider
 {
 public:
@@ -257,13 +265,10 @@ LteUeMac::LteUeMac ()
   
 {
   NS_LOG_FUNCTION (this);
-  m_miUlHarqProcessesPacket.resize (HARQ_PERIOD);
-  for (uint8_t i = 0; i < m_miUlHarqProcessesPacket.size (); i++)
+  for (uint8_t i = 0; i < HARQ_PERIOD; i++)
     {
-      Ptr<PacketBurst> pb = CreateObject <PacketBurst> ();
-      m_miUlHarqProcessesPacket.at (i) = pb;
+      m_miUlHarqProcessesPacketTimer[i] = 0;
     }
-  m_miUlHarqProcessesPacketTimer.resize (HARQ_PERIOD, 0);
    
   m_macSapProvider = new UeMemberLteMacSapProvider (this);
   m_cmacSapProvider = new UeMemberLteUeCmacSapProvider (this);
@@ -283,7 +288,10 @@ void
 LteUeMac::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
-  m_miUlHarqProcessesPacket.clear ();
+  for (uint8_t i = 0; i < HARQ_PERIOD; i++)
+    {
+      m_miUlHarqProcessesPacket[i].clear ();
+    }
   delete m_macSapProvider;
   delete m_cmacSapProvider;
   delete m_uePhySapUser;
@@ -357,15 +365,15 @@ LteUeMac::DoTransmitPdu (LteMacSapProvider::TransmitPduParameters params)
   // store pdu in HARQ buffer
   if (m_message3Ready) // tx msg3 and start contention resolution timer
     { 
-      m_miUlHarqProcessesPacket.at ((m_harqProcessId+1)%HARQ_PERIOD)->AddPacket (params.pdu);
-      m_miUlHarqProcessesPacketTimer.at ((m_harqProcessId+1)%HARQ_PERIOD) = HARQ_PERIOD;
+      m_miUlHarqProcessesPacket[(m_harqProcessId+1)%HARQ_PERIOD].push_back (params.pdu);
+      m_miUlHarqProcessesPacketTimer[(m_harqProcessId+1)%HARQ_PERIOD] = HARQ_PERIOD;
       Time contentionResolutionTimer = MilliSeconds (m_rachConfig.contentionResolutionTimer);
-      m_contentionResolutionTimeout = Simulator::Schedule (contentionResolutionTimer, &LteUeMac::ContentionResolutionTimeout, this);
+      m_contentionResolutionTimeout = LteEventProfiler::Schedule ("LteUeMac::ContentionResolutionTimeout", contentionResolutionTimer, &LteUeMac::ContentionResolutionTimeout, this);
     }
   else
     {
-      m_miUlHarqProcessesPacket.at (m_harqProcessId)->AddPacket (params.pdu);
-      m_miUlHarqProcessesPacketTimer.at (m_harqProcessId) = HARQ_PERIOD;
+      m_miUlHarqProcessesPacket[m_harqProcessId].push_back (params.pdu);
+      m_miUlHarqProcessesPacketTimer[m_harqProcessId] = HARQ_PERIOD;
     }
   m_uePhySapProvider->SendMacPdu (params.pdu);
 }
@@ -483,8 +491,8 @@ LteUeMac::SendRaPreamble (bool contention)
   // 3GPP 36.321 5.1.4 
   Time raWindowBegin = MilliSeconds (3); 
   Time raWindowEnd = MilliSeconds (3 + m_rachConfig.raResponseWindowSize);
-  Simulator::Schedule (raWindowBegin, &LteUeMac::StartWaitingForRaResponse, this);
-  m_noRaResponseReceivedEvent = Simulator::Schedule (raWindowEnd, &LteUeMac::RaResponseTimeout, this, contention);
+  LteEventProfiler::Schedule ("LteUeMac::StartWaitingForRaResponse", raWindowBegin, &LteUeMac::StartWaitingForRaResponse, this);
+  m_noRaResponseReceivedEvent = LteEventProfiler::Schedule ("LteUeMac::RaResponseTimeout", raWindowEnd, &LteUeMac::RaResponseTimeout, this, contention);
   m_rachPreambleReady = false;
 }
 
@@ -546,7 +554,7 @@ LteUeMac::RaResponseTimeout (bool contention)
       m_uePhySapProvider->DeletePrachPreamble();
       if (contention)
         {
-          m_reSendRaPreambleEvent = Simulator::Schedule (MilliSeconds(backoffInterval), &LteUeMac::RandomlySelectAndSendRaPreamble, this);
+          m_reSendRaPreambleEvent = LteEventProfiler::Schedule ("LteUeMac::RandomlySelectAndSendRaPreamble", MilliSeconds(backoffInterval), &LteUeMac::RandomlySelectAndSendRaPreamble, this);
         }
       else
         {
@@ -651,6 +659,13 @@ LteUeMac::DoNotifyConnectionSuccessful()
   m_contentionResolutionTimeout.Cancel();
 }
 
+void
+LteUeMac::DoSetRnti (uint16_t rnti)
+{
+  NS_LOG_FUNCTION (this << rnti);
+  m_rnti = rnti;
+}
+
 void
 LteUeMac::DoReceivePhyPdu (Ptr<Packet> p)
 {
@@ -683,8 +698,7 @@ LteUeMac::DoReceiveLteControlMessage (Ptr<LteControlMessage> msg)
       if (dci.m_ndi == 1)
         {
           // New transmission -> emtpy pkt buffer queue (for deleting eventual pkts not acked )
-          Ptr<PacketBurst> pb = CreateObject <PacketBurst> ();
-          m_miUlHarqProcessesPacket.at (m_harqProcessId) = pb;
+          m_miUlHarqProcessesPacket[m_harqProcessId].clear ();
           // Retrieve data from RLC
           std::map <uint8_t, LteMacSapProvider::ReportBufferStatusParameters>::iterator itBsr;
           uint16_t activeLcs = 0;
@@ -822,19 +836,20 @@ LteUeMac::DoReceiveLteControlMessage (Ptr<LteControlMessage> msg)
         {
           // HARQ retransmission -> retrieve data from HARQ buffer
           NS_LOG_INFO (this << " UE MAC RETX HARQ " << (uint16_t)m_harqProcessId << " rnti " << m_rnti);
-          Ptr<PacketBurst> pb = m_miUlHarqProcessesPacket.at (m_harqProcessId);
-          for (std::list<Ptr<Packet> >::const_iterator j = pb->Begin (); j != pb->End (); ++j)
+          // the channel copies the transmitted packets, hence the buffered
+          // ones are sent as they are
+          const std::vector < Ptr<Packet> >& pkts = m_miUlHarqProcessesPacket[m_harqProcessId];
+          for (std::vector < Ptr<Packet> >::const_iterator j = pkts.begin (); j != pkts.end (); ++j)
             {
-              Ptr<Packet> pkt = (*j)->Copy ();
-              m_uePhySapProvider->SendMacPdu (pkt);
+              m_uePhySapProvider->SendMacPdu (*j);
             }
           if (m_message3Ready) // start contention resolution timer if this is an harq of msg3
             {
               Time contentionResolutionTimer = MilliSeconds (m_rachConfig.contentionResolutionTimer);
               m_contentionResolutionTimeout.Cancel();
-              m_contentionResolutionTimeout = Simulator::Schedule (contentionResolutionTimer, &LteUeMac::ContentionResolutionTimeout, this);
+              m_contentionResolutionTimeout = LteEventProfiler::Schedule ("LteUeMac::ContentionResolutionTimeout", contentionResolutionTimer, &LteUeMac::ContentionResolutionTimeout, this);
             }
-          m_miUlHarqProcessesPacketTimer.at (m_harqProcessId) = HARQ_PERIOD;          
+          m_miUlHarqProcessesPacketTimer[m_harqProcessId] = HARQ_PERIOD;
         }
 
     }
@@ -894,7 +909,7 @@ LteUeMac::ContentionResolutionTimeout(void)
     {
       double backoffInterval = m_backoffTime->GetValue(0, backoffParameterValue[m_backoffParameter]);
       NS_LOG_INFO ("ContentionResolutionTimeout timeout, re-send preamble after backoff " << backoffInterval);
-      m_reSendRaPreambleEvent = Simulator::Schedule (MilliSeconds(backoffInterval), &LteUeMac::RandomlySelectAndSendRaPreamble, this);
+      m_reSendRaPreambleEvent = LteEventProfiler::Schedule ("LteUeMac::RandomlySelectAndSendRaPreamble", MilliSeconds(backoffInterval), &LteUeMac::RandomlySelectAndSendRaPreamble, this);
     }
 
 }
@@ -904,21 +919,20 @@ LteUeMac::RefreshHarqProcessesPacketBuffer (void)
 {
   NS_LOG_FUNCTION (this);
 
-  for (uint16_t i = 0; i < m_miUlHarqProcessesPacketTimer.size (); i++)
+  for (uint16_t i = 0; i < HARQ_PERIOD; i++)
     {
-      if (m_miUlHarqProcessesPacketTimer.at (i) == 0)
+      if (m_miUlHarqProcessesPacketTimer[i] == 0)
         {
-          if (m_miUlHarqProcessesPacket.at (i)->GetSize () > 0)
+          if (!m_miUlHarqProcessesPacket[i].empty ())
             {
               // timer expired: drop packets in buffer for this process
               NS_LOG_INFO (this << " HARQ Proc Id " << i << " packets buffer expired");
-              Ptr<PacketBurst> emptyPb = CreateObject <PacketBurst> ();
-              m_miUlHarqProcessesPacket.at (i) = emptyPb;
+              m_miUlHarqProcessesPacket[i].clear ();
             }
         }
       else
         {
-          m_miUlHarqProcessesPacketTimer.at (i)--;
+          m_miUlHarqProcessesPacketTimer[i]--;
         }
     }
 }
@@ -30,6 +30,7 @@
 
 #include <map>
 
+#include <ns3/lte-common.h>
 #include <ns3/lte-mac-sap.h>
 #include <ns3/lte-ue-cmac-sap.h>
 #include <ns3/lte-ue-phy-sap.h>
@@ -134,6 +135,7 @@ private:
   void DoReset ();
   void DoNotifyConnectionExpired ();
   void DoNotifyConnectionSuccessful();
+  void DoSetRnti (uint16_t rnti);
 
   // forwarded from PHY SAP
   void DoReceivePhyPdu (Ptr<Packet> p);
@@ -177,8 +179,8 @@ private:
   bool m_freshUlBsr; // true when a BSR has been received in the last TTI
 
   uint8_t m_harqProcessId;
-  std::vector < Ptr<PacketBurst> > m_miUlHarqProcessesPacket; // Packets under trasmission of the UL HARQ processes
-  std::vector < uint8_t > m_miUlHarqProcessesPacketTimer; // timer for packet life in the buffer
+  std::vector < Ptr<Packet> > m_miUlHarqProcessesPacket[HARQ_PERIOD]; // Packets under trasmission of the UL HARQ processes, emptied in place
+  uint8_t m_miUlHarqProcessesPacketTimer[HARQ_PERIOD]; // timer for packet life in the buffer
 
   uint16_t m_rnti;
   uint64_t  m_imsi;
@@ -48,6 +48,7 @@
 #include "lte-rrc-protocol-real.h"
 #include "lte-prach-info.h"
 #include <ns3/lte-ue-cmac-sap.h>
+#include <ns3/lte-profiler.h>
 
 
 
@@ -222,7 +223,7 @@ LteUePhy::LteUePhy (Ptr<LteSpectrumPhy> dlPhy, Ptr<LteSpectrumPhy> ulPhy)
 
   NS_ASSERT_MSG (Simulator::Now ().GetNanoSeconds () == 0,
                  "Cannot create UE devices after simulation started");
-  Simulator::Schedule (m_ueMeasurementsFilterPeriod, &LteUePhy::ReportUeMeasurements, this);
+  LteEventProfiler::Schedule ("LteUePhy::ReportUeMeasurements", m_ueMeasurementsFilterPeriod, &LteUePhy::ReportUeMeasurements, this);
 
   DoReset ();
 }
@@ -388,7 +389,7 @@ LteUePhy::DoInitialize ()
     }
   else
     {
-      Simulator::ScheduleNow (&LteUePhy::SubframeIndication, this, 1, 1);
+      LteEventProfiler::ScheduleNow ("LteUePhy::SubframeIndication", &LteUePhy::SubframeIndication, this, 1, 1);
     }  
   m_ulEarfcn = 0;
   m_dlEarfcn = 0;
@@ -624,33 +625,36 @@ LteUePhy::GenerateCqiRsrpRsrq (const SpectrumValue& sinr)
   m_rsrpSinrSampleCounter++;
   if (m_rsrpSinrSampleCounter==m_rsrpSinrSamplePeriod)
     {
-      NS_ASSERT_MSG (m_rsReceivedPowerUpdated, " RS received power info obsolete");
-      // RSRP evaluated as averaged received power among RBs
-      double sum = 0.0;
-      uint8_t rbNum = 0;
-      Values::const_iterator it;
-      for (it = m_rsReceivedPower.ConstValuesBegin (); it != m_rsReceivedPower.ConstValuesEnd (); it++)
+      if (m_traceSampler.IsSampled (m_cellId, m_rnti))
         {
-          // convert PSD [W/Hz] to linear power [W] for the single RE
-          // we consider only one RE for the RS since the channel is 
-          // flat within the same RB 
-          double powerTxW = ((*it) * 180000.0) / 12.0;
-          sum += powerTxW;
-          rbNum++;
-        }
-      double rsrp = (rbNum > 0) ? (sum / rbNum) : DBL_MAX;
-      // averaged SINR among RBs
-      sum = 0.0;
-      rbNum = 0;
-      for (it = sinr.ConstValuesBegin (); it != sinr.ConstValuesEnd (); it++)
-        {
-          sum += (*it);
-          rbNum++;
-        }
-      double avSinr = (rbNum > 0) ? (sum / rbNum) : DBL_MAX;
-      NS_LOG_INFO (this << " cellId " << m_cellId << " rnti " << m_rnti << " RSRP " << rsrp << " SINR " << avSinr);
+          NS_ASSERT_MSG (m_rsReceivedPowerUpdated, " RS received power info obsolete");
+          // RSRP evaluated as averaged received power among RBs
+          double sum = 0.0;
+          uint8_t rbNum = 0;
+          Values::const_iterator it;
+          for (it = m_rsReceivedPower.ConstValuesBegin (); it != m_rsReceivedPower.ConstValuesEnd (); it++)
+            {
+              // convert PSD [W/Hz] to linear power [W] for the single RE
+              // we consider only one RE for the RS since the channel is 
+              // flat within the same RB 
+              double powerTxW = ((*it) * 180000.0) / 12.0;
+              sum += powerTxW;
+              rbNum++;
+            }
+          double rsrp = (rbNum > 0) ? (sum / rbNum) : DBL_MAX;
+          // averaged SINR among RBs
+          sum = 0.0;
+          rbNum = 0;
+          for (it = sinr.ConstValuesBegin (); it != sinr.ConstValuesEnd (); it++)
+            {
+              sum += (*it);
+              rbNum++;
+            }
+          double avSinr = (rbNum > 0) ? (sum / rbNum) : DBL_MAX;
+          NS_LOG_INFO (this << " cellId " << m_cellId << " rnti " << m_rnti << " RSRP " << rsrp << " SINR " << avSinr);
 
-      m_reportCurrentCellRsrpSinrTrace (m_cellId, m_rnti, rsrp, avSinr);
+          m_reportCurrentCellRsrpSinrTrace (m_cellId, m_rnti, rsrp, avSinr);
+        }
       m_rsrpSinrSampleCounter = 0;
     }
 
@@ -944,7 +948,7 @@ LteUePhy::ReportUeMeasurements ()
   m_ueCphySapUser->ReportUeMeasurements (ret);
 
   m_ueMeasurementsMap.clear ();
-  Simulator::Schedule (m_ueMeasurementsFilterPeriod, &LteUePhy::ReportUeMeasurements, this);
+  LteEventProfiler::Schedule ("LteUePhy::ReportUeMeasurements", m_ueMeasurementsFilterPeriod, &LteUePhy::ReportUeMeasurements, this);
 }
 
 void
@@ -1062,19 +1066,22 @@ LteUePhy::ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> > msgLi
             }
           QueueSubChannelsForTransmission (ulRb);
           // fire trace of UL Tx PHY stats
-          HarqProcessInfoList_t harqInfoList = m_harqPhyModule->GetHarqProcessInfoUl (m_rnti, 0);
-          PhyTransmissionStatParameters params;
-          params.m_cellId = m_cellId;
-          params.m_imsi = 0; // it will be set by DlPhyTransmissionCallback in LteHelper
-          params.m_timestamp = Simulator::Now ().GetMilliSeconds () + UL_PUSCH_TTIS_DELAY;
-          params.m_rnti = m_rnti;
-          params.m_txMode = 0; // always SISO for UE
-          params.m_layer = 0;
-          params.m_mcs = dci.m_mcs;
-          params.m_size = dci.m_tbSize;
-          params.m_rv = harqInfoList.size ();
-          params.m_ndi = dci.m_ndi;
-          m_ulPhyTransmission (params);
+          if (m_traceSampler.IsSampled (m_cellId, m_rnti))
+            {
+              HarqProcessInfoList_t harqInfoList = m_harqPhyModule->GetHarqProcessInfoUl (m_rnti, 0);
+              PhyTransmissionStatParameters params;
+              params.m_cellId = m_cellId;
+              params.m_imsi = 0; // it will be set by DlPhyTransmissionCallback in LteHelper
+              params.m_timestamp = Simulator::Now ().GetMilliSeconds () + UL_PUSCH_TTIS_DELAY;
+              params.m_rnti = m_rnti;
+              params.m_txMode = 0; // always SISO for UE
+              params.m_layer = 0;
+              params.m_mcs = dci.m_mcs;
+              params.m_size = dci.m_tbSize;
+              params.m_rv = harqInfoList.size ();
+              params.m_ndi = dci.m_ndi;
+              m_ulPhyTransmission (params);
+            }
           // pass the info to the MAC
           m_uePhySapUser->ReceiveLteControlMessage (msg);
         }
@@ -1275,9 +1282,9 @@ LteUePhy::SubframeIndication (uint32_t frameNo, uint32_t subframeNo)
                   if ((((frameNo-1)*10 + (subframeNo-1)) % m_srsPeriodicity) == m_srsSubframeOffset)
                     {
                       NS_LOG_INFO ("frame " << frameNo << " subframe " << subframeNo << " sending SRS (offset=" << m_srsSubframeOffset << ", period=" << m_srsPeriodicity << ")");
-                      m_sendSrsEvent = Simulator::Schedule (UL_SRS_DELAY_FROM_SUBFRAME_START, 
-                                                            &LteUePhy::SendSrs,
-                                                            this);
+                      m_sendSrsEvent = LteEventProfiler::Schedule ("LteUePhy::SendSrs", UL_SRS_DELAY_FROM_SUBFRAME_START, 
+                                                                   &LteUePhy::SendSrs,
+                                                                   this);
                     }
                 }
 
@@ -1364,7 +1371,7 @@ LteUePhy::SubframeIndication (uint32_t frameNo, uint32_t subframeNo)
     }
 
   // schedule next subframe indication
-  Simulator::Schedule (Seconds (GetTti ()), &LteUePhy::SubframeIndication, this, frameNo, subframeNo);
+  LteEventProfiler::Schedule ("LteUePhy::SubframeIndication", Seconds (GetTti ()), &LteUePhy::SubframeIndication, this, frameNo, subframeNo);
 }
 
 
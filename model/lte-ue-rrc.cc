@@ -26,6 +26,7 @@
 #include "lte-ue-rrc.h"
 
 #include <ns3/fatal-error.h>
+#include <ns3/abort.h>
 #include <ns3/log.h>
 #include <ns3/object-map.h>
 #include <ns3/object-factory.h>
@@ -36,7 +37,9 @@
 #include <ns3/lte-rlc-um.h>
 #include <ns3/lte-rlc-am.h>
 #include <ns3/lte-pdcp.h>
+#include <ns3/lte-traffic-generator.h>
 #include <ns3/lte-radio-bearer-info.h>
+#include <ns3/lte-profiler.h>
 
 #include <cmath>
 
@@ -151,6 +154,9 @@ LteUeRrc::LteUeRrc ()
     m_rnti (0),
     m_cellId (0),
     m_useRlcSm (true),
+    m_useTrafficGenerator (false),
+    m_trafficGeneratorStream (-1),
+    m_trafficGeneratorCount (0),
     m_connectionPending (false),
     m_hasReceivedMib (false),
     m_hasReceivedSib1 (false),
@@ -218,6 +224,13 @@ LteUeRrc::GetTypeId (void)
                    TimeValue (MilliSeconds (2000)), //see 3GPP 36331 UE-TimerAndConstants
                    MakeTimeAccessor (&LteUeRrc::m_t300),
                    MakeTimeChecker ())
+    .AddAttribute ("MaxTrafficGenerators",
+                   "Number of traffic generators for which AssignStreams "
+                   "reserves streams, two each, in the order in which the "
+                   "data radio bearers are set up",
+                   UintegerValue (16),
+                   MakeUintegerAccessor (&LteUeRrc::m_maxTrafficGenerators),
+                   MakeUintegerChecker<uint32_t> (1))
     .AddTraceSource ("MibReceived",
                      "trace fired upon reception of Master Information Block",
                      MakeTraceSourceAccessor (&LteUeRrc::m_mibReceivedTrace),
@@ -409,6 +422,86 @@ LteUeRrc::SetUseRlcSm (bool val)
   m_useRlcSm = val;
 }
 
+void
+LteUeRrc::SetTrafficGeneratorFactory (ObjectFactory factory)
+{
+  NS_LOG_FUNCTION (this);
+  m_useTrafficGenerator = true;
+  m_trafficGeneratorFactory = factory;
+}
+
+int64_t
+LteUeRrc::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_trafficGeneratorStream = stream;
+  m_trafficGeneratorCount = 0;
+  return 2 * m_maxTrafficGenerators;
+}
+
+void
+LteUeRrc::AssignTrafficGeneratorStreams (Ptr<LteTrafficGenerator> generator)
+{
+  if (m_trafficGeneratorStream < 0)
+    {
+      return;
+    }
+  // a new pair of streams for each generator, so that a DRB set up again
+  // after a new connection does not replay the traffic of the previous one
+  NS_ABORT_MSG_IF (m_trafficGeneratorCount >= m_maxTrafficGenerators,
+                   "more than " << m_maxTrafficGenerators << " traffic generators in UE "
+                   << m_imsi << ", increase the MaxTrafficGenerators attribute");
+  generator->AssignStreams (m_trafficGeneratorStream + 2 * m_trafficGeneratorCount);
+  ++m_trafficGeneratorCount;
+}
+
+
+std::map <uint8_t, Ptr<LteDataRadioBearerInfo> >
+LteUeRrc::GetDataRadioBearers () const
+{
+  return m_drbMap;
+}
+
+void
+LteUeRrc::RestoreConnection (uint16_t cellId, uint16_t dlEarfcn, uint16_t rnti,
+                             LteRrcSap::MasterInformationBlock mib,
+                             LteRrcSap::SystemInformationBlockType1 sib1,
+                             LteRrcSap::SystemInformation si,
+                             LteRrcSap::RrcConnectionReconfiguration msg)
+{
+  NS_LOG_FUNCTION (this << m_imsi << cellId << rnti);
+  NS_ASSERT_MSG (m_state == IDLE_START,
+                 "cannot restore a connection from state " << ToString (m_state));
+
+  // camp on the cell as DoForceCampedOnEnb would do, then deliver the
+  // broadcast information without waiting for the next transmission
+  m_cellId = cellId;
+  m_dlEarfcn = dlEarfcn;
+  m_cphySapProvider->SynchronizeWithEnb (m_cellId, m_dlEarfcn);
+  SwitchToState (IDLE_WAIT_MIB);
+  DoRecvMasterInformationBlock (cellId, mib);
+  DoRecvSystemInformationBlockType1 (cellId, sib1);
+  DoRecvSystemInformation (si);
+  NS_ASSERT (m_state == IDLE_CAMPED_NORMALLY);
+
+  // the C-RNTI would have been delivered by the RAR
+  DoSetTemporaryCellRnti (rnti);
+  m_cmacSapProvider->SetRnti (rnti);
+
+  // as on reception of RRC CONNECTION SETUP followed by the first
+  // RRC CONNECTION RECONFIGURATION
+  SwitchToState (IDLE_CONNECTING);
+  m_lastRrcTransactionIdentifier = msg.rrcTransactionIdentifier;
+  ApplyRadioResourceConfigDedicated (msg.radioResourceConfigDedicated);
+  if (msg.haveMeasConfig)
+    {
+      ApplyMeasConfig (msg.measConfig);
+    }
+  SwitchToState (CONNECTED_NORMALLY);
+  m_cmacSapProvider->NotifyConnectionSuccessful ();
+  m_asSapUser->NotifyConnectionSuccessful ();
+  m_connectionEstablishedTrace (m_imsi, m_cellId, m_rnti);
+}
 
 void
 LteUeRrc::DoInitialize (void)
@@ -560,9 +653,9 @@ LteUeRrc::DoNotifyRarReceived ()
         LteRrcSap::RrcConnectionRequest msg;
         msg.ueIdentity = m_imsi;
         m_rrcSapUser->SendRrcConnectionRequest (msg); 
-        m_connectionTimeout = Simulator::Schedule (m_t300,
-                                                   &LteUeRrc::ConnectionTimeout,
-                                                   this);
+        m_connectionTimeout = LteEventProfiler::Schedule ("LteUeRrc::ConnectionTimeout", m_t300,
+                                                          &LteUeRrc::ConnectionTimeout,
+                                                          this);
       }
       break;
 
@@ -609,9 +702,9 @@ LteUeRrc::DoNotifyRandomAccessSuccessful ()
         LteRrcSap::RrcConnectionRequest msg;
         msg.ueIdentity = m_imsi;
         m_rrcSapUser->SendRrcConnectionRequest (msg); 
-        m_connectionTimeout = Simulator::Schedule (m_t300,
-                                                   &LteUeRrc::ConnectionTimeout,
-                                                   this);
+        m_connectionTimeout = LteEventProfiler::Schedule ("LteUeRrc::ConnectionTimeout", m_t300,
+                                                          &LteUeRrc::ConnectionTimeout,
+                                                          this);
       }
       break;
 
@@ -1006,7 +1099,7 @@ LteUeRrc::DoRecvRrcConnectionReconfiguration (LteRrcSap::RrcConnectionReconfigur
           // it's in the current stack, so we would corrupt the stack
           // if we did so. Hence we schedule it for later disposal
           m_srb1Old = m_srb1;
-          Simulator::ScheduleNow (&LteUeRrc::DisposeOldSrb1, this);
+          LteEventProfiler::ScheduleNow ("LteUeRrc::DisposeOldSrb1", &LteUeRrc::DisposeOldSrb1, this);
           m_srb1 = 0; // new instance will be be created within ApplyRadioResourceConfigDedicated
 
           m_drbMap.clear (); // dispose all DRBs
@@ -1371,6 +1464,19 @@ LteUeRrc::ApplyRadioResourceConfigDedicated (LteRrcSap::RadioResourceConfigDedic
               pdcp->SetLteRlcSapProvider (rlc->GetLteRlcSapProvider ());
               rlc->SetLteRlcSapUser (pdcp->GetLteRlcSapUser ());
               drbInfo->m_pdcp = pdcp;
+
+              if (m_useTrafficGenerator)
+                {
+                  // UL traffic generated here, started with the bearer
+                  Ptr<LteTrafficGenerator> generator = m_trafficGeneratorFactory.Create<LteTrafficGenerator> ();
+                  generator->SetRnti (m_rnti);
+                  generator->SetLcId (dtamIt->logicalChannelIdentity);
+                  generator->SetLtePdcpSapProvider (pdcp->GetLtePdcpSapProvider ());
+                  generator->SetLteRlcSapProvider (rlc->GetLteRlcSapProvider ());
+                  generator->SetTxBufferSizeCallback (MakeCallback (&LteRlc::GetTxBufferSize, rlc));
+                  AssignTrafficGeneratorStreams (generator);
+                  drbInfo->m_trafficGenerator = generator;
+                }
             }
 
           m_bid2DrbidMap[dtamIt->epsBearerIdentity] = dtamIt->drbIdentity;
@@ -1388,6 +1494,10 @@ LteUeRrc::ApplyRadioResourceConfigDedicated (LteRrcSap::RadioResourceConfigDedic
                                     lcConfig,
                                     rlc->GetLteMacSapUser ());
           rlc->Initialize ();
+          if (drbInfo->m_trafficGenerator)
+            {
+              drbInfo->m_trafficGenerator->Initialize ();
+            }
         }
       else
         {
@@ -2393,9 +2503,9 @@ LteUeRrc::MeasurementReportTriggering (uint8_t measId)
           PendingTrigger_t t;
           t.measId = measId;
           t.concernedCells = concernedCellsEntry;
-          t.timer = Simulator::Schedule (MilliSeconds (reportConfigEutra.timeToTrigger),
-                                         &LteUeRrc::VarMeasReportListAdd, this,
-                                         measId, concernedCellsEntry);
+          t.timer = LteEventProfiler::Schedule ("LteUeRrc::VarMeasReportListAdd", MilliSeconds (reportConfigEutra.timeToTrigger),
+                                                &LteUeRrc::VarMeasReportListAdd, this,
+                                                measId, concernedCellsEntry);
           std::map<uint8_t, std::list<PendingTrigger_t> >::iterator
             enteringTriggerIt = m_enteringTriggerQueue.find (measId);
           NS_ASSERT (enteringTriggerIt != m_enteringTriggerQueue.end ());
@@ -2418,9 +2528,9 @@ LteUeRrc::MeasurementReportTriggering (uint8_t measId)
           PendingTrigger_t t;
           t.measId = measId;
           t.concernedCells = concernedCellsLeaving;
-          t.timer = Simulator::Schedule (MilliSeconds (reportConfigEutra.timeToTrigger),
-                                         &LteUeRrc::VarMeasReportListErase, this,
-                                         measId, concernedCellsLeaving, reportOnLeave);
+          t.timer = LteEventProfiler::Schedule ("LteUeRrc::VarMeasReportListErase", MilliSeconds (reportConfigEutra.timeToTrigger),
+                                                &LteUeRrc::VarMeasReportListErase, this,
+                                                measId, concernedCellsLeaving, reportOnLeave);
           std::map<uint8_t, std::list<PendingTrigger_t> >::iterator
             leavingTriggerIt = m_leavingTriggerQueue.find (measId);
           NS_ASSERT (leavingTriggerIt != m_leavingTriggerQueue.end ());
@@ -2586,9 +2696,9 @@ LteUeRrc::VarMeasReportListAdd (uint8_t measId, ConcernedCells_t enteringCells)
   NS_ASSERT (!measReportIt->second.cellsTriggeredList.empty ());
   measReportIt->second.numberOfReportsSent = 0;
   measReportIt->second.periodicReportTimer
-    = Simulator::Schedule (UE_MEASUREMENT_REPORT_DELAY,
-                           &LteUeRrc::SendMeasurementReport,
-                           this, measId);
+    = LteEventProfiler::Schedule ("LteUeRrc::SendMeasurementReport", UE_MEASUREMENT_REPORT_DELAY,
+                                  &LteUeRrc::SendMeasurementReport,
+                                  this, measId);
 
   std::map<uint8_t, std::list<PendingTrigger_t> >::iterator
     enteringTriggerIt = m_enteringTriggerQueue.find (measId);
@@ -2850,9 +2960,9 @@ LteUeRrc::SendMeasurementReport (uint8_t measId)
 
       // schedule the next measurement reporting
       measReportIt->second.periodicReportTimer 
-        = Simulator::Schedule (reportInterval,
-                               &LteUeRrc::SendMeasurementReport,
-                               this, measId);
+        = LteEventProfiler::Schedule ("LteUeRrc::SendMeasurementReport", reportInterval,
+                                      &LteUeRrc::SendMeasurementReport,
+                                      this, measId);
 
       // send the measurement report to eNodeB
       m_rrcSapUser->SendMeasurementReport (measurementReport);
@@ -27,6 +27,7 @@
 #define LTE_UE_RRC_H
 
 #include <ns3/object.h>
+#include <ns3/object-factory.h>
 #include <ns3/packet.h>
 #include <ns3/lte-ue-cmac-sap.h>
 #include <ns3/lte-pdcp-sap.h>
@@ -65,6 +66,7 @@ class LteMacSapProvider;
 class LteUeCmacSapUser;
 class LteUeCmacSapProvider;
 class LteDataRadioBearerInfo;
+class LteTrafficGenerator;
 class LteSignalingRadioBearerInfo;
 
 /**
@@ -250,6 +252,52 @@ public:
    */
   void SetUseRlcSm (bool val);
 
+  /** 
+   * Attach a traffic generator, created by the given factory, to each data
+   * radio bearer set up from now on (see LteTrafficGenerator).
+   * 
+   * \param factory the factory of ns3::LteTrafficGenerator objects
+   */
+  void SetTrafficGeneratorFactory (ObjectFactory factory);
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * of the traffic generators set up from now on: each new generator
+   * takes the next two streams of a block sized by the
+   * MaxTrafficGenerators attribute.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices (possibly) assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+  /**
+   * \return the data radio bearers currently configured, indexed by DRBID
+   */
+  std::map <uint8_t, Ptr<LteDataRadioBearerInfo> > GetDataRadioBearers () const;
+
+  /**
+   * Enter CONNECTED_NORMALLY directly from IDLE_START, skipping cell
+   * search, random access and RRC connection establishment. The
+   * broadcast information and the dedicated configuration are the ones
+   * a regular attach to the same cell would have delivered; they are
+   * applied through the same code paths used on reception of the
+   * corresponding messages.
+   *
+   * \param cellId the serving cell
+   * \param dlEarfcn the DL carrier frequency of the serving cell
+   * \param rnti the C-RNTI assigned by the serving cell
+   * \param mib the MIB of the serving cell
+   * \param sib1 the SIB1 of the serving cell
+   * \param si the System Information (SIB2) of the serving cell
+   * \param msg the configuration returned by LteEnbRrc::RestoreUe
+   */
+  void RestoreConnection (uint16_t cellId, uint16_t dlEarfcn, uint16_t rnti,
+                          LteRrcSap::MasterInformationBlock mib,
+                          LteRrcSap::SystemInformationBlockType1 sib1,
+                          LteRrcSap::SystemInformation si,
+                          LteRrcSap::RrcConnectionReconfiguration msg);
+
 
   /**
    * TracedCallback signature for imsi, cellId and rnti events.
@@ -585,6 +633,25 @@ private:
    */
   bool m_useRlcSm;
 
+  /**
+   * Give the next two streams reserved by AssignStreams to a new traffic
+   * generator, if AssignStreams was called.
+   *
+   * \param generator the traffic generator
+   */
+  void AssignTrafficGeneratorStreams (Ptr<LteTrafficGenerator> generator);
+
+  /// True if a traffic generator is attached to each data radio bearer.
+  bool m_useTrafficGenerator;
+  /// Factory of the traffic generators of the data radio bearers.
+  ObjectFactory m_trafficGeneratorFactory;
+  /// First stream of the traffic generators, or -1 if not assigned.
+  int64_t m_trafficGeneratorStream;
+  /// Number of traffic generators given streams since AssignStreams.
+  uint32_t m_trafficGeneratorCount;
+  /// The `MaxTrafficGenerators` attribute.
+  uint32_t m_maxTrafficGenerators;
+
   uint8_t m_lastRrcTransactionIdentifier;
 
   LteRrcSap::PdschConfigDedicated m_pdschConfigDedicated;
@@ -30,10 +30,7 @@
 #include <ns3/nstime.h>
 #include <ns3/lte-amc.h>
 #include <ns3/lte-ffr-sap.h>
-
-// value for SINR outside the range defined by FF-API, used to indicate that there
-// is no CQI for this element
-#define NO_SINR -5000
+#include <ns3/ff-mac-ul-sinr-cache.h>
 
 
 #define HARQ_PROC_NUM 8
@@ -150,8 +147,6 @@ private:
 
   int LcActivePerFlow (uint16_t rnti);
 
-  double EstimateUlSinr (uint16_t rnti, uint16_t rb);
-
   void RefreshDlCqiMaps (void);
   void RefreshUlCqiMaps (void);
 
@@ -224,13 +219,9 @@ private:
   std::map <uint16_t, std::vector <uint16_t> > m_allocationMaps;
 
   /*
-  * Map of UEs' UL-CQI per RBG
-  */
-  std::map <uint16_t, std::vector <double> > m_ueCqi;
-  /*
-  * Map of UEs' timers on UL-CQI per RBG
+  * UEs' UL-CQI per RB, with the time of their last report
   */
-  std::map <uint16_t, uint32_t> m_ueCqiTimers;
+  FfMacUlSinrCache m_ulSinrCache;
 
   /*
   * Map of UE's buffer status reports received
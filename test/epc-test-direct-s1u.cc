@@ -0,0 +1,313 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/point-to-point-epc-helper.h"
+#include "ns3/epc-enb-application.h"
+#include "ns3/epc-sgw-pgw-application.h"
+#include "ns3/epc-enb-s1-sap.h"
+#include "ns3/epc-gtpu-header.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/udp-echo-helper.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/csma-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/udp-header.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/packet-sink.h"
+#include <ns3/ipv4-static-routing-helper.h>
+#include <ns3/ipv4-static-routing.h>
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/eps-bearer.h"
+
+#include <map>
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("EpcTestDirectS1u");
+
+/// UDP port of GTP-U, fixed by the standard
+static const uint16_t GTPU_PORT = 2152;
+
+/**
+ * eNB RRC stub recording the TEID of the bearer set up for each RNTI
+ */
+class EpcTestTeidRecorder : public EpcEnbS1SapUser
+{
+public:
+  virtual void DataRadioBearerSetupRequest (DataRadioBearerSetupRequestParameters params);
+  virtual void PathSwitchRequestAcknowledge (PathSwitchRequestAcknowledgeParameters params);
+
+  std::map<uint16_t, uint32_t> m_teidByRnti;
+};
+
+void
+EpcTestTeidRecorder::DataRadioBearerSetupRequest (DataRadioBearerSetupRequestParameters params)
+{
+  m_teidByRnti[params.rnti] = params.gtpTeid;
+}
+
+void
+EpcTestTeidRecorder::PathSwitchRequestAcknowledge (PathSwitchRequestAcknowledgeParameters params)
+{
+}
+
+
+/**
+ * Sends downlink packets from a remote host to the UEs of an eNB, with
+ * a CSMA cell standing for the radio interface as in the
+ * epc-s1u-downlink test, with and without the DirectS1uDelivery
+ * attribute of the SGW/PGW. Checks that the UEs receive all the bytes
+ * sent, hence that the eNB removed the GTP-U header, and that each
+ * GTP-U packet received by the eNB carries the TEID of the bearer of
+ * its destination UE. Also checks that the SGW/PGW sends the GTP-U
+ * packets through its S1-U socket only without DirectS1uDelivery or
+ * when they exceed the S1-U MTU.
+ */
+class EpcDirectS1uTestCase : public TestCase
+{
+public:
+  EpcDirectS1uTestCase (bool directS1uDelivery, uint32_t pktSize);
+  virtual ~EpcDirectS1uTestCase ();
+
+private:
+  static std::string BuildNameString (bool directS1uDelivery, uint32_t pktSize);
+  virtual void DoRun (void);
+
+  /**
+   * trace sink of the IPv4 packets received by the eNB
+   */
+  void EnbIpv4Rx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface);
+
+  /**
+   * trace sink of the IPv4 packets sent by the SGW/PGW
+   */
+  void SgwIpv4Tx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface);
+
+  bool m_directS1uDelivery;
+  uint32_t m_pktSize;
+  std::map<uint32_t, uint32_t> m_teidByUeAddr;
+  uint32_t m_enbGtpuRxPackets;
+  uint32_t m_wrongTeidPackets;
+  uint32_t m_sgwGtpuTxPackets;
+};
+
+std::string
+EpcDirectS1uTestCase::BuildNameString (bool directS1uDelivery, uint32_t pktSize)
+{
+  std::ostringstream oss;
+  oss << (directS1uDelivery ? "direct" : "socket") << " S1-U delivery, " << pktSize << " bytes";
+  return oss.str ();
+}
+
+EpcDirectS1uTestCase::EpcDirectS1uTestCase (bool directS1uDelivery, uint32_t pktSize)
+  : TestCase (BuildNameString (directS1uDelivery, pktSize)),
+    m_directS1uDelivery (directS1uDelivery),
+    m_pktSize (pktSize),
+    m_enbGtpuRxPackets (0),
+    m_wrongTeidPackets (0),
+    m_sgwGtpuTxPackets (0)
+{
+}
+
+EpcDirectS1uTestCase::~EpcDirectS1uTestCase ()
+{
+}
+
+void
+EpcDirectS1uTestCase::EnbIpv4Rx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  Ptr<Packet> packet = p->Copy ();
+  Ipv4Header ipv4Header;
+  packet->RemoveHeader (ipv4Header);
+  if ((ipv4Header.GetProtocol () != 17) || (ipv4Header.GetFragmentOffset () != 0))
+    {
+      return;
+    }
+  UdpHeader udpHeader;
+  packet->RemoveHeader (udpHeader);
+  if (udpHeader.GetDestinationPort () != GTPU_PORT)
+    {
+      return;
+    }
+  GtpuHeader gtpu;
+  packet->RemoveHeader (gtpu);
+  Ipv4Header innerHeader;
+  packet->PeekHeader (innerHeader);
+  ++m_enbGtpuRxPackets;
+  std::map<uint32_t, uint32_t>::const_iterator it = m_teidByUeAddr.find (innerHeader.GetDestination ().Get ());
+  if ((it == m_teidByUeAddr.end ()) || (it->second != gtpu.GetTeid ()))
+    {
+      NS_LOG_WARN ("TEID " << gtpu.GetTeid () << " for UE " << innerHeader.GetDestination ());
+      ++m_wrongTeidPackets;
+    }
+}
+
+void
+EpcDirectS1uTestCase::SgwIpv4Tx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  Ptr<Packet> packet = p->Copy ();
+  Ipv4Header ipv4Header;
+  packet->RemoveHeader (ipv4Header);
+  if ((ipv4Header.GetProtocol () != 17) || (ipv4Header.GetFragmentOffset () != 0))
+    {
+      return;
+    }
+  UdpHeader udpHeader;
+  packet->PeekHeader (udpHeader);
+  if (udpHeader.GetDestinationPort () == GTPU_PORT)
+    {
+      ++m_sgwGtpuTxPackets;
+    }
+}
+
+void
+EpcDirectS1uTestCase::DoRun ()
+{
+  const uint32_t nUes = 3;
+  const uint32_t numPkts = 5;
+  const uint32_t s1uMtu = 2000;
+  // UDP/IP headers of the packet, GTP-U and UDP/IP tunneling headers
+  const uint32_t s1uOverhead = 28 + 8 + 28;
+
+  Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper> ();
+  epcHelper->SetAttribute ("S1uLinkMtu", UintegerValue (s1uMtu));
+  Ptr<Node> pgw = epcHelper->GetPgwNode ();
+  Ptr<EpcSgwPgwApplication> sgwPgwApp = pgw->GetApplication (0)->GetObject<EpcSgwPgwApplication> ();
+  NS_ASSERT_MSG (sgwPgwApp != 0, "cannot retrieve EpcSgwPgwApplication");
+  sgwPgwApp->SetAttribute ("DirectS1uDelivery", BooleanValue (m_directS1uDelivery));
+  pgw->GetObject<Ipv4L3Protocol> ()->TraceConnectWithoutContext ("Tx", MakeCallback (&EpcDirectS1uTestCase::SgwIpv4Tx, this));
+
+  NodeContainer remoteHostContainer;
+  remoteHostContainer.Create (1);
+  Ptr<Node> remoteHost = remoteHostContainer.Get (0);
+  InternetStackHelper internet;
+  internet.Install (remoteHostContainer);
+
+  // packets larger than the S1-U MTU go through the remote host link
+  // and the cell
+  PointToPointHelper p2ph;
+  p2ph.SetDeviceAttribute ("DataRate",  DataRateValue (DataRate ("100Gb/s")));
+  p2ph.SetDeviceAttribute ("Mtu", UintegerValue (30000));
+  NetDeviceContainer internetDevices = p2ph.Install (pgw, remoteHost);
+  Ipv4AddressHelper ipv4h;
+  ipv4h.SetBase ("1.0.0.0", "255.0.0.0");
+  ipv4h.Assign (internetDevices);
+
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  Ptr<Ipv4StaticRouting> remoteHostStaticRouting = ipv4RoutingHelper.GetStaticRouting (remoteHost->GetObject<Ipv4> ());
+  remoteHostStaticRouting->AddNetworkRouteTo (Ipv4Address ("7.0.0.0"), Ipv4Mask ("255.255.255.0"), 1);
+
+  Ptr<Node> enb = CreateObject<Node> ();
+  NodeContainer ues;
+  ues.Create (nUes);
+  NodeContainer cell;
+  cell.Add (ues);
+  cell.Add (enb);
+  CsmaHelper csmaCell;
+  csmaCell.SetDeviceAttribute ("Mtu", UintegerValue (30000));
+  NetDeviceContainer cellDevices = csmaCell.Install (cell);
+  epcHelper->AddEnb (enb, cellDevices.Get (cellDevices.GetN () - 1), 1);
+  enb->GetObject<Ipv4L3Protocol> ()->TraceConnectWithoutContext ("Rx", MakeCallback (&EpcDirectS1uTestCase::EnbIpv4Rx, this));
+
+  Ptr<EpcEnbApplication> enbApp = enb->GetApplication (0)->GetObject<EpcEnbApplication> ();
+  NS_ASSERT_MSG (enbApp != 0, "cannot retrieve EpcEnbApplication");
+  EpcTestTeidRecorder rrc;
+  enbApp->SetS1SapUser (&rrc);
+
+  internet.Install (ues);
+  std::vector<Ptr<PacketSink> > sinks;
+  for (uint32_t u = 0; u < nUes; ++u)
+    {
+      Ptr<NetDevice> ueLteDevice = cellDevices.Get (u);
+      Ipv4InterfaceContainer ueIpIface = epcHelper->AssignUeIpv4Address (NetDeviceContainer (ueLteDevice));
+      Ptr<Node> ue = ues.Get (u);
+      ue->GetObject<Ipv4> ()->SetAttribute ("IpForward", BooleanValue (false));
+
+      uint16_t port = 1234;
+      PacketSinkHelper packetSinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+      ApplicationContainer apps = packetSinkHelper.Install (ue);
+      apps.Start (Seconds (1.0));
+      apps.Stop (Seconds (10.0));
+      sinks.push_back (apps.Get (0)->GetObject<PacketSink> ());
+
+      UdpEchoClientHelper client (ueIpIface.GetAddress (0), port);
+      client.SetAttribute ("MaxPackets", UintegerValue (numPkts));
+      client.SetAttribute ("Interval", TimeValue (Seconds (0.01)));
+      client.SetAttribute ("PacketSize", UintegerValue (m_pktSize));
+      apps = client.Install (remoteHost);
+      apps.Start (Seconds (2.0));
+      apps.Stop (Seconds (10.0));
+
+      uint64_t imsi = u + 1;
+      uint16_t rnti = u + 1;
+      epcHelper->AddUe (ueLteDevice, imsi);
+      epcHelper->ActivateEpsBearer (ueLteDevice, imsi, EpcTft::Default (), EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+      enbApp->GetS1SapProvider ()->InitialUeMessage (imsi, rnti);
+      NS_TEST_ASSERT_MSG_EQ (rrc.m_teidByRnti.count (rnti), 1U, "no bearer set up for RNTI " << rnti);
+      m_teidByUeAddr[ueIpIface.GetAddress (0).Get ()] = rrc.m_teidByRnti[rnti];
+    }
+
+  Simulator::Run ();
+
+  for (uint32_t u = 0; u < nUes; ++u)
+    {
+      NS_TEST_ASSERT_MSG_EQ (sinks[u]->GetTotalRx (), numPkts * m_pktSize,
+                             "wrong total received bytes, UE " << u + 1);
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_enbGtpuRxPackets, nUes * numPkts, "wrong number of GTP-U packets received by the eNB");
+  NS_TEST_ASSERT_MSG_EQ (m_wrongTeidPackets, 0U, "GTP-U packets received by the eNB with a wrong TEID");
+
+  uint32_t expectedSocketPackets = nUes * numPkts;
+  if (m_directS1uDelivery && (m_pktSize + s1uOverhead <= s1uMtu))
+    {
+      expectedSocketPackets = 0;
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_sgwGtpuTxPackets, expectedSocketPackets,
+                         "wrong number of GTP-U packets sent through the S1-U socket");
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * Test suite of the DirectS1uDelivery attribute of EpcSgwPgwApplication
+ */
+class EpcDirectS1uTestSuite : public TestSuite
+{
+public:
+  EpcDirectS1uTestSuite ();
+};
+
+EpcDirectS1uTestSuite::EpcDirectS1uTestSuite ()
+  : TestSuite ("epc-direct-s1u-delivery", SYSTEM)
+{
+  AddTestCase (new EpcDirectS1uTestCase (false, 100), TestCase::QUICK);
+  AddTestCase (new EpcDirectS1uTestCase (true, 100), TestCase::QUICK);
+  AddTestCase (new EpcDirectS1uTestCase (true, 1400), TestCase::QUICK);
+  // beyond the S1-U MTU of 2000 bytes, the packets are sent through the
+  // socket and fragmented by the IP stack of the SGW/PGW
+  AddTestCase (new EpcDirectS1uTestCase (true, 3000), TestCase::QUICK);
+}
+
+static EpcDirectS1uTestSuite g_epcDirectS1uTestSuite;
@@ -0,0 +1,220 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/point-to-point-epc-helper.h"
+#include "ns3/epc-enb-application.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/udp-echo-helper.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/csma-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/packet-sink.h"
+#include <ns3/ipv4-static-routing-helper.h>
+#include <ns3/ipv4-static-routing.h>
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/eps-bearer.h"
+#include "lte-test-entities.h"
+
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("EpcTestEnbApplication");
+
+/**
+ * Sends downlink packets to the UEs of several eNBs, as in the
+ * epc-s1u-downlink test, with the bearers activated in turn on each eNB
+ * so that the TEIDs allocated by the SGW to an eNB are not contiguous.
+ * The UE context of the first UE of each eNB is released before the
+ * traffic starts: its packets must be discarded by the eNB, while the
+ * other UEs receive all of theirs. The packets counted by the downlink
+ * processing statistics of each eNB are checked as well.
+ */
+class EpcEnbApplicationTestCase : public TestCase
+{
+public:
+  EpcEnbApplicationTestCase (uint32_t nEnbs, uint32_t nUes);
+  virtual ~EpcEnbApplicationTestCase ();
+
+private:
+  static std::string BuildNameString (uint32_t nEnbs, uint32_t nUes);
+  virtual void DoRun (void);
+
+  uint32_t m_nEnbs;
+  uint32_t m_nUes;
+};
+
+std::string
+EpcEnbApplicationTestCase::BuildNameString (uint32_t nEnbs, uint32_t nUes)
+{
+  std::ostringstream oss;
+  oss << nEnbs << " eNBs, " << nUes << " UEs each, first UE released";
+  return oss.str ();
+}
+
+EpcEnbApplicationTestCase::EpcEnbApplicationTestCase (uint32_t nEnbs, uint32_t nUes)
+  : TestCase (BuildNameString (nEnbs, nUes)),
+    m_nEnbs (nEnbs),
+    m_nUes (nUes)
+{
+}
+
+EpcEnbApplicationTestCase::~EpcEnbApplicationTestCase ()
+{
+}
+
+void
+EpcEnbApplicationTestCase::DoRun ()
+{
+  const uint32_t numPkts = 5;
+  const uint32_t pktSize = 200;
+
+  Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper> ();
+  Ptr<Node> pgw = epcHelper->GetPgwNode ();
+
+  NodeContainer remoteHostContainer;
+  remoteHostContainer.Create (1);
+  Ptr<Node> remoteHost = remoteHostContainer.Get (0);
+  InternetStackHelper internet;
+  internet.Install (remoteHostContainer);
+
+  PointToPointHelper p2ph;
+  p2ph.SetDeviceAttribute ("DataRate",  DataRateValue (DataRate ("100Gb/s")));
+  NetDeviceContainer internetDevices = p2ph.Install (pgw, remoteHost);
+  Ipv4AddressHelper ipv4h;
+  ipv4h.SetBase ("1.0.0.0", "255.0.0.0");
+  ipv4h.Assign (internetDevices);
+
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  Ptr<Ipv4StaticRouting> remoteHostStaticRouting = ipv4RoutingHelper.GetStaticRouting (remoteHost->GetObject<Ipv4> ());
+  remoteHostStaticRouting->AddNetworkRouteTo (Ipv4Address ("7.0.0.0"), Ipv4Mask ("255.255.255.0"), 1);
+
+  // as in the epc-s1u-downlink test, a CSMA network simulates each cell
+  // and the CSMA device of the eNB stands for its LTE device
+  std::vector<Ptr<EpcEnbApplication> > enbApps;
+  std::vector<NetDeviceContainer> cellDevices;
+  std::vector<NodeContainer> ues;
+  std::vector<Ptr<EpcTestRrc> > rrcs;
+  for (uint32_t e = 0; e < m_nEnbs; ++e)
+    {
+      Ptr<Node> enb = CreateObject<Node> ();
+      NodeContainer cellUes;
+      cellUes.Create (m_nUes);
+      NodeContainer cell;
+      cell.Add (cellUes);
+      cell.Add (enb);
+      CsmaHelper csmaCell;
+      NetDeviceContainer devices = csmaCell.Install (cell);
+      epcHelper->AddEnb (enb, devices.Get (devices.GetN () - 1), e + 1);
+
+      Ptr<EpcEnbApplication> enbApp = enb->GetApplication (0)->GetObject<EpcEnbApplication> ();
+      NS_ASSERT_MSG (enbApp != 0, "cannot retrieve EpcEnbApplication");
+      enbApp->SetAttribute ("EnablePacketTiming", BooleanValue (true));
+      Ptr<EpcTestRrc> rrc = CreateObject<EpcTestRrc> ();
+      rrc->SetS1SapProvider (enbApp->GetS1SapProvider ());
+      enbApp->SetS1SapUser (rrc->GetS1SapUser ());
+
+      internet.Install (cellUes);
+      enbApps.push_back (enbApp);
+      cellDevices.push_back (devices);
+      ues.push_back (cellUes);
+      rrcs.push_back (rrc);
+    }
+
+  // the bearers are activated in turn on each eNB, so that the TEIDs of
+  // an eNB are interleaved with those of the others
+  std::vector<std::vector<Ptr<PacketSink> > > sinks (m_nEnbs);
+  for (uint32_t u = 0; u < m_nUes; ++u)
+    {
+      for (uint32_t e = 0; e < m_nEnbs; ++e)
+        {
+          Ptr<NetDevice> ueLteDevice = cellDevices[e].Get (u);
+          Ipv4InterfaceContainer ueIpIface = epcHelper->AssignUeIpv4Address (NetDeviceContainer (ueLteDevice));
+          Ptr<Node> ue = ues[e].Get (u);
+          ue->GetObject<Ipv4> ()->SetAttribute ("IpForward", BooleanValue (false));
+
+          uint16_t port = 1234;
+          PacketSinkHelper packetSinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+          ApplicationContainer apps = packetSinkHelper.Install (ue);
+          apps.Start (Seconds (1.0));
+          apps.Stop (Seconds (10.0));
+          sinks[e].push_back (apps.Get (0)->GetObject<PacketSink> ());
+
+          UdpEchoClientHelper client (ueIpIface.GetAddress (0), port);
+          client.SetAttribute ("MaxPackets", UintegerValue (numPkts));
+          client.SetAttribute ("Interval", TimeValue (Seconds (0.01)));
+          client.SetAttribute ("PacketSize", UintegerValue (pktSize));
+          apps = client.Install (remoteHost);
+          apps.Start (Seconds (2.0));
+          apps.Stop (Seconds (10.0));
+
+          uint64_t imsi = e * m_nUes + u + 1;
+          uint16_t rnti = u + 1;
+          epcHelper->AddUe (ueLteDevice, imsi);
+          epcHelper->ActivateEpsBearer (ueLteDevice, imsi, EpcTft::Default (), EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+          enbApps[e]->GetS1SapProvider ()->InitialUeMessage (imsi, rnti);
+        }
+    }
+
+  for (uint32_t e = 0; e < m_nEnbs; ++e)
+    {
+      Simulator::Schedule (Seconds (1.5), &EpcEnbS1SapProvider::UeContextRelease,
+                           enbApps[e]->GetS1SapProvider (), 1);
+    }
+
+  Simulator::Run ();
+
+  for (uint32_t e = 0; e < m_nEnbs; ++e)
+    {
+      NS_TEST_ASSERT_MSG_EQ (sinks[e][0]->GetTotalRx (), 0U,
+                             "packets delivered to a released UE of eNB " << e + 1);
+      for (uint32_t u = 1; u < m_nUes; ++u)
+        {
+          NS_TEST_ASSERT_MSG_EQ (sinks[e][u]->GetTotalRx (), numPkts * pktSize,
+                                 "wrong total received bytes, eNB " << e + 1 << " UE " << u + 1);
+        }
+      // the discarded packets are counted as well
+      NS_TEST_ASSERT_MSG_EQ (enbApps[e]->GetDlPacketProcessingStats ().packets, (uint64_t) m_nUes * numPkts,
+                             "wrong number of DL packets processed by eNB " << e + 1);
+    }
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * Test suite of the TEID handling of EpcEnbApplication
+ */
+class EpcEnbApplicationTestSuite : public TestSuite
+{
+public:
+  EpcEnbApplicationTestSuite ();
+};
+
+EpcEnbApplicationTestSuite::EpcEnbApplicationTestSuite ()
+  : TestSuite ("epc-enb-application", SYSTEM)
+{
+  AddTestCase (new EpcEnbApplicationTestCase (1, 2), TestCase::QUICK);
+  AddTestCase (new EpcEnbApplicationTestCase (3, 3), TestCase::QUICK);
+}
+
+static EpcEnbApplicationTestSuite g_epcEnbApplicationTestSuite;
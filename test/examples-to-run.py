@@ -26,6 +26,8 @@ cpp_examples = [
     ("lena-profiling", "True", "True"),
     ("lena-profiling --simTime=0.1 --nUe=2 --nEnb=5 --nFloors=0", "True", "True"),
     ("lena-profiling --simTime=0.1 --nUe=3 --nEnb=6 --nFloors=1", "True", "True"),
+    ("lena-rach-benchmark --nUe=20 --nEnb=2 --simTime=0.5 --accessWindow=0.2 --outputFile=/dev/null", "True", "True"),
+    ("lena-rach-benchmark --nUe=20 --useIdealRrc=1 --useIdealPrach=1 --simTime=0.5 --accessWindow=0.2 --outputFile=/dev/null", "True", "True"),
     ("lena-rlc-traces", "True", "True"),
     ("lena-rem", "True", "True"),
     ("lena-rem-sector-antenna", "True", "True"),
@@ -0,0 +1,155 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/position-allocator.h"
+#include "ns3/lte-helper.h"
+#include "ns3/lte-ue-net-device.h"
+#include "ns3/lte-enb-net-device.h"
+
+#include <limits>
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteBulkAttachTest");
+
+/**
+ * Attaches UEs placed at random, some of them outside the area of the
+ * eNBs, with LteHelper::BulkAttach and checks that each UE gets the same
+ * eNB as a linear scan of the eNBs for the closest one, whatever the
+ * number of lookup threads.
+ */
+class LteBulkAttachTestCase : public TestCase
+{
+public:
+  LteBulkAttachTestCase (uint32_t nEnbs, uint32_t nUes, uint32_t nThreads);
+  virtual ~LteBulkAttachTestCase ();
+
+private:
+  static std::string BuildNameString (uint32_t nEnbs, uint32_t nUes, uint32_t nThreads);
+  virtual void DoRun (void);
+
+  uint32_t m_nEnbs;
+  uint32_t m_nUes;
+  uint32_t m_nThreads;
+};
+
+std::string
+LteBulkAttachTestCase::BuildNameString (uint32_t nEnbs, uint32_t nUes, uint32_t nThreads)
+{
+  std::ostringstream oss;
+  oss << "BulkAttach vs. closest eNB scan, " << nEnbs << " eNBs, " << nUes << " UEs, "
+      << nThreads << " threads";
+  return oss.str ();
+}
+
+LteBulkAttachTestCase::LteBulkAttachTestCase (uint32_t nEnbs, uint32_t nUes, uint32_t nThreads)
+  : TestCase (BuildNameString (nEnbs, nUes, nThreads)),
+    m_nEnbs (nEnbs),
+    m_nUes (nUes),
+    m_nThreads (nThreads)
+{
+}
+
+LteBulkAttachTestCase::~LteBulkAttachTestCase ()
+{
+}
+
+void
+LteBulkAttachTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable> ();
+  x->SetStream (1);
+
+  // eNBs in a 2 km x 1 km area, UEs up to 500 m outside of it
+  Ptr<ListPositionAllocator> enbPositions = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < m_nEnbs; ++i)
+    {
+      enbPositions->Add (Vector (x->GetValue (0, 2000), x->GetValue (0, 1000), 30));
+    }
+  Ptr<ListPositionAllocator> uePositions = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < m_nUes; ++i)
+    {
+      uePositions->Add (Vector (x->GetValue (-500, 2500), x->GetValue (-500, 1500), 1.5));
+    }
+
+  NodeContainer enbNodes;
+  enbNodes.Create (m_nEnbs);
+  NodeContainer ueNodes;
+  ueNodes.Create (m_nUes);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (enbPositions);
+  mobility.Install (enbNodes);
+  mobility.SetPositionAllocator (uePositions);
+  mobility.Install (ueNodes);
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("BulkAttachThreads", UintegerValue (m_nThreads));
+  NetDeviceContainer enbDevices = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevices = lteHelper->InstallUeDevice (ueNodes);
+  lteHelper->BulkAttach (ueDevices, enbDevices, LteHelper::CLOSEST_ENB);
+
+  for (uint32_t i = 0; i < m_nUes; ++i)
+    {
+      Vector uePos = ueNodes.Get (i)->GetObject<MobilityModel> ()->GetPosition ();
+      double minDistance = std::numeric_limits<double>::infinity ();
+      Ptr<NetDevice> closestEnbDevice;
+      for (uint32_t j = 0; j < m_nEnbs; ++j)
+        {
+          Vector enbPos = enbNodes.Get (j)->GetObject<MobilityModel> ()->GetPosition ();
+          double distance = CalculateDistance (uePos, enbPos);
+          if (distance < minDistance)
+            {
+              minDistance = distance;
+              closestEnbDevice = enbDevices.Get (j);
+            }
+        }
+      Ptr<LteEnbNetDevice> targetEnb = ueDevices.Get (i)->GetObject<LteUeNetDevice> ()->GetTargetEnb ();
+      NS_TEST_ASSERT_MSG_EQ ((targetEnb == closestEnbDevice->GetObject<LteEnbNetDevice> ()), true,
+                             "UE " << i << " at " << uePos << " not attached to the closest eNB");
+    }
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * Test suite of the attachment of many UEs by LteHelper::BulkAttach
+ */
+class LteBulkAttachTestSuite : public TestSuite
+{
+public:
+  LteBulkAttachTestSuite ();
+};
+
+LteBulkAttachTestSuite::LteBulkAttachTestSuite ()
+  : TestSuite ("lte-bulk-attach", SYSTEM)
+{
+  AddTestCase (new LteBulkAttachTestCase (20, 300, 1), TestCase::QUICK);
+  // more than a thousand UEs per thread, for the lookups to be split
+  AddTestCase (new LteBulkAttachTestCase (50, 3000, 3), TestCase::EXTENSIVE);
+}
+
+static LteBulkAttachTestSuite g_lteBulkAttachTestSuite;
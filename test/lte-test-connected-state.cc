@@ -0,0 +1,306 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/position-allocator.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/udp-client-server-helper.h"
+#include "ns3/lte-helper.h"
+#include "ns3/point-to-point-epc-helper.h"
+#include "ns3/lte-enb-net-device.h"
+#include "ns3/lte-ue-net-device.h"
+#include "ns3/lte-enb-rrc.h"
+#include "ns3/lte-ue-rrc.h"
+#include "ns3/lte-rlc.h"
+#include "ns3/lte-pdcp.h"
+#include "ns3/lte-radio-bearer-info.h"
+#include "ns3/epc-ue-nas.h"
+#include "ns3/epc-tft.h"
+
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteConnectedStateTest");
+
+/**
+ * Saves the connected state of UEs with a default and a dedicated GBR
+ * bearer, after some uplink traffic on the latter, restores it in a new
+ * simulation of the same scenario and checks that the UEs end up with
+ * the same RRC state, the same SRS configuration index, the same bearers
+ * (identities, QoS, TFTs and TEIDs) and the same RLC types and PDCP
+ * sequence numbers at the UE and at the eNB as in the original
+ * simulation, and that the eNB resumes the RNTI allocation where it was.
+ */
+class LteConnectedStateTestCase : public TestCase
+{
+public:
+  LteConnectedStateTestCase ();
+  virtual ~LteConnectedStateTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Build the scenario and connect the UEs, either with Attach and the
+   * activation of the dedicated bearers or from the snapshot.
+   *
+   * \param restore true to restore the UEs from the snapshot
+   * \param fileName the name of the snapshot file
+   * \param run index of the run, where the state of the UEs is stored
+   * \param captureTime time at which the state of the UEs is stored
+   */
+  void RunScenario (bool restore, std::string fileName, uint32_t run, Time captureTime);
+
+  /**
+   * Store a description of the state of the UEs
+   *
+   * \param ueDevices the UE devices
+   * \param enbDevices the eNB devices
+   * \param run index of the run
+   */
+  void Capture (NetDeviceContainer ueDevices, NetDeviceContainer enbDevices, uint32_t run);
+
+  /// state of each UE, in each run
+  std::vector<std::string> m_states[2];
+};
+
+LteConnectedStateTestCase::LteConnectedStateTestCase ()
+  : TestCase ("save and restore the connected state with a dedicated bearer")
+{
+}
+
+LteConnectedStateTestCase::~LteConnectedStateTestCase ()
+{
+}
+
+void
+LteConnectedStateTestCase::Capture (NetDeviceContainer ueDevices, NetDeviceContainer enbDevices, uint32_t run)
+{
+  Ptr<LteEnbRrc> enbRrc = enbDevices.Get (0)->GetObject<LteEnbNetDevice> ()->GetRrc ();
+  for (uint32_t u = 0; u < ueDevices.GetN (); ++u)
+    {
+      Ptr<LteUeNetDevice> ueDevice = ueDevices.Get (u)->GetObject<LteUeNetDevice> ();
+      Ptr<LteUeRrc> ueRrc = ueDevice->GetRrc ();
+      uint16_t rnti = ueRrc->GetRnti ();
+      std::ostringstream oss;
+      oss << "IMSI " << ueDevice->GetImsi () << " cell " << ueRrc->GetCellId () << " RNTI " << rnti
+          << " UE RRC state " << ueRrc->GetState ();
+      if (!enbRrc->HasUeManager (rnti))
+        {
+          oss << " unknown to the eNB";
+          m_states[run].push_back (oss.str ());
+          continue;
+        }
+      oss << " eNB RRC state " << enbRrc->GetUeManager (rnti)->GetState ()
+          << " SRS CI " << enbRrc->GetUeManager (rnti)->GetSrsConfigurationIndex ();
+
+      std::map<uint8_t, Ptr<LteDataRadioBearerInfo> > enbDrbs = enbRrc->GetUeManager (rnti)->GetRadioBearers ();
+      std::map<uint8_t, Ptr<LteDataRadioBearerInfo> > ueDrbs = ueRrc->GetDataRadioBearers ();
+      oss << " DRBs " << enbDrbs.size () << "/" << ueDrbs.size ();
+      for (std::map<uint8_t, Ptr<LteDataRadioBearerInfo> >::iterator it = enbDrbs.begin (); it != enbDrbs.end (); ++it)
+        {
+          Ptr<LteDataRadioBearerInfo> enbDrb = it->second;
+          const EpsBearer& bearer = enbDrb->m_epsBearer;
+          LtePdcp::Status enbStatus = enbDrb->m_pdcp->GetStatus ();
+          oss << " | DRB " << (uint32_t) it->first << " EPS bearer " << (uint32_t) enbDrb->m_epsBearerIdentity
+              << " LCID " << (uint32_t) enbDrb->m_logicalChannelIdentity
+              << " QCI " << (uint32_t) bearer.qci
+              << " GBR " << bearer.gbrQosInfo.gbrDl << "/" << bearer.gbrQosInfo.gbrUl
+              << " MBR " << bearer.gbrQosInfo.mbrDl << "/" << bearer.gbrQosInfo.mbrUl
+              << " TEID " << enbDrb->m_gtpTeid
+              << " eNB RLC " << enbDrb->m_rlc->GetInstanceTypeId ().GetName ()
+              << " eNB PDCP " << enbStatus.txSn << "/" << enbStatus.rxSn;
+
+          std::map<uint8_t, Ptr<LteDataRadioBearerInfo> >::iterator ueIt = ueDrbs.find (it->first);
+          if (ueIt == ueDrbs.end ())
+            {
+              oss << " missing at the UE";
+              continue;
+            }
+          Ptr<LteDataRadioBearerInfo> ueDrb = ueIt->second;
+          LtePdcp::Status ueStatus = ueDrb->m_pdcp->GetStatus ();
+          oss << " UE EPS bearer " << (uint32_t) ueDrb->m_epsBearerIdentity
+              << " UE LCID " << (uint32_t) ueDrb->m_logicalChannelIdentity
+              << " UE RLC " << ueDrb->m_rlc->GetInstanceTypeId ().GetName ()
+              << " UE PDCP " << ueStatus.txSn << "/" << ueStatus.rxSn;
+
+          Ptr<EpcTft> tft = ueDevice->GetNas ()->GetTft (ueDrb->m_epsBearerIdentity);
+          if (tft == 0)
+            {
+              oss << " no TFT";
+              continue;
+            }
+          std::list<EpcTft::PacketFilter> filters = tft->GetPacketFilters ();
+          for (std::list<EpcTft::PacketFilter>::iterator fIt = filters.begin (); fIt != filters.end (); ++fIt)
+            {
+              oss << " filter " << (uint32_t) fIt->direction << " " << (uint32_t) fIt->precedence
+                  << " " << fIt->remoteAddress << "/" << fIt->remoteMask
+                  << " " << fIt->localAddress << "/" << fIt->localMask
+                  << " " << fIt->remotePortStart << "-" << fIt->remotePortEnd
+                  << " " << fIt->localPortStart << "-" << fIt->localPortEnd
+                  << " " << (uint32_t) fIt->typeOfService << "/" << (uint32_t) fIt->typeOfServiceMask;
+            }
+        }
+      m_states[run].push_back (oss.str ());
+    }
+  std::ostringstream oss;
+  oss << "eNB last allocated RNTI " << enbRrc->GetLastAllocatedRnti ();
+  m_states[run].push_back (oss.str ());
+}
+
+void
+LteConnectedStateTestCase::RunScenario (bool restore, std::string fileName, uint32_t run, Time captureTime)
+{
+  const uint32_t nUes = 3;
+  const uint16_t ulPort = 1234;
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper> ();
+  lteHelper->SetEpcHelper (epcHelper);
+
+  NodeContainer enbNodes;
+  enbNodes.Create (1);
+  NodeContainer ueNodes;
+  ueNodes.Create (nUes);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0, 0, 0));
+  for (uint32_t u = 0; u < nUes; ++u)
+    {
+      positionAlloc->Add (Vector (20 * (u + 1), 0, 0));
+    }
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+
+  InternetStackHelper internet;
+  internet.Install (ueNodes);
+  epcHelper->AssignUeIpv4Address (ueDevs);
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  for (uint32_t u = 0; u < nUes; ++u)
+    {
+      Ptr<Ipv4StaticRouting> ueStaticRouting = ipv4RoutingHelper.GetStaticRouting (ueNodes.Get (u)->GetObject<Ipv4> ());
+      ueStaticRouting->SetDefaultRoute (epcHelper->GetUeDefaultGatewayAddress (), 1);
+    }
+
+  if (restore)
+    {
+      lteHelper->RestoreConnectedState (fileName, ueDevs, enbDevs);
+    }
+  else
+    {
+      lteHelper->Attach (ueDevs, enbDevs.Get (0));
+
+      GbrQosInformation qos;
+      qos.gbrDl = 64000;
+      qos.gbrUl = 32000;
+      qos.mbrDl = 128000;
+      qos.mbrUl = 64000;
+      EpsBearer bearer (EpsBearer::GBR_CONV_VOICE, qos);
+      Ptr<EpcTft> tft = Create<EpcTft> ();
+      EpcTft::PacketFilter ulpf;
+      ulpf.direction = EpcTft::UPLINK;
+      ulpf.remoteAddress = Ipv4Address ("1.0.0.2");
+      ulpf.remoteMask = Ipv4Mask ("255.255.255.255");
+      ulpf.remotePortStart = ulPort;
+      ulpf.remotePortEnd = ulPort;
+      tft->Add (ulpf);
+      EpcTft::PacketFilter dlpf;
+      dlpf.direction = EpcTft::DOWNLINK;
+      dlpf.localPortStart = ulPort;
+      dlpf.localPortEnd = ulPort + 10;
+      dlpf.precedence = 10;
+      tft->Add (dlpf);
+      // a dedicated bearer for all the UEs but the last one
+      for (uint32_t u = 0; u + 1 < nUes; ++u)
+        {
+          lteHelper->ActivateDedicatedEpsBearer (ueDevs.Get (u), bearer, tft);
+        }
+
+      // uplink traffic on the dedicated bearer, to move the PDCP SNs; the
+      // PGW has no route to the remote address and drops it
+      UdpClientHelper client (Ipv4Address ("1.0.0.2"), ulPort);
+      client.SetAttribute ("MaxPackets", UintegerValue (20));
+      client.SetAttribute ("Interval", TimeValue (MilliSeconds (10)));
+      client.SetAttribute ("PacketSize", UintegerValue (100));
+      ApplicationContainer apps = client.Install (ueNodes);
+      apps.Start (Seconds (0.1));
+
+      Simulator::Schedule (captureTime, &LteHelper::SaveConnectedState, lteHelper, fileName, ueDevs, enbDevs);
+    }
+  Simulator::Schedule (captureTime, &LteConnectedStateTestCase::Capture, this, ueDevs, enbDevs, run);
+
+  Simulator::Stop (captureTime + MilliSeconds (1));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+LteConnectedStateTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("lte-connected-state.txt");
+  RunScenario (false, fileName, 0, Seconds (0.5));
+  RunScenario (true, fileName, 1, MilliSeconds (10));
+
+  NS_TEST_ASSERT_MSG_EQ (m_states[1].size (), m_states[0].size (), "wrong number of UEs");
+  for (uint32_t u = 0; u < m_states[0].size () && u < m_states[1].size (); ++u)
+    {
+      NS_LOG_INFO ("saved:    " << m_states[0][u]);
+      NS_LOG_INFO ("restored: " << m_states[1][u]);
+      NS_TEST_ASSERT_MSG_EQ (m_states[1][u], m_states[0][u], "state of UE " << u << " not restored");
+    }
+  // the dedicated bearer was set up and carried traffic in the first run
+  // the last state is the one of the eNB
+  NS_TEST_ASSERT_MSG_GT (m_states[0].size (), 1U, "no UE state saved");
+  if (m_states[0].size () > 1)
+    {
+      NS_TEST_ASSERT_MSG_NE (m_states[0][0].find ("DRBs 2/2"), std::string::npos, "dedicated bearer not set up");
+      NS_TEST_ASSERT_MSG_EQ (m_states[0][0].find ("eNB PDCP 0/0 UE EPS bearer 2"), std::string::npos,
+                             "no uplink traffic on the dedicated bearer");
+    }
+}
+
+
+/**
+ * Test suite of the snapshot of the connected state of the UEs
+ */
+class LteConnectedStateTestSuite : public TestSuite
+{
+public:
+  LteConnectedStateTestSuite ();
+};
+
+LteConnectedStateTestSuite::LteConnectedStateTestSuite ()
+  : TestSuite ("lte-connected-state", SYSTEM)
+{
+  AddTestCase (new LteConnectedStateTestCase (), TestCase::QUICK);
+}
+
+static LteConnectedStateTestSuite g_lteConnectedStateTestSuite;
@@ -0,0 +1,203 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "ns3/lte-delay-distribution.h"
+#include "ns3/ra-preamble-stats-calculator.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteRaKpiTest");
+
+/**
+ * Feeds LteDelayDistribution with a permutation of equally spaced
+ * delays, and checks the histogram, the summary statistics and the
+ * precision of the percentile estimates.
+ */
+class LteDelayDistributionTestCase : public TestCase
+{
+public:
+  LteDelayDistributionTestCase ();
+  virtual ~LteDelayDistributionTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteDelayDistributionTestCase::LteDelayDistributionTestCase ()
+  : TestCase ("delay distribution")
+{
+}
+
+LteDelayDistributionTestCase::~LteDelayDistributionTestCase ()
+{
+}
+
+void
+LteDelayDistributionTestCase::DoRun (void)
+{
+  // 1 ms bins, the last one counting the delays of 9 ms and more
+  LteDelayDistribution distribution (0.001, 10);
+  const uint32_t n = 1000;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      // 7919 is prime, hence the delays 0, 10 us, ... 9.99 ms in a scrambled order
+      distribution.Add (((i * 7919) % n) * 1e-5);
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (distribution.GetCount (), n, "wrong number of samples");
+  NS_TEST_ASSERT_MSG_EQ_TOL (distribution.GetMean (), 0.004995, 1e-9, "wrong mean");
+  NS_TEST_ASSERT_MSG_EQ_TOL (distribution.GetMin (), 0, 1e-12, "wrong minimum");
+  NS_TEST_ASSERT_MSG_EQ_TOL (distribution.GetMax (), 0.00999, 1e-12, "wrong maximum");
+  for (uint32_t bin = 0; bin < distribution.GetNBins (); ++bin)
+    {
+      NS_TEST_ASSERT_MSG_EQ (distribution.GetBinCount (bin), 100U, "wrong count in bin " << bin);
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (distribution.GetP50 (), 0.005, 0.0002, "inaccurate median");
+  NS_TEST_ASSERT_MSG_EQ_TOL (distribution.GetP95 (), 0.0095, 0.0002, "inaccurate 95th percentile");
+  NS_TEST_ASSERT_MSG_EQ_TOL (distribution.GetP99 (), 0.0099, 0.0002, "inaccurate 99th percentile");
+
+  distribution.Reset ();
+  distribution.Add (0.002);
+  distribution.Add (0.5);
+  NS_TEST_ASSERT_MSG_EQ (distribution.GetCount (), 2U, "samples not reset");
+  NS_TEST_ASSERT_MSG_EQ (distribution.GetBinCount (2), 1U, "wrong bin");
+  NS_TEST_ASSERT_MSG_EQ (distribution.GetBinCount (9), 1U, "large delay not in the last bin");
+  NS_TEST_ASSERT_MSG_EQ_TOL (distribution.GetP99 (), 0.5, 1e-12, "wrong percentile of few samples");
+}
+
+
+/**
+ * Delivers preambles to RaPreambleStatsCalculator as the MAC and the
+ * PHY of two cells would, and checks the collision and decoding
+ * failure counters.
+ */
+class LteRaPreambleKpiTestCase : public TestCase
+{
+public:
+  LteRaPreambleKpiTestCase ();
+  virtual ~LteRaPreambleKpiTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Deliver a preamble to the MAC of a cell
+   * \param stats the calculator
+   * \param cellId the cell
+   * \param rapId the RAPID of the preamble
+   */
+  static void ReceivePreamble (Ptr<RaPreambleStatsCalculator> stats, uint16_t cellId, uint32_t rapId);
+
+  /**
+   * Report the reception of a preamble by the PHY of a cell
+   * \param stats the calculator
+   * \param cellId the cell
+   * \param correct whether the preamble could be decoded
+   */
+  static void ReceivePhyPreamble (Ptr<RaPreambleStatsCalculator> stats, uint16_t cellId, bool correct);
+};
+
+LteRaPreambleKpiTestCase::LteRaPreambleKpiTestCase ()
+  : TestCase ("preamble collisions and decoding failures")
+{
+}
+
+LteRaPreambleKpiTestCase::~LteRaPreambleKpiTestCase ()
+{
+}
+
+void
+LteRaPreambleKpiTestCase::ReceivePreamble (Ptr<RaPreambleStatsCalculator> stats, uint16_t cellId, uint32_t rapId)
+{
+  Ptr<RachPreambleLteControlMessage> msg = Create<RachPreambleLteControlMessage> ();
+  msg->SetRapId (rapId);
+  msg->SetImsi (1);
+  msg->SetStartTime (Simulator::Now ());
+  RaPreambleStatsCalculator::StorePreambleRx (stats, cellId, msg);
+}
+
+void
+LteRaPreambleKpiTestCase::ReceivePhyPreamble (Ptr<RaPreambleStatsCalculator> stats, uint16_t cellId, bool correct)
+{
+  PhyReceptionStatParameters params;
+  params.m_timestamp = Simulator::Now ().GetNanoSeconds ();
+  params.m_cellId = cellId;
+  params.m_imsi = 1;
+  params.m_correctness = correct;
+  RaPreambleStatsCalculator::StorePreamblePhyRx (stats, "", params);
+}
+
+void
+LteRaPreambleKpiTestCase::DoRun (void)
+{
+  Ptr<RaPreambleStatsCalculator> stats = CreateObject<RaPreambleStatsCalculator> ();
+  stats->SetAttribute ("LogEvents", BooleanValue (false));
+  stats->SetAttribute ("EpochDuration", TimeValue (Seconds (1)));
+  stats->SetAttribute ("KpiFilename", StringValue (CreateTempDirFilename ("RaPreambleKpi.txt")));
+
+  // subframe 1: three preambles with RAPID 5 and one with RAPID 7 in
+  // cell 1, one with RAPID 5 in cell 2
+  Time t1 = MilliSeconds (1);
+  Simulator::Schedule (t1, &ReceivePreamble, stats, 1, 5);
+  Simulator::Schedule (t1, &ReceivePreamble, stats, 1, 7);
+  Simulator::Schedule (t1, &ReceivePreamble, stats, 1, 5);
+  Simulator::Schedule (t1, &ReceivePreamble, stats, 2, 5);
+  Simulator::Schedule (t1, &ReceivePreamble, stats, 1, 5);
+  // subframe 2: RAPIDs 5 and 7 again in cell 1, no collision
+  Time t2 = MilliSeconds (2);
+  Simulator::Schedule (t2, &ReceivePreamble, stats, 1, 5);
+  Simulator::Schedule (t2, &ReceivePreamble, stats, 1, 7);
+  // PHY receptions in cell 2
+  Simulator::Schedule (t2, &ReceivePhyPreamble, stats, 2, true);
+  Simulator::Schedule (t2, &ReceivePhyPreamble, stats, 2, false);
+  Simulator::Schedule (t2, &ReceivePhyPreamble, stats, 2, false);
+
+  Simulator::Stop (MilliSeconds (10));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (stats->GetKpi (1).m_collisions, 3U, "wrong number of collisions in cell 1");
+  NS_TEST_ASSERT_MSG_EQ (stats->GetKpi (2).m_collisions, 0U, "collision across cells");
+  NS_TEST_ASSERT_MSG_EQ (stats->GetKpi (2).m_preambleRx, 3U, "wrong number of preambles in cell 2");
+  NS_TEST_ASSERT_MSG_EQ (stats->GetKpi (2).m_decodeFailures, 2U, "wrong number of decoding failures in cell 2");
+  NS_TEST_ASSERT_MSG_EQ (stats->GetKpi (7).m_active, false, "KPIs of a cell never seen");
+  NS_TEST_ASSERT_MSG_EQ (stats->GetKpi (7).m_preambleRx, 0U, "preambles in a cell never seen");
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * Test suite of the random access KPIs
+ */
+class LteRaKpiTestSuite : public TestSuite
+{
+public:
+  LteRaKpiTestSuite ();
+};
+
+LteRaKpiTestSuite::LteRaKpiTestSuite ()
+  : TestSuite ("lte-ra-kpi", UNIT)
+{
+  AddTestCase (new LteDelayDistributionTestCase (), TestCase::QUICK);
+  AddTestCase (new LteRaPreambleKpiTestCase (), TestCase::QUICK);
+}
+
+static LteRaKpiTestSuite g_lteRaKpiTestSuite;
@@ -0,0 +1,71 @@
+#! /usr/bin/env python
+## -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+
+# Scaling benchmark of the random access model: runs lena-rach-benchmark
+# once per point of the sweep, each run appending one line (wall time,
+# events per second, peak RSS and RACH KPIs) to the output file.
+#
+# To be run from the top directory of ns-3, e.g.:
+#   ./src/lte/test/lte-test-rach-benchmark.py --output=RachBenchmark.txt
+# on a tree configured with "-d optimized", or with --configure to have
+# the script configure it.
+
+import optparse
+import os
+import subprocess
+import sys
+
+N_UE = [1000, 2000, 5000, 10000, 20000, 50000, 100000]
+# one PRACH opportunity every 10 ms, every 5 ms and every 2 ms
+PRACH_CONFIGURATION_INDEX = [3, 6, 12]
+# (useIdealRrc, useIdealPrach)
+MODELS = [(True, True), (False, False)]
+
+
+def main():
+    parser = optparse.OptionParser()
+    parser.add_option("--output", default="RachBenchmark.txt",
+                      help="file where the results are appended")
+    parser.add_option("--max-ue", type="int", default=N_UE[-1],
+                      help="largest number of UEs of the sweep")
+    parser.add_option("--n-enb", type="int", default=1,
+                      help="number of eNBs")
+    parser.add_option("--access-window", type="float", default=1.0,
+                      help="the UEs attach uniformly in [0, access window] (s)")
+    parser.add_option("--sim-time", type="float", default=2.0,
+                      help="duration of the simulations (s)")
+    parser.add_option("--runs", type="int", default=1,
+                      help="number of runs of each point")
+    parser.add_option("--configure", action="store_true", default=False,
+                      help="configure an optimized build of the lte module first,"
+                      " replacing the current configuration")
+    (options, args) = parser.parse_args()
+
+    # build first, so that the compilation is not counted in the first run;
+    # the current configuration is kept unless asked otherwise, the results
+    # being meaningful only with an optimized build
+    if options.configure:
+        subprocess.check_call("./waf -d optimized configure --enable-examples --enable-modules=lte",
+                              shell=True)
+    subprocess.check_call("./waf build", shell=True)
+
+    output = os.path.abspath(options.output)
+    for nUe in [n for n in N_UE if n <= options.max_ue]:
+        for prach in PRACH_CONFIGURATION_INDEX:
+            for (idealRrc, idealPrach) in MODELS:
+                for run in range(1, options.runs + 1):
+                    args = ("lena-rach-benchmark --nUe=%d --nEnb=%d --prachConfigurationIndex=%d"
+                            " --useIdealRrc=%d --useIdealPrach=%d --accessWindow=%g --simTime=%g"
+                            " --runNumber=%d --outputFile=%s"
+                            % (nUe, options.n_enb, prach, idealRrc, idealPrach,
+                               options.access_window, options.sim_time, run, output))
+                    print(args)
+                    sys.stdout.flush()
+                    status = subprocess.call("./waf --run '%s'" % args, shell=True)
+                    if status != 0:
+                        print("FAILED (%d): %s" % (status, args))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
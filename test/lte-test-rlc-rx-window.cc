@@ -0,0 +1,146 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/lte-rlc-rx-window.h"
+
+#include <set>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteRlcRxWindowTest");
+
+/**
+ * Checks the searches of LteRlcRxWindow across the SN wrap-around and
+ * against a std::set of the SNs received.
+ */
+class LteRlcRxWindowTestCase : public TestCase
+{
+public:
+  LteRlcRxWindowTestCase ();
+  virtual ~LteRlcRxWindowTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteRlcRxWindowTestCase::LteRlcRxWindowTestCase ()
+  : TestCase ("reception window searches")
+{
+}
+
+LteRlcRxWindowTestCase::~LteRlcRxWindowTestCase ()
+{
+}
+
+void
+LteRlcRxWindowTestCase::DoRun (void)
+{
+  LteRlcRxWindow window;
+  NS_TEST_ASSERT_MSG_EQ (window.IsEmpty (), true, "new window not empty");
+  NS_TEST_ASSERT_MSG_EQ (window.FindNextMissing (5), 5, "wrong next missing SN in an empty window");
+  NS_TEST_ASSERT_MSG_EQ (window.FindNextPresent (5, 100), 100, "PDU found in an empty window");
+
+  // SNs 1020 to 3, except 1
+  for (uint16_t sn = 1020; sn != 4; sn = (sn + 1) % 1024)
+    {
+      if (sn != 1)
+        {
+          window.Insert (sn, Create<Packet> (sn + 1));
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (window.FindNextMissing (1020), 1, "wrong next missing SN across the wrap-around");
+  NS_TEST_ASSERT_MSG_EQ (window.FindNextMissing (2), 4, "wrong next missing SN");
+  NS_TEST_ASSERT_MSG_EQ (window.FindNextPresent (1000, 10), 1020, "wrong next received SN");
+  NS_TEST_ASSERT_MSG_EQ (window.FindNextPresent (1, 10), 2, "wrong next received SN after a gap");
+  NS_TEST_ASSERT_MSG_EQ (window.FindNextPresent (4, 1020), 1020, "PDU found outside of the PDUs received");
+  NS_TEST_ASSERT_MSG_EQ (window.Remove (1023)->GetSize (), 1024U, "wrong PDU removed");
+  NS_TEST_ASSERT_MSG_EQ (window.IsPresent (1023), false, "PDU still present after removal");
+  NS_TEST_ASSERT_MSG_EQ (window.FindNextPresent (1023, 10), 0, "wrong next received SN after a removal");
+  window.Clear ();
+  NS_TEST_ASSERT_MSG_EQ (window.IsEmpty (), true, "window not empty after Clear");
+
+  // PDUs in sequence, then out of order until the buffer drains
+  window.Insert (5, Create<Packet> (5));
+  window.Insert (5, Create<Packet> (6));
+  NS_TEST_ASSERT_MSG_EQ (window.Remove (5)->GetSize (), 6U, "PDU in sequence not replaced");
+  NS_TEST_ASSERT_MSG_EQ (window.IsEmpty (), true, "window not empty after the PDU in sequence");
+  window.Insert (8, Create<Packet> (8));
+  window.Insert (6, Create<Packet> (6));
+  window.Insert (7, Create<Packet> (7));
+  NS_TEST_ASSERT_MSG_EQ (window.FindNextMissing (6), 9, "wrong next missing SN out of order");
+  NS_TEST_ASSERT_MSG_EQ (window.Remove (6)->GetSize (), 6U, "wrong PDU removed out of order");
+  NS_TEST_ASSERT_MSG_EQ (window.Remove (7)->GetSize (), 7U, "wrong PDU removed out of order");
+  NS_TEST_ASSERT_MSG_EQ (window.Remove (8)->GetSize (), 8U, "PDU held in sequence lost");
+  NS_TEST_ASSERT_MSG_EQ (window.IsEmpty (), true, "window not empty once drained");
+  window.Insert (9, Create<Packet> (9));
+  NS_TEST_ASSERT_MSG_EQ (window.FindNextPresent (0, 20), 9, "PDU in sequence not found after a drain");
+  NS_TEST_ASSERT_MSG_EQ (window.Remove (9)->GetSize (), 9U, "wrong PDU in sequence after a drain");
+
+  // a pseudo-random sequence of insertions and removals
+  std::set<uint16_t> received;
+  uint32_t x = 1;
+  for (uint32_t i = 0; i < 20000; ++i)
+    {
+      x = x * 1103515245 + 12345;
+      uint16_t sn = (x >> 8) % 1024;
+      uint16_t end = (x >> 18) % 1024;
+      if (received.count (sn) == 0 && received.size () < 600)
+        {
+          window.Insert (sn, Create<Packet> ());
+          received.insert (sn);
+        }
+      else if (received.count (sn) > 0)
+        {
+          window.Remove (sn);
+          received.erase (sn);
+        }
+
+      uint16_t missing = end;
+      while (received.count (missing) > 0)
+        {
+          missing = (missing + 1) % 1024;
+        }
+      NS_TEST_ASSERT_MSG_EQ (window.FindNextMissing (end), missing, "wrong next missing SN from " << end);
+
+      uint16_t present = sn;
+      while (present != end && received.count (present) == 0)
+        {
+          present = (present + 1) % 1024;
+        }
+      NS_TEST_ASSERT_MSG_EQ (window.FindNextPresent (sn, end), present, "wrong next received SN in [" << sn << ", " << end << ")");
+    }
+}
+
+
+/**
+ * Test suite of the reception buffer of the UM and AM RLC
+ */
+class LteRlcRxWindowTestSuite : public TestSuite
+{
+public:
+  LteRlcRxWindowTestSuite ();
+};
+
+LteRlcRxWindowTestSuite::LteRlcRxWindowTestSuite ()
+  : TestSuite ("lte-rlc-rx-window", UNIT)
+{
+  AddTestCase (new LteRlcRxWindowTestCase (), TestCase::QUICK);
+}
+
+static LteRlcRxWindowTestSuite g_lteRlcRxWindowTestSuite;
@@ -0,0 +1,162 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/lte-stats-writer.h"
+
+#include <fstream>
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteStatsWriterTest");
+
+/**
+ * Writes a few rows with LteStatsWriter, with a buffer small enough to
+ * be flushed several times, and checks the content of the file: the
+ * text itself in TEXT format, its CSV conversion in BINARY format. The
+ * buffers are written either synchronously or by the background thread.
+ */
+class LteStatsWriterTestCase : public TestCase
+{
+public:
+  LteStatsWriterTestCase (LteStatsWriter::Format format, bool async);
+  virtual ~LteStatsWriterTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  LteStatsWriter::Format m_format;
+  bool m_async;
+};
+
+LteStatsWriterTestCase::LteStatsWriterTestCase (LteStatsWriter::Format format, bool async)
+  : TestCase (std::string (format == LteStatsWriter::TEXT ? "text format" : "binary format")
+              + (async ? ", asynchronous" : ", synchronous")),
+    m_format (format),
+    m_async (async)
+{
+}
+
+LteStatsWriterTestCase::~LteStatsWriterTestCase ()
+{
+}
+
+void
+LteStatsWriterTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("lte-stats-writer.out");
+
+  Ptr<LteStatsWriter> writer = CreateObject<LteStatsWriter> ();
+  writer->SetFormat (m_format);
+  writer->SetAttribute ("BufferSize", UintegerValue (16));
+  writer->SetAttribute ("AsyncOutput", BooleanValue (m_async));
+  writer->AddColumn ("time", LteStatsWriter::DOUBLE);
+  writer->AddColumn ("cellId", LteStatsWriter::UINT16);
+  writer->AddColumn ("IMSI", LteStatsWriter::UINT64);
+  writer->AddColumn ("mcs", LteStatsWriter::UINT8);
+  writer->AddColumn ("delay", LteStatsWriter::DOUBLE, 3);
+  NS_TEST_ASSERT_MSG_EQ (writer->Open (filename), true, "cannot create " << filename);
+
+  writer->WriteDouble (0.25);
+  writer->WriteUint (1);
+  writer->WriteUint (12345678901ULL);
+  writer->WriteUint (28);
+  writer->WriteDouble (0.5);
+  writer->EndRow ();
+  writer->WriteDouble (1.5);
+  writer->WriteUint (65535 - 1);
+  writer->WriteUint (7);
+  writer->WriteMissing ();
+  writer->WriteDouble (2);
+  writer->EndRow ();
+  writer->Close ();
+
+  std::ostringstream content;
+  if (m_format == LteStatsWriter::TEXT)
+    {
+      std::ifstream inFile (filename.c_str ());
+      content << inFile.rdbuf ();
+      NS_TEST_ASSERT_MSG_EQ (content.str (),
+                             "% time\tcellId\tIMSI\tmcs\tdelay\n"
+                             "0.25\t1\t12345678901\t28\t0.500\n"
+                             "1.5\t65534\t7\t-\t2.000\n",
+                             "wrong text output");
+
+      // rows ending with a separator, as in the RLC/PDCP statistics
+      std::string trailingFilename = CreateTempDirFilename ("lte-stats-writer-trailing.out");
+      Ptr<LteStatsWriter> trailingWriter = CreateObject<LteStatsWriter> ();
+      trailingWriter->SetAttribute ("AsyncOutput", BooleanValue (m_async));
+      trailingWriter->SetTextTrailingSeparator (true);
+      trailingWriter->AddColumn ("cellId", LteStatsWriter::UINT16);
+      trailingWriter->AddColumn ("mcs", LteStatsWriter::UINT8);
+      NS_TEST_ASSERT_MSG_EQ (trailingWriter->Open (trailingFilename, "% cellId\tmcs"), true,
+                             "cannot create " << trailingFilename);
+      trailingWriter->WriteUint (1);
+      trailingWriter->WriteUint (28);
+      trailingWriter->EndRow ();
+      trailingWriter->Close ();
+      std::ifstream trailingFile (trailingFilename.c_str ());
+      std::ostringstream trailingContent;
+      trailingContent << trailingFile.rdbuf ();
+      NS_TEST_ASSERT_MSG_EQ (trailingContent.str (), "% cellId\tmcs\n1\t28\t\n",
+                             "wrong text output with a trailing separator");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_EQ (LteStatsReader::ConvertToCsv (filename, content), true,
+                             "cannot read " << filename);
+      NS_TEST_ASSERT_MSG_EQ (content.str (),
+                             "time,cellId,IMSI,mcs,delay\n"
+                             "0.25,1,12345678901,28,0.5\n"
+                             "1.5,65534,7,,2\n",
+                             "wrong CSV conversion of the binary output");
+
+      LteStatsReader reader;
+      NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "cannot read " << filename);
+      NS_TEST_ASSERT_MSG_EQ (reader.GetNColumns (), 5U, "wrong number of columns");
+      NS_TEST_ASSERT_MSG_EQ (reader.GetColumnType (2), LteStatsWriter::UINT64, "wrong column type");
+      NS_TEST_ASSERT_MSG_EQ (reader.ReadRow (), true, "missing first row");
+      NS_TEST_ASSERT_MSG_EQ (reader.GetUint (2), 12345678901ULL, "wrong IMSI");
+      NS_TEST_ASSERT_MSG_EQ (reader.ReadRow (), true, "missing second row");
+      NS_TEST_ASSERT_MSG_EQ (reader.IsMissing (3), true, "missing value not detected");
+      NS_TEST_ASSERT_MSG_EQ (reader.ReadRow (), false, "unexpected third row");
+    }
+}
+
+
+/**
+ * Test suite of the output backend of the LTE stats calculators
+ */
+class LteStatsWriterTestSuite : public TestSuite
+{
+public:
+  LteStatsWriterTestSuite ();
+};
+
+LteStatsWriterTestSuite::LteStatsWriterTestSuite ()
+  : TestSuite ("lte-stats-writer", UNIT)
+{
+  AddTestCase (new LteStatsWriterTestCase (LteStatsWriter::TEXT, false), TestCase::QUICK);
+  AddTestCase (new LteStatsWriterTestCase (LteStatsWriter::BINARY, false), TestCase::QUICK);
+  AddTestCase (new LteStatsWriterTestCase (LteStatsWriter::TEXT, true), TestCase::QUICK);
+  AddTestCase (new LteStatsWriterTestCase (LteStatsWriter::BINARY, true), TestCase::QUICK);
+}
+
+static LteStatsWriterTestSuite g_lteStatsWriterTestSuite;
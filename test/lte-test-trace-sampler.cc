@@ -0,0 +1,163 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/lte-trace-sampler.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTraceSamplerTest");
+
+/**
+ * Checks each of the policies of LteTraceSampler, and their combination,
+ * by counting the samples kept over 100 TTIs, 1000 UEs and a few cells.
+ */
+class LteTraceSamplerTestCase : public TestCase
+{
+public:
+  LteTraceSamplerTestCase ();
+  virtual ~LteTraceSamplerTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Count the samples of one TTI
+   * \param sampler the sampling policy
+   * \param cellId the cell of the samples
+   * \param rnti the UE of the samples
+   */
+  void Sample (LteTraceSampler sampler, uint16_t cellId, uint16_t rnti);
+
+  uint32_t m_nSampled; ///< number of samples kept
+};
+
+LteTraceSamplerTestCase::LteTraceSamplerTestCase ()
+  : TestCase ("sampling policies"),
+    m_nSampled (0)
+{
+}
+
+LteTraceSamplerTestCase::~LteTraceSamplerTestCase ()
+{
+}
+
+void
+LteTraceSamplerTestCase::Sample (LteTraceSampler sampler, uint16_t cellId, uint16_t rnti)
+{
+  if (sampler.IsSampled (cellId, rnti))
+    {
+      m_nSampled++;
+    }
+}
+
+void
+LteTraceSamplerTestCase::DoRun (void)
+{
+  LteTraceSampler all;
+  NS_TEST_ASSERT_MSG_EQ (all.IsSampled (1, 1), true, "default sampler dropped a sample");
+
+  // every 10th TTI
+  LteTraceSampler periodic;
+  periodic.SetTtiPeriod (10);
+  m_nSampled = 0;
+  for (uint32_t tti = 0; tti < 100; ++tti)
+    {
+      Simulator::Schedule (MilliSeconds (tti), &LteTraceSamplerTestCase::Sample, this, periodic, 1, 1);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (m_nSampled, 10U, "wrong number of TTIs sampled");
+
+  // 30% of the UEs, always the same ones
+  LteTraceSampler subset;
+  subset.SetUeFraction (0.3);
+  uint32_t nUes = 0;
+  for (uint16_t rnti = 1; rnti <= 1000; ++rnti)
+    {
+      bool sampled = subset.IsSampled (1, rnti);
+      NS_TEST_ASSERT_MSG_EQ (subset.IsSampled (1, rnti), sampled, "inconsistent selection of RNTI " << rnti);
+      if (sampled)
+        {
+          nUes++;
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (nUes, 300U, 50U, "wrong number of UEs sampled");
+
+  LteTraceSampler none;
+  none.SetUeFraction (0);
+  nUes = 0;
+  for (uint16_t rnti = 1; rnti <= 1000; ++rnti)
+    {
+      nUes += none.IsSampled (1, rnti) ? 1 : 0;
+    }
+  NS_TEST_ASSERT_MSG_EQ (nUes, 0U, "UEs sampled with a fraction of 0");
+
+  // selected cells
+  LteTraceSampler cells;
+  cells.AddCell (2);
+  cells.AddCell (4);
+  NS_TEST_ASSERT_MSG_EQ (cells.IsSampled (1, 1), false, "sample of cell 1 kept");
+  NS_TEST_ASSERT_MSG_EQ (cells.IsSampled (2, 1), true, "sample of cell 2 dropped");
+  NS_TEST_ASSERT_MSG_EQ (cells.IsSampled (3, 1), false, "sample of cell 3 kept");
+  NS_TEST_ASSERT_MSG_EQ (cells.IsSampled (4, 1), true, "sample of cell 4 dropped");
+  NS_TEST_ASSERT_MSG_EQ (cells.IsSampled (100, 1), false, "sample of cell 100 kept");
+
+  // all the policies together
+  LteTraceSampler combined = cells;
+  combined.SetTtiPeriod (10);
+  combined.SetUeFraction (0.3);
+  m_nSampled = 0;
+  for (uint32_t tti = 0; tti < 100; ++tti)
+    {
+      for (uint16_t rnti = 1; rnti <= 1000; ++rnti)
+        {
+          if (subset.IsSampled (2, rnti))
+            {
+              Simulator::Schedule (MilliSeconds (tti), &LteTraceSamplerTestCase::Sample, this, combined, 2, rnti);
+            }
+          Simulator::Schedule (MilliSeconds (tti), &LteTraceSamplerTestCase::Sample, this, combined, 1, rnti);
+        }
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  uint32_t nUesCell2 = 0;
+  for (uint16_t rnti = 1; rnti <= 1000; ++rnti)
+    {
+      nUesCell2 += subset.IsSampled (2, rnti) ? 1 : 0;
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_nSampled, 10 * nUesCell2, "wrong number of samples with the combined policies");
+}
+
+
+/**
+ * Test suite of the sampling of the per-TTI traces
+ */
+class LteTraceSamplerTestSuite : public TestSuite
+{
+public:
+  LteTraceSamplerTestSuite ();
+};
+
+LteTraceSamplerTestSuite::LteTraceSamplerTestSuite ()
+  : TestSuite ("lte-trace-sampler", UNIT)
+{
+  AddTestCase (new LteTraceSamplerTestCase (), TestCase::QUICK);
+}
+
+static LteTraceSamplerTestSuite g_lteTraceSamplerTestSuite;
@@ -0,0 +1,176 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/enum.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/position-allocator.h"
+#include "ns3/lte-helper.h"
+#include "ns3/lte-enb-net-device.h"
+#include "ns3/lte-ue-net-device.h"
+#include "ns3/lte-enb-rrc.h"
+#include "ns3/lte-ue-rrc.h"
+#include "ns3/lte-rlc-um.h"
+#include "ns3/lte-radio-bearer-info.h"
+#include "ns3/lte-traffic-generator.h"
+#include "ns3/radio-bearer-stats-calculator.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTrafficGeneratorSystemTest");
+
+/**
+ * Feeds the data radio bearer of a UE with the DL and UL traffic
+ * generators of LteHelper, without the EPC, and checks the packets
+ * received by the PDCP at both ends. The default RLC/SM mapping of the
+ * eNB is remapped to RLC/UM, as the generators need the PDCP.
+ */
+class LteTrafficGeneratorSystemTestCase : public TestCase
+{
+public:
+  LteTrafficGeneratorSystemTestCase (std::string name, LteTrafficGenerator::Model model,
+                                     uint32_t minPackets, uint32_t maxPackets);
+  virtual ~LteTrafficGeneratorSystemTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  LteTrafficGenerator::Model m_model;
+  uint32_t m_minPackets;
+  uint32_t m_maxPackets;
+};
+
+LteTrafficGeneratorSystemTestCase::LteTrafficGeneratorSystemTestCase (std::string name, LteTrafficGenerator::Model model,
+                                                                      uint32_t minPackets, uint32_t maxPackets)
+  : TestCase (name),
+    m_model (model),
+    m_minPackets (minPackets),
+    m_maxPackets (maxPackets)
+{
+}
+
+LteTrafficGeneratorSystemTestCase::~LteTrafficGeneratorSystemTestCase ()
+{
+}
+
+void
+LteTrafficGeneratorSystemTestCase::DoRun (void)
+{
+  NodeContainer enbNodes;
+  enbNodes.Create (1);
+  NodeContainer ueNodes;
+  ueNodes.Create (1);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0, 0, 0));
+  positionAlloc->Add (Vector (10, 0, 0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("UseDlTrafficGenerator", BooleanValue (true));
+  lteHelper->SetAttribute ("UseUlTrafficGenerator", BooleanValue (true));
+  lteHelper->SetDlTrafficGeneratorAttribute ("Model", EnumValue (m_model));
+  lteHelper->SetUlTrafficGeneratorAttribute ("Model", EnumValue (m_model));
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+
+  Ptr<LteEnbRrc> enbRrc = enbDevs.Get (0)->GetObject<LteEnbNetDevice> ()->GetRrc ();
+  EnumValue epsBearerToRlcMapping;
+  enbRrc->GetAttribute ("EpsBearerToRlcMapping", epsBearerToRlcMapping);
+  NS_TEST_ASSERT_MSG_EQ (epsBearerToRlcMapping.Get (), LteEnbRrc::RLC_UM_ALWAYS,
+                         "RLC/SM not remapped to RLC/UM");
+
+  // one stream for each spectrum PHY and the UE MAC, and two for each
+  // generator that the RRCs can set up
+  Ptr<LteUeRrc> ueRrc = ueDevs.Get (0)->GetObject<LteUeNetDevice> ()->GetRrc ();
+  enbRrc->SetAttribute ("MaxTrafficGenerators", UintegerValue (8));
+  ueRrc->SetAttribute ("MaxTrafficGenerators", UintegerValue (4));
+  int64_t nStreams = lteHelper->AssignStreams (enbDevs, 1);
+  NS_TEST_ASSERT_MSG_EQ (nStreams, 2 + 2 * 8, "streams of the DL generators not assigned");
+  nStreams = lteHelper->AssignStreams (ueDevs, 1 + nStreams);
+  NS_TEST_ASSERT_MSG_EQ (nStreams, 2 + 1 + 2 * 4, "streams of the UL generators not assigned");
+
+  lteHelper->Attach (ueDevs, enbDevs.Get (0));
+  lteHelper->ActivateDataRadioBearer (ueDevs, EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+
+  lteHelper->EnablePdcpTraces ();
+  Ptr<RadioBearerStatsCalculator> pdcpStats = lteHelper->GetPdcpStats ();
+  pdcpStats->SetAttribute ("EpochDuration", TimeValue (Seconds (2)));
+  pdcpStats->SetAttribute ("DlPdcpOutputFilename", StringValue (CreateTempDirFilename ("DlPdcpStats.txt")));
+  pdcpStats->SetAttribute ("UlPdcpOutputFilename", StringValue (CreateTempDirFilename ("UlPdcpStats.txt")));
+
+  // within the first epoch, whose statistics are reset when written
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+
+  Ptr<LteUeNetDevice> ueDev = ueDevs.Get (0)->GetObject<LteUeNetDevice> ();
+  std::map <uint8_t, Ptr<LteDataRadioBearerInfo> > drbs = ueDev->GetRrc ()->GetDataRadioBearers ();
+  NS_TEST_ASSERT_MSG_EQ (drbs.size (), 1U, "data radio bearer not set up");
+  if (!drbs.empty ())
+    {
+      Ptr<LteDataRadioBearerInfo> drb = drbs.begin ()->second;
+      NS_TEST_ASSERT_MSG_EQ ((drb->m_rlc->GetObject<LteRlcUm> () != 0), true, "data radio bearer not on RLC/UM");
+      NS_TEST_ASSERT_MSG_EQ ((drb->m_trafficGenerator != 0), true, "UL traffic generator not attached");
+    }
+
+  uint64_t imsi = ueDev->GetImsi ();
+  uint8_t lcid = 3;
+  uint32_t dlRxPackets = pdcpStats->GetDlRxPackets (imsi, lcid);
+  uint32_t ulRxPackets = pdcpStats->GetUlRxPackets (imsi, lcid);
+  NS_LOG_INFO ("DL PDCP RX " << dlRxPackets << " UL PDCP RX " << ulRxPackets);
+  NS_TEST_ASSERT_MSG_GT (dlRxPackets + 1, m_minPackets, "too few DL packets received by the PDCP of the UE");
+  NS_TEST_ASSERT_MSG_LT (dlRxPackets, m_maxPackets + 1, "too many DL packets received by the PDCP of the UE");
+  NS_TEST_ASSERT_MSG_GT (ulRxPackets + 1, m_minPackets, "too few UL packets received by the PDCP of the eNB");
+  NS_TEST_ASSERT_MSG_LT (ulRxPackets, m_maxPackets + 1, "too many UL packets received by the PDCP of the eNB");
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * Test suite of the traffic generators attached to the data radio bearers
+ * by LteHelper
+ */
+class LteTrafficGeneratorSystemTestSuite : public TestSuite
+{
+public:
+  LteTrafficGeneratorSystemTestSuite ();
+};
+
+LteTrafficGeneratorSystemTestSuite::LteTrafficGeneratorSystemTestSuite ()
+  : TestSuite ("lte-traffic-generator-system", SYSTEM)
+{
+  // a packet each 10 ms from the set up of the bearer
+  AddTestCase (new LteTrafficGeneratorSystemTestCase ("periodic", LteTrafficGenerator::PERIODIC, 80, 100),
+               TestCase::QUICK);
+  // the 1000 byte packets kept in the RLC buffer, more than 2.4 Mb/s on
+  // 25 RBs close to the eNB
+  AddTestCase (new LteTrafficGeneratorSystemTestCase ("full buffer", LteTrafficGenerator::FULL_BUFFER, 300, 100000),
+               TestCase::QUICK);
+}
+
+static LteTrafficGeneratorSystemTestSuite g_lteTrafficGeneratorSystemTestSuite;
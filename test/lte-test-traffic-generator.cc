@@ -0,0 +1,201 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/nstime.h"
+#include "ns3/callback.h"
+#include "ns3/lte-traffic-generator.h"
+
+#include <algorithm>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTrafficGeneratorTest");
+
+/**
+ * PDCP and RLC SAP providers counting the packets of the generator, with
+ * the backlog of a RLC buffer of the given size, drained by Drain
+ */
+class LteTrafficGeneratorTestSink : public LtePdcpSapProvider,
+                                    public LteRlcSapProvider
+{
+public:
+  LteTrafficGeneratorTestSink (uint32_t maxBacklog)
+    : m_nSdus (0),
+      m_nPdus (0),
+      m_pduBytes (0),
+      m_backlog (0),
+      m_maxBacklog (maxBacklog)
+  {
+  }
+
+  virtual void TransmitPdcpSdu (TransmitPdcpSduParameters params)
+  {
+    m_nSdus++;
+    if (m_backlog + params.pdcpSdu->GetSize () <= m_maxBacklog)
+      {
+        m_backlog += params.pdcpSdu->GetSize ();
+      }
+  }
+
+  virtual void TransmitPdcpPdu (TransmitPdcpPduParameters params)
+  {
+    m_nPdus++;
+    m_pduBytes += params.pdcpPdu->GetSize ();
+  }
+
+  uint32_t GetBacklog (void) const
+  {
+    return m_backlog;
+  }
+
+  void Drain (uint32_t bytes)
+  {
+    m_backlog -= std::min (m_backlog, bytes);
+  }
+
+  uint32_t m_nSdus;
+  uint32_t m_nPdus;
+  uint32_t m_pduBytes;
+  uint32_t m_backlog;
+  uint32_t m_maxBacklog;
+};
+
+/**
+ * Runs a traffic generator attached to the test sink and checks the
+ * number of packets generated. The sink is drained by 100 bytes each
+ * TTI, in between the top-ups of the full buffer model.
+ */
+class LteTrafficGeneratorTestCase : public TestCase
+{
+public:
+  LteTrafficGeneratorTestCase (std::string name, LteTrafficGenerator::Model model,
+                               Time duration, uint32_t nPackets, uint32_t tolerance,
+                               bool bypassPdcp, uint32_t maxBacklog);
+  virtual ~LteTrafficGeneratorTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  LteTrafficGenerator::Model m_model;
+  Time m_duration;
+  uint32_t m_nPackets;
+  uint32_t m_tolerance;
+  bool m_bypassPdcp;
+  uint32_t m_maxBacklog;
+};
+
+LteTrafficGeneratorTestCase::LteTrafficGeneratorTestCase (std::string name, LteTrafficGenerator::Model model,
+                                                          Time duration, uint32_t nPackets, uint32_t tolerance,
+                                                          bool bypassPdcp, uint32_t maxBacklog)
+  : TestCase (name),
+    m_model (model),
+    m_duration (duration),
+    m_nPackets (nPackets),
+    m_tolerance (tolerance),
+    m_bypassPdcp (bypassPdcp),
+    m_maxBacklog (maxBacklog)
+{
+}
+
+LteTrafficGeneratorTestCase::~LteTrafficGeneratorTestCase ()
+{
+}
+
+void
+LteTrafficGeneratorTestCase::DoRun (void)
+{
+  const uint32_t packetSize = 100;
+  LteTrafficGeneratorTestSink sink (m_maxBacklog);
+  Ptr<LteTrafficGenerator> generator = CreateObject<LteTrafficGenerator> ();
+  generator->SetAttribute ("Model", EnumValue (m_model));
+  generator->SetAttribute ("PacketSize", UintegerValue (packetSize));
+  generator->SetAttribute ("Interval", TimeValue (MilliSeconds (10)));
+  generator->SetAttribute ("Jitter", TimeValue (MilliSeconds (5)));
+  generator->SetAttribute ("FullBufferBacklog", UintegerValue (10 * packetSize));
+  generator->SetAttribute ("BypassPdcp", BooleanValue (m_bypassPdcp));
+  generator->SetRnti (1);
+  generator->SetLcId (3);
+  generator->SetLtePdcpSapProvider (&sink);
+  generator->SetLteRlcSapProvider (&sink);
+  generator->SetTxBufferSizeCallback (MakeCallback (&LteTrafficGeneratorTestSink::GetBacklog, &sink));
+  generator->Initialize ();
+  for (Time t = MicroSeconds (500); t < m_duration; t += MilliSeconds (1))
+    {
+      Simulator::Schedule (t, &LteTrafficGeneratorTestSink::Drain, &sink, packetSize);
+    }
+
+  Simulator::Stop (m_duration);
+  Simulator::Run ();
+
+  uint32_t nPackets = m_bypassPdcp ? sink.m_nPdus : sink.m_nSdus;
+  NS_TEST_ASSERT_MSG_EQ (m_bypassPdcp ? sink.m_nSdus : sink.m_nPdus, 0U, "packets sent to the wrong SAP");
+  NS_TEST_ASSERT_MSG_EQ_TOL (nPackets, m_nPackets, m_tolerance, "wrong number of packets generated");
+  if (m_bypassPdcp)
+    {
+      // 2 bytes of PDCP header with a 12 bit SN
+      NS_TEST_ASSERT_MSG_EQ (sink.m_pduBytes, nPackets * (packetSize + 2), "PDCP header not added");
+    }
+
+  generator->Dispose ();
+  Simulator::Destroy ();
+}
+
+
+/**
+ * Test suite of the traffic generator of the data radio bearers
+ */
+class LteTrafficGeneratorTestSuite : public TestSuite
+{
+public:
+  LteTrafficGeneratorTestSuite ();
+};
+
+LteTrafficGeneratorTestSuite::LteTrafficGeneratorTestSuite ()
+  : TestSuite ("lte-traffic-generator", UNIT)
+{
+  // 10 packets to fill the buffer at 0 ms, then one to replace the packet
+  // drained at each TTI
+  AddTestCase (new LteTrafficGeneratorTestCase ("full buffer", LteTrafficGenerator::FULL_BUFFER,
+                                                MicroSeconds (999500), 1009, 0, false, 100000),
+               TestCase::QUICK);
+  // the RLC buffer holds half of the backlog: the top-up stops at the first
+  // packet dropped, i.e., 6 packets at 0 ms and then 2 at each TTI
+  AddTestCase (new LteTrafficGeneratorTestCase ("full buffer, RLC buffer full", LteTrafficGenerator::FULL_BUFFER,
+                                                MicroSeconds (999500), 2004, 0, false, 500),
+               TestCase::QUICK);
+  // the last report of the 100th period may fall after the end
+  AddTestCase (new LteTrafficGeneratorTestCase ("periodic", LteTrafficGenerator::PERIODIC,
+                                                Seconds (1), 100, 1, false, 100000),
+               TestCase::QUICK);
+  AddTestCase (new LteTrafficGeneratorTestCase ("periodic without PDCP", LteTrafficGenerator::PERIODIC,
+                                                Seconds (1), 100, 1, true, 100000),
+               TestCase::QUICK);
+  AddTestCase (new LteTrafficGeneratorTestCase ("poisson", LteTrafficGenerator::POISSON,
+                                                Seconds (10), 1000, 100, false, 100000),
+               TestCase::QUICK);
+  // about half of the time in on periods of 100 ms
+  AddTestCase (new LteTrafficGeneratorTestCase ("on-off", LteTrafficGenerator::ON_OFF,
+                                                Seconds (20), 1000, 350, false, 100000),
+               TestCase::QUICK);
+}
+
+static LteTrafficGeneratorTestSuite g_lteTrafficGeneratorTestSuite;
@@ -0,0 +1,119 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/ff-mac-ul-sinr-cache.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteUlSinrCacheTest");
+
+/**
+ * Checks the estimate of the RBs without a report and the expiry of the
+ * UL SINR kept by FfMacUlSinrCache, as the schedulers did with the maps
+ * of the UL-CQIs and of their timers.
+ */
+class LteUlSinrCacheTestCase : public TestCase
+{
+public:
+  LteUlSinrCacheTestCase ();
+  virtual ~LteUlSinrCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteUlSinrCacheTestCase::LteUlSinrCacheTestCase ()
+  : TestCase ("UL SINR estimate and expiry")
+{
+}
+
+LteUlSinrCacheTestCase::~LteUlSinrCacheTestCase ()
+{
+}
+
+void
+LteUlSinrCacheTestCase::DoRun (void)
+{
+  const uint32_t validity = 3;
+  FfMacUlSinrCache cache;
+  cache.Configure (25, validity);
+  NS_TEST_ASSERT_MSG_EQ ((cache.Find (1) == 0), true, "SINR found without a report");
+
+  // PUSCH reports on RBs 2 and 3
+  FfMacUlSinrCache::UeSinr_t* ue = cache.Update (1);
+  cache.SetSinr (ue, 2, 10.0);
+  cache.SetSinr (ue, 3, 20.0);
+  NS_TEST_ASSERT_MSG_EQ ((cache.Find (1) == ue), true, "SINR not found after a report");
+  NS_TEST_ASSERT_MSG_EQ (ue->m_sinr[0], NO_SINR, "RB without a report not initialized");
+  NS_TEST_ASSERT_MSG_EQ_TOL (cache.GetSinr (ue, 3), 20.0, 1e-9, "wrong SINR of a RB reported");
+  NS_TEST_ASSERT_MSG_EQ_TOL (cache.GetSinr (ue, 7), 15.0, 1e-9, "wrong estimate of a RB not reported");
+  NS_TEST_ASSERT_MSG_EQ_TOL (ue->m_sinr[7], 15.0, 1e-9, "estimate not stored");
+  cache.SetSinr (ue, 2, 25.0);
+  NS_TEST_ASSERT_MSG_EQ_TOL (cache.GetSinr (ue, 8), 20.0, 1e-9, "average not updated by a new report");
+
+  std::map <uint16_t, std::vector <double> > sinrMap = cache.GetSinrMap ();
+  NS_TEST_ASSERT_MSG_EQ (sinrMap.size (), 1U, "wrong number of UEs in the SINR map");
+  NS_TEST_ASSERT_MSG_EQ (sinrMap[1].size (), 25U, "wrong number of RBs in the SINR map");
+  NS_TEST_ASSERT_MSG_EQ_TOL (sinrMap[1][2], 25.0, 1e-9, "wrong SINR in the SINR map");
+
+  // the report is valid for the given number of TTIs after it, as with
+  // the timers of the schedulers
+  for (uint32_t i = 0; i < validity; i++)
+    {
+      cache.NewTti ();
+      NS_TEST_ASSERT_MSG_EQ ((cache.Find (1) != 0), true, "SINR expired after " << i + 1 << " TTIs");
+    }
+  cache.NewTti ();
+  NS_TEST_ASSERT_MSG_EQ ((cache.Find (1) == 0), true, "SINR not expired");
+  NS_TEST_ASSERT_MSG_EQ (cache.GetSinrMap ().size (), 0U, "expired SINR in the SINR map");
+
+  // a new report after the expiry starts from scratch
+  ue = cache.Update (1);
+  cache.SetSinr (ue, 4, 5.0);
+  NS_TEST_ASSERT_MSG_EQ (ue->m_sinr[2], NO_SINR, "expired SINR kept");
+  NS_TEST_ASSERT_MSG_EQ_TOL (cache.GetSinr (ue, 0), 5.0, 1e-9, "expired SINR in the estimate");
+
+  cache.Remove (1);
+  NS_TEST_ASSERT_MSG_EQ ((cache.Find (1) == 0), true, "SINR found after the release of the UE");
+
+  // RBs initialized with a given SINR, as in the RR scheduler
+  FfMacUlSinrCache rrCache;
+  rrCache.Configure (6, validity, 30.0);
+  ue = rrCache.Update (2);
+  rrCache.SetSinr (ue, 0, 0.0);
+  NS_TEST_ASSERT_MSG_EQ_TOL (rrCache.GetSinr (ue, 1), 30.0, 1e-9, "wrong initial SINR");
+  NS_TEST_ASSERT_MSG_EQ_TOL (ue->m_sinrSum / ue->m_sinrNum, 25.0, 1e-9, "initial SINR not in the average");
+}
+
+
+/**
+ * Test suite of the UL SINR kept by the schedulers
+ */
+class LteUlSinrCacheTestSuite : public TestSuite
+{
+public:
+  LteUlSinrCacheTestSuite ();
+};
+
+LteUlSinrCacheTestSuite::LteUlSinrCacheTestSuite ()
+  : TestSuite ("lte-ul-sinr-cache", UNIT)
+{
+  AddTestCase (new LteUlSinrCacheTestCase (), TestCase::QUICK);
+}
+
+static LteUlSinrCacheTestSuite g_lteUlSinrCacheTestSuite;
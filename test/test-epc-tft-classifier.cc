@@ -328,4 +328,60 @@ EpcTftClassifierTestSuite::EpcTftClassifierTestSuite ()
   AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::UPLINK,   Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     9,     5897,     0,    2), TestCase::QUICK);
   AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),  5897,       10,     0,    2), TestCase::QUICK);
 
+
+
+  ///////////////////////////////////////////////////////////
+  // check fully specified filters mixed with range filters
+  ///////////////////////////////////////////////////////////
+
+  Ptr<EpcTftClassifier> c5 = Create<EpcTftClassifier> ();
+  c5->Add (EpcTft::Default (), 1);
+  Ptr<EpcTft> tft5_2 = Create<EpcTft> ();
+  EpcTft::PacketFilter pf5_2_1;
+  pf5_2_1.remoteAddress.Set ("10.0.0.1");
+  pf5_2_1.remoteMask.Set (0xFFFFFFFF);
+  pf5_2_1.localAddress.Set ("7.0.0.1");
+  pf5_2_1.localMask.Set (0xFFFFFFFF);
+  pf5_2_1.remotePortStart = 80;
+  pf5_2_1.remotePortEnd   = 80;
+  pf5_2_1.localPortStart = 5000;
+  pf5_2_1.localPortEnd   = 5000;
+  tft5_2->Add (pf5_2_1);
+  c5->Add (tft5_2, 2);
+  Ptr<EpcTft> tft5_3 = Create<EpcTft> ();
+  EpcTft::PacketFilter pf5_3_1;
+  pf5_3_1.remoteAddress.Set ("10.0.0.0");
+  pf5_3_1.remoteMask.Set (0xFF000000);
+  pf5_3_1.remotePortStart = 8080;
+  pf5_3_1.remotePortEnd   = 8080;
+  tft5_3->Add (pf5_3_1);
+  c5->Add (tft5_3, 3);
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::UPLINK,   Ipv4Address ("7.0.0.1"), Ipv4Address ("10.0.0.1"),  5000,       80,     0,    2), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::DOWNLINK, Ipv4Address ("10.0.0.1"), Ipv4Address ("7.0.0.1"),    80,     5000,     0,    2), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::UPLINK,   Ipv4Address ("7.0.0.1"), Ipv4Address ("10.0.0.1"),  5001,       80,     0,    1), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::UPLINK,   Ipv4Address ("7.0.0.1"), Ipv4Address ("10.0.0.2"),  5000,     8080,     0,    3), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::UPLINK,   Ipv4Address ("7.0.0.1"), Ipv4Address ("10.0.0.1"),  5000,       80,  0xb8,    2), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c5, EpcTft::UPLINK,   Ipv4Address ("7.0.0.1"), Ipv4Address ("10.0.0.1"),  5000,       80,     0,    2), TestCase::QUICK);
+  // same flows as above, now served by the per-flow cache of c1
+  AddTestCase (new EpcTftClassifierTestCase (c1, EpcTft::UPLINK,   Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     4,     1024,     0,    2), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c1, EpcTft::UPLINK,   Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     4,     1234,     0,    0), TestCase::QUICK);
+
+
+
+  ///////////////////////////////////////////////////////////
+  // check a packet filter added after the TFT, which is taken
+  // into account once the TFT is added again
+  ///////////////////////////////////////////////////////////
+
+  Ptr<EpcTftClassifier> c6 = Create<EpcTftClassifier> ();
+  c6->Add (EpcTft::Default (), 1);
+  Ptr<EpcTft> tft6_2 = Create<EpcTft> ();
+  tft6_2->Add (pf5_2_1);
+  c6->Add (tft6_2, 2);
+  tft6_2->Add (pf5_3_1);
+  c6->Add (tft6_2, 2);
+  AddTestCase (new EpcTftClassifierTestCase (c6, EpcTft::UPLINK,   Ipv4Address ("7.0.0.1"), Ipv4Address ("10.0.0.1"),  5000,       80,     0,    2), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c6, EpcTft::UPLINK,   Ipv4Address ("7.0.0.1"), Ipv4Address ("10.0.0.2"),  5000,     8080,     0,    2), TestCase::QUICK);
+  AddTestCase (new EpcTftClassifierTestCase (c6, EpcTft::UPLINK,   Ipv4Address ("7.0.0.1"), Ipv4Address ("10.0.0.2"),  5000,     8081,     0,    1), TestCase::QUICK);
+
 }